@@ -0,0 +1,365 @@
+// Allocations.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+#ifndef TSTALLOCATIONS_HPP
+#define TSTALLOCATIONS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include "Fatal.hpp"
+#include "Measurement.hpp"
+
+
+namespace tst
+{
+  /**
+   * The allocation figures of a single thread.
+   */
+  struct AllocationCounters
+  {
+    /** Number of allocations made. */
+    std::uint64_t count;
+    /** Number of bytes allocated. */
+    std::uint64_t bytes;
+    /**
+     * Number of bytes allocated and not yet released. Memory released
+     * by a different thread than the allocating one makes this number
+     * drift, which is why it is signed.
+     */
+    std::int64_t live;
+    /** Highest value of 'live' since the last call to 'start'. */
+    std::int64_t peak;
+    /** Nesting depth of Allocations::Ignore objects. */
+    unsigned int ignored;
+  };
+
+
+  /**
+   * Allocations keeps track of the memory allocated through the global
+   * operator new, per thread. The operators are only replaced in
+   * programs that use TESTALLOCATIONHOOKS, in all others the counters
+   * simply stay zero and 'installed' returns false.
+   *
+   * The TestCase attributes the allocations of the thread running a
+   * test function to its Measurement, including the bytes the function
+   * left allocated. Allocations made by other threads the function
+   * starts are not accounted for.
+   */
+  class Allocations
+  {
+  public:
+    /**
+     * While an Ignore object exists, allocations of the thread creating
+     * it are not counted. The framework uses it to hide its own
+     * allocations (e.g., for recording results) from test functions.
+     */
+    class Ignore
+    {
+    public:
+      Ignore();
+      ~Ignore();
+
+      Ignore(Ignore&&) = delete;
+      Ignore(Ignore const&) = delete;
+
+      Ignore& operator =(Ignore&&) = delete;
+      Ignore& operator =(Ignore const&) = delete;
+    };
+
+    static AllocationCounters& counters();
+
+    static bool installed();
+    static bool install();
+
+    static AllocationCounters start();
+    static void stop(AllocationCounters const& start, Measurement& measurement);
+
+    static void* allocate(std::size_t size) noexcept;
+    static void* allocateOrFail(std::size_t size);
+    static void deallocate(void* pointer) noexcept;
+
+  private:
+    static bool& hooks();
+
+    /*
+     * Each block is preceded by a header recording its size and whether
+     * it was counted, keeping the alignment malloc guarantees.
+     */
+    struct alignas(std::max_align_t) Header
+    {
+      std::size_t size;
+      bool counted;
+    };
+  };
+
+
+  /** @cond never */
+#if defined(__cpp_sized_deallocation)
+  #define TSTSIZEDDELETE\
+    void operator delete(void* pointer, std::size_t) noexcept\
+    {\
+      tst::Allocations::deallocate(pointer);\
+    }\
+    void operator delete[](void* pointer, std::size_t) noexcept\
+    {\
+      tst::Allocations::deallocate(pointer);\
+    }
+#else
+  #define TSTSIZEDDELETE
+#endif
+  /** @endcond never */
+
+  /**
+   * Replace the global operators new and delete with ones that count
+   * allocations (see Allocations). To be used once per program, at
+   * global scope of one of its source files, e.g.,
+   * @code
+   * TESTALLOCATIONHOOKS()
+   * @endcode
+   * @note over-aligned allocations are not counted
+   */
+  #define TESTALLOCATIONHOOKS()\
+    void* operator new(std::size_t size)\
+    {\
+      return tst::Allocations::allocateOrFail(size);\
+    }\
+    void* operator new[](std::size_t size)\
+    {\
+      return tst::Allocations::allocateOrFail(size);\
+    }\
+    void* operator new(std::size_t size, std::nothrow_t const&) noexcept\
+    {\
+      return tst::Allocations::allocate(size);\
+    }\
+    void* operator new[](std::size_t size, std::nothrow_t const&) noexcept\
+    {\
+      return tst::Allocations::allocate(size);\
+    }\
+    void operator delete(void* pointer) noexcept\
+    {\
+      tst::Allocations::deallocate(pointer);\
+    }\
+    void operator delete[](void* pointer) noexcept\
+    {\
+      tst::Allocations::deallocate(pointer);\
+    }\
+    void operator delete(void* pointer, std::nothrow_t const&) noexcept\
+    {\
+      tst::Allocations::deallocate(pointer);\
+    }\
+    void operator delete[](void* pointer, std::nothrow_t const&) noexcept\
+    {\
+      tst::Allocations::deallocate(pointer);\
+    }\
+    TSTSIZEDDELETE\
+    bool const tst_allocation_hooks = tst::Allocations::install();
+
+  /** @cond never */
+  #define TESTALLOCATIONSIMPL(expression_, maximum_, message_)\
+    do\
+    {\
+      TSTCHECKED();\
+      std::uint64_t tst_allocations = tst::Allocations::counters().count;\
+      expression_;\
+      tst_allocations = tst::Allocations::counters().count - tst_allocations;\
+      if (!tst::Allocations::installed())\
+        result.failed(__FILE__, __LINE__, "Allocation hooks not installed (see TESTALLOCATIONHOOKS)");\
+      else if (tst_allocations > static_cast<std::uint64_t>(maximum_))\
+        result.failed(__FILE__, __LINE__, message_);\
+    } while (false)
+  /** @endcond never */
+
+  /**
+   * Test that executing an expression does not allocate any memory on
+   * the current thread.
+   * @param expression_ expression to execute
+   * @note the assertion fails unless TESTALLOCATIONHOOKS is used
+   */
+  #define TESTASSERTNOALLOCATIONS(expression_)\
+    TESTALLOCATIONSIMPL(expression_, 0, "Unexpected allocation in: " #expression_)
+
+  /**
+   * Test that executing an expression allocates memory at most a given
+   * number of times on the current thread.
+   * @param expression_ expression to execute
+   * @param maximum_ maximum number of allocations allowed
+   * @note the assertion fails unless TESTALLOCATIONHOOKS is used
+   */
+  #define TESTASSERTALLOCATIONS(expression_, maximum_)\
+    TESTALLOCATIONSIMPL(expression_, maximum_, "More than " #maximum_ " allocations in: " #expression_)
+}
+
+namespace tst
+{
+  /**
+   * Stop counting the allocations of the calling thread.
+   */
+  inline Allocations::Ignore::Ignore()
+  {
+    counters().ignored++;
+  }
+
+  /**
+   * Resume counting the allocations of the calling thread, unless
+   * other Ignore objects still exist.
+   */
+  inline Allocations::Ignore::~Ignore()
+  {
+    counters().ignored--;
+  }
+
+  /**
+   * @return allocation counters of the calling thread
+   */
+  inline AllocationCounters& Allocations::counters()
+  {
+    static thread_local AllocationCounters counters;
+    return counters;
+  }
+
+  /**
+   * @return true if the program replaces the global operators new and
+   *         delete using TESTALLOCATIONHOOKS, false otherwise
+   */
+  inline bool Allocations::installed()
+  {
+    return hooks();
+  }
+
+  /**
+   * Note that the allocation hooks are installed. Invoked by
+   * TESTALLOCATIONHOOKS during static initialization.
+   * @return true
+   */
+  inline bool Allocations::install()
+  {
+    hooks() = true;
+    return true;
+  }
+
+  /**
+   * @return flag telling whether the allocation hooks are installed
+   */
+  inline bool& Allocations::hooks()
+  {
+    static bool hooks = false;
+    return hooks;
+  }
+
+  /**
+   * Start a measurement of the allocations of the calling thread.
+   * @return the counters at the start, to be passed to 'stop'
+   */
+  inline AllocationCounters Allocations::start()
+  {
+    AllocationCounters& counters = Allocations::counters();
+
+    counters.peak = counters.live;
+    return counters;
+  }
+
+  /**
+   * Finish a measurement of the allocations of the calling thread.
+   * @param start counters as returned by 'start'
+   * @param measurement measurement to store the figures in
+   */
+  inline void Allocations::stop(AllocationCounters const& start, Measurement& measurement)
+  {
+    AllocationCounters const& counters = Allocations::counters();
+
+    measurement.allocations = counters.count - start.count;
+    measurement.allocated = counters.bytes - start.bytes;
+    measurement.peak = counters.peak > start.live ? counters.peak - start.live : 0;
+    measurement.leaked = counters.live > start.live ? counters.live - start.live : 0;
+  }
+
+  /**
+   * Allocate and count a block of memory.
+   * @param size size of the block in bytes
+   * @return pointer to the block or null if no memory is available
+   */
+  inline void* Allocations::allocate(std::size_t size) noexcept
+  {
+    if (size > static_cast<std::size_t>(-1) - sizeof(Header))
+      return nullptr;
+
+    Header* header = static_cast<Header*>(std::malloc(sizeof(Header) + size));
+    if (header == nullptr)
+      return nullptr;
+
+    AllocationCounters& counters = Allocations::counters();
+
+    header->size = size;
+    header->counted = counters.ignored == 0;
+
+    if (header->counted)
+    {
+      counters.count++;
+      counters.bytes += size;
+      counters.live += size;
+
+      if (counters.live > counters.peak)
+        counters.peak = counters.live;
+    }
+    return header + 1;
+  }
+
+  /**
+   * Allocate and count a block of memory, failing the way operator new
+   * does if no memory is available.
+   * @param size size of the block in bytes
+   * @return pointer to the block
+   */
+  inline void* Allocations::allocateOrFail(std::size_t size)
+  {
+    void* pointer = allocate(size);
+
+    if (pointer == nullptr)
+    {
+#if TSTEXCEPTIONS
+      throw std::bad_alloc();
+#else
+      std::abort();
+#endif
+    }
+    return pointer;
+  }
+
+  /**
+   * Release a block of memory previously retrieved from 'allocate'.
+   * @param pointer pointer to the block (may be null)
+   */
+  inline void Allocations::deallocate(void* pointer) noexcept
+  {
+    if (pointer == nullptr)
+      return;
+
+    Header* header = static_cast<Header*>(pointer) - 1;
+
+    if (header->counted)
+      counters().live -= header->size;
+
+    std::free(header);
+  }
+}
+
+
+#endif
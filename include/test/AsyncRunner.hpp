@@ -0,0 +1,385 @@
+// AsyncRunner.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+#ifndef TSTASYNCRUNNER_HPP
+#define TSTASYNCRUNNER_HPP
+
+#include "Task.hpp"
+
+#if TST_COROUTINES
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "EventLoop.hpp"
+#include "Fatal.hpp"
+#include "Fixtures.hpp"
+#include "RecordingResult.hpp"
+#include "TestBase.hpp"
+#include "TestCaseBase.hpp"
+#include "TestResult.hpp"
+#include "TestVisitor.hpp"
+
+
+namespace tst
+{
+  /**
+   * An AsyncRunner runs tests on a few threads, each running an
+   * EventLoop. Test functions that are coroutines (see TestCase::add)
+   * are interleaved on these loops: while one waits for I/O or a timer,
+   * others run, so that hundreds of I/O bound tests can be in flight at
+   * once. Ordinary test functions run to completion when started, as
+   * they would on a ParallelRunner.
+   *
+   * The units of work are the same as for the ParallelRunner, except
+   * that a case that is not concurrent but has coroutine functions is
+   * run by a coroutine awaiting them one after the other, so that it
+   * does not block its thread either. Each unit reports into a private
+   * RecordingResult and the recorded events are replayed in the order
+   * of a serial run.
+   *
+   * Timeouts of test functions are not enforced.
+   */
+  class AsyncRunner
+  {
+  public:
+    explicit AsyncRunner(unsigned int threads = 1, unsigned int concurrency = 64);
+
+    AsyncRunner(AsyncRunner&&) = delete;
+    AsyncRunner(AsyncRunner const&) = delete;
+
+    AsyncRunner& operator =(AsyncRunner&&) = delete;
+    AsyncRunner& operator =(AsyncRunner const&) = delete;
+
+    void run(TestBase& test, TestResult& result);
+
+    unsigned int threads() const;
+    unsigned int concurrency() const;
+
+  private:
+    struct Unit
+    {
+      TestBase* test;
+      TestCaseBase* testCase;
+      unsigned int function;
+      bool first;
+      bool last;
+      /* True if all functions of 'testCase' are run by this unit. */
+      bool whole;
+    };
+
+    typedef std::vector<Unit> Units;
+
+    class Collector: public TestVisitor
+    {
+    public:
+      Collector(Units& units, Fixtures& fixtures);
+
+      virtual void visit(TestBase& test) override;
+      virtual void visit(TestCaseBase& test) override;
+
+      virtual void enter(TestSuite& suite) override;
+      virtual void leave(TestSuite& suite) override;
+
+    private:
+      Units* units_;
+      Fixtures* fixtures_;
+    };
+
+    unsigned int threads_;
+    unsigned int concurrency_;
+
+    static Task execute(Unit const& unit, TestResult& result);
+  };
+}
+
+namespace tst
+{
+  /**
+   * @param threads number of threads to use; zero means one per
+   *        hardware thread
+   * @param concurrency maximum number of units in flight on each thread
+   */
+  inline AsyncRunner::AsyncRunner(unsigned int threads, unsigned int concurrency)
+    : threads_(threads),
+      concurrency_(concurrency > 0 ? concurrency : 1)
+  {
+    if (threads_ == 0)
+      threads_ = std::thread::hardware_concurrency();
+
+    if (threads_ == 0)
+      threads_ = 1;
+  }
+
+  /**
+   * Run the given test and report to the given result object.
+   * @param test test to run
+   * @param result result object to report to
+   */
+  inline void AsyncRunner::run(TestBase& test, TestResult& result)
+  {
+    Units units;
+    Fixtures fixtures;
+    Collector collector(units, fixtures);
+    test.accept(collector);
+
+    if (units.empty())
+      return;
+
+    fixtures.setUp();
+
+    unsigned int threads = threads_ < units.size() ? threads_ : units.size();
+
+    std::vector<RecordingResult> records(units.size());
+    std::vector<char> done(units.size(), 0);
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::atomic<bool> stop(false);
+    std::atomic<std::size_t> next(0);
+
+    auto work = [&]()
+    {
+      EventLoop loop;
+      std::function<void()> launch;
+
+      // each unit finishing makes room for the next one
+      launch = [&]()
+      {
+        if (stop.load(std::memory_order_relaxed))
+          return;
+
+        std::size_t task = next.fetch_add(1, std::memory_order_relaxed);
+
+        if (task >= units.size())
+          return;
+
+        loop.spawn(execute(units[task], records[task]), [&, task](Task const&)
+        {
+          {
+            std::lock_guard<std::mutex> lock(mutex);
+            done[task] = 1;
+          }
+          condition.notify_one();
+          launch();
+        });
+      };
+
+      for (unsigned int i = 0; i < concurrency_; ++i)
+        launch();
+
+      loop.run();
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+
+    for (unsigned int i = 0; i < threads; ++i)
+      workers.emplace_back(work);
+
+    bool open = false;
+
+    // replay the results in order as soon as they become available
+    for (std::size_t i = 0; i < records.size(); ++i)
+    {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&]() { return done[i] != 0; });
+      }
+
+      Unit const& unit = units[i];
+
+      if (unit.first)
+      {
+        result.startTest(unit.testCase->name());
+        open = true;
+      }
+
+      records[i].replay(result);
+      records[i].clear();
+
+      if (unit.last)
+      {
+        result.endTest();
+        open = false;
+      }
+
+      if (result.stopped())
+      {
+        // units already running are waited for, but not reported
+        stop.store(true, std::memory_order_relaxed);
+
+        if (open)
+          result.endTest();
+        break;
+      }
+    }
+
+    for (auto it = workers.begin(); it != workers.end(); ++it)
+      it->join();
+
+    for (auto it = units.begin(); it != units.end(); ++it)
+    {
+      if (it->testCase != nullptr && it->first)
+        it->testCase->leave();
+    }
+
+    fixtures.tearDown();
+  }
+
+  /**
+   * @return number of threads used
+   */
+  inline unsigned int AsyncRunner::threads() const
+  {
+    return threads_;
+  }
+
+  /**
+   * @return maximum number of units in flight on each thread
+   */
+  inline unsigned int AsyncRunner::concurrency() const
+  {
+    return concurrency_;
+  }
+
+  /**
+   * @param unit unit of work to execute
+   * @param result result object to report to
+   * @return task executing the unit
+   */
+  inline Task AsyncRunner::execute(Unit const& unit, TestResult& result)
+  {
+    if (unit.testCase == nullptr)
+    {
+      TSTTRY
+      {
+        unit.test->run(result);
+      }
+      TSTCATCH(...)
+      {
+        result.failed(__FILE__, __LINE__, "Unexpected exception");
+      }
+      co_return;
+    }
+
+    if (!unit.whole)
+    {
+      co_await unit.testCase->startFunction(result, unit.function);
+      co_return;
+    }
+
+    TestCaseBase& test = *unit.testCase;
+    result.startTest(test.name());
+
+    for (unsigned int i = 0; i < test.functionCount() && !result.stopped(); ++i)
+    {
+      if (test.functionSelected(i))
+        co_await test.startFunction(result, i);
+    }
+
+    test.leave();
+    result.endTest();
+  }
+
+  /**
+   * @param units list of units to add collected units of work to
+   * @param fixtures fixtures to track the suites containing units in
+   */
+  inline AsyncRunner::Collector::Collector(Units& units, Fixtures& fixtures)
+    : units_(&units),
+      fixtures_(&fixtures)
+  {
+  }
+
+  /**
+   * @copydoc TestVisitor::visit
+   */
+  inline void AsyncRunner::Collector::visit(TestBase& test)
+  {
+    Unit unit = {&test, nullptr, 0, false, false, false};
+    units_->push_back(unit);
+    fixtures_->use();
+  }
+
+  /**
+   * @copydoc TestVisitor::visit
+   */
+  inline void AsyncRunner::Collector::visit(TestCaseBase& test)
+  {
+    unsigned int count = test.functionCount();
+    unsigned int selected = test.selectedCount();
+
+    if (count > 0 && selected == 0)
+      return;
+
+    if (!test.concurrent())
+    {
+      bool async = false;
+
+      for (unsigned int i = 0; i < count && !async; ++i)
+        async = test.functionSelected(i) && test.functionAsync(i);
+
+      if (!async)
+        visit(static_cast<TestBase&>(test));
+      else
+      {
+        Unit unit = {&test, &test, 0, false, false, true};
+        units_->push_back(unit);
+        fixtures_->use();
+      }
+      return;
+    }
+
+    unsigned int index = 0;
+
+    for (unsigned int i = 0; i < count; ++i)
+    {
+      if (!test.functionSelected(i))
+        continue;
+
+      Unit unit = {&test, &test, i, index == 0, index == selected - 1, false};
+      units_->push_back(unit);
+      index++;
+    }
+    fixtures_->use();
+  }
+
+  /**
+   * @copydoc TestVisitor::enter
+   */
+  inline void AsyncRunner::Collector::enter(TestSuite& suite)
+  {
+    fixtures_->enter(suite);
+  }
+
+  /**
+   * @copydoc TestVisitor::leave
+   */
+  inline void AsyncRunner::Collector::leave(TestSuite& suite)
+  {
+    fixtures_->leave(suite);
+  }
+}
+
+#endif
+
+#endif
@@ -0,0 +1,110 @@
+// Benchmark.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTBENCHMARK_HPP
+#define TSTBENCHMARK_HPP
+
+#include <cstddef>
+
+
+namespace tst
+{
+  /**
+   * An object of this class is handed to each benchmark function. It
+   * tells the function how many iterations of the code under test to
+   * run in one go.
+   *
+   * @code
+   * void benchmarkSort(tst::Benchmark& benchmark)
+   * {
+   *   for (std::size_t i = 0; i < benchmark.iterations(); ++i)
+   *   {
+   *     std::vector<int> copy = data_;
+   *     std::sort(copy.begin(), copy.end());
+   *     tst::doNotOptimize(copy);
+   *   }
+   * }
+   * @endcode
+   */
+  class Benchmark
+  {
+  public:
+    explicit Benchmark(std::size_t iterations);
+
+    std::size_t iterations() const;
+
+  private:
+    std::size_t iterations_;
+  };
+
+
+  template<typename T>
+  void doNotOptimize(T const& value);
+
+  void clobberMemory();
+}
+
+namespace tst
+{
+  /**
+   * @param iterations number of iterations to run
+   */
+  inline Benchmark::Benchmark(std::size_t iterations)
+    : iterations_(iterations)
+  {
+  }
+
+  /**
+   * @return number of iterations the benchmark function has to run
+   */
+  inline std::size_t Benchmark::iterations() const
+  {
+    return iterations_;
+  }
+
+  /**
+   * Prevent the compiler from optimizing away the computation of a
+   * value that is otherwise unused.
+   * @param value value to treat as used
+   */
+  template<typename T>
+  inline void doNotOptimize(T const& value)
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static void const* volatile sink;
+    sink = &value;
+#endif
+  }
+
+  /**
+   * Force the compiler to assume that all memory may have been read
+   * and written, preventing it from eliding stores.
+   */
+  inline void clobberMemory()
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#endif
+  }
+}
+
+
+#endif
@@ -0,0 +1,361 @@
+// BenchmarkCase.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTBENCHMARKCASE_HPP
+#define TSTBENCHMARKCASE_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "BenchmarkReporter.hpp"
+#include "Fatal.hpp"
+#include "PerfCounters.hpp"
+#include "Statistics.hpp"
+#include "TestStorage.hpp"
+
+
+namespace tst
+{
+  /**
+   * This class is the base class for all classes containing
+   * benchmarks. It is the counterpart of TestCase: benchmark functions
+   * are registered using 'add' and run using 'run'.
+   *
+   * Each benchmark function is first warmed up. Afterwards the number
+   * of iterations is scaled until a single call of the function takes
+   * at least the configured sample time. Then the configured number of
+   * samples is taken and statistics over the time of an iteration are
+   * reported. If TST_PERF_COUNTERS is defined, the events counted while
+   * taking the samples are reported as well.
+   *
+   * Calibration gives up, and the benchmark is reported as failed, if
+   * the sample time is not reached within a billion iterations or if
+   * calibrating takes longer than the configured limit, e.g., because
+   * the function ignores the number of iterations it is asked to run.
+   */
+  template<typename T>
+  class BenchmarkCase
+  {
+  public:
+    typedef void (T::*Function)(Benchmark&);
+
+    /** The maximum number of iterations in a sample. */
+    static std::size_t const max_iterations = 1000000000;
+
+    BenchmarkCase(T& instance, char const* name = nullptr);
+    virtual ~BenchmarkCase() = default;
+
+    BenchmarkCase(BenchmarkCase&&) = delete;
+    BenchmarkCase(BenchmarkCase const&) = delete;
+
+    BenchmarkCase& operator =(BenchmarkCase&&) = delete;
+    BenchmarkCase& operator =(BenchmarkCase const&) = delete;
+
+    virtual void run(BenchmarkReporter& reporter);
+    virtual bool add(Function const& function, char const* name = nullptr);
+
+    void setSamples(unsigned int samples);
+    void setSampleTime(std::chrono::nanoseconds time);
+    void setWarmUpTime(std::chrono::nanoseconds time);
+    void setCalibrationTime(std::chrono::nanoseconds time);
+
+  protected:
+    virtual void setUp();
+    virtual void tearDown();
+
+  private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Entry
+    {
+      Function function;
+      char const* name;
+    };
+
+    typedef TestStorage<Entry> Functions;
+
+    T* instance_;
+    char const* name_;
+    Functions functions_;
+
+    unsigned int samples_;
+    std::chrono::nanoseconds sample_time_;
+    std::chrono::nanoseconds warm_up_time_;
+    std::chrono::nanoseconds calibration_time_;
+
+    void measure(Function function, BenchmarkReporter& reporter);
+    double time(Function function, std::size_t iterations);
+
+    static char const* strip(char const* name);
+  };
+
+
+  /**
+   * Register a benchmark function along with its name. To be used in the
+   * constructor of a benchmark case, e.g.,
+   * TESTADDBENCHMARK(MyBenchmark::sort).
+   * @param function_ qualified name of the benchmark function
+   */
+  #define TESTADDBENCHMARK(function_)\
+    add(&function_, #function_)
+}
+
+namespace tst
+{
+  template<typename T>
+  std::size_t const BenchmarkCase<T>::max_iterations;
+
+  /**
+   * The default constructor creates an empty BenchmarkCase.
+   */
+  template<typename T>
+  inline BenchmarkCase<T>::BenchmarkCase(T& instance, char const* name)
+    : instance_(&instance),
+      name_(name),
+      functions_(),
+      samples_(30),
+      sample_time_(std::chrono::milliseconds(5)),
+      warm_up_time_(std::chrono::milliseconds(50)),
+      calibration_time_(std::chrono::seconds(10))
+  {
+  }
+
+  /**
+   * Run all benchmarks and report to the given reporter.
+   * @param reporter reporter object to report to
+   */
+  template<typename T>
+  inline void BenchmarkCase<T>::run(BenchmarkReporter& reporter)
+  {
+    reporter.startBenchmark(name_);
+
+    for (auto it = functions_.begin(); it != functions_.end(); ++it)
+    {
+      reporter.startBenchmarkFunction(it->name);
+      setUp();
+
+      measure(it->function, reporter);
+
+      tearDown();
+    }
+
+    reporter.endBenchmark();
+  }
+
+  /**
+   * This method can be used to add a new benchmark function to the
+   * list of benchmarks to execute.
+   * @param function benchmark function to add
+   * @param name name of the benchmark function; a qualified name (as
+   *        produced by TESTADD) is stripped down to the function name
+   * @return true if adding the function was successful, false if not
+   */
+  template<typename T>
+  inline bool BenchmarkCase<T>::add(Function const& function, char const* name)
+  {
+    if (function != nullptr)
+    {
+      Entry entry = {function, strip(name)};
+      return functions_.add(entry);
+    }
+    return false;
+  }
+
+  /**
+   * @param samples number of samples to take per benchmark function
+   */
+  template<typename T>
+  inline void BenchmarkCase<T>::setSamples(unsigned int samples)
+  {
+    samples_ = samples > 0 ? samples : 1;
+  }
+
+  /**
+   * @param time minimum time a single sample has to take
+   */
+  template<typename T>
+  inline void BenchmarkCase<T>::setSampleTime(std::chrono::nanoseconds time)
+  {
+    sample_time_ = time;
+  }
+
+  /**
+   * @param time time to run each benchmark function before starting
+   *        the measurement
+   */
+  template<typename T>
+  inline void BenchmarkCase<T>::setWarmUpTime(std::chrono::nanoseconds time)
+  {
+    warm_up_time_ = time;
+  }
+
+  /**
+   * @param time maximum time scaling the number of iterations may take
+   *        before the benchmark function is reported as failed
+   */
+  template<typename T>
+  inline void BenchmarkCase<T>::setCalibrationTime(std::chrono::nanoseconds time)
+  {
+    calibration_time_ = time;
+  }
+
+  /**
+   * This method can be overwritten to do some initialization work
+   * before each benchmark function. It is not part of the measurement.
+   */
+  template<typename T>
+  inline void BenchmarkCase<T>::setUp()
+  {
+  }
+
+  /**
+   * This method can be overwritten to undo the initialization work
+   * done in setUp.
+   */
+  template<typename T>
+  inline void BenchmarkCase<T>::tearDown()
+  {
+  }
+
+  /**
+   * Warm up, calibrate, and measure a benchmark function.
+   * @param function benchmark function to measure
+   * @param reporter reporter to report the result to
+   */
+  template<typename T>
+  void BenchmarkCase<T>::measure(Function function, BenchmarkReporter& reporter)
+  {
+    double sample_time = static_cast<double>(sample_time_.count());
+    std::size_t iterations = 1;
+    std::vector<double> samples;
+    char const* failure = nullptr;
+
+    TSTTRY
+    {
+      Clock::time_point start = Clock::now();
+
+      do
+      {
+        time(function, 1);
+      } while (Clock::now() - start < warm_up_time_);
+
+      start = Clock::now();
+
+      // scale the number of iterations until a sample takes long enough
+      // for the clock resolution and call overhead not to matter
+      for (;;)
+      {
+        double elapsed = time(function, iterations);
+
+        if (elapsed >= sample_time)
+          break;
+
+        if (iterations == max_iterations)
+        {
+          failure = "Calibration exceeded the maximum number of iterations";
+          break;
+        }
+
+        if (Clock::now() - start >= calibration_time_)
+        {
+          failure = "Calibration exceeded the maximum time";
+          break;
+        }
+
+        double factor = elapsed > 0.0 ? sample_time / elapsed * 1.2 : 10.0;
+        factor = factor < 1.5 ? 1.5 : factor > 10.0 ? 10.0 : factor;
+
+        // computed in floating point, so that it cannot overflow
+        double next = static_cast<double>(iterations) * factor + 1.0;
+        iterations = next < max_iterations ? static_cast<std::size_t>(next) : max_iterations;
+      }
+
+      if (failure != nullptr)
+      {
+        reporter.failed(failure);
+        reporter.endBenchmarkFunction(Statistics(std::move(samples)), 0);
+        return;
+      }
+
+      samples.reserve(samples_);
+
+#ifdef TST_PERF_COUNTERS
+      PerfCounts events = PerfCounters::thread().read();
+#endif
+
+      for (unsigned int i = 0; i < samples_; ++i)
+        samples.push_back(time(function, iterations) / iterations);
+
+#ifdef TST_PERF_COUNTERS
+      reporter.countedEvents(PerfCounters::thread().read() - events, samples_ * iterations);
+#endif
+    }
+    TSTCATCH(...)
+    {
+      // a benchmark that throws is not meaningful; we report it without
+      // any samples
+      reporter.failed("Unexpected exception");
+      samples.clear();
+      iterations = 0;
+    }
+
+    reporter.endBenchmarkFunction(Statistics(std::move(samples)), iterations);
+  }
+
+  /**
+   * @param function benchmark function to run
+   * @param iterations number of iterations to run
+   * @return time the given number of iterations took, in nanoseconds
+   */
+  template<typename T>
+  double BenchmarkCase<T>::time(Function function, std::size_t iterations)
+  {
+    Benchmark benchmark(iterations);
+
+    Clock::time_point start = Clock::now();
+    (instance_->*function)(benchmark);
+    Clock::time_point end = Clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count();
+  }
+
+  /**
+   * @param name qualified or unqualified name of a function (may be
+   *        null)
+   * @return the name without any qualification
+   */
+  template<typename T>
+  inline char const* BenchmarkCase<T>::strip(char const* name)
+  {
+    if (name != nullptr)
+    {
+      for (char const* c = name; *c != '\0'; ++c)
+      {
+        if (*c == ':')
+          name = c + 1;
+      }
+    }
+    return name;
+  }
+}
+
+
+#endif
@@ -0,0 +1,100 @@
+// BenchmarkReporter.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTBENCHMARKREPORTER_HPP
+#define TSTBENCHMARKREPORTER_HPP
+
+#include <cstddef>
+
+#include "Measurement.hpp"
+
+
+namespace tst
+{
+  class Statistics;
+
+
+  /**
+   * Objects of derived classes are used for evaluating benchmarks. This
+   * is the counterpart of TestResult for BenchmarkCase objects.
+   */
+  class BenchmarkReporter
+  {
+  public:
+    /** Destroy the reporter object. */
+    virtual ~BenchmarkReporter() = default;
+
+    /**
+     * This method marks the beginning of a new benchmark case to run.
+     * The method is invoked automatically by the framework.
+     * @param benchmark name of the benchmark case that is about to be
+     *        run
+     */
+    virtual void startBenchmark(char const* benchmark) = 0;
+
+    /**
+     * This method marks the end of a benchmark case previously started
+     * using 'startBenchmark'. The method is invoked automatically by
+     * the framework.
+     */
+    virtual void endBenchmark() = 0;
+
+    /**
+     * This method marks the beginning of the measurement of a new
+     * benchmark function. The method is invoked automatically by the
+     * framework.
+     * @param function name of the benchmark function that is about to
+     *        be measured (may be null)
+     */
+    virtual void startBenchmarkFunction(char const* function) = 0;
+
+    /**
+     * This method marks the end of the measurement of a benchmark
+     * function. The method is invoked automatically by the framework.
+     * @param statistics statistics over the time of a single iteration
+     *        (in nanoseconds) in all samples taken
+     * @param iterations number of iterations run per sample
+     */
+    virtual void endBenchmarkFunction(Statistics const& statistics, std::size_t iterations) = 0;
+
+    /**
+     * This method reports the events counted while measuring a
+     * benchmark function, right before 'endBenchmarkFunction'. The
+     * method is only invoked if TST_PERF_COUNTERS is defined.
+     * @param events events counted in all iterations of all samples
+     * @param iterations total number of iterations run
+     */
+    virtual void countedEvents(PerfCounts const& /*events*/, std::size_t /*iterations*/)
+    {
+    }
+
+    /**
+     * This method reports why a benchmark function could not be
+     * measured, right before 'endBenchmarkFunction' is invoked without
+     * any samples.
+     * @param message description of the failure
+     */
+    virtual void failed(char const* /*message*/)
+    {
+    }
+  };
+}
+
+
+#endif
@@ -0,0 +1,456 @@
+// BufferedPrinter.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTBUFFEREDPRINTER_HPP
+#define TSTBUFFEREDPRINTER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+
+
+namespace tst
+{
+  /**
+   * A printer that can be used in place of an std::ostream by results
+   * and reporters (e.g., DefaultResult<BufferedPrinter>). Output is
+   * formatted into a set of buffers allocated once upfront and full
+   * buffers are written to a file descriptor by a background thread, so
+   * that the thread running the tests never blocks on a slow consumer
+   * unless all buffers are in flight.
+   *
+   * Pending output is written out by 'flush' and on destruction. The
+   * most recently created printer additionally installs handlers for
+   * fatal signals that write out all pending output before the signal
+   * takes its usual course; output the writer thread was in the middle
+   * of writing may appear twice in that case.
+   *
+   * A printer must only be used by one thread at a time.
+   */
+  class BufferedPrinter
+  {
+  public:
+    explicit BufferedPrinter(int fd = STDOUT_FILENO, std::size_t size = 64 * 1024);
+    ~BufferedPrinter();
+
+    BufferedPrinter(BufferedPrinter&&) = delete;
+    BufferedPrinter(BufferedPrinter const&) = delete;
+
+    BufferedPrinter& operator =(BufferedPrinter&&) = delete;
+    BufferedPrinter& operator =(BufferedPrinter const&) = delete;
+
+    BufferedPrinter& operator <<(char const* string);
+    BufferedPrinter& operator <<(char character);
+    BufferedPrinter& operator <<(int value);
+    BufferedPrinter& operator <<(long value);
+    BufferedPrinter& operator <<(long long value);
+    BufferedPrinter& operator <<(unsigned int value);
+    BufferedPrinter& operator <<(unsigned long value);
+    BufferedPrinter& operator <<(unsigned long long value);
+
+    void flush();
+
+  private:
+    /* The number of buffers; one is filled while the others are written. */
+    static unsigned int const Buffers = 4;
+
+    int fd_;
+    std::size_t size_;
+    char* memory_;
+
+    /* Buffers [head_, tail_) are full, buffer tail_ is being filled. */
+    std::size_t lengths_[Buffers];
+    std::atomic<unsigned long> head_;
+    std::atomic<unsigned long> tail_;
+    std::atomic<std::size_t> fill_;
+
+    std::mutex mutex_;
+    std::condition_variable submitted_;
+    std::condition_variable written_;
+    bool done_;
+
+    pid_t pid_;
+    BufferedPrinter* previous_;
+    struct sigaction actions_[6];
+
+    std::thread writer_;
+
+    char* buffer(unsigned long index) const;
+
+    void append(char const* data, std::size_t length);
+    void submit();
+    void write();
+
+    BufferedPrinter& printSigned(long long value);
+    BufferedPrinter& printUnsigned(unsigned long long value, bool negative);
+
+    static int const* signals();
+    static std::atomic<BufferedPrinter*>& instance();
+    static void handle(int signal);
+    static void writeAll(int fd, char const* data, std::size_t length);
+  };
+}
+
+namespace tst
+{
+  /**
+   * @param fd file descriptor to write output to
+   * @param size size of each of the buffers, in bytes
+   */
+  inline BufferedPrinter::BufferedPrinter(int fd, std::size_t size)
+    : fd_(fd),
+      size_(size > 0 ? size : 1),
+      memory_(new char[Buffers * size_]),
+      lengths_(),
+      head_(0),
+      tail_(0),
+      fill_(0),
+      mutex_(),
+      submitted_(),
+      written_(),
+      done_(false),
+      pid_(getpid()),
+      previous_(instance().exchange(this)),
+      actions_(),
+      writer_(&BufferedPrinter::write, this)
+  {
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+
+    action.sa_handler = &BufferedPrinter::handle;
+    sigemptyset(&action.sa_mask);
+
+    for (unsigned int i = 0; signals()[i] != 0; ++i)
+      sigaction(signals()[i], &action, &actions_[i]);
+  }
+
+  /**
+   * Write out all pending output and destroy the printer.
+   */
+  inline BufferedPrinter::~BufferedPrinter()
+  {
+    flush();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      done_ = true;
+    }
+
+    submitted_.notify_one();
+    writer_.join();
+
+    if (instance().load() == this)
+    {
+      for (unsigned int i = 0; signals()[i] != 0; ++i)
+        sigaction(signals()[i], &actions_[i], nullptr);
+
+      instance().store(previous_);
+    }
+
+    delete[] memory_;
+  }
+
+  /**
+   * @param string null terminated string to print (may be null)
+   * @return this printer
+   */
+  inline BufferedPrinter& BufferedPrinter::operator <<(char const* string)
+  {
+    if (string != nullptr)
+      append(string, std::strlen(string));
+
+    return *this;
+  }
+
+  /**
+   * @param character character to print
+   * @return this printer
+   */
+  inline BufferedPrinter& BufferedPrinter::operator <<(char character)
+  {
+    append(&character, 1);
+    return *this;
+  }
+
+  /**
+   * @param value value to print in decimal notation
+   * @return this printer
+   */
+  inline BufferedPrinter& BufferedPrinter::operator <<(int value)
+  {
+    return printSigned(value);
+  }
+
+  /**
+   * @copydoc BufferedPrinter::operator <<(int)
+   */
+  inline BufferedPrinter& BufferedPrinter::operator <<(long value)
+  {
+    return printSigned(value);
+  }
+
+  /**
+   * @copydoc BufferedPrinter::operator <<(int)
+   */
+  inline BufferedPrinter& BufferedPrinter::operator <<(long long value)
+  {
+    return printSigned(value);
+  }
+
+  /**
+   * @copydoc BufferedPrinter::operator <<(int)
+   */
+  inline BufferedPrinter& BufferedPrinter::operator <<(unsigned int value)
+  {
+    return printUnsigned(value, false);
+  }
+
+  /**
+   * @copydoc BufferedPrinter::operator <<(int)
+   */
+  inline BufferedPrinter& BufferedPrinter::operator <<(unsigned long value)
+  {
+    return printUnsigned(value, false);
+  }
+
+  /**
+   * @copydoc BufferedPrinter::operator <<(int)
+   */
+  inline BufferedPrinter& BufferedPrinter::operator <<(unsigned long long value)
+  {
+    return printUnsigned(value, false);
+  }
+
+  /**
+   * Write out all output printed so far. The method returns once the
+   * output has been handed to the operating system.
+   */
+  inline void BufferedPrinter::flush()
+  {
+    if (fill_.load(std::memory_order_relaxed) > 0)
+      submit();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    written_.wait(lock, [this]() { return head_.load() == tail_.load(); });
+  }
+
+  /**
+   * @param index index of a buffer in the sequence of buffers
+   * @return pointer to the memory of the buffer
+   */
+  inline char* BufferedPrinter::buffer(unsigned long index) const
+  {
+    return memory_ + (index % Buffers) * size_;
+  }
+
+  /**
+   * Append data to the current buffer, handing it over to the writer
+   * whenever it becomes full.
+   * @param data data to append
+   * @param length number of bytes to append
+   */
+  inline void BufferedPrinter::append(char const* data, std::size_t length)
+  {
+    while (length > 0)
+    {
+      std::size_t fill = fill_.load(std::memory_order_relaxed);
+      std::size_t count = length < size_ - fill ? length : size_ - fill;
+
+      std::memcpy(buffer(tail_.load(std::memory_order_relaxed)) + fill, data, count);
+      fill_.store(fill + count, std::memory_order_relaxed);
+
+      data += count;
+      length -= count;
+
+      if (fill + count == size_)
+        submit();
+    }
+  }
+
+  /**
+   * Hand the current buffer over to the writer thread and wait until the
+   * next buffer is available for filling.
+   */
+  inline void BufferedPrinter::submit()
+  {
+    unsigned long tail = tail_.load(std::memory_order_relaxed);
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    lengths_[tail % Buffers] = fill_.load(std::memory_order_relaxed);
+    tail_.store(tail + 1);
+    fill_.store(0, std::memory_order_relaxed);
+
+    submitted_.notify_one();
+    written_.wait(lock, [this, tail]() { return tail + 1 - head_.load() < Buffers; });
+  }
+
+  /**
+   * The main loop of the writer thread.
+   */
+  inline void BufferedPrinter::write()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    for (;;)
+    {
+      submitted_.wait(lock, [this]() { return head_.load() != tail_.load() || done_; });
+
+      unsigned long head = head_.load();
+
+      if (head == tail_.load())
+        break;
+
+      std::size_t length = lengths_[head % Buffers];
+
+      lock.unlock();
+      writeAll(fd_, buffer(head), length);
+      lock.lock();
+
+      head_.store(head + 1);
+      written_.notify_all();
+    }
+  }
+
+  /**
+   * @param value value to print
+   * @return this printer
+   */
+  inline BufferedPrinter& BufferedPrinter::printSigned(long long value)
+  {
+    if (value < 0)
+      return printUnsigned(0ULL - static_cast<unsigned long long>(value), true);
+
+    return printUnsigned(static_cast<unsigned long long>(value), false);
+  }
+
+  /**
+   * @param value absolute value to print
+   * @param negative true if a minus sign is to be printed in front
+   * @return this printer
+   */
+  inline BufferedPrinter& BufferedPrinter::printUnsigned(unsigned long long value, bool negative)
+  {
+    char digits[24];
+    char* begin = digits + sizeof(digits);
+
+    do
+    {
+      *--begin = static_cast<char>('0' + value % 10);
+      value /= 10;
+    } while (value > 0);
+
+    if (negative)
+      *--begin = '-';
+
+    append(begin, digits + sizeof(digits) - begin);
+    return *this;
+  }
+
+  /**
+   * @return zero terminated list of signals pending output is written
+   *         out on
+   */
+  inline int const* BufferedPrinter::signals()
+  {
+    static int const signals[] = {SIGABRT, SIGBUS, SIGFPE, SIGILL, SIGSEGV, SIGTERM, 0};
+    return signals;
+  }
+
+  /**
+   * @return the printer pending output is written out for on fatal
+   *         signals
+   */
+  inline std::atomic<BufferedPrinter*>& BufferedPrinter::instance()
+  {
+    static std::atomic<BufferedPrinter*> instance(nullptr);
+    return instance;
+  }
+
+  /**
+   * Handler for fatal signals. It writes out all pending output using
+   * only async-signal-safe functions, restores the previous disposition
+   * of the signal and raises it again.
+   * @param signal the signal that was received
+   */
+  inline void BufferedPrinter::handle(int signal)
+  {
+    BufferedPrinter* printer = instance().exchange(nullptr);
+
+    if (printer == nullptr)
+    {
+      ::signal(signal, SIG_DFL);
+      raise(signal);
+      return;
+    }
+
+    // a process forked off after the printer was created must not
+    // write the output of its parent
+    if (printer->pid_ == getpid())
+    {
+      unsigned long tail = printer->tail_.load();
+
+      for (unsigned long i = printer->head_.load(); i != tail; ++i)
+        writeAll(printer->fd_, printer->buffer(i), printer->lengths_[i % Buffers]);
+
+      writeAll(printer->fd_, printer->buffer(tail), printer->fill_.load());
+    }
+
+    for (unsigned int i = 0; signals()[i] != 0; ++i)
+    {
+      if (signals()[i] == signal)
+        sigaction(signal, &printer->actions_[i], nullptr);
+    }
+
+    raise(signal);
+  }
+
+  /**
+   * Write a block of data completely, retrying on interruption.
+   * @param fd file descriptor to write to
+   * @param data data to write
+   * @param length number of bytes to write
+   */
+  inline void BufferedPrinter::writeAll(int fd, char const* data, std::size_t length)
+  {
+    while (length > 0)
+    {
+      ssize_t written = ::write(fd, data, length);
+
+      if (written < 0)
+      {
+        if (errno == EINTR)
+          continue;
+
+        break;
+      }
+
+      data += written;
+      length -= written;
+    }
+  }
+}
+
+
+#endif
@@ -0,0 +1,821 @@
+// Compare.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+#ifndef TSTCOMPARE_HPP
+#define TSTCOMPARE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+/** @cond never */
+#if defined(__GNUC__) && defined(__x86_64__)
+  #define TSTSIMD 1
+  #define TSTTARGET(isa_) __attribute__((target(isa_)))
+  #include <immintrin.h>
+#else
+  #define TSTSIMD 0
+#endif
+/** @endcond never */
+
+
+namespace tst
+{
+  /**
+   * How much two floating point values may differ and still be
+   * considered equal. Two values are equal if they differ by no more
+   * than 'absolute', by no more than 'relative' times the larger of
+   * their magnitudes, or by no more than 'ulps' units in the last
+   * place. Two NaNs are equal, a NaN and a number are not.
+   */
+  struct Tolerance
+  {
+    /** Number of representable values in between. */
+    std::uint64_t ulps;
+    /** Maximum absolute difference. */
+    double absolute;
+    /** Maximum difference relative to the larger magnitude. */
+    double relative;
+  };
+
+
+  Tolerance ulps(std::uint64_t ulps);
+  Tolerance absolute(double absolute);
+  Tolerance relative(double relative);
+
+
+  /**
+   * Compare provides the comparison kernels behind TESTASSERTBUFFER and
+   * TESTASSERTFLOATS. They compare whole buffers at once, using SSE2 or
+   * AVX2 where available (chosen at run time) and plain loops
+   * otherwise, and count all mismatches instead of stopping at the
+   * first one.
+   */
+  class Compare
+  {
+  public:
+    enum Isa
+    {
+      Scalar,
+      Sse2,
+      Avx2,
+    };
+
+    struct Mismatch
+    {
+      /** Index of the first mismatch, if any. */
+      std::size_t first;
+      /** Number of mismatching elements. */
+      std::size_t count;
+    };
+
+    static Isa best();
+
+    static Mismatch bytes(void const* first, void const* second, std::size_t size, Isa isa = best());
+    static Mismatch floats(float const* first,
+                           float const* second,
+                           std::size_t count,
+                           Tolerance const& tolerance,
+                           Isa isa = best());
+    static Mismatch floats(double const* first,
+                           double const* second,
+                           std::size_t count,
+                           Tolerance const& tolerance,
+                           Isa isa = best());
+
+    template<typename T>
+    static bool equal(T first, T second, Tolerance const& tolerance);
+
+    static bool checkBytes(void const* first,
+                           void const* second,
+                           std::size_t size,
+                           char* message,
+                           std::size_t length);
+
+    template<typename T>
+    static bool checkFloats(T const* first,
+                            T const* second,
+                            std::size_t count,
+                            Tolerance const& tolerance,
+                            char* message,
+                            std::size_t length);
+
+    static void print(char* message, std::size_t length, std::size_t& used, char const* format, ...);
+
+  private:
+    static void mismatch(Mismatch& mismatch, std::size_t index, std::size_t count);
+    static std::int64_t ordinal(float value);
+    static std::int64_t ordinal(double value);
+
+    static void bytesScalar(unsigned char const* first,
+                            unsigned char const* second,
+                            std::size_t begin,
+                            std::size_t end,
+                            Mismatch& mismatch);
+
+    template<typename T>
+    static void floatsScalar(T const* first,
+                             T const* second,
+                             std::size_t begin,
+                             std::size_t end,
+                             Tolerance const& tolerance,
+                             Mismatch& mismatch);
+
+#if TSTSIMD
+    static void bytesSse2(unsigned char const* first,
+                          unsigned char const* second,
+                          std::size_t size,
+                          Mismatch& mismatch);
+    static void bytesAvx2(unsigned char const* first,
+                          unsigned char const* second,
+                          std::size_t size,
+                          Mismatch& mismatch);
+    static void floatsSse2(float const* first,
+                           float const* second,
+                           std::size_t count,
+                           Tolerance const& tolerance,
+                           Mismatch& mismatch);
+    static void floatsAvx2(float const* first,
+                           float const* second,
+                           std::size_t count,
+                           Tolerance const& tolerance,
+                           Mismatch& mismatch);
+    static void floatsSse2(double const* first,
+                           double const* second,
+                           std::size_t count,
+                           Tolerance const& tolerance,
+                           Mismatch& mismatch);
+    static void floatsAvx2(double const* first,
+                           double const* second,
+                           std::size_t count,
+                           Tolerance const& tolerance,
+                           Mismatch& mismatch);
+#endif
+  };
+
+
+  /** @cond never */
+  #define TSTCOMPAREIMPL(check_)\
+    do\
+    {\
+      TSTCHECKED();\
+      char tst_message[1024];\
+      if (!(check_))\
+        result.failed(__FILE__, __LINE__, tst_message);\
+    } while (false)
+  /** @endcond never */
+
+  /**
+   * Test that two buffers have the same contents. The assertion counts
+   * once, no matter the size of the buffers. If it fails, the number of
+   * differing bytes and the bytes around the first difference are
+   * reported.
+   * @param first_ pointer to the first buffer
+   * @param second_ pointer to the second buffer
+   * @param size_ size of the buffers, in bytes
+   */
+  #define TESTASSERTBUFFER(first_, second_, size_)\
+    TSTCOMPAREIMPL(tst::Compare::checkBytes((first_), (second_), (size_),\
+                                            tst_message, sizeof(tst_message)))
+
+  /**
+   * Test that two arrays of floats or doubles are equal within a
+   * tolerance, e.g.,
+   * TESTASSERTFLOATS(result, expected, count, tst::ulps(4)).
+   * The assertion counts once, no matter the number of values. If it
+   * fails, the number of differing values and the values around the
+   * first difference are reported.
+   * @param first_ pointer to the first array
+   * @param second_ pointer to the second array
+   * @param count_ number of values in the arrays
+   * @param tolerance_ tolerance of the comparison (see Tolerance)
+   */
+  #define TESTASSERTFLOATS(first_, second_, count_, tolerance_)\
+    TSTCOMPAREIMPL(tst::Compare::checkFloats((first_), (second_), (count_), (tolerance_),\
+                                             tst_message, sizeof(tst_message)))
+}
+
+namespace tst
+{
+  /**
+   * @param ulps number of units in the last place values may differ by
+   * @return a tolerance of the given number of units in the last place
+   */
+  inline Tolerance ulps(std::uint64_t ulps)
+  {
+    return Tolerance{ulps, 0.0, 0.0};
+  }
+
+  /**
+   * @param absolute maximum absolute difference
+   * @return a tolerance of the given absolute difference
+   */
+  inline Tolerance absolute(double absolute)
+  {
+    return Tolerance{0, absolute, 0.0};
+  }
+
+  /**
+   * @param relative maximum difference relative to the larger magnitude,
+   *        e.g., 1e-6
+   * @return a tolerance of the given relative difference
+   */
+  inline Tolerance relative(double relative)
+  {
+    return Tolerance{0, 0.0, relative};
+  }
+
+  /**
+   * @return the fastest instruction set supported by the processor; the
+   *         environment variable TST_SIMD ("scalar", "sse2", or "avx2")
+   *         can restrict it further
+   */
+  inline Compare::Isa Compare::best()
+  {
+    static Isa const isa = []()
+    {
+      Isa best = Scalar;
+#if TSTSIMD
+      best = __builtin_cpu_supports("avx2") ? Avx2 : Sse2;
+#endif
+      char const* requested = std::getenv("TST_SIMD");
+
+      if (requested != nullptr)
+      {
+        if (std::strcmp(requested, "scalar") == 0)
+          best = Scalar;
+        else if (std::strcmp(requested, "sse2") == 0 && best > Sse2)
+          best = Sse2;
+      }
+      return best;
+    }();
+
+    return isa;
+  }
+
+  /**
+   * @param first pointer to the first buffer
+   * @param second pointer to the second buffer
+   * @param size size of the buffers, in bytes
+   * @param isa instruction set to use; it has to be supported
+   * @return the differing bytes
+   */
+  inline Compare::Mismatch Compare::bytes(void const* first, void const* second, std::size_t size, Isa isa)
+  {
+    unsigned char const* first_ = static_cast<unsigned char const*>(first);
+    unsigned char const* second_ = static_cast<unsigned char const*>(second);
+    Mismatch mismatch = {size, 0};
+
+#if TSTSIMD
+    if (isa == Avx2)
+      bytesAvx2(first_, second_, size, mismatch);
+    else if (isa == Sse2)
+      bytesSse2(first_, second_, size, mismatch);
+    else
+#endif
+      bytesScalar(first_, second_, 0, size, mismatch);
+
+    static_cast<void>(isa);
+    return mismatch;
+  }
+
+  /**
+   * @param first pointer to the first array
+   * @param second pointer to the second array
+   * @param count number of values in the arrays
+   * @param tolerance tolerance of the comparison
+   * @param isa instruction set to use; it has to be supported
+   * @return the values not equal within the tolerance
+   */
+  inline Compare::Mismatch Compare::floats(float const* first,
+                                           float const* second,
+                                           std::size_t count,
+                                           Tolerance const& tolerance,
+                                           Isa isa)
+  {
+    Mismatch mismatch = {count, 0};
+
+#if TSTSIMD
+    if (isa == Avx2)
+      floatsAvx2(first, second, count, tolerance, mismatch);
+    else if (isa == Sse2)
+      floatsSse2(first, second, count, tolerance, mismatch);
+    else
+#endif
+      floatsScalar(first, second, 0, count, tolerance, mismatch);
+
+    static_cast<void>(isa);
+    return mismatch;
+  }
+
+  /**
+   * @copydoc Compare::floats(float const*, float const*, std::size_t, Tolerance const&, Isa)
+   */
+  inline Compare::Mismatch Compare::floats(double const* first,
+                                           double const* second,
+                                           std::size_t count,
+                                           Tolerance const& tolerance,
+                                           Isa isa)
+  {
+    Mismatch mismatch = {count, 0};
+
+#if TSTSIMD
+    if (isa == Avx2)
+      floatsAvx2(first, second, count, tolerance, mismatch);
+    else if (isa == Sse2)
+      floatsSse2(first, second, count, tolerance, mismatch);
+    else
+#endif
+      floatsScalar(first, second, 0, count, tolerance, mismatch);
+
+    static_cast<void>(isa);
+    return mismatch;
+  }
+
+  /**
+   * @param first first value
+   * @param second second value
+   * @param tolerance tolerance of the comparison
+   * @return true if the values are equal within the tolerance, false
+   *         otherwise
+   */
+  template<typename T>
+  inline bool Compare::equal(T first, T second, Tolerance const& tolerance)
+  {
+    if (first == second)
+      return true;
+
+    if (std::isnan(first) || std::isnan(second))
+      return std::isnan(first) && std::isnan(second);
+
+    T difference = std::fabs(first - second);
+
+    if (difference <= static_cast<T>(tolerance.absolute))
+      return true;
+
+    if (difference <= static_cast<T>(tolerance.relative) * std::max(std::fabs(first), std::fabs(second)))
+      return true;
+
+    if (tolerance.ulps == 0)
+      return false;
+
+    std::int64_t distance = ordinal(first) - ordinal(second);
+    return static_cast<std::uint64_t>(distance < 0 ? -distance : distance) <= tolerance.ulps;
+  }
+
+  /**
+   * Compare two buffers and describe how they differ.
+   * @param first pointer to the first buffer
+   * @param second pointer to the second buffer
+   * @param size size of the buffers, in bytes
+   * @param message buffer to store a description of the differences in
+   * @param length size of the message buffer
+   * @return true if the buffers are equal, false otherwise
+   */
+  inline bool Compare::checkBytes(void const* first,
+                                  void const* second,
+                                  std::size_t size,
+                                  char* message,
+                                  std::size_t length)
+  {
+    Mismatch mismatch = bytes(first, second, size);
+
+    if (mismatch.count == 0)
+      return true;
+
+    std::size_t begin = mismatch.first > 8 ? mismatch.first - 8 : 0;
+    std::size_t end = std::min(begin + 24, size);
+    std::size_t used = 0;
+
+    print(message, length, used, "%zu of %zu bytes differ, first at offset %zu (0x%zx)",
+          mismatch.count, size, mismatch.first, mismatch.first);
+
+    void const* buffers[] = {first, second};
+
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+      unsigned char const* buffer = static_cast<unsigned char const*>(buffers[i]);
+
+      print(message, length, used, "\n  %s %08zx:", i == 0 ? "first: " : "second:", begin);
+
+      for (std::size_t j = begin; j < end; ++j)
+        print(message, length, used, j == mismatch.first ? " [%02x]" : " %02x", buffer[j]);
+    }
+    return false;
+  }
+
+  /**
+   * Compare two arrays of floating point values and describe how they
+   * differ.
+   * @param first pointer to the first array
+   * @param second pointer to the second array
+   * @param count number of values in the arrays
+   * @param tolerance tolerance of the comparison
+   * @param message buffer to store a description of the differences in
+   * @param length size of the message buffer
+   * @return true if the arrays are equal within the tolerance, false
+   *         otherwise
+   */
+  template<typename T>
+  inline bool Compare::checkFloats(T const* first,
+                                   T const* second,
+                                   std::size_t count,
+                                   Tolerance const& tolerance,
+                                   char* message,
+                                   std::size_t length)
+  {
+    Mismatch mismatch = floats(first, second, count, tolerance);
+
+    if (mismatch.count == 0)
+      return true;
+
+    int digits = std::numeric_limits<T>::max_digits10;
+    std::size_t begin = mismatch.first > 3 ? mismatch.first - 3 : 0;
+    std::size_t end = std::min(begin + 8, count);
+    std::size_t used = 0;
+
+    print(message, length, used,
+          "%zu of %zu values differ (tolerance %llu ulps, absolute %g, relative %g), first at index %zu",
+          mismatch.count, count, static_cast<unsigned long long>(tolerance.ulps),
+          tolerance.absolute, tolerance.relative, mismatch.first);
+
+    T const* arrays[] = {first, second};
+
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+      print(message, length, used, "\n  %s [%zu]", i == 0 ? "first: " : "second:", begin);
+
+      for (std::size_t j = begin; j < end; ++j)
+        print(message, length, used, j == mismatch.first ? " <%.*g>" : " %.*g",
+              digits, static_cast<double>(arrays[i][j]));
+    }
+    return false;
+  }
+
+  /**
+   * Account for mismatching elements.
+   * @param mismatch mismatch to update
+   * @param index index of the first of the elements
+   * @param count number of elements
+   */
+  inline void Compare::mismatch(Mismatch& mismatch, std::size_t index, std::size_t count)
+  {
+    if (mismatch.count == 0)
+      mismatch.first = index;
+
+    mismatch.count += count;
+  }
+
+  /**
+   * @param value a float that is not NaN
+   * @return position of the value in the ordered sequence of all floats
+   */
+  inline std::int64_t Compare::ordinal(float value)
+  {
+    std::int32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    return bits < 0 ? -static_cast<std::int64_t>(bits & 0x7fffffff) : bits;
+  }
+
+  /**
+   * @param value a double that is not NaN
+   * @return position of the value in the ordered sequence of all doubles
+   */
+  inline std::int64_t Compare::ordinal(double value)
+  {
+    std::int64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    return bits < 0 ? -(bits & 0x7fffffffffffffff) : bits;
+  }
+
+  /**
+   * Append to a message, truncating it if the buffer is too small.
+   * @param message buffer containing the message
+   * @param length size of the buffer
+   * @param used number of characters already in the buffer
+   * @param format printf style format string
+   */
+  inline void Compare::print(char* message, std::size_t length, std::size_t& used, char const* format, ...)
+  {
+    if (used + 1 >= length)
+      return;
+
+    std::va_list arguments;
+    va_start(arguments, format);
+    int printed = std::vsnprintf(message + used, length - used, format, arguments);
+    va_end(arguments);
+
+    if (printed > 0)
+      used = std::min(used + static_cast<std::size_t>(printed), length - 1);
+  }
+
+  /**
+   * @param first pointer to the first buffer
+   * @param second pointer to the second buffer
+   * @param begin offset of the first byte to compare
+   * @param end offset past the last byte to compare
+   * @param mismatch mismatch to update
+   */
+  inline void Compare::bytesScalar(unsigned char const* first,
+                                   unsigned char const* second,
+                                   std::size_t begin,
+                                   std::size_t end,
+                                   Mismatch& mismatch)
+  {
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      if (first[i] != second[i])
+        Compare::mismatch(mismatch, i, 1);
+    }
+  }
+
+  /**
+   * @param first pointer to the first array
+   * @param second pointer to the second array
+   * @param begin index of the first value to compare
+   * @param end index past the last value to compare
+   * @param tolerance tolerance of the comparison
+   * @param mismatch mismatch to update
+   */
+  template<typename T>
+  inline void Compare::floatsScalar(T const* first,
+                                    T const* second,
+                                    std::size_t begin,
+                                    std::size_t end,
+                                    Tolerance const& tolerance,
+                                    Mismatch& mismatch)
+  {
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      if (!equal(first[i], second[i], tolerance))
+        Compare::mismatch(mismatch, i, 1);
+    }
+  }
+
+#if TSTSIMD
+  /*
+   * The vector kernels compare a block of elements at once. For bytes
+   * the comparison is exact. For floating point values they only detect
+   * the common case of values that are equal within the tolerance and
+   * leave all other lanes, e.g., NaNs or values of different sign, to
+   * 'equal', so that all instruction sets agree.
+   */
+
+  /**
+   * @copydoc Compare::bytesScalar
+   */
+  TSTTARGET("sse2")
+  inline void Compare::bytesSse2(unsigned char const* first,
+                                 unsigned char const* second,
+                                 std::size_t size,
+                                 Mismatch& mismatch)
+  {
+    std::size_t i = 0;
+
+    for (; i + 16 <= size; i += 16)
+    {
+      __m128i x = _mm_loadu_si128(reinterpret_cast<__m128i const*>(first + i));
+      __m128i y = _mm_loadu_si128(reinterpret_cast<__m128i const*>(second + i));
+      unsigned int differ = ~static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, y))) & 0xffff;
+
+      if (differ != 0)
+        Compare::mismatch(mismatch, i + __builtin_ctz(differ), __builtin_popcount(differ));
+    }
+
+    bytesScalar(first, second, i, size, mismatch);
+  }
+
+  /**
+   * @copydoc Compare::bytesScalar
+   */
+  TSTTARGET("avx2")
+  inline void Compare::bytesAvx2(unsigned char const* first,
+                                 unsigned char const* second,
+                                 std::size_t size,
+                                 Mismatch& mismatch)
+  {
+    std::size_t i = 0;
+
+    for (; i + 32 <= size; i += 32)
+    {
+      __m256i x = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(first + i));
+      __m256i y = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(second + i));
+      unsigned int differ = ~static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+
+      if (differ != 0)
+        Compare::mismatch(mismatch, i + __builtin_ctz(differ), __builtin_popcount(differ));
+    }
+
+    bytesScalar(first, second, i, size, mismatch);
+  }
+
+  /**
+   * @copydoc Compare::floatsScalar
+   */
+  TSTTARGET("sse2")
+  inline void Compare::floatsSse2(float const* first,
+                                  float const* second,
+                                  std::size_t count,
+                                  Tolerance const& tolerance,
+                                  Mismatch& mismatch)
+  {
+    __m128 sign = _mm_set1_ps(-0.0f);
+    __m128 absolute = _mm_set1_ps(static_cast<float>(tolerance.absolute));
+    __m128 relative = _mm_set1_ps(static_cast<float>(tolerance.relative));
+    __m128i ulps = _mm_set1_epi32(static_cast<int>(std::min<std::uint64_t>(tolerance.ulps, 0x7fffffff)));
+    std::size_t i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+      __m128 x = _mm_loadu_ps(first + i);
+      __m128 y = _mm_loadu_ps(second + i);
+      __m128 difference = _mm_andnot_ps(sign, _mm_sub_ps(x, y));
+      __m128 magnitude = _mm_max_ps(_mm_andnot_ps(sign, x), _mm_andnot_ps(sign, y));
+
+      __m128 equal = _mm_cmpeq_ps(x, y);
+      equal = _mm_or_ps(equal, _mm_cmple_ps(difference, absolute));
+      equal = _mm_or_ps(equal, _mm_cmple_ps(difference, _mm_mul_ps(relative, magnitude)));
+
+      if (tolerance.ulps > 0)
+      {
+        // for values of the same sign the difference of their bits is
+        // their distance in units in the last place
+        __m128i xi = _mm_castps_si128(x);
+        __m128i yi = _mm_castps_si128(y);
+        __m128i signs = _mm_srai_epi32(_mm_xor_si128(xi, yi), 31);
+        __m128i distance = _mm_sub_epi32(xi, yi);
+        __m128i negative = _mm_srai_epi32(distance, 31);
+        distance = _mm_sub_epi32(_mm_xor_si128(distance, negative), negative);
+
+        __m128i far = _mm_or_si128(signs, _mm_cmpgt_epi32(distance, ulps));
+        __m128 close = _mm_andnot_ps(_mm_castsi128_ps(far), _mm_cmpord_ps(x, y));
+        equal = _mm_or_ps(equal, close);
+      }
+
+      unsigned int differ = ~static_cast<unsigned int>(_mm_movemask_ps(equal)) & 0xf;
+
+      if (differ != 0)
+        floatsScalar(first, second, i, i + 4, tolerance, mismatch);
+    }
+
+    floatsScalar(first, second, i, count, tolerance, mismatch);
+  }
+
+  /**
+   * @copydoc Compare::floatsScalar
+   */
+  TSTTARGET("avx2")
+  inline void Compare::floatsAvx2(float const* first,
+                                  float const* second,
+                                  std::size_t count,
+                                  Tolerance const& tolerance,
+                                  Mismatch& mismatch)
+  {
+    __m256 sign = _mm256_set1_ps(-0.0f);
+    __m256 absolute = _mm256_set1_ps(static_cast<float>(tolerance.absolute));
+    __m256 relative = _mm256_set1_ps(static_cast<float>(tolerance.relative));
+    __m256i ulps = _mm256_set1_epi32(static_cast<int>(std::min<std::uint64_t>(tolerance.ulps, 0x7fffffff)));
+    std::size_t i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+      __m256 x = _mm256_loadu_ps(first + i);
+      __m256 y = _mm256_loadu_ps(second + i);
+      __m256 difference = _mm256_andnot_ps(sign, _mm256_sub_ps(x, y));
+      __m256 magnitude = _mm256_max_ps(_mm256_andnot_ps(sign, x), _mm256_andnot_ps(sign, y));
+
+      __m256 equal = _mm256_cmp_ps(x, y, _CMP_EQ_OQ);
+      equal = _mm256_or_ps(equal, _mm256_cmp_ps(difference, absolute, _CMP_LE_OQ));
+      equal = _mm256_or_ps(equal, _mm256_cmp_ps(difference, _mm256_mul_ps(relative, magnitude), _CMP_LE_OQ));
+
+      if (tolerance.ulps > 0)
+      {
+        __m256i xi = _mm256_castps_si256(x);
+        __m256i yi = _mm256_castps_si256(y);
+        __m256i signs = _mm256_srai_epi32(_mm256_xor_si256(xi, yi), 31);
+        __m256i distance = _mm256_abs_epi32(_mm256_sub_epi32(xi, yi));
+
+        __m256i far = _mm256_or_si256(signs, _mm256_cmpgt_epi32(distance, ulps));
+        __m256 close = _mm256_andnot_ps(_mm256_castsi256_ps(far), _mm256_cmp_ps(x, y, _CMP_ORD_Q));
+        equal = _mm256_or_ps(equal, close);
+      }
+
+      unsigned int differ = ~static_cast<unsigned int>(_mm256_movemask_ps(equal)) & 0xff;
+
+      if (differ != 0)
+        floatsScalar(first, second, i, i + 8, tolerance, mismatch);
+    }
+
+    floatsScalar(first, second, i, count, tolerance, mismatch);
+  }
+
+  /**
+   * @copydoc Compare::floatsScalar
+   * @note Distances in units in the last place are left to 'equal'.
+   */
+  TSTTARGET("sse2")
+  inline void Compare::floatsSse2(double const* first,
+                                  double const* second,
+                                  std::size_t count,
+                                  Tolerance const& tolerance,
+                                  Mismatch& mismatch)
+  {
+    __m128d sign = _mm_set1_pd(-0.0);
+    __m128d absolute = _mm_set1_pd(tolerance.absolute);
+    __m128d relative = _mm_set1_pd(tolerance.relative);
+    std::size_t i = 0;
+
+    for (; i + 2 <= count; i += 2)
+    {
+      __m128d x = _mm_loadu_pd(first + i);
+      __m128d y = _mm_loadu_pd(second + i);
+      __m128d difference = _mm_andnot_pd(sign, _mm_sub_pd(x, y));
+      __m128d magnitude = _mm_max_pd(_mm_andnot_pd(sign, x), _mm_andnot_pd(sign, y));
+
+      __m128d equal = _mm_cmpeq_pd(x, y);
+      equal = _mm_or_pd(equal, _mm_cmple_pd(difference, absolute));
+      equal = _mm_or_pd(equal, _mm_cmple_pd(difference, _mm_mul_pd(relative, magnitude)));
+
+      if (_mm_movemask_pd(equal) != 0x3)
+        floatsScalar(first, second, i, i + 2, tolerance, mismatch);
+    }
+
+    floatsScalar(first, second, i, count, tolerance, mismatch);
+  }
+
+  /**
+   * @copydoc Compare::floatsScalar
+   */
+  TSTTARGET("avx2")
+  inline void Compare::floatsAvx2(double const* first,
+                                  double const* second,
+                                  std::size_t count,
+                                  Tolerance const& tolerance,
+                                  Mismatch& mismatch)
+  {
+    __m256d sign = _mm256_set1_pd(-0.0);
+    __m256d absolute = _mm256_set1_pd(tolerance.absolute);
+    __m256d relative = _mm256_set1_pd(tolerance.relative);
+    __m256i ulps = _mm256_set1_epi64x(static_cast<long long>(std::min<std::uint64_t>(tolerance.ulps, 0x7fffffffffffffff)));
+    __m256i zero = _mm256_setzero_si256();
+    std::size_t i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+      __m256d x = _mm256_loadu_pd(first + i);
+      __m256d y = _mm256_loadu_pd(second + i);
+      __m256d difference = _mm256_andnot_pd(sign, _mm256_sub_pd(x, y));
+      __m256d magnitude = _mm256_max_pd(_mm256_andnot_pd(sign, x), _mm256_andnot_pd(sign, y));
+
+      __m256d equal = _mm256_cmp_pd(x, y, _CMP_EQ_OQ);
+      equal = _mm256_or_pd(equal, _mm256_cmp_pd(difference, absolute, _CMP_LE_OQ));
+      equal = _mm256_or_pd(equal, _mm256_cmp_pd(difference, _mm256_mul_pd(relative, magnitude), _CMP_LE_OQ));
+
+      if (tolerance.ulps > 0)
+      {
+        __m256i xi = _mm256_castpd_si256(x);
+        __m256i yi = _mm256_castpd_si256(y);
+        __m256i signs = _mm256_cmpgt_epi64(zero, _mm256_xor_si256(xi, yi));
+        __m256i distance = _mm256_sub_epi64(xi, yi);
+        __m256i negative = _mm256_cmpgt_epi64(zero, distance);
+        distance = _mm256_sub_epi64(_mm256_xor_si256(distance, negative), negative);
+
+        __m256i far = _mm256_or_si256(signs, _mm256_cmpgt_epi64(distance, ulps));
+        __m256d close = _mm256_andnot_pd(_mm256_castsi256_pd(far), _mm256_cmp_pd(x, y, _CMP_ORD_Q));
+        equal = _mm256_or_pd(equal, close);
+      }
+
+      if (_mm256_movemask_pd(equal) != 0xf)
+        floatsScalar(first, second, i, i + 4, tolerance, mismatch);
+    }
+
+    floatsScalar(first, second, i, count, tolerance, mismatch);
+  }
+#endif
+}
+
+
+#endif
@@ -0,0 +1,531 @@
+// ConcurrentResult.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTCONCURRENTRESULT_HPP
+#define TSTCONCURRENTRESULT_HPP
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "TestResult.hpp"
+
+
+namespace tst
+{
+  /**
+   * This class is a TestResult that may be used by multiple threads at
+   * the same time. Like DefaultResult it prints the results to a
+   * stream.
+   *
+   * Each thread reporting to the object gets its own shard of counters
+   * and its own buffer of failures. Checking an assertion only touches
+   * the calling thread's shard. Shards are merged into the global
+   * statistics when the thread ends a test (and when printing the
+   * summary); buffered failures are then printed in the order they
+   * occurred on that thread.
+   */
+  template<typename T>
+  class ConcurrentResult: public TestResult
+  {
+  public:
+    ConcurrentResult(T& printer, bool verbose = false);
+
+    ConcurrentResult(ConcurrentResult&&) = delete;
+    ConcurrentResult(ConcurrentResult const&) = delete;
+
+    ConcurrentResult& operator =(ConcurrentResult&&) = delete;
+    ConcurrentResult& operator =(ConcurrentResult const&) = delete;
+
+    virtual bool threadSafe() const override;
+
+    virtual void startTest(char const* test) override;
+    virtual void endTest() override;
+
+    virtual void startTestFunction(char const* function) override;
+    virtual void endTestFunction(Measurement const& measurement) override;
+
+    virtual void checked(char const* file, int line) override;
+    virtual void failed(char const* file, int line, char const* message) override;
+
+    void printSummary();
+
+    int testsRun() const;
+    int testsFailed() const;
+
+    int functionsRun() const;
+    int functionsFailed() const;
+
+    int assertionsChecked() const;
+    int assertionsFailed() const;
+
+  private:
+    struct Failure
+    {
+      char const* function;
+      unsigned int file;
+      int line;
+      unsigned int message;
+    };
+
+    struct Shard
+    {
+      /* Thread reporting to the shard. */
+      std::thread::id thread;
+      char const* test;
+      char const* function;
+      bool test_failed;
+      bool function_failed;
+
+      int tests_run;
+      int tests_failed;
+      int functions_run;
+      int functions_failed;
+      int functions_run_this_test;
+      int functions_failed_this_test;
+      int assertions_checked;
+      int assertions_failed;
+
+      std::vector<Failure> failures;
+      std::vector<char> strings;
+
+      /* Keep shards of different threads on different cache lines. */
+      char padding[64];
+    };
+
+    typedef std::vector<std::unique_ptr<Shard>> Shards;
+
+    T* printer_;
+    bool verbose_;
+    unsigned long id_;
+
+    mutable std::mutex mutex_;
+    Shards shards_;
+
+    int tests_run_;
+    int tests_failed_;
+    int functions_run_;
+    int functions_failed_;
+    int assertions_checked_;
+    int assertions_failed_;
+
+    Shard& shard();
+    void merge(Shard& shard);
+    void flush(Shard& shard);
+    void mergeAll();
+
+    unsigned int store(Shard& shard, char const* string);
+    char const* string(Shard const& shard, unsigned int offset) const;
+
+    void printTestResult(Shard const& shard) const;
+    void printError(char const* test,
+                    char const* function,
+                    char const* file,
+                    int line,
+                    char const* message) const;
+  };
+}
+
+namespace tst
+{
+  /**
+   * The default constructor creates an empty ConcurrentResult object.
+   */
+  template<typename T>
+  inline ConcurrentResult<T>::ConcurrentResult(T& printer, bool verbose)
+    : printer_(&printer),
+      verbose_(verbose),
+      id_(0),
+      mutex_(),
+      shards_(),
+      tests_run_(0),
+      tests_failed_(0),
+      functions_run_(0),
+      functions_failed_(0),
+      assertions_checked_(0),
+      assertions_failed_(0)
+  {
+    // objects might be reallocated at the same address, so we identify
+    // them by a unique id in the per-thread shard cache
+    static std::atomic<unsigned long> ids(0);
+    id_ = ++ids;
+  }
+
+  /**
+   * @copydoc TestResult::threadSafe
+   */
+  template<typename T>
+  bool ConcurrentResult<T>::threadSafe() const
+  {
+    return true;
+  }
+
+  /**
+   * @copydoc TestResult::startTest
+   */
+  template<typename T>
+  void ConcurrentResult<T>::startTest(char const* test)
+  {
+    Shard& shard = this->shard();
+
+    shard.test = test;
+    shard.test_failed = false;
+    shard.functions_run_this_test = 0;
+    shard.functions_failed_this_test = 0;
+    shard.tests_run++;
+  }
+
+  /**
+   * @copydoc TestResult::endTest
+   */
+  template<typename T>
+  void ConcurrentResult<T>::endTest()
+  {
+    Shard& shard = this->shard();
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    flush(shard);
+
+    if (verbose_)
+      printTestResult(shard);
+
+    merge(shard);
+    shard.test = nullptr;
+  }
+
+  /**
+   * @copydoc TestResult::startTestFunction
+   */
+  template<typename T>
+  void ConcurrentResult<T>::startTestFunction(char const* function)
+  {
+    Shard& shard = this->shard();
+
+    shard.function = function;
+    shard.function_failed = false;
+  }
+
+  /**
+   * @copydoc TestResult::endTestFunction
+   */
+  template<typename T>
+  void ConcurrentResult<T>::endTestFunction(Measurement const& measurement)
+  {
+    Shard& shard = this->shard();
+
+    shard.functions_run++;
+    shard.functions_run_this_test++;
+    shard.assertions_checked += static_cast<int>(measurement.checked);
+  }
+
+  /**
+   * @copydoc TestResult::checked
+   */
+  template<typename T>
+  void ConcurrentResult<T>::checked(char const*, int)
+  {
+    shard().assertions_checked++;
+  }
+
+  /**
+   * @copydoc TestResult::failed
+   */
+  template<typename T>
+  void ConcurrentResult<T>::failed(char const* file, int line, char const* message)
+  {
+    Shard& shard = this->shard();
+
+    shard.assertions_failed++;
+
+    if (!shard.test_failed)
+    {
+      shard.tests_failed++;
+      shard.test_failed = true;
+    }
+
+    if (!shard.function_failed)
+    {
+      shard.functions_failed++;
+      shard.functions_failed_this_test++;
+      shard.function_failed = true;
+    }
+
+    Failure failure = {shard.function, store(shard, file), line, store(shard, message)};
+    shard.failures.push_back(failure);
+  }
+
+  /**
+   * Print a summary of all tests run. All threads reporting to this
+   * object have to be finished at this point.
+   */
+  template<typename T>
+  void ConcurrentResult<T>::printSummary()
+  {
+    mergeAll();
+
+    (*printer_) << "Tests run:          " << testsRun()          << '\n';
+    (*printer_) << "Tests failed:       " << testsFailed()       << '\n';
+    (*printer_) << "Functions run:      " << functionsRun()      << '\n';
+    (*printer_) << "Functions failed:   " << functionsFailed()   << '\n';
+    (*printer_) << "Assertions checked: " << assertionsChecked() << '\n';
+    (*printer_) << "Assertions failed:  " << assertionsFailed()  << '\n';
+  }
+
+  /**
+   * @return number of tests that were run
+   * @note only tests that have ended are accounted for
+   */
+  template<typename T>
+  inline int ConcurrentResult<T>::testsRun() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tests_run_;
+  }
+
+  /**
+   * @return number of tests that were run and that failed
+   */
+  template<typename T>
+  inline int ConcurrentResult<T>::testsFailed() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tests_failed_;
+  }
+
+  /**
+   * @return number of test functions that were run
+   */
+  template<typename T>
+  inline int ConcurrentResult<T>::functionsRun() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return functions_run_;
+  }
+
+  /**
+   * @return number of test functions that were run and that failed
+   */
+  template<typename T>
+  inline int ConcurrentResult<T>::functionsFailed() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return functions_failed_;
+  }
+
+  /**
+   * @return number of assertions that were checked
+   */
+  template<typename T>
+  inline int ConcurrentResult<T>::assertionsChecked() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return assertions_checked_;
+  }
+
+  /**
+   * @return number of assertions that were checked and that failed
+   */
+  template<typename T>
+  inline int ConcurrentResult<T>::assertionsFailed() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return assertions_failed_;
+  }
+
+  /**
+   * @return the shard of the calling thread
+   */
+  template<typename T>
+  typename ConcurrentResult<T>::Shard& ConcurrentResult<T>::shard()
+  {
+    struct Cache
+    {
+      unsigned long id;
+      Shard* shard;
+    };
+
+    // the common case is a thread reporting to one and the same result
+    // object over and over again, which we serve without any locking
+    static thread_local Cache cache = {0, nullptr};
+
+    if (cache.id != id_)
+    {
+      std::thread::id thread = std::this_thread::get_id();
+      std::lock_guard<std::mutex> lock(mutex_);
+
+      // the thread may have reported to another result object in the
+      // meantime, in which case it already owns a shard here
+      auto it = shards_.begin();
+      while (it != shards_.end() && (*it)->thread != thread)
+        ++it;
+
+      if (it == shards_.end())
+      {
+        std::unique_ptr<Shard> shard(new Shard());
+        shard->thread = thread;
+
+        shards_.push_back(std::move(shard));
+        it = shards_.end() - 1;
+      }
+
+      cache.id = id_;
+      cache.shard = it->get();
+    }
+    return *cache.shard;
+  }
+
+  /**
+   * Merge the counters of a shard into the global statistics.
+   * @param shard shard to merge
+   * @note the mutex has to be held
+   */
+  template<typename T>
+  void ConcurrentResult<T>::merge(Shard& shard)
+  {
+    tests_run_ += shard.tests_run;
+    tests_failed_ += shard.tests_failed;
+    functions_run_ += shard.functions_run;
+    functions_failed_ += shard.functions_failed;
+    assertions_checked_ += shard.assertions_checked;
+    assertions_failed_ += shard.assertions_failed;
+
+    shard.tests_run = 0;
+    shard.tests_failed = 0;
+    shard.functions_run = 0;
+    shard.functions_failed = 0;
+    shard.assertions_checked = 0;
+    shard.assertions_failed = 0;
+  }
+
+  /**
+   * Print all failures buffered in a shard.
+   * @param shard shard to flush
+   * @note the mutex has to be held
+   */
+  template<typename T>
+  void ConcurrentResult<T>::flush(Shard& shard)
+  {
+    for (auto it = shard.failures.begin(); it != shard.failures.end(); ++it)
+    {
+      printError(shard.test, it->function,
+                 string(shard, it->file), it->line, string(shard, it->message));
+    }
+
+    shard.failures.clear();
+    shard.strings.clear();
+  }
+
+  /**
+   * Flush and merge all shards.
+   */
+  template<typename T>
+  void ConcurrentResult<T>::mergeAll()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (auto it = shards_.begin(); it != shards_.end(); ++it)
+    {
+      flush(**it);
+      merge(**it);
+    }
+  }
+
+  /**
+   * @param shard shard to store the string in
+   * @param string string to store (may be null)
+   * @return offset of the copy in the shard's string buffer
+   */
+  template<typename T>
+  unsigned int ConcurrentResult<T>::store(Shard& shard, char const* string)
+  {
+    if (string == nullptr)
+      return static_cast<unsigned int>(-1);
+
+    unsigned int offset = static_cast<unsigned int>(shard.strings.size());
+    shard.strings.insert(shard.strings.end(), string, string + std::strlen(string) + 1);
+    return offset;
+  }
+
+  /**
+   * @param shard shard the string was stored in
+   * @param offset offset of a string as returned by 'store'
+   * @return pointer to the stored string or null
+   */
+  template<typename T>
+  char const* ConcurrentResult<T>::string(Shard const& shard, unsigned int offset) const
+  {
+    return offset != static_cast<unsigned int>(-1) ? &shard.strings[offset] : nullptr;
+  }
+
+  /**
+   * This small helper method prints the result for the current test of
+   * a shard.
+   */
+  template<typename T>
+  void ConcurrentResult<T>::printTestResult(Shard const& shard) const
+  {
+    if (shard.test != nullptr)
+      (*printer_) << shard.test;
+    else
+      (*printer_) << "<unnamed>";
+
+    int successful = shard.functions_run_this_test - shard.functions_failed_this_test;
+    int total = shard.functions_run_this_test;
+    int percentage = total > 0 ? successful * 100 / total : 100;
+
+    (*printer_) << ":\n\t";
+    (*printer_) << successful << '/' << total << " (" << percentage << "%)"
+                << ":\t" << (shard.test_failed ? "Failed" : "Successful") << '\n';
+  }
+
+  /**
+   * @param test name of the test the error occurred in (may be null)
+   * @param function name of the function the error occurred in (may be
+   *        null)
+   * @param file file the error occurred in
+   * @param line line the error occurred in
+   * @param message optional message to print (may be null)
+   */
+  template<typename T>
+  void ConcurrentResult<T>::printError(char const* test,
+                                       char const* function,
+                                       char const* file,
+                                       int line,
+                                       char const* message) const
+  {
+    (*printer_) << "\tError: " << file << " (" << line << ")";
+
+    if (test != nullptr)
+      (*printer_) << ": " << test;
+
+    if (function != nullptr)
+      (*printer_) << "::" << function;
+
+    if (message != nullptr)
+      (*printer_) << ": " << message;
+
+    (*printer_) << '\n';
+  }
+}
+
+
+#endif
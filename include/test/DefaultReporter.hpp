@@ -0,0 +1,177 @@
+// DefaultReporter.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTDEFAULTREPORTER_HPP
+#define TSTDEFAULTREPORTER_HPP
+
+#include "BenchmarkReporter.hpp"
+#include "Format.hpp"
+#include "Statistics.hpp"
+
+
+namespace tst
+{
+  /**
+   * This class represents a reasonable default implementation of a
+   * BenchmarkReporter. It prints the statistics of each benchmark
+   * function to a stream, followed by the events counted per
+   * iteration, if any.
+   */
+  template<typename T>
+  class DefaultReporter: public BenchmarkReporter
+  {
+  public:
+    DefaultReporter(T& printer);
+
+    virtual void startBenchmark(char const* benchmark) override;
+    virtual void endBenchmark() override;
+
+    virtual void startBenchmarkFunction(char const* function) override;
+    virtual void endBenchmarkFunction(Statistics const& statistics, std::size_t iterations) override;
+
+    virtual void countedEvents(PerfCounts const& events, std::size_t iterations) override;
+    virtual void failed(char const* message) override;
+
+  private:
+    T* printer_;
+    int function_;
+    char const* function_name_;
+    char const* failure_;
+
+    PerfCounts events_;
+    std::size_t events_iterations_;
+  };
+}
+
+namespace tst
+{
+  /**
+   * @param printer stream to print to
+   */
+  template<typename T>
+  inline DefaultReporter<T>::DefaultReporter(T& printer)
+    : printer_(&printer),
+      function_(0),
+      function_name_(nullptr),
+      failure_(nullptr),
+      events_(),
+      events_iterations_(0)
+  {
+  }
+
+  /**
+   * @copydoc BenchmarkReporter::startBenchmark
+   */
+  template<typename T>
+  void DefaultReporter<T>::startBenchmark(char const* benchmark)
+  {
+    function_ = 0;
+
+    if (benchmark != nullptr)
+      (*printer_) << benchmark << ":\n";
+  }
+
+  /**
+   * @copydoc BenchmarkReporter::endBenchmark
+   */
+  template<typename T>
+  void DefaultReporter<T>::endBenchmark()
+  {
+  }
+
+  /**
+   * @copydoc BenchmarkReporter::startBenchmarkFunction
+   */
+  template<typename T>
+  void DefaultReporter<T>::startBenchmarkFunction(char const* function)
+  {
+    function_++;
+    function_name_ = function;
+    failure_ = nullptr;
+    events_iterations_ = 0;
+  }
+
+  /**
+   * @copydoc BenchmarkReporter::endBenchmarkFunction
+   */
+  template<typename T>
+  void DefaultReporter<T>::endBenchmarkFunction(Statistics const& statistics,
+                                                std::size_t iterations)
+  {
+    if (function_name_ != nullptr)
+      (*printer_) << '\t' << function_name_ << ":\t";
+    else
+      (*printer_) << "\t#" << function_ << ":\t";
+
+    if (statistics.size() == 0)
+    {
+      (*printer_) << "Failed";
+
+      if (failure_ != nullptr)
+        (*printer_) << " (" << failure_ << ')';
+
+      (*printer_) << '\n';
+      return;
+    }
+
+    (*printer_) << "median ";
+    printTime(*printer_, statistics.median());
+    (*printer_) << " +/- ";
+    printTime(*printer_, statistics.mad());
+    (*printer_) << ", min ";
+    printTime(*printer_, statistics.min());
+    (*printer_) << ", p90 ";
+    printTime(*printer_, statistics.percentile(90.0));
+    (*printer_) << ", p99 ";
+    printTime(*printer_, statistics.percentile(99.0));
+    (*printer_) << " (" << statistics.size() << " x " << iterations << ")\n";
+
+    if (events_iterations_ > 0)
+    {
+      (*printer_) << "\t\tper iteration: ";
+      printEvents(*printer_, events_, events_iterations_);
+      (*printer_) << '\n';
+    }
+  }
+
+  /**
+   * @copydoc BenchmarkReporter::countedEvents
+   */
+  template<typename T>
+  void DefaultReporter<T>::countedEvents(PerfCounts const& events, std::size_t iterations)
+  {
+    events_ = events;
+
+    // all events being zero means none of them could be counted
+    if (events.instructions > 0 || events.context_switches > 0 || events.page_faults > 0)
+      events_iterations_ = iterations;
+  }
+
+  /**
+   * @copydoc BenchmarkReporter::failed
+   */
+  template<typename T>
+  void DefaultReporter<T>::failed(char const* message)
+  {
+    failure_ = message;
+  }
+}
+
+
+#endif
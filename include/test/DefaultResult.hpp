@@ -20,6 +20,9 @@
 #ifndef TSTDEFAULTRESULT_HPP
 #define TSTDEFAULTRESULT_HPP
 
+#include "Format.hpp"
+#include "Measurement.hpp"
+#include "Ranking.hpp"
 #include "TestResult.hpp"
 
 
@@ -28,19 +31,21 @@ namespace tst
   /**
    * This class represents a reasonable default implementation of a
    * TestResult. Being minimalistic it merely prints the results to a
-   * stream.
+   * stream. Optionally, the summary includes the slowest test
+   * functions and test cases. Test functions leaving memory allocated
+   * (see Allocations) are always listed.
    */
   template<typename T>
   class DefaultResult: public TestResult
   {
   public:
-    DefaultResult(T& printer, bool verbose = false);
+    DefaultResult(T& printer, bool verbose = false, unsigned int slowest = 0);
 
     virtual void startTest(char const* test) override;
     virtual void endTest() override;
 
-    virtual void startTestFunction() override;
-    virtual void endTestFunction() override;
+    virtual void startTestFunction(char const* function) override;
+    virtual void endTestFunction(Measurement const& measurement) override;
 
     virtual void checked(char const* file, int line) override;
     virtual void failed(char const* file, int line, char const* message) override;
@@ -56,9 +61,23 @@ namespace tst
     int assertionsChecked() const;
     int assertionsFailed() const;
 
+    int functionsLeaking() const;
+
   private:
+    struct Timing
+    {
+      char const* test;
+      char const* name;
+      int function;
+      Measurement measurement;
+    };
+
+    /* We have a fixed upper limit of slowest functions we report. */
+    typedef Ranking<Timing, 32> Timings;
+
     T* printer_;
     bool verbose_;
+    unsigned int slowest_;
 
     int test_id_;
     int tests_run_;
@@ -73,11 +92,22 @@ namespace tst
     int assertions_checked_;
     int assertions_failed_;
 
+    int functions_leaking_;
+
     char const* current_test_;
+    char const* current_function_;
     int last_failed_test_;
     int last_failed_function_;
 
+    Measurement test_measurement_;
+    Timings slowest_functions_;
+    Timings slowest_tests_;
+    Timings leaks_;
+
     void printTestResult() const;
+    void printName(Timing const& timing) const;
+    void printSlowest(char const* title, Timings const& timings) const;
+    void printLeaks() const;
     void printError(char const* file, int line, char const* message) const;
   };
 }
@@ -88,9 +118,10 @@ namespace tst
    * The default constructor creates an empty DefaultResult object.
    */
   template<typename T>
-  inline DefaultResult<T>::DefaultResult(T& printer, bool verbose)
+  inline DefaultResult<T>::DefaultResult(T& printer, bool verbose, unsigned int slowest)
     : printer_(&printer),
       verbose_(verbose),
+      slowest_(slowest < 32 ? slowest : 32),
       test_id_(0),
       tests_run_(0),
       tests_failed_(0),
@@ -101,9 +132,15 @@ namespace tst
       functions_failed_this_test_(0),
       assertions_checked_(0),
       assertions_failed_(0),
+      functions_leaking_(0),
       current_test_(0),
+      current_function_(0),
       last_failed_test_(0),
-      last_failed_function_(0)
+      last_failed_function_(0),
+      test_measurement_(),
+      slowest_functions_(),
+      slowest_tests_(),
+      leaks_()
   {
   }
 
@@ -120,6 +157,7 @@ namespace tst
     functions_failed_this_test_ = 0;
 
     current_test_ = test;
+    test_measurement_ = Measurement();
   }
 
   /**
@@ -131,33 +169,58 @@ namespace tst
     if (verbose_)
       printTestResult();
 
+    if (slowest_ > 0)
+    {
+      Timing timing = {current_test_, nullptr, 0, test_measurement_};
+      slowest_tests_.offer(test_measurement_.wall, timing);
+    }
+
     current_test_ = 0;
+    current_function_ = 0;
   }
 
   /**
    * @copydoc TestResult::StartTestFunction
    */
   template<typename T>
-  void DefaultResult<T>::startTestFunction()
+  void DefaultResult<T>::startTestFunction(char const* function)
   {
     function_id_++;
+    current_function_ = function;
   }
 
   /**
    * @copydoc TestResult::EndTestFunction
    */
   template<typename T>
-  void DefaultResult<T>::endTestFunction()
+  void DefaultResult<T>::endTestFunction(Measurement const& measurement)
   {
     functions_run_this_test_++;
     functions_run_++;
+    assertions_checked_ += static_cast<int>(measurement.checked);
+
+    test_measurement_ += measurement;
+
+    if (slowest_ > 0)
+    {
+      Timing timing = {current_test_, current_function_, functions_run_this_test_, measurement};
+      slowest_functions_.offer(measurement.wall, timing);
+    }
+
+    if (measurement.leaked > 0)
+    {
+      Timing timing = {current_test_, current_function_, functions_run_this_test_, measurement};
+
+      functions_leaking_++;
+      leaks_.offer(measurement.leaked, timing);
+    }
   }
 
   /**
    * @copydoc TestResult::checked
    */
   template<typename T>
-  void DefaultResult<T>::checked(char const* file, int line)
+  void DefaultResult<T>::checked(char const*, int)
   {
     assertions_checked_++;
   }
@@ -196,6 +259,18 @@ namespace tst
     (*printer_) << "Functions failed:   " << functionsFailed()   << '\n';
     (*printer_) << "Assertions checked: " << assertionsChecked() << '\n';
     (*printer_) << "Assertions failed:  " << assertionsFailed()  << '\n';
+
+    if (slowest_ > 0)
+    {
+      printSlowest("Slowest functions:\n", slowest_functions_);
+      printSlowest("Slowest tests:\n", slowest_tests_);
+    }
+
+    if (functions_leaking_ > 0)
+    {
+      (*printer_) << "Functions leaking:  " << functionsLeaking() << '\n';
+      printLeaks();
+    }
   }
 
   /**
@@ -255,6 +330,15 @@ namespace tst
     return assertions_failed_;
   }
 
+  /**
+   * @return number of test functions that left memory allocated
+   */
+  template<typename T>
+  inline int DefaultResult<T>::functionsLeaking() const
+  {
+    return functions_leaking_;
+  }
+
   /**
    * This small helper method prints the result for the current test.
    */
@@ -268,13 +352,91 @@ namespace tst
       (*printer_) << test_id_;
 
     int successful = functions_run_this_test_ - functions_failed_this_test_;
-    int percentage = functions_run_ > 0 ? successful * 100 / functions_run_this_test_ : 100;
+    int percentage = functions_run_this_test_ > 0 ? successful * 100 / functions_run_this_test_ : 100;
 
     (*printer_) << ":\n\t";
     (*printer_) << successful << '/' << functions_run_this_test_ << " (" << percentage << "%)"
                 << ":\t" << (last_failed_test_ != test_id_ ? "Successful" : "Failed") << '\n';
   }
 
+  /**
+   * Print a table of the slowest functions or tests.
+   * @param title title of the table
+   * @param timings the timings to print
+   */
+  template<typename T>
+  void DefaultResult<T>::printSlowest(char const* title, Timings const& timings) const
+  {
+    (*printer_) << title;
+
+    for (unsigned int i = 0; i < timings.size() && i < slowest_; ++i)
+    {
+      Timing const& timing = timings[i];
+
+      printName(timing);
+      printTime(*printer_, timing.measurement.wall);
+      (*printer_) << " (";
+
+      // zero unless measured, see cpuTime
+      if (timing.measurement.cpu > 0)
+      {
+        (*printer_) << "cpu ";
+        printTime(*printer_, timing.measurement.cpu);
+        (*printer_) << ", ";
+      }
+
+      (*printer_) << "set up ";
+      printTime(*printer_, timing.measurement.set_up);
+      (*printer_) << ", tear down ";
+      printTime(*printer_, timing.measurement.tear_down);
+      (*printer_) << ")";
+
+      PerfCounts const& events = timing.measurement.events;
+
+      if (events.instructions > 0 || events.context_switches > 0 || events.page_faults > 0)
+      {
+        (*printer_) << "\n\t\t";
+        printEvents(*printer_, events);
+      }
+      (*printer_) << '\n';
+    }
+  }
+
+  /**
+   * Print the test functions that left the most memory allocated.
+   */
+  template<typename T>
+  void DefaultResult<T>::printLeaks() const
+  {
+    for (unsigned int i = 0; i < leaks_.size(); ++i)
+    {
+      Measurement const& measurement = leaks_[i].measurement;
+
+      printName(leaks_[i]);
+      (*printer_) << static_cast<unsigned long long>(measurement.leaked) << " bytes leaked ("
+                  << static_cast<unsigned long long>(measurement.allocations) << " allocations, peak "
+                  << static_cast<unsigned long long>(measurement.peak) << " bytes)\n";
+    }
+  }
+
+  /**
+   * Print the name of a test or test function as row header of a
+   * table.
+   * @param timing entry of the table to print the name of
+   */
+  template<typename T>
+  void DefaultResult<T>::printName(Timing const& timing) const
+  {
+    (*printer_) << '\t' << (timing.test != nullptr ? timing.test : "<unnamed>");
+
+    if (timing.name != nullptr)
+      (*printer_) << "::" << timing.name;
+    else if (timing.function > 0)
+      (*printer_) << " #" << timing.function;
+
+    (*printer_) << ":\t";
+  }
+
   /**
    * @param file file the error occurred in
    * @param line line the error occurred in
@@ -288,6 +450,9 @@ namespace tst
     if (current_test_ != nullptr)
       (*printer_) << ": " << current_test_;
 
+    if (current_function_ != nullptr)
+      (*printer_) << "::" << current_function_;
+
     if (message != nullptr)
       (*printer_) << ": " << message;
 
@@ -0,0 +1,226 @@
+// EventLog.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+#ifndef TSTEVENTLOG_HPP
+#define TSTEVENTLOG_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "Snapshot.hpp"
+
+
+namespace tst
+{
+  /**
+   * An EventLog provides access to a binary log of a test run, as
+   * written by EventLogResult. The log is mapped into memory and its
+   * records are used in place.
+   *
+   * A log starts with a Header, followed by fixed-size records in the
+   * order of the events they describe. Strings (names of cases and
+   * functions, file names, and messages) are stored once, in a String
+   * record followed by the null terminated string padded to a multiple
+   * of the record size, and are referred to by their id afterwards. Ids
+   * are assigned consecutively starting with one; zero denotes null.
+   * All numbers are stored in the byte order of the machine writing the
+   * log.
+   */
+  class EventLog
+  {
+  public:
+    enum Type
+    {
+      StartTest = 1,
+      EndTest,
+      StartFunction,
+      EndFunction,
+      Failed,
+      String,
+    };
+
+    struct Header
+    {
+      std::uint32_t magic;
+      std::uint32_t version;
+      /** Size of each record, in bytes. */
+      std::uint32_t size;
+      std::uint32_t reserved;
+      /** Start of the run, in nanoseconds since the epoch. */
+      std::uint64_t started;
+      std::uint64_t padding[3];
+    };
+
+    struct Record
+    {
+      /** Type of the record (see Type). */
+      std::uint32_t type;
+      /**
+       * Id of the name (StartTest, StartFunction), of the file (Failed),
+       * or of the string that follows (String).
+       */
+      std::uint32_t string;
+      /** Id of the message (Failed). */
+      std::uint32_t message;
+      /**
+       * Line (Failed), number of assertions checked (EndFunction), or
+       * length of the string that follows (String).
+       */
+      std::uint32_t number;
+      /** Time of the event, in nanoseconds since the start of the run. */
+      std::uint64_t time;
+      /** Wall clock time of the function (EndFunction). */
+      std::uint64_t wall;
+      /** CPU time of the function (EndFunction). */
+      std::uint64_t cpu;
+      /** Number of allocations of the function (EndFunction). */
+      std::uint64_t allocations;
+    };
+
+    static std::uint32_t const Magic = 0x4c545354; // "TSTL"
+    static std::uint32_t const Version = 1;
+
+    explicit EventLog(char const* path);
+
+    EventLog(EventLog&&) = delete;
+    EventLog(EventLog const&) = delete;
+
+    EventLog& operator =(EventLog&&) = delete;
+    EventLog& operator =(EventLog const&) = delete;
+
+    bool valid() const;
+    Header const& header() const;
+
+    template<typename F>
+    void forEach(F function) const;
+
+    char const* string(std::uint32_t id) const;
+
+    static std::size_t blocks(std::uint32_t length);
+
+  private:
+    Snapshot::Mapping mapping_;
+    Record const* begin_;
+    Record const* end_;
+    /* Pointers to all strings, indexed by their id. */
+    std::vector<char const*> strings_;
+    bool valid_;
+  };
+}
+
+namespace tst
+{
+  static_assert(sizeof(EventLog::Header) == sizeof(EventLog::Record), "header has to span one record");
+  static_assert(sizeof(EventLog::Record) == 48, "records have to be packed");
+
+
+  /**
+   * Map a log into memory and index its strings.
+   * @param path path to the log
+   */
+  inline EventLog::EventLog(char const* path)
+    : mapping_(path),
+      begin_(nullptr),
+      end_(nullptr),
+      strings_(1, nullptr),
+      valid_(false)
+  {
+    if (!mapping_.valid() || mapping_.size() < sizeof(Header))
+      return;
+
+    Header const& header = this->header();
+
+    if (header.magic != Magic || header.version != Version || header.size != sizeof(Record))
+      return;
+
+    std::size_t count = (mapping_.size() - sizeof(Header)) / sizeof(Record);
+    begin_ = static_cast<Record const*>(mapping_.data()) + 1;
+    end_ = begin_ + count;
+
+    for (Record const* record = begin_; record < end_; ++record)
+    {
+      if (record->type != String)
+        continue;
+
+      std::size_t blocks = EventLog::blocks(record->number);
+
+      // a string cut off by an interrupted run is dropped
+      if (static_cast<std::size_t>(end_ - record - 1) < blocks || record->string != strings_.size())
+        break;
+
+      strings_.push_back(reinterpret_cast<char const*>(record + 1));
+      record += blocks;
+    }
+    valid_ = true;
+  }
+
+  /**
+   * @return true if the log could be read, false otherwise
+   */
+  inline bool EventLog::valid() const
+  {
+    return valid_;
+  }
+
+  /**
+   * @return header of the log; only to be used if the log is valid
+   */
+  inline EventLog::Header const& EventLog::header() const
+  {
+    return *static_cast<Header const*>(mapping_.data());
+  }
+
+  /**
+   * Call a function for each record of the log, except for String
+   * records, in the order in which they were written.
+   * @param function function taking a Record const&
+   */
+  template<typename F>
+  inline void EventLog::forEach(F function) const
+  {
+    for (Record const* record = begin_; record < end_; ++record)
+    {
+      if (record->type != String)
+        function(*record);
+      else
+        record += blocks(record->number);
+    }
+  }
+
+  /**
+   * @param id id of a string
+   * @return the string or null if the id is zero or unknown
+   */
+  inline char const* EventLog::string(std::uint32_t id) const
+  {
+    return id < strings_.size() ? strings_[id] : nullptr;
+  }
+
+  /**
+   * @param length length of a string, excluding the terminator
+   * @return number of records the string occupies
+   */
+  inline std::size_t EventLog::blocks(std::uint32_t length)
+  {
+    return (static_cast<std::size_t>(length) + sizeof(Record)) / sizeof(Record);
+  }
+}
+
+
+#endif
@@ -0,0 +1,344 @@
+// EventLogResult.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+#ifndef TSTEVENTLOGRESULT_HPP
+#define TSTEVENTLOGRESULT_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Allocations.hpp"
+#include "EventLog.hpp"
+#include "Measurement.hpp"
+#include "TestResult.hpp"
+
+
+namespace tst
+{
+  /**
+   * A TestResult that appends a record of each event to a binary log
+   * (see EventLog), optionally forwarding all events to another
+   * TestResult. Passed assertions are only counted and failures cost a
+   * single record, so that logging stays cheap for runs with millions
+   * of assertions. The log can be queried with the query-log tool.
+   *
+   * Records are buffered and written in blocks; whatever is buffered
+   * is written when the object is destroyed or 'flush' is called.
+   */
+  class EventLogResult: public TestResult
+  {
+  public:
+    explicit EventLogResult(char const* path);
+    EventLogResult(char const* path, TestResult& result);
+    ~EventLogResult();
+
+    EventLogResult(EventLogResult&&) = delete;
+    EventLogResult(EventLogResult const&) = delete;
+
+    EventLogResult& operator =(EventLogResult&&) = delete;
+    EventLogResult& operator =(EventLogResult const&) = delete;
+
+    bool valid() const;
+    bool flush();
+
+    virtual void startTest(char const* test) override;
+    virtual void endTest() override;
+
+    virtual void startTestFunction(char const* function) override;
+    virtual void endTestFunction(Measurement const& measurement) override;
+
+    virtual void checked(char const* file, int line) override;
+    virtual void failed(char const* file, int line, char const* message) override;
+
+    virtual bool stopped() const override;
+
+  private:
+    typedef EventLog::Record Record;
+    typedef std::unordered_map<std::string, std::uint32_t> Strings;
+
+    std::FILE* file_;
+    TestResult* result_;
+    std::uint64_t start_;
+    std::vector<Record> buffer_;
+    Strings strings_;
+    std::uint64_t checked_;
+    bool valid_;
+
+    void open(char const* path);
+    void append(EventLog::Type type, std::uint32_t string);
+    void append(Record const& record);
+    std::uint32_t intern(char const* string);
+  };
+}
+
+namespace tst
+{
+  /**
+   * @param path path to the log to write; an existing file is replaced
+   */
+  inline EventLogResult::EventLogResult(char const* path)
+    : file_(nullptr),
+      result_(nullptr),
+      start_(wallTime()),
+      buffer_(),
+      strings_(),
+      checked_(0),
+      valid_(false)
+  {
+    open(path);
+  }
+
+  /**
+   * @param path path to the log to write; an existing file is replaced
+   * @param result result object to forward all events to
+   */
+  inline EventLogResult::EventLogResult(char const* path, TestResult& result)
+    : file_(nullptr),
+      result_(&result),
+      start_(wallTime()),
+      buffer_(),
+      strings_(),
+      checked_(0),
+      valid_(false)
+  {
+    open(path);
+  }
+
+  /**
+   * Write all buffered records and close the log.
+   */
+  inline EventLogResult::~EventLogResult()
+  {
+    if (file_ != nullptr)
+    {
+      flush();
+      std::fclose(file_);
+    }
+  }
+
+  /**
+   * @return true if all records were written so far, false otherwise
+   */
+  inline bool EventLogResult::valid() const
+  {
+    return valid_;
+  }
+
+  /**
+   * Write all buffered records to the log.
+   * @return true on success, false otherwise
+   */
+  inline bool EventLogResult::flush()
+  {
+    if (file_ == nullptr)
+      return false;
+
+    if (!buffer_.empty())
+    {
+      valid_ = std::fwrite(buffer_.data(), sizeof(Record), buffer_.size(), file_) == buffer_.size() && valid_;
+      buffer_.clear();
+    }
+
+    valid_ = std::fflush(file_) == 0 && valid_;
+    return valid_;
+  }
+
+  /**
+   * @copydoc TestResult::startTest
+   */
+  inline void EventLogResult::startTest(char const* test)
+  {
+    append(EventLog::StartTest, intern(test));
+
+    if (result_ != nullptr)
+      result_->startTest(test);
+  }
+
+  /**
+   * @copydoc TestResult::endTest
+   */
+  inline void EventLogResult::endTest()
+  {
+    append(EventLog::EndTest, 0);
+
+    if (result_ != nullptr)
+      result_->endTest();
+  }
+
+  /**
+   * @copydoc TestResult::startTestFunction
+   */
+  inline void EventLogResult::startTestFunction(char const* function)
+  {
+    checked_ = 0;
+    append(EventLog::StartFunction, intern(function));
+
+    if (result_ != nullptr)
+      result_->startTestFunction(function);
+  }
+
+  /**
+   * @copydoc TestResult::endTestFunction
+   */
+  inline void EventLogResult::endTestFunction(Measurement const& measurement)
+  {
+    std::uint64_t checked = checked_ + measurement.checked;
+    Record record = {
+      EventLog::EndFunction,
+      0,
+      0,
+      static_cast<std::uint32_t>(checked < UINT32_MAX ? checked : UINT32_MAX),
+      wallTime() - start_,
+      measurement.wall,
+      measurement.cpu,
+      measurement.allocations,
+    };
+    append(record);
+
+    if (result_ != nullptr)
+      result_->endTestFunction(measurement);
+  }
+
+  /**
+   * @copydoc TestResult::checked
+   */
+  inline void EventLogResult::checked(char const* file, int line)
+  {
+    checked_++;
+
+    if (result_ != nullptr)
+      result_->checked(file, line);
+  }
+
+  /**
+   * @copydoc TestResult::failed
+   */
+  inline void EventLogResult::failed(char const* file, int line, char const* message)
+  {
+    std::uint32_t strings[] = {intern(file), intern(message)};
+    Record record = {
+      EventLog::Failed,
+      strings[0],
+      strings[1],
+      static_cast<std::uint32_t>(line),
+      wallTime() - start_,
+      0,
+      0,
+      0,
+    };
+    append(record);
+
+    if (result_ != nullptr)
+      result_->failed(file, line, message);
+  }
+
+  /**
+   * @copydoc TestResult::stopped
+   */
+  inline bool EventLogResult::stopped() const
+  {
+    return result_ != nullptr && result_->stopped();
+  }
+
+  /**
+   * Open the log and write its header.
+   * @param path path to the log to write
+   */
+  inline void EventLogResult::open(char const* path)
+  {
+    Allocations::Ignore ignore;
+
+    file_ = std::fopen(path, "wb");
+    if (file_ == nullptr)
+      return;
+
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    EventLog::Header header = {
+      EventLog::Magic,
+      EventLog::Version,
+      sizeof(Record),
+      0,
+      static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count()),
+      {0, 0, 0},
+    };
+
+    buffer_.reserve(4096);
+    valid_ = std::fwrite(&header, sizeof(header), 1, file_) == 1;
+  }
+
+  /**
+   * @param type type of the record to append
+   * @param string id of the string the record refers to
+   */
+  inline void EventLogResult::append(EventLog::Type type, std::uint32_t string)
+  {
+    Record record = {static_cast<std::uint32_t>(type), string, 0, 0, wallTime() - start_, 0, 0, 0};
+    append(record);
+  }
+
+  /**
+   * @param record record to append to the log
+   */
+  inline void EventLogResult::append(Record const& record)
+  {
+    Allocations::Ignore ignore;
+
+    buffer_.push_back(record);
+
+    if (buffer_.size() >= 4096)
+      flush();
+  }
+
+  /**
+   * Look up the id of a string, appending a String record if the string
+   * was not used before.
+   * @param string string to look up (may be null)
+   * @return id of the string
+   */
+  inline std::uint32_t EventLogResult::intern(char const* string)
+  {
+    if (string == nullptr)
+      return 0;
+
+    Allocations::Ignore ignore;
+
+    auto inserted = strings_.emplace(string, static_cast<std::uint32_t>(strings_.size() + 1));
+
+    if (!inserted.second)
+      return inserted.first->second;
+
+    std::uint32_t length = static_cast<std::uint32_t>(inserted.first->first.size());
+    Record record = {EventLog::String, inserted.first->second, 0, length, 0, 0, 0, 0};
+    append(record);
+
+    std::size_t blocks = EventLog::blocks(length);
+    std::size_t offset = buffer_.size();
+
+    buffer_.resize(offset + blocks, Record());
+    std::memcpy(&buffer_[offset], string, length);
+    return inserted.first->second;
+  }
+}
+
+
+#endif
@@ -0,0 +1,662 @@
+// EventLoop.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+#ifndef TSTEVENTLOOP_HPP
+#define TSTEVENTLOOP_HPP
+
+#include "Task.hpp"
+
+#if TST_COROUTINES
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "Measurement.hpp"
+#include "Sites.hpp"
+
+
+namespace tst
+{
+  /**
+   * An EventLoop runs coroutines (see Task) on a single thread. A
+   * coroutine waiting for a file descriptor to become readable or
+   * writable, or for some time to pass, is suspended and the loop runs
+   * others in the meantime, so that many I/O bound tests can make
+   * progress on one thread. Waiting is implemented using epoll.
+   *
+   * Coroutines running on a loop can refer to it through 'current' or
+   * use the free functions 'readable', 'writable', 'sleep', and 'yield'.
+   */
+  class EventLoop
+  {
+  public:
+    typedef std::function<void(Task const&)> Done;
+
+    /* Suspends a coroutine until a file descriptor is ready. */
+    class IoAwaiter
+    {
+    public:
+      IoAwaiter(EventLoop& loop, int fd, std::uint32_t events);
+
+      bool await_ready() const noexcept;
+      void await_suspend(std::coroutine_handle<> handle);
+      void await_resume() noexcept;
+
+    private:
+      EventLoop* loop_;
+      int fd_;
+      std::uint32_t events_;
+#ifdef TST_SITE_COUNTERS
+      /* Assertions counted before suspending, other coroutines count
+       * their own while this one waits. */
+      std::uint64_t checked_;
+#endif
+    };
+
+    /* Suspends a coroutine until a point in time. */
+    class SleepAwaiter
+    {
+    public:
+      SleepAwaiter(EventLoop& loop, std::uint64_t deadline);
+
+      bool await_ready() const noexcept;
+      void await_suspend(std::coroutine_handle<> handle);
+      void await_resume() noexcept;
+
+    private:
+      EventLoop* loop_;
+      std::uint64_t deadline_;
+#ifdef TST_SITE_COUNTERS
+      /* Assertions counted before suspending, other coroutines count
+       * their own while this one waits. */
+      std::uint64_t checked_;
+#endif
+    };
+
+    EventLoop();
+    ~EventLoop();
+
+    EventLoop(EventLoop&&) = delete;
+    EventLoop(EventLoop const&) = delete;
+
+    EventLoop& operator =(EventLoop&&) = delete;
+    EventLoop& operator =(EventLoop const&) = delete;
+
+    void spawn(Task task, Done done = Done());
+    void post(std::coroutine_handle<> handle);
+
+    void run();
+    void run(Task& task);
+
+    std::size_t tasks() const;
+
+    IoAwaiter readable(int fd);
+    IoAwaiter writable(int fd);
+    SleepAwaiter sleep(std::chrono::nanoseconds duration);
+    SleepAwaiter yield();
+
+    static EventLoop* current();
+
+  private:
+    /* The coroutines waiting for a file descriptor. */
+    struct Watch
+    {
+      std::coroutine_handle<> reader;
+      std::coroutine_handle<> writer;
+    };
+
+    struct Timer
+    {
+      std::uint64_t deadline;
+      /* Orders timers with equal deadlines by their creation. */
+      std::uint64_t sequence;
+      std::coroutine_handle<> handle;
+
+      bool operator >(Timer const& other) const;
+    };
+
+    struct Spawned
+    {
+      Done done;
+      /* False for tasks passed to 'run', which stay with the caller. */
+      bool owned;
+    };
+
+    typedef std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> Timers;
+
+    int epoll_;
+    /* An eventfd signaled by 'post', to wake up the loop. */
+    int wakeup_;
+    std::deque<std::coroutine_handle<>> ready_;
+    std::unordered_map<int, Watch> watches_;
+    Timers timers_;
+    std::uint64_t sequence_;
+    std::unordered_map<void*, Spawned> spawned_;
+    std::vector<Task::Handle> finished_;
+    std::mutex mutex_;
+    std::vector<std::coroutine_handle<>> posted_;
+
+    void start(Task::Handle handle, Spawned spawned);
+    void watch(int fd, std::uint32_t events, std::coroutine_handle<> handle);
+    void arm(int fd, Watch const& watch, bool add);
+    void wait();
+    void reap();
+    void drain();
+
+    static void finished(void* context, Task::Handle handle);
+    static EventLoop*& running();
+  };
+
+
+  EventLoop::IoAwaiter readable(int fd);
+  EventLoop::IoAwaiter writable(int fd);
+  EventLoop::SleepAwaiter sleep(std::chrono::nanoseconds duration);
+  EventLoop::SleepAwaiter yield();
+}
+
+namespace tst
+{
+  /**
+   * @param loop loop to wait on
+   * @param fd file descriptor to wait for
+   * @param events EPOLLIN or EPOLLOUT
+   */
+  inline EventLoop::IoAwaiter::IoAwaiter(EventLoop& loop, int fd, std::uint32_t events)
+    : loop_(&loop),
+      fd_(fd),
+      events_(events)
+#ifdef TST_SITE_COUNTERS
+      , checked_(0)
+#endif
+  {
+  }
+
+  /**
+   * @return false, the loop is always asked
+   */
+  inline bool EventLoop::IoAwaiter::await_ready() const noexcept
+  {
+    return false;
+  }
+
+  /**
+   * @param handle coroutine to resume once the file descriptor is ready
+   */
+  inline void EventLoop::IoAwaiter::await_suspend(std::coroutine_handle<> handle)
+  {
+#ifdef TST_SITE_COUNTERS
+    checked_ = Sites::take();
+#endif
+    loop_->watch(fd_, events_, handle);
+  }
+
+  /**
+   * Errors and hang ups also wake up the coroutine, it finds out about
+   * them when using the file descriptor.
+   */
+  inline void EventLoop::IoAwaiter::await_resume() noexcept
+  {
+#ifdef TST_SITE_COUNTERS
+    Sites::credit(checked_);
+#endif
+  }
+
+  /**
+   * @param loop loop to wait on
+   * @param deadline point in time (as returned by 'wallTime') to wait
+   *        for
+   */
+  inline EventLoop::SleepAwaiter::SleepAwaiter(EventLoop& loop, std::uint64_t deadline)
+    : loop_(&loop),
+      deadline_(deadline)
+#ifdef TST_SITE_COUNTERS
+      , checked_(0)
+#endif
+  {
+  }
+
+  /**
+   * @return false, even a deadline in the past lets other coroutines
+   *         run first
+   */
+  inline bool EventLoop::SleepAwaiter::await_ready() const noexcept
+  {
+    return false;
+  }
+
+  /**
+   * @param handle coroutine to resume once the deadline passed
+   */
+  inline void EventLoop::SleepAwaiter::await_suspend(std::coroutine_handle<> handle)
+  {
+#ifdef TST_SITE_COUNTERS
+    checked_ = Sites::take();
+#endif
+    Timer timer = {deadline_, loop_->sequence_++, handle};
+    loop_->timers_.push(timer);
+  }
+
+  /**
+   * There is nothing to return.
+   */
+  inline void EventLoop::SleepAwaiter::await_resume() noexcept
+  {
+#ifdef TST_SITE_COUNTERS
+    Sites::credit(checked_);
+#endif
+  }
+
+  /**
+   * The default constructor creates an EventLoop without any tasks.
+   */
+  inline EventLoop::EventLoop()
+    : epoll_(epoll_create1(EPOLL_CLOEXEC)),
+      wakeup_(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)),
+      ready_(),
+      watches_(),
+      timers_(),
+      sequence_(0),
+      spawned_(),
+      finished_(),
+      mutex_(),
+      posted_()
+  {
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = wakeup_;
+
+    epoll_ctl(epoll_, EPOLL_CTL_ADD, wakeup_, &event);
+  }
+
+  /**
+   * Destroy the loop along with all tasks it owns that did not finish.
+   */
+  inline EventLoop::~EventLoop()
+  {
+    for (auto it = spawned_.begin(); it != spawned_.end(); ++it)
+    {
+      if (it->second.owned)
+        Task::Handle::from_address(it->first).destroy();
+    }
+
+    close(wakeup_);
+    close(epoll_);
+  }
+
+  /**
+   * Let the loop run a task. It starts running once the loop runs.
+   * @param task task to run; the loop takes ownership of it
+   * @param done function to call once the task finished (may be empty)
+   */
+  inline void EventLoop::spawn(Task task, Done done)
+  {
+    Spawned spawned = {std::move(done), true};
+    start(task.release(), std::move(spawned));
+  }
+
+  /**
+   * Resume a coroutine on this loop. This method may be called from any
+   * thread, e.g., by a thread doing blocking work on behalf of a
+   * coroutine.
+   * @param handle coroutine to resume
+   */
+  inline void EventLoop::post(std::coroutine_handle<> handle)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      posted_.push_back(handle);
+    }
+
+    std::uint64_t one = 1;
+    ssize_t written = write(wakeup_, &one, sizeof(one));
+    static_cast<void>(written);
+  }
+
+  /**
+   * Run until all tasks finished.
+   */
+  inline void EventLoop::run()
+  {
+    EventLoop* previous = std::exchange(running(), this);
+
+    while (!spawned_.empty())
+    {
+      drain();
+
+      while (!ready_.empty())
+      {
+        std::coroutine_handle<> handle = ready_.front();
+        ready_.pop_front();
+
+        handle.resume();
+        reap();
+      }
+
+      if (!spawned_.empty())
+        wait();
+    }
+
+    running() = previous;
+  }
+
+  /**
+   * Run a task, along with all others, until all of them finished.
+   * @param task task to run; it stays with the caller, who can find out
+   *        about its outcome afterwards
+   */
+  inline void EventLoop::run(Task& task)
+  {
+    if (!task.valid() || task.done())
+      return;
+
+    Spawned spawned = {Done(), false};
+    start(task.handle_, std::move(spawned));
+    run();
+  }
+
+  /**
+   * @return number of tasks that did not finish yet
+   */
+  inline std::size_t EventLoop::tasks() const
+  {
+    return spawned_.size();
+  }
+
+  /**
+   * @param fd file descriptor to wait for
+   * @return an object to co_await until the descriptor is readable
+   */
+  inline EventLoop::IoAwaiter EventLoop::readable(int fd)
+  {
+    return IoAwaiter(*this, fd, EPOLLIN);
+  }
+
+  /**
+   * @param fd file descriptor to wait for
+   * @return an object to co_await until the descriptor is writable
+   */
+  inline EventLoop::IoAwaiter EventLoop::writable(int fd)
+  {
+    return IoAwaiter(*this, fd, EPOLLOUT);
+  }
+
+  /**
+   * @param duration time to wait
+   * @return an object to co_await until the time passed
+   */
+  inline EventLoop::SleepAwaiter EventLoop::sleep(std::chrono::nanoseconds duration)
+  {
+    return SleepAwaiter(*this, wallTime() + duration.count());
+  }
+
+  /**
+   * @return an object to co_await to let all other coroutines ready to
+   *         run do so first
+   */
+  inline EventLoop::SleepAwaiter EventLoop::yield()
+  {
+    return SleepAwaiter(*this, 0);
+  }
+
+  /**
+   * @return the loop running on the calling thread, or null if none is
+   */
+  inline EventLoop* EventLoop::current()
+  {
+    return running();
+  }
+
+  /**
+   * @param handle coroutine of the task to start
+   * @param spawned what to do once it finished
+   */
+  inline void EventLoop::start(Task::Handle handle, Spawned spawned)
+  {
+    handle.promise().setNotify(&EventLoop::finished, this);
+    spawned_.emplace(handle.address(), std::move(spawned));
+    ready_.push_back(handle);
+  }
+
+  /**
+   * @param fd file descriptor to watch
+   * @param events EPOLLIN or EPOLLOUT
+   * @param handle coroutine to resume once the descriptor is ready
+   */
+  inline void EventLoop::watch(int fd, std::uint32_t events, std::coroutine_handle<> handle)
+  {
+    auto it = watches_.find(fd);
+    bool add = it == watches_.end();
+
+    if (add)
+      it = watches_.emplace(fd, Watch()).first;
+
+    if (events & EPOLLIN)
+      it->second.reader = handle;
+    else
+      it->second.writer = handle;
+
+    arm(fd, it->second, add);
+  }
+
+  /**
+   * @param fd file descriptor to watch
+   * @param watch coroutines waiting for the descriptor
+   * @param add true if the descriptor is not yet known to epoll
+   */
+  inline void EventLoop::arm(int fd, Watch const& watch, bool add)
+  {
+    epoll_event event = {};
+    event.events = EPOLLONESHOT | (watch.reader ? EPOLLIN : 0u) | (watch.writer ? EPOLLOUT : 0u);
+    event.data.fd = fd;
+
+    if (epoll_ctl(epoll_, add ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &event) != 0)
+    {
+      // a descriptor epoll cannot watch, e.g., a regular file, is
+      // always ready
+      if (watch.reader)
+        ready_.push_back(watch.reader);
+      if (watch.writer)
+        ready_.push_back(watch.writer);
+
+      watches_.erase(fd);
+    }
+  }
+
+  /**
+   * Wait for file descriptors, timers, and posted coroutines and make
+   * the coroutines waiting for them ready.
+   */
+  inline void EventLoop::wait()
+  {
+    std::uint64_t now = wallTime();
+    int timeout = -1;
+
+    if (!timers_.empty())
+    {
+      std::uint64_t deadline = timers_.top().deadline;
+      timeout = deadline <= now ? 0 : static_cast<int>((deadline - now + 999999) / 1000000);
+    }
+
+    epoll_event events[64];
+    int count = epoll_wait(epoll_, events, 64, timeout);
+
+    for (int i = 0; i < count; ++i)
+    {
+      int fd = events[i].data.fd;
+
+      if (fd == wakeup_)
+      {
+        std::uint64_t value;
+        ssize_t read = ::read(wakeup_, &value, sizeof(value));
+        static_cast<void>(read);
+        continue;
+      }
+
+      auto it = watches_.find(fd);
+
+      if (it == watches_.end())
+        continue;
+
+      std::uint32_t ready = events[i].events;
+      bool failed = (ready & (EPOLLERR | EPOLLHUP)) != 0;
+      Watch& watch = it->second;
+
+      if (watch.reader && (failed || (ready & EPOLLIN)))
+        ready_.push_back(std::exchange(watch.reader, std::coroutine_handle<>()));
+
+      if (watch.writer && (failed || (ready & EPOLLOUT)))
+        ready_.push_back(std::exchange(watch.writer, std::coroutine_handle<>()));
+
+      if (watch.reader || watch.writer)
+        arm(fd, watch, false);
+      else
+      {
+        epoll_ctl(epoll_, EPOLL_CTL_DEL, fd, nullptr);
+        watches_.erase(it);
+      }
+    }
+
+    now = wallTime();
+
+    while (!timers_.empty() && timers_.top().deadline <= now)
+    {
+      ready_.push_back(timers_.top().handle);
+      timers_.pop();
+    }
+  }
+
+  /**
+   * Dispose of all tasks that finished.
+   */
+  inline void EventLoop::reap()
+  {
+    while (!finished_.empty())
+    {
+      Task::Handle handle = finished_.back();
+      finished_.pop_back();
+
+      auto it = spawned_.find(handle.address());
+      Spawned spawned = std::move(it->second);
+      spawned_.erase(it);
+
+      handle.promise().setNotify(nullptr, nullptr);
+
+      if (!spawned.owned)
+        continue;
+
+      // the callback may spawn further tasks
+      Task task(handle);
+
+      if (spawned.done)
+        spawned.done(task);
+    }
+  }
+
+  /**
+   * Make all posted coroutines ready.
+   */
+  inline void EventLoop::drain()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    ready_.insert(ready_.end(), posted_.begin(), posted_.end());
+    posted_.clear();
+  }
+
+  /**
+   * Called by a task spawned on the loop once it finished.
+   * @param context the loop
+   * @param handle coroutine of the task
+   */
+  inline void EventLoop::finished(void* context, Task::Handle handle)
+  {
+    static_cast<EventLoop*>(context)->finished_.push_back(handle);
+  }
+
+  /**
+   * @return the loop running on the calling thread
+   */
+  inline EventLoop*& EventLoop::running()
+  {
+    static thread_local EventLoop* loop = nullptr;
+    return loop;
+  }
+
+  /**
+   * Order timers by deadline, for use in a min-heap.
+   */
+  inline bool EventLoop::Timer::operator >(Timer const& other) const
+  {
+    return deadline > other.deadline || (deadline == other.deadline && sequence > other.sequence);
+  }
+
+  /**
+   * @param fd file descriptor to wait for
+   * @return an object to co_await until the descriptor is readable on
+   *         the loop running on the calling thread
+   */
+  inline EventLoop::IoAwaiter readable(int fd)
+  {
+    return EventLoop::current()->readable(fd);
+  }
+
+  /**
+   * @param fd file descriptor to wait for
+   * @return an object to co_await until the descriptor is writable on
+   *         the loop running on the calling thread
+   */
+  inline EventLoop::IoAwaiter writable(int fd)
+  {
+    return EventLoop::current()->writable(fd);
+  }
+
+  /**
+   * @param duration time to wait
+   * @return an object to co_await until the time passed, on the loop
+   *         running on the calling thread
+   */
+  inline EventLoop::SleepAwaiter sleep(std::chrono::nanoseconds duration)
+  {
+    return EventLoop::current()->sleep(duration);
+  }
+
+  /**
+   * @return an object to co_await to let other coroutines on the loop
+   *         running on the calling thread run first
+   */
+  inline EventLoop::SleepAwaiter yield()
+  {
+    return EventLoop::current()->yield();
+  }
+}
+
+#endif
+
+#endif
@@ -0,0 +1,141 @@
+// FailFastResult.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+#ifndef TSTFAILFASTRESULT_HPP
+#define TSTFAILFASTRESULT_HPP
+
+#include <atomic>
+
+#include "TestResult.hpp"
+
+
+namespace tst
+{
+  /**
+   * A TestResult that forwards all events to another TestResult and
+   * asks the runner to stop once a given number of assertions failed.
+   * Test functions already running are completed, so that all events
+   * stay properly nested. Combined with a Schedule running previously
+   * failed tests first, a broken build is reported within seconds.
+   */
+  class FailFastResult: public TestResult
+  {
+  public:
+    FailFastResult(TestResult& result, unsigned int failures = 1);
+
+    virtual bool threadSafe() const override;
+    virtual bool stopped() const override;
+
+    virtual void startTest(char const* test) override;
+    virtual void endTest() override;
+
+    virtual void startTestFunction(char const* function) override;
+    virtual void endTestFunction(Measurement const& measurement) override;
+
+    virtual void checked(char const* file, int line) override;
+    virtual void failed(char const* file, int line, char const* message) override;
+
+  private:
+    TestResult* result_;
+    unsigned int limit_;
+    std::atomic<unsigned int> failures_;
+  };
+}
+
+namespace tst
+{
+  /**
+   * @param result result object to forward all events to
+   * @param failures number of failed assertions after which the run is
+   *        to be stopped
+   */
+  inline FailFastResult::FailFastResult(TestResult& result, unsigned int failures)
+    : result_(&result),
+      limit_(failures > 0 ? failures : 1),
+      failures_(0)
+  {
+  }
+
+  /**
+   * @copydoc TestResult::threadSafe
+   */
+  inline bool FailFastResult::threadSafe() const
+  {
+    return result_->threadSafe();
+  }
+
+  /**
+   * @copydoc TestResult::stopped
+   */
+  inline bool FailFastResult::stopped() const
+  {
+    return failures_.load(std::memory_order_relaxed) >= limit_ || result_->stopped();
+  }
+
+  /**
+   * @copydoc TestResult::startTest
+   */
+  inline void FailFastResult::startTest(char const* test)
+  {
+    result_->startTest(test);
+  }
+
+  /**
+   * @copydoc TestResult::endTest
+   */
+  inline void FailFastResult::endTest()
+  {
+    result_->endTest();
+  }
+
+  /**
+   * @copydoc TestResult::startTestFunction
+   */
+  inline void FailFastResult::startTestFunction(char const* function)
+  {
+    result_->startTestFunction(function);
+  }
+
+  /**
+   * @copydoc TestResult::endTestFunction
+   */
+  inline void FailFastResult::endTestFunction(Measurement const& measurement)
+  {
+    result_->endTestFunction(measurement);
+  }
+
+  /**
+   * @copydoc TestResult::checked
+   */
+  inline void FailFastResult::checked(char const* file, int line)
+  {
+    result_->checked(file, line);
+  }
+
+  /**
+   * @copydoc TestResult::failed
+   */
+  inline void FailFastResult::failed(char const* file, int line, char const* message)
+  {
+    failures_.fetch_add(1, std::memory_order_relaxed);
+    result_->failed(file, line, message);
+  }
+}
+
+
+#endif
@@ -0,0 +1,156 @@
+// FailureBuffer.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTFAILUREBUFFER_HPP
+#define TSTFAILUREBUFFER_HPP
+
+#include <cstddef>
+
+
+namespace tst
+{
+  /**
+   * A FailureBuffer holds on to the assertion failures of a single test
+   * function for results that can only report them once the function
+   * has finished. It uses a fixed amount of memory: only the first
+   * 'Capacity' failures are kept, the remaining ones are just counted,
+   * and file names and messages are truncated to 'TextSize' - 1
+   * characters.
+   */
+  class FailureBuffer
+  {
+  public:
+    static unsigned int const Capacity = 16;
+    static std::size_t const TextSize = 256;
+
+    struct Failure
+    {
+      char file[TextSize];
+      int line;
+      char message[TextSize];
+      bool has_message;
+    };
+
+    FailureBuffer();
+
+    void add(char const* file, int line, char const* message);
+    void clear();
+
+    unsigned int size() const;
+    unsigned long count() const;
+
+    Failure const& operator [](unsigned int index) const;
+
+  private:
+    Failure failures_[Capacity];
+    unsigned int size_;
+    unsigned long count_;
+
+    static void copy(char* destination, char const* source);
+  };
+}
+
+namespace tst
+{
+  /**
+   * The default constructor creates an empty FailureBuffer.
+   */
+  inline FailureBuffer::FailureBuffer()
+    : size_(0),
+      count_(0)
+  {
+  }
+
+  /**
+   * @param file file in which the assertion failure occurred (may be
+   *        null)
+   * @param line line where the assertion failure occurred
+   * @param message optional message (may be null)
+   */
+  inline void FailureBuffer::add(char const* file, int line, char const* message)
+  {
+    count_++;
+
+    if (size_ == Capacity)
+      return;
+
+    Failure& failure = failures_[size_++];
+
+    copy(failure.file, file);
+    failure.line = line;
+    copy(failure.message, message);
+    failure.has_message = message != nullptr;
+  }
+
+  /**
+   * Remove all failures from the buffer.
+   */
+  inline void FailureBuffer::clear()
+  {
+    size_ = 0;
+    count_ = 0;
+  }
+
+  /**
+   * @return number of failures stored in the buffer
+   */
+  inline unsigned int FailureBuffer::size() const
+  {
+    return size_;
+  }
+
+  /**
+   * @return number of failures added to the buffer, including the ones
+   *         that did not fit in
+   */
+  inline unsigned long FailureBuffer::count() const
+  {
+    return count_;
+  }
+
+  /**
+   * @param index index of the failure to retrieve (has to be less than
+   *        'size()')
+   * @return the failure at the given index
+   */
+  inline FailureBuffer::Failure const& FailureBuffer::operator [](unsigned int index) const
+  {
+    return failures_[index];
+  }
+
+  /**
+   * @param destination buffer of 'TextSize' characters to copy to
+   * @param source string to copy (may be null)
+   */
+  inline void FailureBuffer::copy(char* destination, char const* source)
+  {
+    std::size_t i = 0;
+
+    if (source != nullptr)
+    {
+      for (; i < TextSize - 1 && source[i] != '\0'; ++i)
+        destination[i] = source[i];
+    }
+
+    destination[i] = '\0';
+  }
+}
+
+
+#endif
@@ -0,0 +1,172 @@
+// FanOutResult.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTFANOUTRESULT_HPP
+#define TSTFANOUTRESULT_HPP
+
+#include "TestResult.hpp"
+#include "TestStorage.hpp"
+
+
+namespace tst
+{
+  /**
+   * A TestResult that forwards all events to a number of other results,
+   * e.g., to print human readable output and write a JUnit report in
+   * the same run.
+   */
+  class FanOutResult: public TestResult
+  {
+  public:
+    FanOutResult();
+
+    FanOutResult(FanOutResult&&) = delete;
+    FanOutResult(FanOutResult const&) = delete;
+
+    FanOutResult& operator =(FanOutResult&&) = delete;
+    FanOutResult& operator =(FanOutResult const&) = delete;
+
+    bool add(TestResult& result);
+
+    virtual bool threadSafe() const override;
+    virtual bool stopped() const override;
+
+    virtual void startTest(char const* test) override;
+    virtual void endTest() override;
+
+    virtual void startTestFunction(char const* function) override;
+    virtual void endTestFunction(Measurement const& measurement) override;
+
+    virtual void checked(char const* file, int line) override;
+    virtual void failed(char const* file, int line, char const* message) override;
+
+  private:
+    typedef TestStorage<TestResult*> Results;
+
+    Results results_;
+  };
+}
+
+namespace tst
+{
+  /**
+   * The default constructor creates a FanOutResult without any results
+   * to forward to.
+   */
+  inline FanOutResult::FanOutResult()
+    : results_()
+  {
+  }
+
+  /**
+   * @param result result to forward all events to
+   * @return true if adding the result was successful, false if not
+   */
+  inline bool FanOutResult::add(TestResult& result)
+  {
+    if (&result != this)
+      return results_.add(&result);
+
+    return false;
+  }
+
+  /**
+   * @return true if all results forwarded to are thread safe
+   */
+  inline bool FanOutResult::threadSafe() const
+  {
+    for (unsigned int i = 0; i < results_.size(); ++i)
+    {
+      if (!results_[i]->threadSafe())
+        return false;
+    }
+    return true;
+  }
+
+  /**
+   * @return true if any of the results forwarded to asks for the run to
+   *         be stopped
+   */
+  inline bool FanOutResult::stopped() const
+  {
+    for (unsigned int i = 0; i < results_.size(); ++i)
+    {
+      if (results_[i]->stopped())
+        return true;
+    }
+    return false;
+  }
+
+  /**
+   * @copydoc TestResult::startTest
+   */
+  inline void FanOutResult::startTest(char const* test)
+  {
+    for (auto it = results_.begin(); it != results_.end(); ++it)
+      (*it)->startTest(test);
+  }
+
+  /**
+   * @copydoc TestResult::endTest
+   */
+  inline void FanOutResult::endTest()
+  {
+    for (auto it = results_.begin(); it != results_.end(); ++it)
+      (*it)->endTest();
+  }
+
+  /**
+   * @copydoc TestResult::startTestFunction
+   */
+  inline void FanOutResult::startTestFunction(char const* function)
+  {
+    for (auto it = results_.begin(); it != results_.end(); ++it)
+      (*it)->startTestFunction(function);
+  }
+
+  /**
+   * @copydoc TestResult::endTestFunction
+   */
+  inline void FanOutResult::endTestFunction(Measurement const& measurement)
+  {
+    for (auto it = results_.begin(); it != results_.end(); ++it)
+      (*it)->endTestFunction(measurement);
+  }
+
+  /**
+   * @copydoc TestResult::checked
+   */
+  inline void FanOutResult::checked(char const* file, int line)
+  {
+    for (auto it = results_.begin(); it != results_.end(); ++it)
+      (*it)->checked(file, line);
+  }
+
+  /**
+   * @copydoc TestResult::failed
+   */
+  inline void FanOutResult::failed(char const* file, int line, char const* message)
+  {
+    for (auto it = results_.begin(); it != results_.end(); ++it)
+      (*it)->failed(file, line, message);
+  }
+}
+
+
+#endif
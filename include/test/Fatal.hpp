@@ -0,0 +1,147 @@
+// Fatal.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTFATAL_HPP
+#define TSTFATAL_HPP
+
+#include <csetjmp>
+#include <cstdlib>
+
+
+/** @cond never */
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+  #define TSTEXCEPTIONS 1
+#else
+  #define TSTEXCEPTIONS 0
+#endif
+
+#if !TSTEXCEPTIONS && !defined(TST_FATAL_RETURN) && !defined(TST_FATAL_LONGJMP)
+  #define TST_FATAL_LONGJMP
+#endif
+
+/*
+ * Replacements for try and catch that compile to never taken branches
+ * if exceptions are disabled.
+ */
+#if TSTEXCEPTIONS
+  #define TSTTRY try
+  #define TSTCATCH(exception_) catch(exception_)
+#else
+  #define TSTTRY if (true)
+  #define TSTCATCH(exception_) else if (false)
+#endif
+/** @endcond never */
+
+
+namespace tst
+{
+  /**
+   * Test framework exception used for signaling fatal assertion
+   * failures, i.e., ones that have to terminate the current test
+   * function.
+   */
+  struct FatalFailure
+  {
+  };
+
+
+  /**
+   * Fatal describes how a fatal assertion failure terminates the
+   * current test function. The mechanism is selected at compile time:
+   * - by default a FatalFailure exception is thrown
+   * - if TST_FATAL_RETURN is defined, the function containing the
+   *   assertion returns; fatal assertions can then only be used
+   *   directly in test functions (or other functions returning void)
+   * - if TST_FATAL_LONGJMP is defined, control jumps back into the
+   *   framework using longjmp; destructors of objects local to the
+   *   test function are not run in this case, so fatal assertions must
+   *   not skip over objects with non-trivial destructors
+   *
+   * Without exception support (e.g., -fno-exceptions) TST_FATAL_LONGJMP
+   * is the default. Either way set up and tear down functions are run
+   * and the failure is reported before the test function terminates.
+   * TESTTHROWS and TESTTHROWSANY do not compile without exceptions.
+   */
+  class Fatal
+  {
+  public:
+    static std::jmp_buf* exchange(std::jmp_buf* target);
+    [[noreturn]] static void jump();
+
+  private:
+    static std::jmp_buf*& target();
+  };
+
+
+  /** @cond never */
+#if defined(TST_FATAL_LONGJMP)
+  #define TSTFATAL()\
+    tst::Fatal::jump()
+#elif defined(TST_FATAL_RETURN)
+  #define TSTFATAL()\
+    return
+#else
+  #define TSTFATAL()\
+    throw tst::FatalFailure()
+#endif
+  /** @endcond never */
+}
+
+namespace tst
+{
+  /**
+   * Set the jump buffer that 'jump' returns to on the current thread.
+   * @param target jump buffer initialized by setjmp (may be null)
+   * @return the previously set jump buffer
+   */
+  inline std::jmp_buf* Fatal::exchange(std::jmp_buf* target)
+  {
+    std::jmp_buf* previous = Fatal::target();
+
+    Fatal::target() = target;
+    return previous;
+  }
+
+  /**
+   * Terminate the current test function by jumping back to the jump
+   * buffer set on the current thread. If there is none, the program is
+   * aborted.
+   */
+  inline void Fatal::jump()
+  {
+    std::jmp_buf* target = Fatal::target();
+
+    if (target == nullptr)
+      std::abort();
+
+    std::longjmp(*target, 1);
+  }
+
+  /**
+   * @return the jump buffer of the current thread
+   */
+  inline std::jmp_buf*& Fatal::target()
+  {
+    static thread_local std::jmp_buf* target = nullptr;
+    return target;
+  }
+}
+
+
+#endif
@@ -0,0 +1,274 @@
+// Filter.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTFILTER_HPP
+#define TSTFILTER_HPP
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "TestBase.hpp"
+#include "TestCaseBase.hpp"
+#include "TestVisitor.hpp"
+
+
+namespace tst
+{
+  /**
+   * A Filter restricts a test run to the test functions whose names
+   * match a list of patterns. Patterns are separated by commas and may
+   * contain the wildcards '*' (any sequence of characters) and '?' (any
+   * single character). A pattern containing "::" is matched against
+   * "<case>::<function>", any other pattern against the name of the
+   * case only. Patterns prefixed with '-' exclude matching functions.
+   *
+   * For example, "Parser*,-*::testSlow*" runs all functions of cases
+   * starting with "Parser", except for the ones starting with
+   * "testSlow".
+   */
+  class Filter
+  {
+  public:
+    Filter(char const* patterns = nullptr);
+
+    static Filter fromEnvironment();
+    static Filter fromArguments(int argc, char const* const* argv);
+
+    bool empty() const;
+    bool matches(char const* test, char const* function) const;
+
+    void apply(TestBase& test) const;
+
+  private:
+    struct Pattern
+    {
+      std::string text;
+      bool qualified;
+      bool negative;
+    };
+
+    typedef std::vector<Pattern> Patterns;
+
+    class Selector: public TestVisitor
+    {
+    public:
+      Selector(Filter const& filter);
+
+      virtual void visit(TestBase& test) override;
+      virtual void visit(TestCaseBase& test) override;
+
+    private:
+      Filter const* filter_;
+    };
+
+    Patterns patterns_;
+    bool positive_;
+
+    static bool match(char const* pattern, char const* string);
+  };
+}
+
+namespace tst
+{
+  /**
+   * @param patterns comma separated list of patterns (may be null, in
+   *        which case the filter matches everything)
+   */
+  inline Filter::Filter(char const* patterns)
+    : patterns_(),
+      positive_(false)
+  {
+    if (patterns == nullptr)
+      return;
+
+    while (*patterns != '\0')
+    {
+      char const* end = std::strchr(patterns, ',');
+
+      if (end == nullptr)
+        end = patterns + std::strlen(patterns);
+
+      Pattern pattern;
+      pattern.negative = *patterns == '-';
+      pattern.text.assign(patterns + (pattern.negative ? 1 : 0), end);
+      pattern.qualified = pattern.text.find("::") != std::string::npos;
+
+      if (!pattern.text.empty())
+      {
+        positive_ = positive_ || !pattern.negative;
+        patterns_.push_back(pattern);
+      }
+
+      patterns = *end == ',' ? end + 1 : end;
+    }
+  }
+
+  /**
+   * Create a filter from the environment variable TST_FILTER.
+   * @return the filter described by the environment or a filter
+   *         matching everything if the variable is not set
+   */
+  inline Filter Filter::fromEnvironment()
+  {
+    return Filter(std::getenv("TST_FILTER"));
+  }
+
+  /**
+   * Create a filter from a command line argument of the form
+   * "--filter=<patterns>". If no such argument is present, the
+   * environment is consulted as done by 'fromEnvironment'.
+   * @param argc number of arguments
+   * @param argv list of arguments, as passed to main
+   * @return the filter described by the command line
+   */
+  inline Filter Filter::fromArguments(int argc, char const* const* argv)
+  {
+    static char const prefix[] = "--filter=";
+
+    for (int i = 1; i < argc; ++i)
+    {
+      if (std::strncmp(argv[i], prefix, sizeof(prefix) - 1) == 0)
+        return Filter(argv[i] + sizeof(prefix) - 1);
+    }
+    return fromEnvironment();
+  }
+
+  /**
+   * @return true if the filter has no patterns and matches everything
+   */
+  inline bool Filter::empty() const
+  {
+    return patterns_.empty();
+  }
+
+  /**
+   * @param test name of a test case
+   * @param function name of a function of this case (may be null)
+   * @return true if the given function is to be run, false otherwise
+   */
+  inline bool Filter::matches(char const* test, char const* function) const
+  {
+    std::string name = test != nullptr ? test : "";
+    bool selected = !positive_;
+
+    name += "::";
+    name += function != nullptr ? function : "";
+
+    for (auto it = patterns_.begin(); it != patterns_.end(); ++it)
+    {
+      char const* string = it->qualified ? name.c_str() : (test != nullptr ? test : "");
+
+      if (!match(it->text.c_str(), string))
+        continue;
+
+      if (it->negative)
+        return false;
+
+      selected = true;
+    }
+    return selected;
+  }
+
+  /**
+   * Deselect all currently selected test functions that do not match
+   * the filter. Tests that do not expose their test functions cannot
+   * be matched and are deselected if the filter contains any positive
+   * pattern.
+   * @param test root of the tree of tests to apply the filter to
+   */
+  inline void Filter::apply(TestBase& test) const
+  {
+    if (patterns_.empty())
+      return;
+
+    Selector selector(*this);
+    test.accept(selector);
+  }
+
+  /**
+   * @param pattern pattern possibly containing the wildcards '*' and '?'
+   * @param string string to match against the pattern
+   * @return true if the string matches the pattern, false otherwise
+   */
+  inline bool Filter::match(char const* pattern, char const* string)
+  {
+    char const* star = nullptr;
+    char const* resume = nullptr;
+
+    while (*string != '\0')
+    {
+      if (*pattern == '*')
+      {
+        star = ++pattern;
+        resume = string;
+      }
+      else if (*pattern == '?' || *pattern == *string)
+      {
+        ++pattern;
+        ++string;
+      }
+      else if (star != nullptr)
+      {
+        pattern = star;
+        string = ++resume;
+      }
+      else
+        return false;
+    }
+
+    while (*pattern == '*')
+      ++pattern;
+
+    return *pattern == '\0';
+  }
+
+  /**
+   * @param filter filter to select tests with
+   */
+  inline Filter::Selector::Selector(Filter const& filter)
+    : filter_(&filter)
+  {
+  }
+
+  /**
+   * @copydoc TestVisitor::visit
+   */
+  inline void Filter::Selector::visit(TestBase& test)
+  {
+    if (filter_->positive_)
+      test.select(false);
+  }
+
+  /**
+   * @copydoc TestVisitor::visit
+   */
+  inline void Filter::Selector::visit(TestCaseBase& test)
+  {
+    for (unsigned int i = 0; i < test.functionCount(); ++i)
+    {
+      if (test.functionSelected(i) && !filter_->matches(test.name(), test.functionName(i)))
+        test.selectFunction(i, false);
+    }
+  }
+}
+
+
+#endif
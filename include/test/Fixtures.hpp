@@ -0,0 +1,271 @@
+// Fixtures.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+#ifndef TSTFIXTURES_HPP
+#define TSTFIXTURES_HPP
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Allocations.hpp"
+#include "TestSuite.hpp"
+
+
+namespace tst
+{
+  /**
+   * A SharedFixture is an object shared by several test functions (or
+   * cases) that is only constructed once it is first used. Expensive
+   * fixtures can be kept in one and are never built in runs not
+   * selecting any function using them, e.g., filtered runs.
+   *
+   * Construction is thread-safe, the first thread using the fixture
+   * builds it while others wait. The allocations made while doing so
+   * are not accounted to the test function triggering it, the time it
+   * takes is. Its lifetime is up to the user: a fixture can be reset in
+   * TestCaseBase::tearDownCase or TestSuite::tearDownSuite, or simply
+   * live until it is destroyed. Note that fixtures first used in the
+   * worker processes of a ForkRunner are built in each of them; ones
+   * used in TestSuite::setUpSuite are built once and inherited.
+   */
+  template<typename T>
+  class SharedFixture
+  {
+  public:
+    typedef std::function<std::unique_ptr<T>()> Factory;
+
+    SharedFixture();
+    explicit SharedFixture(Factory factory);
+
+    SharedFixture(SharedFixture&&) = delete;
+    SharedFixture(SharedFixture const&) = delete;
+
+    SharedFixture& operator =(SharedFixture&&) = delete;
+    SharedFixture& operator =(SharedFixture const&) = delete;
+
+    T& get();
+    T& operator *();
+    T* operator ->();
+
+    bool constructed() const;
+    void reset();
+
+  private:
+    Factory factory_;
+    std::mutex mutex_;
+    std::unique_ptr<T> object_;
+    /* Allows for lock-free access once the object exists. */
+    std::atomic<T*> pointer_;
+  };
+
+
+  /**
+   * Fixtures lets runners set up the suites containing the tests they
+   * run before running any of them, and tear them down afterwards. It
+   * is fed by the TestVisitor a runner uses to collect its units of
+   * work: suites are entered and left and each unit collected marks
+   * the suites it is contained in as used. Suites without any units
+   * are neither set up nor torn down.
+   */
+  class Fixtures
+  {
+  public:
+    Fixtures();
+
+    Fixtures(Fixtures&&) = delete;
+    Fixtures(Fixtures const&) = delete;
+
+    Fixtures& operator =(Fixtures&&) = delete;
+    Fixtures& operator =(Fixtures const&) = delete;
+
+    void enter(TestSuite& suite);
+    void leave(TestSuite& suite);
+    void use();
+
+    void setUp();
+    void tearDown();
+
+  private:
+    /* All suites entered, in the order they were entered in. */
+    std::vector<TestSuite*> suites_;
+    std::vector<char> used_;
+    /* Indices of the suites entered but not yet left. */
+    std::vector<std::size_t> open_;
+  };
+}
+
+namespace tst
+{
+  /**
+   * The default constructor creates a SharedFixture that default
+   * constructs its object.
+   */
+  template<typename T>
+  inline SharedFixture<T>::SharedFixture()
+    : SharedFixture([]() { return std::unique_ptr<T>(new T()); })
+  {
+  }
+
+  /**
+   * @param factory function creating the object when first used
+   */
+  template<typename T>
+  inline SharedFixture<T>::SharedFixture(Factory factory)
+    : factory_(std::move(factory)),
+      mutex_(),
+      object_(),
+      pointer_(nullptr)
+  {
+  }
+
+  /**
+   * @return the object, constructed if this has not happened yet
+   * @note If the factory throws, the exception is passed on and the
+   *       next use tries again.
+   */
+  template<typename T>
+  inline T& SharedFixture<T>::get()
+  {
+    T* pointer = pointer_.load(std::memory_order_acquire);
+
+    if (pointer != nullptr)
+      return *pointer;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (object_ == nullptr)
+    {
+      Allocations::Ignore ignore;
+
+      object_ = factory_();
+      pointer_.store(object_.get(), std::memory_order_release);
+    }
+    return *object_;
+  }
+
+  /**
+   * @copydoc SharedFixture::get
+   */
+  template<typename T>
+  inline T& SharedFixture<T>::operator *()
+  {
+    return get();
+  }
+
+  /**
+   * @copydoc SharedFixture::get
+   */
+  template<typename T>
+  inline T* SharedFixture<T>::operator ->()
+  {
+    return &get();
+  }
+
+  /**
+   * @return true if the object was constructed, false otherwise
+   */
+  template<typename T>
+  inline bool SharedFixture<T>::constructed() const
+  {
+    return pointer_.load(std::memory_order_acquire) != nullptr;
+  }
+
+  /**
+   * Destroy the object, if it was constructed. The next use constructs
+   * it anew. No other thread may use the fixture at the same time.
+   */
+  template<typename T>
+  inline void SharedFixture<T>::reset()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Allocations::Ignore ignore;
+
+    pointer_.store(nullptr, std::memory_order_release);
+    object_.reset();
+  }
+
+  /**
+   * The default constructor creates a Fixtures object knowing no
+   * suites.
+   */
+  inline Fixtures::Fixtures()
+    : suites_(),
+      used_(),
+      open_()
+  {
+  }
+
+  /**
+   * @param suite suite entered by the visitor
+   */
+  inline void Fixtures::enter(TestSuite& suite)
+  {
+    open_.push_back(suites_.size());
+    suites_.push_back(&suite);
+    used_.push_back(0);
+  }
+
+  /**
+   * @param suite suite left by the visitor
+   */
+  inline void Fixtures::leave(TestSuite& /*suite*/)
+  {
+    if (!open_.empty())
+      open_.pop_back();
+  }
+
+  /**
+   * Mark all suites currently entered as used.
+   */
+  inline void Fixtures::use()
+  {
+    // if a suite is used, so are all the ones containing it
+    for (auto it = open_.rbegin(); it != open_.rend() && used_[*it] == 0; ++it)
+      used_[*it] = 1;
+  }
+
+  /**
+   * Set up all suites used, outermost first.
+   */
+  inline void Fixtures::setUp()
+  {
+    for (std::size_t i = 0; i < suites_.size(); ++i)
+    {
+      if (used_[i] != 0)
+        suites_[i]->enter();
+    }
+  }
+
+  /**
+   * Tear down all suites used, in the reverse order of 'setUp'.
+   */
+  inline void Fixtures::tearDown()
+  {
+    for (std::size_t i = suites_.size(); i > 0; --i)
+    {
+      if (used_[i - 1] != 0)
+        suites_[i - 1]->leave();
+    }
+  }
+}
+
+
+#endif
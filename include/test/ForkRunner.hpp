@@ -0,0 +1,1379 @@
+// ForkRunner.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTFORKRUNNER_HPP
+#define TSTFORKRUNNER_HPP
+
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#if defined(__GLIBC__)
+#  include <execinfo.h>
+#  define TSTBACKTRACE
+#endif
+
+#include "Allocations.hpp"
+#include "Fatal.hpp"
+#include "Fixtures.hpp"
+#include "Measurement.hpp"
+#include "Schedule.hpp"
+#include "Sites.hpp"
+#include "TestBase.hpp"
+#include "TestCaseBase.hpp"
+#include "TestResult.hpp"
+#include "TestVisitor.hpp"
+#include "RecordingResult.hpp"
+
+
+namespace tst
+{
+  /**
+   * A ForkRunner runs a test (typically a TestSuite) in a set of worker
+   * processes. The test cases are dealt out to the workers round robin
+   * and each worker streams its results back to the parent over a
+   * pipe.
+   *
+   * If a worker dies while running a test function (because of a
+   * segmentation fault or an abort, for instance) the function is
+   * reported as failed and a new worker is started that continues
+   * with the next function. Like the ParallelRunner the results are
+   * reported to the given TestResult in the order a serial run would
+   * have produced them.
+   *
+   * The runner also enforces the timeouts of test functions (see
+   * TestCaseBase::setTimeout). A worker exceeding the time limit of its
+   * function is asked to send the stack of the thread running the
+   * function (where supported) and is killed afterwards. The function
+   * is reported as failed, including the elapsed time and the stack,
+   * and a new worker continues with the next function.
+   *
+   * With a Schedule the test cases are reported in the order it
+   * determines and dealt out to the least loaded worker, based on their
+   * expected duration. The run ends early if the result object asks for
+   * it (see FailFastResult), in which case the workers are killed.
+   *
+   * @note this runner is only available on POSIX systems
+   */
+  class ForkRunner
+  {
+  public:
+    explicit ForkRunner(unsigned int workers = 0,
+                        std::chrono::milliseconds timeout = std::chrono::milliseconds::zero());
+
+    ForkRunner(ForkRunner&&) = delete;
+    ForkRunner(ForkRunner const&) = delete;
+
+    ForkRunner& operator =(ForkRunner&&) = delete;
+    ForkRunner& operator =(ForkRunner const&) = delete;
+
+    void run(TestBase& test, TestResult& result);
+
+    unsigned int workers() const;
+    std::chrono::milliseconds timeout() const;
+
+    void setSchedule(Schedule const* schedule);
+
+  private:
+    struct Unit
+    {
+      TestBase* test;
+      TestCaseBase* testCase;
+    };
+
+    typedef std::vector<Unit> Units;
+
+    class Collector: public TestVisitor
+    {
+    public:
+      Collector(Units& units, Fixtures& fixtures);
+
+      virtual void visit(TestBase& test) override;
+      virtual void visit(TestCaseBase& test) override;
+
+      virtual void enter(TestSuite& suite) override;
+      virtual void leave(TestSuite& suite) override;
+
+    private:
+      Units* units_;
+      Fixtures* fixtures_;
+    };
+
+    enum Type
+    {
+      StartTest,
+      EndTest,
+      StartTestFunction,
+      EndTestFunction,
+      Checked,
+      Failed,
+      EndUnit,
+      SiteListed,
+      Stack,
+    };
+
+    /*
+     * The header of a message sent from a worker to the parent. The
+     * strings (if any) follow right after it, including their
+     * terminating null byte. A length of zero denotes a null string.
+     * The end of a test function carries the raw Measurement as first
+     * payload instead, and its start the point in time (as returned by
+     * 'wallTime') it started at as second one.
+     */
+    struct Message
+    {
+      unsigned int type;
+      unsigned int unit;
+      unsigned int function;
+      int line;
+      unsigned int count;
+      unsigned int first;
+      unsigned int second;
+    };
+
+    /*
+     * The result object used inside a worker process. It serializes all
+     * events into a buffer that is written to the pipe at least after
+     * each test function. The start of a test function is written out
+     * immediately, so that the parent knows which function a crashed
+     * worker was running, and so are failures, so that they survive a
+     * crash.
+     */
+    class PipeResult: public TestResult
+    {
+    public:
+      PipeResult(int fd);
+
+      virtual void startTest(char const* test) override;
+      virtual void endTest() override;
+
+      virtual void startTestFunction(char const* function) override;
+      virtual void endTestFunction(Measurement const& measurement) override;
+
+      virtual void checked(char const* file, int line) override;
+      virtual void failed(char const* file, int line, char const* message) override;
+
+      void setUnit(unsigned int unit);
+      void setFunction(unsigned int function);
+
+      void endUnit();
+      void sendSites();
+      void sendStack();
+      void flush();
+
+      static PipeResult*& current();
+
+    private:
+      int fd_;
+      unsigned int unit_;
+      unsigned int function_;
+      pthread_t thread_;
+
+      char const* checked_file_;
+      int checked_line_;
+      unsigned int checked_count_;
+
+      std::vector<char> buffer_;
+#ifdef TST_SITE_COUNTERS
+      /* The most recently listed site the parent knows about. */
+      Site* sites_sent_;
+#endif
+
+      void send(Type type, int line, unsigned int count, char const* first, char const* second);
+      void send(Message const& message, void const* first, void const* second);
+      void sendData(Type type, void const* data, unsigned int size);
+      void sendChecked();
+    };
+
+    struct Worker
+    {
+      pid_t pid;
+      int fd;
+
+      /* The units assigned to this worker, in the order they are run. */
+      std::vector<std::size_t> units;
+      /* The unit currently in progress (as index into 'units'). */
+      std::size_t next;
+      /* The next function to run in the current unit. */
+      unsigned int function;
+
+      bool test_open;
+      bool function_open;
+
+      /*
+       * The point in time (as returned by 'wallTime') at which the
+       * current function times out or, once it did, at which the
+       * process is killed; zero if there is no such point.
+       */
+      std::uint64_t deadline;
+      /* The point in time the current function started at. */
+      std::uint64_t started;
+      /* The time the current function ran for when it timed out. */
+      std::uint64_t elapsed;
+      bool expired;
+      /* The stack of the function that timed out, if received. */
+      std::string stack;
+
+      std::vector<char> input;
+    };
+
+    typedef std::vector<Worker> Workers;
+
+    unsigned int workers_;
+    std::chrono::milliseconds timeout_;
+    Schedule const* schedule_;
+
+    void arrange(Units& units, std::vector<double>& weights) const;
+
+    void spawn(Worker& worker, Workers& workers, Units const& units);
+    void finish(Worker& worker,
+                int status,
+                Units const& units,
+                std::vector<RecordingResult>& records,
+                std::vector<char>& done);
+    void abandon(Worker& worker,
+                 Units const& units,
+                 std::vector<RecordingResult>& records,
+                 std::vector<char>& done);
+    void parse(Worker& worker,
+               Units const& units,
+               std::set<std::string>& strings,
+               std::vector<RecordingResult>& records,
+               std::vector<char>& done);
+    int watch(Workers& workers) const;
+
+    static void work(Worker const& worker, Units const& units, int fd);
+    static bool writeAll(int fd, char const* data, std::size_t size);
+    static char const* intern(std::set<std::string>& strings, char const* string);
+    static std::string symbolize(void* const* frames, int count);
+    static void dump(int signal);
+  };
+}
+
+namespace tst
+{
+  /**
+   * @param workers number of worker processes to use; zero means one
+   *        per hardware thread
+   * @param timeout maximum time a test function may take unless its
+   *        test case specifies a timeout; zero means no limit
+   */
+  inline ForkRunner::ForkRunner(unsigned int workers, std::chrono::milliseconds timeout)
+    : workers_(workers),
+      timeout_(timeout),
+      schedule_(nullptr)
+  {
+    if (workers_ == 0)
+    {
+      long count = sysconf(_SC_NPROCESSORS_ONLN);
+      workers_ = count > 0 ? static_cast<unsigned int>(count) : 1;
+    }
+  }
+
+  /**
+   * Run the given test and report to the given result object.
+   * @param test test to run
+   * @param result result object to report to
+   */
+  inline void ForkRunner::run(TestBase& test, TestResult& result)
+  {
+    Units units;
+    Fixtures fixtures;
+    Collector collector(units, fixtures);
+    test.accept(collector);
+
+    if (units.empty())
+      return;
+
+    // suites are set up before forking, the workers inherit their state
+    fixtures.setUp();
+
+    std::vector<double> weights(units.size(), 1.0);
+    arrange(units, weights);
+
+    unsigned int count = workers_ < units.size() ? workers_ : units.size();
+
+    std::vector<RecordingResult> records(units.size());
+    std::vector<char> done(units.size(), 0);
+    std::set<std::string> strings;
+    std::vector<double> loads(count, 0.0);
+    Workers workers(count);
+
+    // hand each unit to the worker with the least load, or the fewest
+    // units in case of a tie; without a schedule all weights are equal,
+    // making this a round robin assignment
+    for (std::size_t i = 0; i < units.size(); ++i)
+    {
+      unsigned int least = 0;
+
+      for (unsigned int j = 1; j < count; ++j)
+      {
+        if (loads[j] < loads[least] ||
+            (loads[j] == loads[least] && workers[j].units.size() < workers[least].units.size()))
+          least = j;
+      }
+
+      loads[least] += weights[i];
+      workers[least].units.push_back(i);
+    }
+
+    for (auto it = workers.begin(); it != workers.end(); ++it)
+    {
+      it->pid = -1;
+      it->fd = -1;
+      it->next = 0;
+      it->function = 0;
+      it->test_open = false;
+      it->function_open = false;
+      it->deadline = 0;
+      it->started = 0;
+      it->elapsed = 0;
+      it->expired = false;
+
+      spawn(*it, workers, units);
+
+      if (it->fd < 0)
+        abandon(*it, units, records, done);
+    }
+
+    std::size_t replayed = 0;
+    std::vector<pollfd> fds;
+    std::vector<Worker*> polled;
+    bool stopped = false;
+
+    while (!stopped)
+    {
+      fds.clear();
+      polled.clear();
+
+      for (auto it = workers.begin(); it != workers.end(); ++it)
+      {
+        if (it->fd >= 0)
+        {
+          pollfd fd = {it->fd, POLLIN, 0};
+          fds.push_back(fd);
+          polled.push_back(&*it);
+        }
+      }
+
+      if (fds.empty())
+        break;
+
+      if (poll(fds.data(), fds.size(), watch(workers)) < 0)
+      {
+        if (errno == EINTR)
+          continue;
+        break;
+      }
+
+      for (std::size_t i = 0; i < fds.size(); ++i)
+      {
+        if (fds[i].revents == 0)
+          continue;
+
+        Worker& worker = *polled[i];
+        char buffer[65536];
+        ssize_t size = read(worker.fd, buffer, sizeof(buffer));
+
+        if (size < 0 && (errno == EINTR || errno == EAGAIN))
+          continue;
+
+        if (size > 0)
+        {
+          worker.input.insert(worker.input.end(), buffer, buffer + size);
+          parse(worker, units, strings, records, done);
+          continue;
+        }
+
+        // the worker closed its end of the pipe, i.e., it is done or
+        // it died
+        int status = 0;
+
+        close(worker.fd);
+        worker.fd = -1;
+
+        while (waitpid(worker.pid, &status, 0) < 0 && errno == EINTR)
+        {
+        }
+
+        finish(worker, status, units, records, done);
+
+        if (worker.next < worker.units.size())
+        {
+          spawn(worker, workers, units);
+
+          if (worker.fd < 0)
+            abandon(worker, units, records, done);
+        }
+      }
+
+      while (replayed < units.size() && done[replayed] != 0 && !stopped)
+      {
+        records[replayed].replay(result);
+        records[replayed].clear();
+        replayed++;
+
+        stopped = result.stopped();
+      }
+    }
+
+    if (stopped)
+    {
+      for (auto it = workers.begin(); it != workers.end(); ++it)
+      {
+        if (it->fd < 0)
+          continue;
+
+        kill(it->pid, SIGKILL);
+        close(it->fd);
+
+        while (waitpid(it->pid, nullptr, 0) < 0 && errno == EINTR)
+        {
+        }
+      }
+
+      fixtures.tearDown();
+      return;
+    }
+
+    for (; replayed < units.size(); ++replayed)
+      records[replayed].replay(result);
+
+    fixtures.tearDown();
+  }
+
+  /**
+   * @return number of worker processes used
+   */
+  inline unsigned int ForkRunner::workers() const
+  {
+    return workers_;
+  }
+
+  /**
+   * @return maximum time a test function may take unless its test case
+   *         specifies a timeout, or zero if there is no such limit
+   */
+  inline std::chrono::milliseconds ForkRunner::timeout() const
+  {
+    return timeout_;
+  }
+
+  /**
+   * Set the schedule determining the order in which test cases are
+   * reported and how they are distributed among the workers. Without a
+   * schedule they are dealt out round robin and reported in the order
+   * in which a serial run would run them.
+   * @param schedule schedule to use (may be null); it has to stay alive
+   *        as long as it is used
+   */
+  inline void ForkRunner::setSchedule(Schedule const* schedule)
+  {
+    schedule_ = schedule;
+  }
+
+  /**
+   * Reorder the units of work according to the schedule, if any.
+   * @param units list of units to reorder
+   * @param weights list of weights, one per unit, that receives the
+   *        expected durations of the reordered units
+   */
+  inline void ForkRunner::arrange(Units& units, std::vector<double>& weights) const
+  {
+    if (schedule_ == nullptr)
+      return;
+
+    std::vector<Schedule::Estimate> estimates;
+
+    for (auto it = units.begin(); it != units.end(); ++it)
+      estimates.push_back(schedule_->estimate(*it->test));
+
+    std::vector<std::size_t> order = schedule_->arrange(estimates);
+    Units arranged;
+
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+      arranged.push_back(units[order[i]]);
+      weights[i] = estimates[order[i]].seconds;
+    }
+
+    units.swap(arranged);
+  }
+
+  /**
+   * Start a new worker process that continues where the given worker
+   * left off.
+   * @param worker worker to start a process for
+   * @param workers list of all workers
+   * @param units list of all units
+   */
+  inline void ForkRunner::spawn(Worker& worker, Workers& workers, Units const& units)
+  {
+    int fds[2];
+
+    if (pipe(fds) != 0)
+      return;
+
+    // whatever is buffered now would otherwise be output by the child
+    // as well
+    std::fflush(nullptr);
+
+    pid_t pid = fork();
+
+    if (pid < 0)
+    {
+      close(fds[0]);
+      close(fds[1]);
+      return;
+    }
+
+    if (pid == 0)
+    {
+      close(fds[0]);
+
+      for (auto it = workers.begin(); it != workers.end(); ++it)
+      {
+        if (it->fd >= 0)
+          close(it->fd);
+      }
+
+      work(worker, units, fds[1]);
+      std::fflush(nullptr);
+      _exit(0);
+    }
+
+    close(fds[1]);
+
+    worker.pid = pid;
+    worker.fd = fds[0];
+    worker.deadline = 0;
+    worker.expired = false;
+    worker.stack.clear();
+    worker.input.clear();
+  }
+
+  /**
+   * Evaluate the termination of a worker process. If the process did
+   * not finish all its work, the unit it was working on is reported as
+   * failed.
+   * @param worker worker whose process terminated
+   * @param status status of the process as retrieved by 'waitpid'
+   * @param units list of all units
+   * @param records list of records, one per unit
+   * @param done list of flags indicating which unit is done
+   */
+  inline void ForkRunner::finish(Worker& worker,
+                                 int status,
+                                 Units const& units,
+                                 std::vector<RecordingResult>& records,
+                                 std::vector<char>& done)
+  {
+    if (worker.next >= worker.units.size())
+      return;
+
+    char message[128];
+
+    if (worker.expired)
+    {
+      unsigned long long elapsed = worker.elapsed / 1000000;
+      std::snprintf(message, sizeof(message), "Timed out after %llu ms", elapsed);
+    }
+    else if (WIFSIGNALED(status))
+    {
+      int signal = WTERMSIG(status);
+      std::snprintf(message, sizeof(message),
+                    "Terminated by signal %d (%s)", signal, strsignal(signal));
+    }
+    else
+      std::snprintf(message, sizeof(message),
+                    "Exited unexpectedly with status %d", WEXITSTATUS(status));
+
+    std::size_t index = worker.units[worker.next];
+    Unit const& unit = units[index];
+    RecordingResult& record = records[index];
+
+    // the process may have died before it got to start the test case,
+    // the failure must still be reported as part of it
+    if (!worker.test_open && unit.testCase != nullptr)
+    {
+      record.startTest(unit.testCase->name());
+      worker.test_open = true;
+    }
+
+    if (!worker.stack.empty())
+      record.failed(__FILE__, __LINE__, (std::string(message) + "; stack:\n" + worker.stack).c_str());
+    else
+      record.failed(__FILE__, __LINE__, message);
+
+    worker.deadline = 0;
+    worker.expired = false;
+    worker.stack.clear();
+
+    if (worker.function_open)
+    {
+      // the function ran until the process died
+      Measurement measurement = Measurement();
+      measurement.wall = wallTime() - worker.started;
+
+      record.endTestFunction(measurement);
+      worker.function_open = false;
+      worker.function++;
+
+      // continue with the next function of the test case, if any
+      if (unit.testCase != nullptr && worker.function < unit.testCase->functionCount())
+        return;
+    }
+
+    if (worker.test_open)
+      record.endTest();
+
+    done[index] = 1;
+
+    worker.next++;
+    worker.function = 0;
+    worker.test_open = false;
+  }
+
+  /**
+   * Report all units still assigned to a worker as failed, because no
+   * process could be started for it.
+   * @param worker worker to give up on
+   * @param units list of all units
+   * @param records list of records, one per unit
+   * @param done list of flags indicating which unit is done
+   */
+  inline void ForkRunner::abandon(Worker& worker,
+                                  Units const& units,
+                                  std::vector<RecordingResult>& records,
+                                  std::vector<char>& done)
+  {
+    for (; worker.next < worker.units.size(); ++worker.next)
+    {
+      std::size_t index = worker.units[worker.next];
+      Unit const& unit = units[index];
+      RecordingResult& record = records[index];
+
+      if (!worker.test_open && unit.testCase != nullptr)
+        record.startTest(unit.testCase->name());
+
+      record.failed(__FILE__, __LINE__, "Failed to start worker process");
+
+      if (worker.test_open || unit.testCase != nullptr)
+        record.endTest();
+
+      worker.test_open = false;
+      done[index] = 1;
+    }
+  }
+
+  /**
+   * Parse all complete messages received from a worker process.
+   * @param worker worker to parse the input of
+   * @param units list of all units
+   * @param strings set of strings to intern strings in
+   * @param records list of records, one per unit
+   * @param done list of flags indicating which unit is done
+   */
+  inline void ForkRunner::parse(Worker& worker,
+                                Units const& units,
+                                std::set<std::string>& strings,
+                                std::vector<RecordingResult>& records,
+                                std::vector<char>& done)
+  {
+    std::size_t offset = 0;
+
+    while (worker.input.size() - offset >= sizeof(Message))
+    {
+      Message message;
+      std::memcpy(&message, &worker.input[offset], sizeof(message));
+
+      std::size_t size = sizeof(message) + message.first + message.second;
+      if (worker.input.size() - offset < size)
+        break;
+
+      char const* first = message.first > 0 ? &worker.input[offset + sizeof(message)] : nullptr;
+      char const* second = message.second > 0 ? first + message.first : nullptr;
+      RecordingResult& record = records[message.unit];
+
+      switch (message.type)
+      {
+      case StartTest:
+        record.startTest(intern(strings, first));
+        worker.test_open = true;
+        break;
+
+      case EndTest:
+        record.endTest();
+        worker.test_open = false;
+        break;
+
+      case StartTestFunction:
+      {
+        record.startTestFunction(intern(strings, first));
+        worker.function = message.function;
+        worker.function_open = true;
+
+        TestCaseBase const* test = units[message.unit].testCase;
+        std::chrono::milliseconds timeout = std::chrono::milliseconds::zero();
+
+        if (test != nullptr)
+          timeout = test->functionTimeout(message.function);
+
+        if (timeout == std::chrono::milliseconds::zero())
+          timeout = timeout_;
+
+        // the parent may get to the message late, so the worker's clock,
+        // which is the same as ours, is used
+        worker.started = wallTime();
+
+        if (message.second == sizeof(worker.started))
+          std::memcpy(&worker.started, second, sizeof(worker.started));
+
+        worker.deadline = 0;
+
+        if (timeout > std::chrono::milliseconds::zero())
+          worker.deadline = worker.started + std::chrono::nanoseconds(timeout).count();
+        break;
+      }
+
+      case EndTestFunction:
+      {
+        Measurement measurement = Measurement();
+
+        if (message.first == sizeof(measurement))
+          std::memcpy(&measurement, first, sizeof(measurement));
+
+        record.endTestFunction(measurement);
+        worker.function = message.function + 1;
+        worker.function_open = false;
+
+        // the function may have finished just after it timed out, in
+        // which case the worker is spared
+        worker.deadline = 0;
+        worker.expired = false;
+        worker.stack.clear();
+        break;
+      }
+
+      case Checked:
+        record.checked(intern(strings, first), message.line, message.count);
+        break;
+
+      case Failed:
+        record.failed(first, message.line, second);
+        break;
+
+      case EndUnit:
+        done[message.unit] = 1;
+        worker.next++;
+        worker.function = 0;
+        worker.test_open = false;
+        break;
+
+      case SiteListed:
+      {
+        // workers are forked off this process, so their sites live at
+        // the same addresses as ours
+        Site* site;
+
+        if (message.first == sizeof(site))
+        {
+          std::memcpy(&site, first, sizeof(site));
+          Sites::list(*site);
+        }
+        break;
+      }
+
+      case Stack:
+      {
+        if (!worker.expired)
+          break;
+
+        void* frames[64];
+        int count = message.first / sizeof(frames[0]);
+
+        if (count > 64)
+          count = 64;
+
+        std::memcpy(frames, first, count * sizeof(frames[0]));
+        worker.stack = symbolize(frames, count);
+
+        // there is no point in waiting any longer
+        kill(worker.pid, SIGKILL);
+        worker.deadline = 0;
+        break;
+      }
+      }
+
+      offset += size;
+    }
+
+    worker.input.erase(worker.input.begin(), worker.input.begin() + offset);
+  }
+
+  /**
+   * Check the workers for test functions that timed out. A worker whose
+   * function just timed out is asked for its stack and given a second
+   * to send it, a worker whose grace period is over is killed.
+   * @param workers list of all workers
+   * @return time until the next deadline in milliseconds, suitable as
+   *         timeout for 'poll'; -1 if there is no deadline
+   */
+  inline int ForkRunner::watch(Workers& workers) const
+  {
+    std::uint64_t now = wallTime();
+    std::uint64_t next = 0;
+
+    for (auto it = workers.begin(); it != workers.end(); ++it)
+    {
+      if (it->fd < 0 || it->deadline == 0)
+        continue;
+
+      if (now >= it->deadline)
+      {
+        if (!it->expired)
+        {
+          it->expired = true;
+          it->elapsed = now - it->started;
+#ifdef TSTBACKTRACE
+          kill(it->pid, SIGQUIT);
+          it->deadline = now + 1000000000;
+#else
+          kill(it->pid, SIGKILL);
+          it->deadline = 0;
+#endif
+        }
+        else
+        {
+          kill(it->pid, SIGKILL);
+          it->deadline = 0;
+        }
+      }
+
+      if (it->deadline != 0 && (next == 0 || it->deadline < next))
+        next = it->deadline;
+    }
+
+    if (next == 0)
+      return -1;
+
+    // round up, so that we do not wake up right before the deadline
+    return static_cast<int>((next - now + 999999) / 1000000);
+  }
+
+  /**
+   * The main function of a worker process.
+   * @param worker worker describing the work to do
+   * @param units list of all units
+   * @param fd file descriptor of the pipe to the parent
+   */
+  inline void ForkRunner::work(Worker const& worker, Units const& units, int fd)
+  {
+    PipeResult result(fd);
+
+#ifdef TSTBACKTRACE
+    // the first call to 'backtrace' may allocate, which is not safe to
+    // do inside a signal handler
+    void* frame;
+    backtrace(&frame, 1);
+
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = &dump;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+
+    PipeResult::current() = &result;
+    sigaction(SIGQUIT, &action, nullptr);
+#endif
+
+    for (std::size_t i = worker.next; i < worker.units.size(); ++i)
+    {
+      std::size_t index = worker.units[i];
+      Unit const& unit = units[index];
+
+      result.setUnit(index);
+
+      if (unit.testCase != nullptr)
+      {
+        bool resume = i == worker.next;
+
+        if (!resume || !worker.test_open)
+          result.startTest(unit.testCase->name());
+
+        unsigned int count = unit.testCase->functionCount();
+
+        for (unsigned int j = resume ? worker.function : 0; j < count; ++j)
+        {
+          if (!unit.testCase->functionSelected(j))
+            continue;
+
+          result.setFunction(j);
+          unit.testCase->runFunction(result, j);
+        }
+
+        unit.testCase->leave();
+        result.endTest();
+      }
+      else
+      {
+        TSTTRY
+        {
+          unit.test->run(result);
+        }
+        TSTCATCH(...)
+        {
+          result.failed(__FILE__, __LINE__, "Unexpected exception");
+        }
+      }
+
+      result.endUnit();
+    }
+
+    result.flush();
+  }
+
+  /**
+   * @param fd file descriptor to write to
+   * @param data pointer to the data to write
+   * @param size number of bytes to write
+   * @return true if all data was written, false otherwise
+   */
+  inline bool ForkRunner::writeAll(int fd, char const* data, std::size_t size)
+  {
+    while (size > 0)
+    {
+      ssize_t written = write(fd, data, size);
+
+      if (written < 0)
+      {
+        if (errno == EINTR)
+          continue;
+        return false;
+      }
+
+      data += written;
+      size -= written;
+    }
+    return true;
+  }
+
+  /**
+   * @param strings set of strings to intern the string in
+   * @param string string to intern (may be null)
+   * @return pointer to a copy of the string that stays valid as long as
+   *         the set exists
+   */
+  inline char const* ForkRunner::intern(std::set<std::string>& strings, char const* string)
+  {
+    if (string == nullptr)
+      return nullptr;
+
+    return strings.insert(string).first->c_str();
+  }
+
+  /**
+   * @param frames list of return addresses of a stack
+   * @param count number of addresses in the list
+   * @return textual representation of the stack, one frame per line
+   */
+  inline std::string ForkRunner::symbolize(void* const* frames, int count)
+  {
+    std::string stack;
+
+#ifdef TSTBACKTRACE
+    char** symbols = backtrace_symbols(frames, count);
+
+    for (int i = 0; i < count; ++i)
+    {
+      char buffer[32];
+      std::snprintf(buffer, sizeof(buffer), "#%-2d ", i);
+
+      stack += buffer;
+
+      // workers are forked off this process, so the addresses of their
+      // code are ours
+      if (symbols != nullptr)
+        stack += symbols[i];
+      else
+      {
+        std::snprintf(buffer, sizeof(buffer), "%p", frames[i]);
+        stack += buffer;
+      }
+      stack += '\n';
+    }
+
+    std::free(symbols);
+#endif
+    return stack;
+  }
+
+  /**
+   * The handler for SIGQUIT in worker processes, sending the stack of
+   * the thread running the test function to the parent.
+   * @param signal number of the signal received
+   */
+  inline void ForkRunner::dump(int /*signal*/)
+  {
+    PipeResult* result = PipeResult::current();
+
+    if (result != nullptr)
+      result->sendStack();
+  }
+
+  /**
+   * @param units list of units to add collected units of work to
+   * @param fixtures fixtures to track the suites containing units in
+   */
+  inline ForkRunner::Collector::Collector(Units& units, Fixtures& fixtures)
+    : units_(&units),
+      fixtures_(&fixtures)
+  {
+  }
+
+  /**
+   * @copydoc TestVisitor::visit
+   */
+  inline void ForkRunner::Collector::visit(TestBase& test)
+  {
+    Unit unit = {&test, nullptr};
+    units_->push_back(unit);
+    fixtures_->use();
+  }
+
+  /**
+   * @copydoc TestVisitor::visit
+   */
+  inline void ForkRunner::Collector::visit(TestCaseBase& test)
+  {
+    if (test.functionCount() > 0 && test.selectedCount() == 0)
+      return;
+
+    Unit unit = {&test, &test};
+    units_->push_back(unit);
+    fixtures_->use();
+  }
+
+  /**
+   * @copydoc TestVisitor::enter
+   */
+  inline void ForkRunner::Collector::enter(TestSuite& suite)
+  {
+    fixtures_->enter(suite);
+  }
+
+  /**
+   * @copydoc TestVisitor::leave
+   */
+  inline void ForkRunner::Collector::leave(TestSuite& suite)
+  {
+    fixtures_->leave(suite);
+  }
+
+  /**
+   * @param fd file descriptor of the pipe to write to
+   */
+  inline ForkRunner::PipeResult::PipeResult(int fd)
+    : fd_(fd),
+      unit_(0),
+      function_(0),
+      thread_(pthread_self()),
+      checked_file_(nullptr),
+      checked_line_(0),
+      checked_count_(0),
+      buffer_()
+#ifdef TST_SITE_COUNTERS
+      // sites listed before the fork are listed in the parent already
+      , sites_sent_(Sites::executed())
+#endif
+  {
+  }
+
+  /**
+   * @copydoc TestResult::startTest
+   */
+  inline void ForkRunner::PipeResult::startTest(char const* test)
+  {
+    send(StartTest, 0, 0, test, nullptr);
+  }
+
+  /**
+   * @copydoc TestResult::endTest
+   */
+  inline void ForkRunner::PipeResult::endTest()
+  {
+    send(EndTest, 0, 0, nullptr, nullptr);
+  }
+
+  /**
+   * @copydoc TestResult::startTestFunction
+   */
+  inline void ForkRunner::PipeResult::startTestFunction(char const* function)
+  {
+    if (checked_count_ > 0)
+      sendChecked();
+
+    std::uint64_t started = wallTime();
+    unsigned int size = function != nullptr ? std::strlen(function) + 1 : 0;
+    Message message = {
+      static_cast<unsigned int>(StartTestFunction), unit_, function_, 0, 0, size, sizeof(started)
+    };
+
+    send(message, function, &started);
+    flush();
+  }
+
+  /**
+   * @copydoc TestResult::endTestFunction
+   */
+  inline void ForkRunner::PipeResult::endTestFunction(Measurement const& measurement)
+  {
+    sendData(EndTestFunction, &measurement, sizeof(measurement));
+    // so that a crash in a later function loses no sites
+    sendSites();
+    flush();
+  }
+
+  /**
+   * @copydoc TestResult::checked
+   */
+  inline void ForkRunner::PipeResult::checked(char const* file, int line)
+  {
+    if (checked_count_ > 0 && (checked_file_ != file || checked_line_ != line))
+      sendChecked();
+
+    checked_file_ = file;
+    checked_line_ = line;
+    checked_count_++;
+  }
+
+  /**
+   * @copydoc TestResult::failed
+   */
+  inline void ForkRunner::PipeResult::failed(char const* file, int line, char const* message)
+  {
+    send(Failed, line, 0, file, message);
+    // failures are rare, but must not get lost in a crash that follows
+    flush();
+  }
+
+  /**
+   * @param unit index of the unit that events are reported for
+   */
+  inline void ForkRunner::PipeResult::setUnit(unsigned int unit)
+  {
+    unit_ = unit;
+  }
+
+  /**
+   * @param function index of the function that is run next
+   */
+  inline void ForkRunner::PipeResult::setFunction(unsigned int function)
+  {
+    function_ = function;
+  }
+
+  /**
+   * Signal that all work on the current unit is done.
+   */
+  inline void ForkRunner::PipeResult::endUnit()
+  {
+    send(EndUnit, 0, 0, nullptr, nullptr);
+    sendSites();
+    flush();
+  }
+
+  /**
+   * Send the assertion sites listed in this process since the last call.
+   * Assertion counts travel as part of each function's Measurement.
+   * @see Sites
+   */
+  inline void ForkRunner::PipeResult::sendSites()
+  {
+#ifdef TST_SITE_COUNTERS
+    Site* head = Sites::executed();
+
+    // sites are prepended to the list, the new ones come first
+    for (Site* site = head; site != sites_sent_; site = site->next)
+      sendData(SiteListed, &site, sizeof(site));
+
+    sites_sent_ = head;
+#endif
+  }
+
+  /**
+   * Send the stack of the thread that created this object, i.e., the
+   * one running the test functions, bypassing the buffer. If called on
+   * a different thread the request is forwarded to the right one.
+   * @note this method is async-signal-safe once 'backtrace' was called
+   *       at least once
+   */
+  inline void ForkRunner::PipeResult::sendStack()
+  {
+#ifdef TSTBACKTRACE
+    if (!pthread_equal(pthread_self(), thread_))
+    {
+      pthread_kill(thread_, SIGQUIT);
+      return;
+    }
+
+    void* frames[64];
+    int count = backtrace(frames, 64);
+    unsigned int size = count * sizeof(frames[0]);
+
+    Message message = {static_cast<unsigned int>(Stack), unit_, function_, 0, 0, size, 0};
+    char data[sizeof(message) + sizeof(frames)];
+
+    // a single write of less than PIPE_BUF bytes is atomic, so the
+    // message cannot be torn apart
+    std::memcpy(data, &message, sizeof(message));
+    std::memcpy(data + sizeof(message), frames, size);
+    writeAll(fd_, data, sizeof(message) + size);
+#endif
+  }
+
+  /**
+   * @return the result object of this worker process, if any
+   */
+  inline ForkRunner::PipeResult*& ForkRunner::PipeResult::current()
+  {
+    static PipeResult* result = nullptr;
+    return result;
+  }
+
+  /**
+   * Write all buffered events to the pipe.
+   */
+  inline void ForkRunner::PipeResult::flush()
+  {
+    if (checked_count_ > 0)
+      sendChecked();
+
+#ifdef TSTBACKTRACE
+    // 'sendStack' writes to the pipe directly from the SIGQUIT handler;
+    // it must not do so in the middle of the buffer, so the signal is
+    // held back until the buffer is written completely
+    sigset_t quit;
+    sigset_t previous;
+    sigemptyset(&quit);
+    sigaddset(&quit, SIGQUIT);
+    pthread_sigmask(SIG_BLOCK, &quit, &previous);
+#endif
+
+    bool written = writeAll(fd_, buffer_.data(), buffer_.size());
+
+#ifdef TSTBACKTRACE
+    pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+#endif
+
+    if (!written)
+      _exit(1);
+
+    buffer_.clear();
+  }
+
+  /**
+   * Serialize a message into the buffer.
+   */
+  inline void ForkRunner::PipeResult::send(Type type,
+                                           int line,
+                                           unsigned int count,
+                                           char const* first,
+                                           char const* second)
+  {
+    if (type != Checked && checked_count_ > 0)
+      sendChecked();
+
+    unsigned int first_size = first != nullptr ? std::strlen(first) + 1 : 0;
+    unsigned int second_size = second != nullptr ? std::strlen(second) + 1 : 0;
+
+    Message message = {
+      static_cast<unsigned int>(type), unit_, function_, line, count, first_size, second_size
+    };
+
+    send(message, first, second);
+  }
+
+  /**
+   * Serialize a message into the buffer, along with its payloads, whose
+   * sizes it contains.
+   */
+  inline void ForkRunner::PipeResult::send(Message const& message, void const* first, void const* second)
+  {
+    Allocations::Ignore ignore;
+
+    char const* data = reinterpret_cast<char const*>(&message);
+    char const* first_data = static_cast<char const*>(first);
+    char const* second_data = static_cast<char const*>(second);
+
+    buffer_.insert(buffer_.end(), data, data + sizeof(message));
+    buffer_.insert(buffer_.end(), first_data, first_data + message.first);
+    buffer_.insert(buffer_.end(), second_data, second_data + message.second);
+
+    if (buffer_.size() >= 65536)
+      flush();
+  }
+
+  /**
+   * Serialize a message carrying a binary payload into the buffer.
+   */
+  inline void ForkRunner::PipeResult::sendData(Type type, void const* data, unsigned int size)
+  {
+    Allocations::Ignore ignore;
+
+    if (checked_count_ > 0)
+      sendChecked();
+
+    Message message = {static_cast<unsigned int>(type), unit_, function_, 0, 0, size, 0};
+
+    char const* header = reinterpret_cast<char const*>(&message);
+    char const* payload = static_cast<char const*>(data);
+
+    buffer_.insert(buffer_.end(), header, header + sizeof(message));
+    buffer_.insert(buffer_.end(), payload, payload + size);
+  }
+
+  /**
+   * Serialize the pending assertion checks into the buffer.
+   */
+  inline void ForkRunner::PipeResult::sendChecked()
+  {
+    unsigned int count = checked_count_;
+
+    checked_count_ = 0;
+    send(Checked, checked_line_, count, checked_file_, nullptr);
+  }
+}
+
+
+#endif
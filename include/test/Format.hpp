@@ -0,0 +1,254 @@
+// Format.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTFORMAT_HPP
+#define TSTFORMAT_HPP
+
+#include <cstdint>
+#include <iterator>
+
+#include "Measurement.hpp"
+
+
+namespace tst
+{
+  template<typename T>
+  void printTime(T& printer, double nanoseconds);
+
+  template<typename T>
+  void printFixed(T& printer, std::uint64_t value, std::uint64_t scale);
+
+  template<typename T>
+  void printEvents(T& printer, PerfCounts const& events, std::uint64_t iterations = 1);
+
+  template<typename T>
+  void printJson(T& printer, char const* string);
+
+  template<typename T>
+  void printXml(T& printer, char const* string);
+}
+
+namespace tst
+{
+  /**
+   * Print a time with a suitable unit and two decimal places. The
+   * printer only has to support printing of integers, characters, and
+   * strings.
+   * @param printer stream to print to
+   * @param nanoseconds time to print, in nanoseconds
+   */
+  template<typename T>
+  void printTime(T& printer, double nanoseconds)
+  {
+    static char const* const units[] = {"ns", "us", "ms", "s"};
+    unsigned int unit = 0;
+
+    while (nanoseconds >= 1000.0 && unit < 3)
+    {
+      nanoseconds /= 1000.0;
+      unit++;
+    }
+
+    long hundredths = static_cast<long>(nanoseconds * 100.0 + 0.5);
+    long fraction = hundredths % 100;
+
+    printer << hundredths / 100 << '.' << (fraction < 10 ? "0" : "") << fraction
+            << ' ' << units[unit];
+  }
+
+  /**
+   * Print a fixed point number as a decimal fraction with all its
+   * places, e.g., a value of 1500 with a scale of 1000 as "1.500".
+   * @param printer stream to print to
+   * @param value value to print, in units of 1/scale
+   * @param scale power of ten the value is scaled by
+   */
+  template<typename T>
+  void printFixed(T& printer, std::uint64_t value, std::uint64_t scale)
+  {
+    printer << static_cast<unsigned long long>(value / scale);
+
+    if (scale > 1)
+    {
+      printer << '.';
+
+      for (std::uint64_t place = scale / 10; place > 0; place /= 10)
+        printer << static_cast<char>('0' + value / place % 10);
+    }
+  }
+
+  /**
+   * Print all event counts that are not zero as a comma separated list,
+   * e.g., "1200 cycles, 2400 instructions".
+   * @param printer stream to print to
+   * @param events event counts to print
+   * @param iterations number of iterations the counts are to be
+   *        divided by; with more than one, two decimal places are
+   *        printed
+   */
+  template<typename T>
+  void printEvents(T& printer, PerfCounts const& events, std::uint64_t iterations)
+  {
+    struct
+    {
+      std::uint64_t count;
+      char const* name;
+    } const counts[] = {
+      {events.cycles, " cycles"},
+      {events.instructions, " instructions"},
+      {events.branch_misses, " branch misses"},
+      {events.l1d_misses, " L1d misses"},
+      {events.llc_misses, " LLC misses"},
+      {events.context_switches, " context switches"},
+      {events.page_faults, " page faults"},
+    };
+    char const* separator = "";
+
+    for (auto it = std::begin(counts); it != std::end(counts); ++it)
+    {
+      if (it->count == 0)
+        continue;
+
+      printer << separator;
+
+      if (iterations > 1)
+        printFixed(printer, it->count * 100 / iterations, 100);
+      else
+        printer << static_cast<unsigned long long>(it->count);
+
+      printer << it->name;
+      separator = ", ";
+    }
+  }
+
+  /**
+   * Print a string as a JSON string literal, including the surrounding
+   * quotes. The string is assumed to be UTF-8 encoded. The result is a
+   * valid double quoted YAML scalar as well.
+   * @param printer stream to print to
+   * @param string string to print; null is printed as JSON null
+   */
+  template<typename T>
+  void printJson(T& printer, char const* string)
+  {
+    static char const digits[] = "0123456789abcdef";
+
+    if (string == nullptr)
+    {
+      printer << "null";
+      return;
+    }
+
+    printer << '"';
+
+    for (; *string != '\0'; ++string)
+    {
+      unsigned char c = static_cast<unsigned char>(*string);
+
+      switch (c)
+      {
+      case '"':
+        printer << "\\\"";
+        break;
+
+      case '\\':
+        printer << "\\\\";
+        break;
+
+      case '\n':
+        printer << "\\n";
+        break;
+
+      case '\r':
+        printer << "\\r";
+        break;
+
+      case '\t':
+        printer << "\\t";
+        break;
+
+      default:
+        if (c < 0x20)
+          printer << "\\u00" << digits[c >> 4] << digits[c & 0xf];
+        else
+          printer << *string;
+        break;
+      }
+    }
+
+    printer << '"';
+  }
+
+  /**
+   * Print a string with all characters that are special in XML text and
+   * attribute values replaced by entities. Whitespace other than blanks
+   * is written as character references, so that it survives attribute
+   * value normalization, and control characters that are not allowed in
+   * XML 1.0 are replaced by '?'.
+   * @param printer stream to print to
+   * @param string string to print (may be null)
+   */
+  template<typename T>
+  void printXml(T& printer, char const* string)
+  {
+    if (string == nullptr)
+      return;
+
+    for (; *string != '\0'; ++string)
+    {
+      unsigned char c = static_cast<unsigned char>(*string);
+
+      switch (c)
+      {
+      case '&':
+        printer << "&amp;";
+        break;
+
+      case '<':
+        printer << "&lt;";
+        break;
+
+      case '>':
+        printer << "&gt;";
+        break;
+
+      case '"':
+        printer << "&quot;";
+        break;
+
+      case '\'':
+        printer << "&apos;";
+        break;
+
+      case '\t':
+      case '\n':
+      case '\r':
+        printer << "&#" << static_cast<int>(c) << ';';
+        break;
+
+      default:
+        printer << (c < 0x20 ? '?' : *string);
+        break;
+      }
+    }
+  }
+}
+
+
+#endif
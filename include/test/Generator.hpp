@@ -0,0 +1,564 @@
+// Generator.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+#ifndef TSTGENERATOR_HPP
+#define TSTGENERATOR_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace tst
+{
+  /**
+   * A fast pseudo random number generator (xoshiro256**) meeting the
+   * requirements of a uniform random bit generator, so that it can be
+   * used with the distributions of the standard library. Seeding it is
+   * cheap, which allows for seeding one per generated value.
+   */
+  class Random
+  {
+  public:
+    typedef std::uint64_t result_type;
+
+    explicit Random(std::uint64_t seed);
+
+    result_type operator ()();
+
+    static constexpr result_type min()
+    {
+      return 0;
+    }
+
+    static constexpr result_type max()
+    {
+      return std::numeric_limits<result_type>::max();
+    }
+
+    static std::uint64_t mix(std::uint64_t value);
+
+  private:
+    std::uint64_t state_[4];
+  };
+
+
+  /**
+   * A Generator produces random values of type T for property tests
+   * (see Property), knows how to shrink a value, i.e., which simpler
+   * values to try instead of one for which a property does not hold,
+   * and how to print a value.
+   *
+   * Besides a source of randomness, generating takes a size between
+   * zero and 100, which grows over the course of a property test: the
+   * first values are small and simple, later ones get larger.
+   * Generators can be composed, e.g., vectors(pairs(integers<int>(),
+   * strings())) generates lists of pairs.
+   */
+  template<typename T>
+  class Generator
+  {
+  public:
+    typedef T Value;
+    typedef std::function<T(Random&, unsigned int)> Generate;
+    typedef std::function<std::vector<T>(T const&)> Shrink;
+    typedef std::function<std::string(T const&)> Print;
+
+    Generator(Generate generate, Shrink shrink, Print print);
+
+    T operator ()(Random& random, unsigned int size) const;
+    std::vector<T> shrink(T const& value) const;
+    std::string print(T const& value) const;
+
+  private:
+    Generate generate_;
+    Shrink shrink_;
+    Print print_;
+  };
+
+
+  template<typename T>
+  Generator<T> integers(T min = std::numeric_limits<T>::min(),
+                        T max = std::numeric_limits<T>::max());
+
+  template<typename T>
+  Generator<T> floats(T min = -1e6, T max = 1e6);
+
+  Generator<std::string> strings(std::size_t length = 32,
+                                 std::string alphabet = std::string());
+
+  template<typename T>
+  Generator<std::vector<T>> vectors(Generator<T> const& element, std::size_t length = 32);
+
+  template<typename A, typename B>
+  Generator<std::pair<A, B>> pairs(Generator<A> const& first, Generator<B> const& second);
+}
+
+namespace tst
+{
+  /**
+   * @param seed value to derive the generator's state from
+   */
+  inline Random::Random(std::uint64_t seed)
+  {
+    // the state is filled using splitmix64, as recommended by the
+    // authors of xoshiro
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+      seed += 0x9e3779b97f4a7c15ull;
+      state_[i] = mix(seed);
+    }
+  }
+
+  /**
+   * @return the next random number
+   */
+  inline Random::result_type Random::operator ()()
+  {
+    std::uint64_t result = state_[1] * 5;
+    result = ((result << 7) | (result >> 57)) * 9;
+
+    std::uint64_t t = state_[1] << 17;
+
+    state_[2] ^= state_[0];
+    state_[3] ^= state_[1];
+    state_[1] ^= state_[2];
+    state_[0] ^= state_[3];
+    state_[2] ^= t;
+    state_[3] = (state_[3] << 45) | (state_[3] >> 19);
+
+    return result;
+  }
+
+  /**
+   * @param value value to scramble
+   * @return a scrambled version of the value (the finalizer of
+   *         splitmix64), suitable for deriving seeds from indices
+   */
+  inline std::uint64_t Random::mix(std::uint64_t value)
+  {
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+    return value ^ (value >> 31);
+  }
+
+  /**
+   * @param generate function generating a value
+   * @param shrink function returning simpler candidates for a value,
+   *        most promising first (may be null if values cannot shrink)
+   * @param print function printing a value
+   */
+  template<typename T>
+  inline Generator<T>::Generator(Generate generate, Shrink shrink, Print print)
+    : generate_(std::move(generate)),
+      shrink_(std::move(shrink)),
+      print_(std::move(print))
+  {
+  }
+
+  /**
+   * @param random source of randomness
+   * @param size size of the value to generate, between 0 and 100
+   * @return a newly generated value
+   */
+  template<typename T>
+  inline T Generator<T>::operator ()(Random& random, unsigned int size) const
+  {
+    return generate_(random, size);
+  }
+
+  /**
+   * @param value value to shrink
+   * @return list of simpler values, most promising first
+   */
+  template<typename T>
+  inline std::vector<T> Generator<T>::shrink(T const& value) const
+  {
+    return shrink_ ? shrink_(value) : std::vector<T>();
+  }
+
+  /**
+   * @param value value to print
+   * @return textual representation of the value
+   */
+  template<typename T>
+  inline std::string Generator<T>::print(T const& value) const
+  {
+    return print_ ? print_(value) : std::string("?");
+  }
+
+  /**
+   * Create a generator for integers in a given range. Values close to
+   * zero and the bounds of the range are generated more often than
+   * others, as that is where bugs tend to lurk. Values shrink towards
+   * zero, or the bound closest to it.
+   * @param min smallest value to generate
+   * @param max largest value to generate
+   * @return the generator
+   */
+  template<typename T>
+  inline Generator<T> integers(T min, T max)
+  {
+    static_assert(std::is_integral<T>::value, "integers requires an integral type");
+
+    // the distributions are not defined for character types
+    typedef typename std::conditional<std::is_signed<T>::value, long long, unsigned long long>::type Wide;
+
+    T target = min > 0 ? min : (max < 0 ? max : 0);
+
+    auto generate = [min, max, target](Random& random, unsigned int size) -> T
+    {
+      switch (random() % 8)
+      {
+      case 0:
+        return min;
+      case 1:
+        return max;
+      case 2:
+      case 3:
+      {
+        // a small value around the target; distances are computed
+        // unsigned, which cannot overflow
+        unsigned long long below = static_cast<unsigned long long>(target) - static_cast<unsigned long long>(min);
+        unsigned long long above = static_cast<unsigned long long>(max) - static_cast<unsigned long long>(target);
+        T lower = static_cast<T>(static_cast<unsigned long long>(target) - std::min<unsigned long long>(size, below));
+        T upper = static_cast<T>(static_cast<unsigned long long>(target) + std::min<unsigned long long>(size, above));
+        return static_cast<T>(std::uniform_int_distribution<Wide>(lower, upper)(random));
+      }
+      default:
+        return static_cast<T>(std::uniform_int_distribution<Wide>(min, max)(random));
+      }
+    };
+
+    auto shrink = [target](T const& value) -> std::vector<T>
+    {
+      std::vector<T> candidates;
+
+      if (value == target)
+        return candidates;
+
+      candidates.push_back(target);
+
+      // halve the distance to the target, computed without overflowing
+      unsigned long long distance = value > target
+        ? static_cast<unsigned long long>(value) - static_cast<unsigned long long>(target)
+        : static_cast<unsigned long long>(target) - static_cast<unsigned long long>(value);
+
+      for (unsigned long long step = distance / 2; step > 0; step /= 2)
+      {
+        unsigned long long candidate = value > target
+          ? static_cast<unsigned long long>(value) - step
+          : static_cast<unsigned long long>(value) + step;
+        candidates.push_back(static_cast<T>(candidate));
+      }
+
+      if (distance > 1)
+        candidates.push_back(value > target ? static_cast<T>(value - 1) : static_cast<T>(value + 1));
+
+      return candidates;
+    };
+
+    auto print = [](T const& value) -> std::string
+    {
+      return std::to_string(static_cast<Wide>(value));
+    };
+
+    return Generator<T>(generate, shrink, print);
+  }
+
+  /**
+   * Create a generator for floating point numbers in a given range.
+   * Zero, the bounds, and values of small magnitude are generated more
+   * often than others. Values shrink towards zero (or the bound closest
+   * to it) and towards integral values.
+   * @param min smallest value to generate
+   * @param max largest value to generate
+   * @return the generator
+   */
+  template<typename T>
+  inline Generator<T> floats(T min, T max)
+  {
+    static_assert(std::is_floating_point<T>::value, "floats requires a floating point type");
+
+    T target = min > 0 ? min : (max < 0 ? max : 0);
+
+    auto generate = [min, max, target](Random& random, unsigned int size) -> T
+    {
+      switch (random() % 8)
+      {
+      case 0:
+        return min;
+      case 1:
+        return max;
+      case 2:
+        return target;
+      case 3:
+      {
+        T lower = std::max(min, target - static_cast<T>(size));
+        T upper = std::min(max, target + static_cast<T>(size));
+        return std::uniform_real_distribution<T>(lower, upper)(random);
+      }
+      default:
+        return std::uniform_real_distribution<T>(min, max)(random);
+      }
+    };
+
+    auto shrink = [min, max, target](T const& value) -> std::vector<T>
+    {
+      std::vector<T> candidates;
+
+      if (value == target || std::isnan(value))
+        return candidates;
+
+      candidates.push_back(target);
+
+      T integral = std::trunc(value);
+
+      if (integral != value && integral >= min && integral <= max)
+        candidates.push_back(integral);
+
+      T half = target + (value - target) / 2;
+
+      if (half != value && half != target)
+        candidates.push_back(half);
+
+      return candidates;
+    };
+
+    auto print = [](T const& value) -> std::string
+    {
+      char buffer[64];
+      std::snprintf(buffer, sizeof(buffer), "%.17g", static_cast<double>(value));
+      return buffer;
+    };
+
+    return Generator<T>(generate, shrink, print);
+  }
+
+  /**
+   * Create a generator for strings. Strings shrink by dropping
+   * characters and replacing them with the first one of the alphabet.
+   * @param length maximum length of the strings to generate
+   * @param alphabet characters to choose from; all printable ASCII
+   *        characters if empty
+   * @return the generator
+   */
+  inline Generator<std::string> strings(std::size_t length, std::string alphabet)
+  {
+    if (alphabet.empty())
+    {
+      for (char c = ' '; c <= '~'; ++c)
+        alphabet += c;
+    }
+
+    auto generate = [length, alphabet](Random& random, unsigned int size) -> std::string
+    {
+      std::size_t limit = length * size / 100;
+      std::size_t count = random() % (limit + 1);
+      std::string string;
+
+      string.reserve(count);
+
+      for (std::size_t i = 0; i < count; ++i)
+        string += alphabet[random() % alphabet.size()];
+
+      return string;
+    };
+
+    auto shrink = [alphabet](std::string const& value) -> std::vector<std::string>
+    {
+      std::vector<std::string> candidates;
+
+      if (value.empty())
+        return candidates;
+
+      candidates.push_back(std::string());
+
+      if (value.size() > 1)
+      {
+        candidates.push_back(value.substr(0, value.size() / 2));
+        candidates.push_back(value.substr(value.size() / 2));
+      }
+
+      for (std::size_t i = 0; i < value.size(); ++i)
+        candidates.push_back(value.substr(0, i) + value.substr(i + 1));
+
+      for (std::size_t i = 0; i < value.size(); ++i)
+      {
+        if (value[i] != alphabet[0])
+        {
+          candidates.push_back(value);
+          candidates.back()[i] = alphabet[0];
+        }
+      }
+      return candidates;
+    };
+
+    auto print = [](std::string const& value) -> std::string
+    {
+      std::string string = "\"";
+
+      for (auto it = value.begin(); it != value.end(); ++it)
+      {
+        unsigned char c = static_cast<unsigned char>(*it);
+
+        if (c == '"' || c == '\\')
+        {
+          string += '\\';
+          string += *it;
+        }
+        else if (c < ' ' || c > '~')
+        {
+          char buffer[8];
+          std::snprintf(buffer, sizeof(buffer), "\\x%02x", c);
+          string += buffer;
+        }
+        else
+          string += *it;
+      }
+      return string + '"';
+    };
+
+    return Generator<std::string>(generate, shrink, print);
+  }
+
+  /**
+   * Create a generator for lists of values. Lists shrink by dropping
+   * elements and by shrinking individual elements.
+   * @param element generator for the elements
+   * @param length maximum length of the lists to generate
+   * @return the generator
+   */
+  template<typename T>
+  inline Generator<std::vector<T>> vectors(Generator<T> const& element, std::size_t length)
+  {
+    typedef std::vector<T> Vector;
+
+    auto generate = [element, length](Random& random, unsigned int size) -> Vector
+    {
+      std::size_t limit = length * size / 100;
+      std::size_t count = random() % (limit + 1);
+      Vector vector;
+
+      vector.reserve(count);
+
+      for (std::size_t i = 0; i < count; ++i)
+        vector.push_back(element(random, size));
+
+      return vector;
+    };
+
+    auto shrink = [element](Vector const& value) -> std::vector<Vector>
+    {
+      std::vector<Vector> candidates;
+
+      if (value.empty())
+        return candidates;
+
+      candidates.push_back(Vector());
+
+      if (value.size() > 1)
+      {
+        candidates.push_back(Vector(value.begin(), value.begin() + value.size() / 2));
+        candidates.push_back(Vector(value.begin() + value.size() / 2, value.end()));
+      }
+
+      for (std::size_t i = 0; i < value.size(); ++i)
+      {
+        candidates.push_back(value);
+        candidates.back().erase(candidates.back().begin() + i);
+      }
+
+      for (std::size_t i = 0; i < value.size(); ++i)
+      {
+        std::vector<T> simpler = element.shrink(value[i]);
+
+        for (auto it = simpler.begin(); it != simpler.end(); ++it)
+        {
+          candidates.push_back(value);
+          candidates.back()[i] = *it;
+        }
+      }
+      return candidates;
+    };
+
+    auto print = [element](Vector const& value) -> std::string
+    {
+      std::string string = "[";
+
+      for (std::size_t i = 0; i < value.size(); ++i)
+        string += (i > 0 ? ", " : "") + element.print(value[i]);
+
+      return string + "]";
+    };
+
+    return Generator<Vector>(generate, shrink, print);
+  }
+
+  /**
+   * Create a generator for pairs of values. Pairs shrink by shrinking
+   * either of their values.
+   * @param first generator for the first values
+   * @param second generator for the second values
+   * @return the generator
+   */
+  template<typename A, typename B>
+  inline Generator<std::pair<A, B>> pairs(Generator<A> const& first, Generator<B> const& second)
+  {
+    typedef std::pair<A, B> Pair;
+
+    auto generate = [first, second](Random& random, unsigned int size) -> Pair
+    {
+      A a = first(random, size);
+      return Pair(std::move(a), second(random, size));
+    };
+
+    auto shrink = [first, second](Pair const& value) -> std::vector<Pair>
+    {
+      std::vector<Pair> candidates;
+      std::vector<A> as = first.shrink(value.first);
+      std::vector<B> bs = second.shrink(value.second);
+
+      for (auto it = as.begin(); it != as.end(); ++it)
+        candidates.push_back(Pair(*it, value.second));
+
+      for (auto it = bs.begin(); it != bs.end(); ++it)
+        candidates.push_back(Pair(value.first, *it));
+
+      return candidates;
+    };
+
+    auto print = [first, second](Pair const& value) -> std::string
+    {
+      return "(" + first.print(value.first) + ", " + second.print(value.second) + ")";
+    };
+
+    return Generator<Pair>(generate, shrink, print);
+  }
+}
+
+
+#endif
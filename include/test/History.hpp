@@ -0,0 +1,390 @@
+// History.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTHISTORY_HPP
+#define TSTHISTORY_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+
+namespace tst
+{
+  /**
+   * A History stores information about previous test runs, keyed by
+   * the name of the test: whether the last run failed and exponentially
+   * weighted moving averages of the durations and of the instructions
+   * executed (if counted, see PerfCounters), which smooth out the noise
+   * of individual runs. It can be saved to and
+   * loaded from a small binary file.
+   */
+  class History
+  {
+  public:
+    typedef std::uint64_t Key;
+
+    History();
+
+    bool load(char const* path);
+    bool save(char const* path) const;
+
+    bool empty() const;
+    std::size_t size() const;
+
+    bool duration(Key key, double& seconds) const;
+    bool instructions(Key key, double& instructions) const;
+    bool failed(Key key) const;
+    double average() const;
+
+    void update(Key key, double seconds, bool failed = false, double instructions = 0.0);
+
+    static Key key(char const* test, char const* function = nullptr);
+
+  private:
+    struct Record
+    {
+      Key key;
+      double seconds;
+      /* Zero if instructions were never counted. */
+      double instructions;
+      /* One if the last run failed, zero otherwise. */
+      std::uint32_t status;
+      /* Number of runs recorded. */
+      std::uint32_t runs;
+    };
+
+    /* The record of version 1 files, which know durations only. */
+    struct RecordV1
+    {
+      Key key;
+      double seconds;
+    };
+
+    /* The record of version 2 files, which lack instruction counts. */
+    struct RecordV2
+    {
+      Key key;
+      double seconds;
+      std::uint32_t status;
+      std::uint32_t runs;
+    };
+
+    typedef std::vector<Record> Records;
+
+    /* Records are kept sorted by key. */
+    Records records_;
+
+    /* The file starts with "TSTH" followed by the format version. */
+    static std::uint32_t const Magic = 0x48545354;
+    static std::uint32_t const Version = 3;
+
+    static bool less(Record const& record, Key key);
+    static bool read(std::FILE* file, std::uint32_t version, std::uint32_t count, Records& records);
+  };
+}
+
+namespace tst
+{
+  /**
+   * The default constructor creates an empty History object.
+   */
+  inline History::History()
+    : records_()
+  {
+  }
+
+  /**
+   * Load a history from a file, replacing the current contents. Files
+   * written by older versions are converted.
+   * @param path path to the file to load
+   * @return true if the history was loaded, false if the file does not
+   *         exist or is not a valid history file
+   */
+  inline bool History::load(char const* path)
+  {
+    std::FILE* file = std::fopen(path, "rb");
+    if (file == nullptr)
+      return false;
+
+    std::uint32_t magic = 0;
+    std::uint32_t version = 0;
+    std::uint32_t count = 0;
+    Records records;
+
+    bool success = std::fread(&magic, sizeof(magic), 1, file) == 1 &&
+                   magic == Magic &&
+                   std::fread(&version, sizeof(version), 1, file) == 1 &&
+                   version >= 1 && version <= Version &&
+                   std::fread(&count, sizeof(count), 1, file) == 1 &&
+                   read(file, version, count, records);
+
+    std::fclose(file);
+
+    if (success)
+      records_.swap(records);
+
+    return success;
+  }
+
+  /**
+   * Save the history to a file. The history is written to a temporary
+   * file next to it, which is renamed once complete, so that an
+   * interrupted save never leaves a truncated history behind.
+   * @param path path to the file to write
+   * @return true if the history was saved, false otherwise
+   */
+  inline bool History::save(char const* path) const
+  {
+    std::string temporary(path);
+    temporary += ".tmp";
+
+    std::FILE* file = std::fopen(temporary.c_str(), "wb");
+    if (file == nullptr)
+      return false;
+
+    std::uint32_t magic = Magic;
+    std::uint32_t version = Version;
+    std::uint32_t count = static_cast<std::uint32_t>(records_.size());
+
+    bool success = std::fwrite(&magic, sizeof(magic), 1, file) == 1 &&
+                   std::fwrite(&version, sizeof(version), 1, file) == 1 &&
+                   std::fwrite(&count, sizeof(count), 1, file) == 1 &&
+                   (count == 0 || std::fwrite(records_.data(), sizeof(Record), count, file) == count);
+
+    success = std::fclose(file) == 0 && success;
+    success = success && std::rename(temporary.c_str(), path) == 0;
+
+    if (!success)
+      std::remove(temporary.c_str());
+
+    return success;
+  }
+
+  /**
+   * @return true if the history contains no records, false otherwise
+   */
+  inline bool History::empty() const
+  {
+    return records_.empty();
+  }
+
+  /**
+   * @return number of records in the history
+   */
+  inline std::size_t History::size() const
+  {
+    return records_.size();
+  }
+
+  /**
+   * @param key key of the test to look up
+   * @param seconds duration of the test's last run, in seconds
+   * @return true if the test was found, false if not
+   */
+  inline bool History::duration(Key key, double& seconds) const
+  {
+    auto it = std::lower_bound(records_.begin(), records_.end(), key, &History::less);
+
+    if (it == records_.end() || it->key != key)
+      return false;
+
+    seconds = it->seconds;
+    return true;
+  }
+
+  /**
+   * @param key key of the test to look up
+   * @param instructions number of instructions the test executed
+   * @return true if the test was found and its instructions were
+   *         counted, false if not
+   */
+  inline bool History::instructions(Key key, double& instructions) const
+  {
+    auto it = std::lower_bound(records_.begin(), records_.end(), key, &History::less);
+
+    if (it == records_.end() || it->key != key || it->instructions == 0.0)
+      return false;
+
+    instructions = it->instructions;
+    return true;
+  }
+
+  /**
+   * @param key key of the test to look up
+   * @return true if the last recorded run of the test failed, false if
+   *         it passed or the test is unknown
+   */
+  inline bool History::failed(Key key) const
+  {
+    auto it = std::lower_bound(records_.begin(), records_.end(), key, &History::less);
+    return it != records_.end() && it->key == key && it->status != 0;
+  }
+
+  /**
+   * @return average of all recorded durations, in seconds, or zero if
+   *         the history is empty
+   */
+  inline double History::average() const
+  {
+    double total = 0.0;
+
+    for (auto it = records_.begin(); it != records_.end(); ++it)
+      total += it->seconds;
+
+    return records_.empty() ? 0.0 : total / records_.size();
+  }
+
+  /**
+   * Record the outcome of a test run. The recorded duration and
+   * instruction count move a quarter of the way towards the new ones,
+   * so that a single outlier does not upset the scheduling of
+   * subsequent runs.
+   * @param key key of the test that ran
+   * @param seconds duration of the run, in seconds
+   * @param failed true if the run failed, false if it passed
+   * @param instructions number of instructions executed; zero if they
+   *        were not counted
+   */
+  inline void History::update(Key key, double seconds, bool failed, double instructions)
+  {
+    auto it = std::lower_bound(records_.begin(), records_.end(), key, &History::less);
+
+    if (it == records_.end() || it->key != key)
+    {
+      Record record = {key, seconds, instructions, failed ? 1u : 0u, 1};
+      records_.insert(it, record);
+      return;
+    }
+
+    if (instructions > 0.0)
+    {
+      if (it->instructions == 0.0)
+        it->instructions = instructions;
+      else
+        it->instructions += (instructions - it->instructions) / 4.0;
+    }
+
+    it->seconds += (seconds - it->seconds) / 4.0;
+    it->status = failed ? 1 : 0;
+    it->runs++;
+  }
+
+  /**
+   * @param test name of a test (may be null)
+   * @param function name of a test function (may be null)
+   * @return key identifying the given test in a history
+   */
+  inline History::Key History::key(char const* test, char const* function)
+  {
+    // FNV-1a, with a separator between test and function name
+    Key hash = 14695981039346656037ull;
+
+    for (char const* c = test != nullptr ? test : ""; *c != '\0'; ++c)
+      hash = (hash ^ static_cast<unsigned char>(*c)) * 1099511628211ull;
+
+    hash = (hash ^ 0xff) * 1099511628211ull;
+
+    for (char const* c = function != nullptr ? function : ""; *c != '\0'; ++c)
+      hash = (hash ^ static_cast<unsigned char>(*c)) * 1099511628211ull;
+
+    return hash;
+  }
+
+  /**
+   * Comparison function used for binary searching the records.
+   */
+  inline bool History::less(Record const& record, Key key)
+  {
+    return record.key < key;
+  }
+
+  /**
+   * @param file file to read the records from
+   * @param version format version of the file
+   * @param count number of records in the file
+   * @param records list to store the records in
+   * @return true if all records were read, false otherwise
+   */
+  inline bool History::read(std::FILE* file,
+                            std::uint32_t version,
+                            std::uint32_t count,
+                            Records& records)
+  {
+    std::size_t size = version == 1 ? sizeof(RecordV1) :
+                       version == 2 ? sizeof(RecordV2) : sizeof(Record);
+
+    // the count is not to be trusted before the file is known to hold
+    // that many records
+    long position = std::ftell(file);
+    if (position < 0 || std::fseek(file, 0, SEEK_END) != 0)
+      return false;
+
+    long end = std::ftell(file);
+    if (end < position || std::fseek(file, position, SEEK_SET) != 0)
+      return false;
+
+    if (static_cast<unsigned long>(end - position) / size < count)
+      return false;
+
+    records.resize(count);
+
+    if (version == Version)
+    {
+      if (count > 0 && std::fread(records.data(), sizeof(Record), count, file) != count)
+        return false;
+    }
+    else
+    {
+      for (std::uint32_t i = 0; i < count; ++i)
+      {
+        RecordV2 old = {0, 0.0, 0, 1};
+
+        if (version == 1)
+        {
+          RecordV1 oldest;
+
+          if (std::fread(&oldest, sizeof(oldest), 1, file) != 1)
+            return false;
+
+          old.key = oldest.key;
+          old.seconds = oldest.seconds;
+        }
+        else if (std::fread(&old, sizeof(old), 1, file) != 1)
+          return false;
+
+        Record record = {old.key, old.seconds, 0.0, old.status, old.runs};
+        records[i] = record;
+      }
+    }
+
+    // lookups binary search the records, which requires them to be
+    // sorted by key, without duplicates
+    auto unsorted = [](Record const& first, Record const& second)
+    {
+      return first.key >= second.key;
+    };
+    return std::adjacent_find(records.begin(), records.end(), unsorted) == records.end();
+  }
+}
+
+
+#endif
@@ -0,0 +1,177 @@
+// HistoryResult.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTHISTORYRESULT_HPP
+#define TSTHISTORYRESULT_HPP
+
+#include "History.hpp"
+#include "TestResult.hpp"
+
+
+namespace tst
+{
+  /**
+   * A TestResult that records the durations and outcomes of test cases
+   * and named test functions in a History and forwards all events to
+   * another TestResult. For each case the average duration of its test
+   * functions is stored, so that the numbers stay meaningful for runs
+   * of only a subset of a case's functions.
+   */
+  class HistoryResult: public TestResult
+  {
+  public:
+    HistoryResult(History& history, TestResult& result);
+
+    virtual void startTest(char const* test) override;
+    virtual void endTest() override;
+
+    virtual void startTestFunction(char const* function) override;
+    virtual void endTestFunction(Measurement const& measurement) override;
+
+    virtual void checked(char const* file, int line) override;
+    virtual void failed(char const* file, int line, char const* message) override;
+
+    virtual bool stopped() const override;
+
+  private:
+    History* history_;
+    TestResult* result_;
+
+    char const* test_;
+    char const* function_;
+    unsigned int functions_;
+    std::uint64_t wall_;
+    std::uint64_t instructions_;
+
+    bool test_failed_;
+    bool function_failed_;
+  };
+}
+
+namespace tst
+{
+  /**
+   * @param history history to record durations in
+   * @param result result object to forward all events to
+   */
+  inline HistoryResult::HistoryResult(History& history, TestResult& result)
+    : history_(&history),
+      result_(&result),
+      test_(nullptr),
+      function_(nullptr),
+      functions_(0),
+      wall_(0),
+      instructions_(0),
+      test_failed_(false),
+      function_failed_(false)
+  {
+  }
+
+  /**
+   * @copydoc TestResult::startTest
+   */
+  inline void HistoryResult::startTest(char const* test)
+  {
+    test_ = test;
+    functions_ = 0;
+    wall_ = 0;
+    instructions_ = 0;
+    test_failed_ = false;
+
+    result_->startTest(test);
+  }
+
+  /**
+   * @copydoc TestResult::endTest
+   */
+  inline void HistoryResult::endTest()
+  {
+    double seconds = wall_ / 1000000000.0;
+    double instructions = static_cast<double>(instructions_);
+
+    if (functions_ > 0)
+    {
+      seconds /= functions_;
+      instructions /= functions_;
+    }
+
+    history_->update(History::key(test_), seconds, test_failed_, instructions);
+
+    result_->endTest();
+  }
+
+  /**
+   * @copydoc TestResult::startTestFunction
+   */
+  inline void HistoryResult::startTestFunction(char const* function)
+  {
+    function_ = function;
+    function_failed_ = false;
+
+    result_->startTestFunction(function);
+  }
+
+  /**
+   * @copydoc TestResult::endTestFunction
+   */
+  inline void HistoryResult::endTestFunction(Measurement const& measurement)
+  {
+    functions_++;
+    wall_ += measurement.wall;
+    instructions_ += measurement.events.instructions;
+
+    if (function_ != nullptr)
+      history_->update(History::key(test_, function_),
+                       measurement.wall / 1000000000.0,
+                       function_failed_,
+                       static_cast<double>(measurement.events.instructions));
+
+    result_->endTestFunction(measurement);
+  }
+
+  /**
+   * @copydoc TestResult::checked
+   */
+  inline void HistoryResult::checked(char const* file, int line)
+  {
+    result_->checked(file, line);
+  }
+
+  /**
+   * @copydoc TestResult::failed
+   */
+  inline void HistoryResult::failed(char const* file, int line, char const* message)
+  {
+    test_failed_ = true;
+    function_failed_ = true;
+
+    result_->failed(file, line, message);
+  }
+
+  /**
+   * @copydoc TestResult::stopped
+   */
+  inline bool HistoryResult::stopped() const
+  {
+    return result_->stopped();
+  }
+}
+
+
+#endif
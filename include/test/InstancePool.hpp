@@ -0,0 +1,146 @@
+// InstancePool.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+#ifndef TSTINSTANCEPOOL_HPP
+#define TSTINSTANCEPOOL_HPP
+
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#include "Allocations.hpp"
+
+
+namespace tst
+{
+  /**
+   * An InstancePool hands out raw memory for objects of type T, in
+   * which the objects can be constructed using placement new. Memory
+   * returned to the pool is reused, so that once the pool has grown to
+   * the number of objects in use at the same time, acquiring memory is
+   * nothing more than taking an entry off a list. The memory is only
+   * freed when the pool is destroyed.
+   */
+  template<typename T>
+  class InstancePool
+  {
+  public:
+    InstancePool();
+
+    InstancePool(InstancePool&&) = delete;
+    InstancePool(InstancePool const&) = delete;
+
+    InstancePool& operator =(InstancePool&&) = delete;
+    InstancePool& operator =(InstancePool const&) = delete;
+
+    void* acquire();
+    void release(void* memory);
+
+    std::size_t capacity() const;
+
+    static InstancePool& global();
+
+  private:
+    typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type Slot;
+
+    /* Slots are allocated in blocks of growing size. */
+    std::vector<std::unique_ptr<Slot[]>> blocks_;
+    std::vector<Slot*> free_;
+    std::size_t capacity_;
+    mutable std::mutex mutex_;
+  };
+}
+
+namespace tst
+{
+  /**
+   * The default constructor creates an empty InstancePool.
+   */
+  template<typename T>
+  inline InstancePool<T>::InstancePool()
+    : blocks_(),
+      free_(),
+      capacity_(0),
+      mutex_()
+  {
+  }
+
+  /**
+   * @return memory suitable for holding an object of type T
+   */
+  template<typename T>
+  inline void* InstancePool<T>::acquire()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (free_.empty())
+    {
+      // the pool's memory is not to be attributed to the test function
+      // happening to need it first
+      Allocations::Ignore ignore;
+      std::size_t size = capacity_ > 0 ? capacity_ : 1;
+
+      blocks_.emplace_back(new Slot[size]);
+      free_.reserve(capacity_ + size);
+
+      for (std::size_t i = size; i > 0; --i)
+        free_.push_back(&blocks_.back()[i - 1]);
+
+      capacity_ += size;
+    }
+
+    Slot* slot = free_.back();
+    free_.pop_back();
+    return slot;
+  }
+
+  /**
+   * @param memory memory previously returned by 'acquire'; the object
+   *        constructed in it has to be destroyed already
+   */
+  template<typename T>
+  inline void InstancePool<T>::release(void* memory)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_.push_back(static_cast<Slot*>(memory));
+  }
+
+  /**
+   * @return number of objects the pool can hold without growing
+   */
+  template<typename T>
+  inline std::size_t InstancePool<T>::capacity() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_;
+  }
+
+  /**
+   * @return the pool shared by all users of objects of type T
+   */
+  template<typename T>
+  inline InstancePool<T>& InstancePool<T>::global()
+  {
+    static InstancePool pool;
+    return pool;
+  }
+}
+
+
+#endif
@@ -0,0 +1,290 @@
+// JUnitResult.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTJUNITRESULT_HPP
+#define TSTJUNITRESULT_HPP
+
+#include <cstdint>
+#include <cstdio>
+
+#include "FailureBuffer.hpp"
+#include "Format.hpp"
+#include "Measurement.hpp"
+#include "TestResult.hpp"
+
+
+namespace tst
+{
+  /**
+   * A TestResult that streams the results as JUnit XML. Every test case
+   * becomes a <testsuite> element and every test function a <testcase>
+   * element with its wall time in seconds:
+   * @code
+   * <?xml version="1.0" encoding="UTF-8"?>
+   * <testsuites>
+   *   <testsuite name="MyTest">
+   *     <testcase classname="MyTest" name="testMe1" time="0.000001200">
+   *       <failure type="assertion" message="has to fail!">Sample.cpp:44</failure>
+   *     </testcase>
+   *   </testsuite>
+   * </testsuites>
+   * @endcode
+   * Since elements are written as soon as they are complete, the
+   * <testsuite> elements carry no counts; consumers derive them from
+   * their children. Memory use is bounded by the FailureBuffer used for
+   * the failures of the function currently running.
+   *
+   * Failures reported outside of a test function, e.g., by the tear
+   * down of a test case, are written as <error> elements of an
+   * additional <testcase> named after the test case; those reported
+   * outside of any test case end up in an unnamed <testsuite>.
+   */
+  template<typename T>
+  class JUnitResult: public TestResult
+  {
+  public:
+    JUnitResult(T& printer);
+
+    virtual void startTest(char const* test) override;
+    virtual void endTest() override;
+
+    virtual void startTestFunction(char const* function) override;
+    virtual void endTestFunction(Measurement const& measurement) override;
+
+    virtual void checked(char const* file, int line) override;
+    virtual void failed(char const* file, int line, char const* message) override;
+
+    void printSummary();
+
+  private:
+    T* printer_;
+
+    char const* test_;
+    char const* function_;
+    unsigned int functions_;
+
+    FailureBuffer failures_;
+
+    void printOrphans();
+    void printCaseFailures();
+    void printTestCase(char const* name, std::uint64_t time);
+    void printFailures(char const* element, char const* type);
+  };
+}
+
+namespace tst
+{
+  /**
+   * @param printer stream to print the results to
+   */
+  template<typename T>
+  inline JUnitResult<T>::JUnitResult(T& printer)
+    : printer_(&printer),
+      test_(nullptr),
+      function_(nullptr),
+      functions_(0),
+      failures_()
+  {
+    (*printer_) << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<testsuites>\n";
+  }
+
+  /**
+   * @copydoc TestResult::startTest
+   */
+  template<typename T>
+  void JUnitResult<T>::startTest(char const* test)
+  {
+    printOrphans();
+
+    test_ = test;
+    functions_ = 0;
+
+    (*printer_) << "  <testsuite name=\"";
+    printXml(*printer_, test_ != nullptr ? test_ : "<unnamed>");
+    (*printer_) << "\">\n";
+  }
+
+  /**
+   * @copydoc TestResult::endTest
+   */
+  template<typename T>
+  void JUnitResult<T>::endTest()
+  {
+    printCaseFailures();
+
+    (*printer_) << "  </testsuite>\n";
+    test_ = nullptr;
+  }
+
+  /**
+   * @copydoc TestResult::startTestFunction
+   */
+  template<typename T>
+  void JUnitResult<T>::startTestFunction(char const* function)
+  {
+    // failures reported since the last function belong to the case
+    printCaseFailures();
+
+    function_ = function;
+    functions_++;
+  }
+
+  /**
+   * @copydoc TestResult::endTestFunction
+   */
+  template<typename T>
+  void JUnitResult<T>::endTestFunction(Measurement const& measurement)
+  {
+    if (function_ != nullptr)
+      printTestCase(function_, measurement.wall);
+    else
+    {
+      char name[16];
+      std::snprintf(name, sizeof(name), "#%u", functions_);
+      printTestCase(name, measurement.wall);
+    }
+
+    printFailures("failure", "assertion");
+    function_ = nullptr;
+  }
+
+  /**
+   * @copydoc TestResult::checked
+   */
+  template<typename T>
+  void JUnitResult<T>::checked(char const*, int)
+  {
+  }
+
+  /**
+   * @copydoc TestResult::failed
+   */
+  template<typename T>
+  void JUnitResult<T>::failed(char const* file, int line, char const* message)
+  {
+    failures_.add(file, line, message);
+  }
+
+  /**
+   * Close the document. To be called once after all tests have been
+   * run.
+   */
+  template<typename T>
+  void JUnitResult<T>::printSummary()
+  {
+    printOrphans();
+
+    (*printer_) << "</testsuites>\n";
+  }
+
+  /**
+   * Print the failures reported outside of any test case, if any, as
+   * part of an unnamed <testsuite> element.
+   */
+  template<typename T>
+  void JUnitResult<T>::printOrphans()
+  {
+    if (failures_.count() > 0)
+    {
+      test_ = nullptr;
+
+      (*printer_) << "  <testsuite name=\"";
+      printXml(*printer_, "<unnamed>");
+      (*printer_) << "\">\n";
+      endTest();
+    }
+  }
+
+  /**
+   * Print the failures reported outside of a test function, if any, as
+   * <error> elements of a <testcase> named after the test case.
+   */
+  template<typename T>
+  void JUnitResult<T>::printCaseFailures()
+  {
+    if (failures_.count() > 0)
+    {
+      printTestCase(test_ != nullptr ? test_ : "<unnamed>", 0);
+      printFailures("error", "case");
+    }
+  }
+
+  /**
+   * Print the opening tag of a <testcase> element, without closing it.
+   * @param name name of the test case
+   * @param time wall time of the test case, in nanoseconds
+   */
+  template<typename T>
+  void JUnitResult<T>::printTestCase(char const* name, std::uint64_t time)
+  {
+    (*printer_) << "    <testcase classname=\"";
+    printXml(*printer_, test_ != nullptr ? test_ : "<unnamed>");
+    (*printer_) << "\" name=\"";
+    printXml(*printer_, name);
+    (*printer_) << "\" time=\"";
+    printFixed(*printer_, time, 1000000000);
+    (*printer_) << '"';
+  }
+
+  /**
+   * Print the buffered failures as children of a <testcase> element,
+   * close it, and forget about the failures.
+   * @param element name of the elements to use for the failures
+   * @param type type attribute of the elements
+   */
+  template<typename T>
+  void JUnitResult<T>::printFailures(char const* element, char const* type)
+  {
+    if (failures_.count() == 0)
+    {
+      (*printer_) << "/>\n";
+      return;
+    }
+
+    (*printer_) << ">\n";
+
+    for (unsigned int i = 0; i < failures_.size(); ++i)
+    {
+      (*printer_) << "      <" << element << " type=\"" << type << '"';
+
+      if (failures_[i].has_message)
+      {
+        (*printer_) << " message=\"";
+        printXml(*printer_, failures_[i].message);
+        (*printer_) << '"';
+      }
+
+      (*printer_) << '>';
+      printXml(*printer_, failures_[i].file);
+      (*printer_) << ':' << failures_[i].line << "</" << element << ">\n";
+    }
+
+    if (failures_.count() > failures_.size())
+    {
+      (*printer_) << "      <system-out>" << failures_.count() - failures_.size()
+                  << " further failures omitted</system-out>\n";
+    }
+
+    (*printer_) << "    </testcase>\n";
+    failures_.clear();
+  }
+}
+
+
+#endif
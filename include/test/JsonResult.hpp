@@ -0,0 +1,255 @@
+// JsonResult.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTJSONRESULT_HPP
+#define TSTJSONRESULT_HPP
+
+#include "Format.hpp"
+#include "Measurement.hpp"
+#include "TestResult.hpp"
+
+
+namespace tst
+{
+  /**
+   * A TestResult that streams all events as JSON Lines, i.e., one JSON
+   * object per line, as they arrive. Every object has a "type" member
+   * naming the event:
+   * @code
+   * {"type":"test","test":"MyTest"}
+   * {"type":"failure","test":"MyTest","function":"testMe1","file":"Sample.cpp","line":44,"message":"has to fail!"}
+   * {"type":"function","test":"MyTest","function":"testMe1","index":1,"checked":1,"failed":1,"wall_ns":1200,"cpu_ns":1100,"set_up_ns":30,"tear_down_ns":20,"allocations":0,"allocated":0,"peak":0,"leaked":0,"cycles":0,"instructions":0,"branch_misses":0,"l1d_misses":0,"llc_misses":0,"context_switches":0,"page_faults":0}
+   * {"type":"endtest","test":"MyTest","functions":4,"functions_failed":3}
+   * {"type":"summary","tests":2,"tests_failed":2,"functions":9,"functions_failed":5,"assertions":10,"assertions_failed":5}
+   * @endcode
+   * Nothing besides a few counters is kept in memory.
+   */
+  template<typename T>
+  class JsonResult: public TestResult
+  {
+  public:
+    JsonResult(T& printer);
+
+    virtual void startTest(char const* test) override;
+    virtual void endTest() override;
+
+    virtual void startTestFunction(char const* function) override;
+    virtual void endTestFunction(Measurement const& measurement) override;
+
+    virtual void checked(char const* file, int line) override;
+    virtual void failed(char const* file, int line, char const* message) override;
+
+    void printSummary();
+
+  private:
+    T* printer_;
+
+    char const* test_;
+    char const* function_;
+
+    unsigned long tests_;
+    unsigned long tests_failed_;
+    unsigned long functions_;
+    unsigned long functions_failed_;
+    unsigned long assertions_;
+    unsigned long assertions_failed_;
+
+    unsigned int functions_this_test_;
+    unsigned int functions_failed_this_test_;
+    unsigned long checked_this_function_;
+    unsigned long failed_this_function_;
+
+    void printPrefix(char const* type) const;
+  };
+}
+
+namespace tst
+{
+  /**
+   * @param printer stream to print the events to
+   */
+  template<typename T>
+  inline JsonResult<T>::JsonResult(T& printer)
+    : printer_(&printer),
+      test_(nullptr),
+      function_(nullptr),
+      tests_(0),
+      tests_failed_(0),
+      functions_(0),
+      functions_failed_(0),
+      assertions_(0),
+      assertions_failed_(0),
+      functions_this_test_(0),
+      functions_failed_this_test_(0),
+      checked_this_function_(0),
+      failed_this_function_(0)
+  {
+  }
+
+  /**
+   * @copydoc TestResult::startTest
+   */
+  template<typename T>
+  void JsonResult<T>::startTest(char const* test)
+  {
+    test_ = test;
+    function_ = nullptr;
+    tests_++;
+
+    functions_this_test_ = 0;
+    functions_failed_this_test_ = 0;
+
+    printPrefix("test");
+    (*printer_) << "}\n";
+  }
+
+  /**
+   * @copydoc TestResult::endTest
+   */
+  template<typename T>
+  void JsonResult<T>::endTest()
+  {
+    if (functions_failed_this_test_ > 0)
+      tests_failed_++;
+
+    printPrefix("endtest");
+    (*printer_) << ",\"functions\":" << functions_this_test_
+                << ",\"functions_failed\":" << functions_failed_this_test_ << "}\n";
+
+    test_ = nullptr;
+    function_ = nullptr;
+  }
+
+  /**
+   * @copydoc TestResult::startTestFunction
+   */
+  template<typename T>
+  void JsonResult<T>::startTestFunction(char const* function)
+  {
+    function_ = function;
+    functions_++;
+    functions_this_test_++;
+
+    checked_this_function_ = 0;
+    failed_this_function_ = 0;
+  }
+
+  /**
+   * @copydoc TestResult::endTestFunction
+   */
+  template<typename T>
+  void JsonResult<T>::endTestFunction(Measurement const& measurement)
+  {
+    if (failed_this_function_ > 0)
+    {
+      functions_failed_++;
+      functions_failed_this_test_++;
+    }
+
+    printPrefix("function");
+    (*printer_) << ",\"index\":" << functions_this_test_
+                << ",\"checked\":" << checked_this_function_ + measurement.checked
+                << ",\"failed\":" << failed_this_function_
+                << ",\"wall_ns\":" << static_cast<unsigned long long>(measurement.wall)
+                << ",\"cpu_ns\":" << static_cast<unsigned long long>(measurement.cpu)
+                << ",\"set_up_ns\":" << static_cast<unsigned long long>(measurement.set_up)
+                << ",\"tear_down_ns\":" << static_cast<unsigned long long>(measurement.tear_down)
+                << ",\"allocations\":" << static_cast<unsigned long long>(measurement.allocations)
+                << ",\"allocated\":" << static_cast<unsigned long long>(measurement.allocated)
+                << ",\"peak\":" << static_cast<unsigned long long>(measurement.peak)
+                << ",\"leaked\":" << static_cast<unsigned long long>(measurement.leaked);
+
+    PerfCounts const& events = measurement.events;
+
+    (*printer_) << ",\"cycles\":" << static_cast<unsigned long long>(events.cycles)
+                << ",\"instructions\":" << static_cast<unsigned long long>(events.instructions)
+                << ",\"branch_misses\":" << static_cast<unsigned long long>(events.branch_misses)
+                << ",\"l1d_misses\":" << static_cast<unsigned long long>(events.l1d_misses)
+                << ",\"llc_misses\":" << static_cast<unsigned long long>(events.llc_misses)
+                << ",\"context_switches\":" << static_cast<unsigned long long>(events.context_switches)
+                << ",\"page_faults\":" << static_cast<unsigned long long>(events.page_faults)
+                << "}\n";
+
+    function_ = nullptr;
+  }
+
+  /**
+   * @copydoc TestResult::checked
+   */
+  template<typename T>
+  void JsonResult<T>::checked(char const*, int)
+  {
+    assertions_++;
+    checked_this_function_++;
+  }
+
+  /**
+   * @copydoc TestResult::failed
+   */
+  template<typename T>
+  void JsonResult<T>::failed(char const* file, int line, char const* message)
+  {
+    assertions_failed_++;
+    failed_this_function_++;
+
+    printPrefix("failure");
+    (*printer_) << ",\"file\":";
+    printJson(*printer_, file);
+    (*printer_) << ",\"line\":" << line << ",\"message\":";
+    printJson(*printer_, message);
+    (*printer_) << "}\n";
+  }
+
+  /**
+   * Print a line summarizing the whole run.
+   */
+  template<typename T>
+  void JsonResult<T>::printSummary()
+  {
+    (*printer_) << "{\"type\":\"summary\""
+                << ",\"tests\":" << tests_
+                << ",\"tests_failed\":" << tests_failed_
+                << ",\"functions\":" << functions_
+                << ",\"functions_failed\":" << functions_failed_
+                << ",\"assertions\":" << assertions_
+                << ",\"assertions_failed\":" << assertions_failed_
+                << "}\n";
+  }
+
+  /**
+   * Print the opening of an event object along with the current test
+   * and function, if any.
+   * @param type type of the event
+   */
+  template<typename T>
+  void JsonResult<T>::printPrefix(char const* type) const
+  {
+    (*printer_) << "{\"type\":\"" << type << "\",\"test\":";
+    printJson(*printer_, test_);
+
+    if (function_ != nullptr)
+    {
+      (*printer_) << ",\"function\":";
+      printJson(*printer_, function_);
+    }
+  }
+}
+
+
+#endif
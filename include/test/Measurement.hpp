@@ -0,0 +1,198 @@
+// Measurement.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTMEASUREMENT_HPP
+#define TSTMEASUREMENT_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+
+#if defined(__unix__) || defined(__APPLE__)
+#  include <time.h>
+#endif
+
+
+namespace tst
+{
+  /**
+   * The numbers of hardware and software events counted while running
+   * a piece of code (see PerfCounters). Events that could not be
+   * counted are zero.
+   */
+  struct PerfCounts
+  {
+    /** CPU cycles. */
+    std::uint64_t cycles;
+    /** Instructions retired. */
+    std::uint64_t instructions;
+    /** Mispredicted branches. */
+    std::uint64_t branch_misses;
+    /** Level 1 data cache read misses. */
+    std::uint64_t l1d_misses;
+    /** Last level cache misses. */
+    std::uint64_t llc_misses;
+    /** Context switches, a software event. */
+    std::uint64_t context_switches;
+    /** Page faults, a software event. */
+    std::uint64_t page_faults;
+  };
+
+
+  /**
+   * A Measurement contains the figures collected while running a single
+   * test function. All times are in nanoseconds, all sizes in bytes.
+   * The allocation figures are only collected if the global operator
+   * new is replaced by TESTALLOCATIONHOOKS (see Allocations), the
+   * event counts only if TST_PERF_COUNTERS is defined.
+   */
+  struct Measurement
+  {
+    /** Wall clock time of set up, test function, and tear down. */
+    std::uint64_t wall;
+    /**
+     * CPU time consumed by the thread running the test; only measured
+     * if TST_CPU_TIME is defined.
+     */
+    std::uint64_t cpu;
+    /** Wall clock time spent in set up. */
+    std::uint64_t set_up;
+    /** Wall clock time spent in tear down. */
+    std::uint64_t tear_down;
+    /** Number of allocations made. */
+    std::uint64_t allocations;
+    /** Total size of the allocations made. */
+    std::uint64_t allocated;
+    /** Highest amount of memory allocated at any time. */
+    std::uint64_t peak;
+    /** Amount of memory still allocated at the end. */
+    std::uint64_t leaked;
+    /**
+     * Number of assertions checked, if counted by Sites (see
+     * TST_SITE_COUNTERS) instead of being reported one by one.
+     */
+    std::uint64_t checked;
+    /** Events counted by the thread running the function. */
+    PerfCounts events;
+  };
+
+
+  std::uint64_t wallTime();
+  std::uint64_t cpuTime();
+
+  PerfCounts& operator +=(PerfCounts& lhs, PerfCounts const& rhs);
+  PerfCounts operator -(PerfCounts const& lhs, PerfCounts const& rhs);
+
+  Measurement& operator +=(Measurement& lhs, Measurement const& rhs);
+}
+
+namespace tst
+{
+  /**
+   * @return current value of a monotonic clock, in nanoseconds
+   */
+  inline std::uint64_t wallTime()
+  {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+  }
+
+  /**
+   * @return CPU time consumed by the calling thread so far, in
+   *         nanoseconds; on systems not supporting per-thread CPU time
+   *         the time of the process is used
+   * @note Reading the CPU time of a thread is a system call on most
+   *       systems, which costs more than running an empty test
+   *       function. It is therefore only read if TST_CPU_TIME is
+   *       defined, otherwise zero is returned.
+   */
+  inline std::uint64_t cpuTime()
+  {
+#if !defined(TST_CPU_TIME)
+    return 0;
+#elif defined(CLOCK_THREAD_CPUTIME_ID)
+    timespec time;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return static_cast<std::uint64_t>(time.tv_sec) * 1000000000u + time.tv_nsec;
+#else
+    return static_cast<std::uint64_t>(std::clock()) * 1000000000u / CLOCKS_PER_SEC;
+#endif
+  }
+
+  /**
+   * Accumulate the event counts of one object into another.
+   * @param lhs counts to add to
+   * @param rhs counts to add
+   * @return the accumulated counts
+   */
+  inline PerfCounts& operator +=(PerfCounts& lhs, PerfCounts const& rhs)
+  {
+    lhs.cycles += rhs.cycles;
+    lhs.instructions += rhs.instructions;
+    lhs.branch_misses += rhs.branch_misses;
+    lhs.l1d_misses += rhs.l1d_misses;
+    lhs.llc_misses += rhs.llc_misses;
+    lhs.context_switches += rhs.context_switches;
+    lhs.page_faults += rhs.page_faults;
+    return lhs;
+  }
+
+  /**
+   * @param lhs counts at the end of a measurement
+   * @param rhs counts at the start of a measurement
+   * @return the events counted in between
+   */
+  inline PerfCounts operator -(PerfCounts const& lhs, PerfCounts const& rhs)
+  {
+    PerfCounts counts = {
+      lhs.cycles - rhs.cycles,
+      lhs.instructions - rhs.instructions,
+      lhs.branch_misses - rhs.branch_misses,
+      lhs.l1d_misses - rhs.l1d_misses,
+      lhs.llc_misses - rhs.llc_misses,
+      lhs.context_switches - rhs.context_switches,
+      lhs.page_faults - rhs.page_faults,
+    };
+    return counts;
+  }
+
+  /**
+   * Accumulate the figures of one measurement into another.
+   * @param lhs measurement to add to
+   * @param rhs measurement to add
+   * @return the accumulated measurement
+   */
+  inline Measurement& operator +=(Measurement& lhs, Measurement const& rhs)
+  {
+    lhs.wall += rhs.wall;
+    lhs.cpu += rhs.cpu;
+    lhs.set_up += rhs.set_up;
+    lhs.tear_down += rhs.tear_down;
+    lhs.allocations += rhs.allocations;
+    lhs.allocated += rhs.allocated;
+    lhs.peak = lhs.peak > rhs.peak ? lhs.peak : rhs.peak;
+    lhs.leaked += rhs.leaked;
+    lhs.checked += rhs.checked;
+    lhs.events += rhs.events;
+    return lhs;
+  }
+}
+
+
+#endif
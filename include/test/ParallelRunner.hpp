@@ -0,0 +1,397 @@
+// ParallelRunner.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTPARALLELRUNNER_HPP
+#define TSTPARALLELRUNNER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Fatal.hpp"
+#include "Fixtures.hpp"
+#include "Schedule.hpp"
+#include "TestBase.hpp"
+#include "TestCaseBase.hpp"
+#include "TestResult.hpp"
+#include "TestVisitor.hpp"
+#include "RecordingResult.hpp"
+#include "WorkQueue.hpp"
+
+
+namespace tst
+{
+  /**
+   * A ParallelRunner runs a test (typically a TestSuite) on a pool of
+   * worker threads. Test cases are the unit of work, unless a case
+   * declared its test functions as concurrent, in which case each of
+   * them is scheduled individually.
+   *
+   * Each piece of work reports into a private RecordingResult. The
+   * recorded events are replayed into the actual TestResult in the
+   * order in which a serial run would have produced them, meaning the
+   * result object does not have to be thread-safe and its output does
+   * not depend on the scheduling.
+   *
+   * If the TestResult is thread-safe (see ConcurrentResult) the workers
+   * report to it directly instead. In this mode each test case runs as
+   * a whole on one worker, because its functions have to report
+   * between a single startTest/endTest pair.
+   *
+   * With a Schedule the test cases are started, and reported, in the
+   * order it determines, e.g., longest first, which minimizes the time
+   * until the last worker is done. The run ends early if the result
+   * object asks for it (see FailFastResult).
+   */
+  class ParallelRunner
+  {
+  public:
+    explicit ParallelRunner(unsigned int workers = 0);
+
+    ParallelRunner(ParallelRunner&&) = delete;
+    ParallelRunner(ParallelRunner const&) = delete;
+
+    ParallelRunner& operator =(ParallelRunner&&) = delete;
+    ParallelRunner& operator =(ParallelRunner const&) = delete;
+
+    void run(TestBase& test, TestResult& result);
+
+    unsigned int workers() const;
+
+    void setSchedule(Schedule const* schedule);
+
+  private:
+    struct Unit
+    {
+      TestBase* test;
+      TestCaseBase* testCase;
+      unsigned int function;
+      bool first;
+      bool last;
+    };
+
+    typedef std::vector<Unit> Units;
+
+    class Collector: public TestVisitor
+    {
+    public:
+      Collector(Units& units, Fixtures& fixtures, bool split);
+
+      virtual void visit(TestBase& test) override;
+      virtual void visit(TestCaseBase& test) override;
+
+      virtual void enter(TestSuite& suite) override;
+      virtual void leave(TestSuite& suite) override;
+
+    private:
+      Units* units_;
+      Fixtures* fixtures_;
+      bool split_;
+    };
+
+    unsigned int workers_;
+    Schedule const* schedule_;
+
+    void arrange(Units& units) const;
+
+    static void execute(Unit const& unit, TestResult& result);
+  };
+}
+
+namespace tst
+{
+  /**
+   * @param workers number of worker threads to use; zero means one per
+   *        hardware thread
+   */
+  inline ParallelRunner::ParallelRunner(unsigned int workers)
+    : workers_(workers),
+      schedule_(nullptr)
+  {
+    if (workers_ == 0)
+      workers_ = std::thread::hardware_concurrency();
+
+    if (workers_ == 0)
+      workers_ = 1;
+  }
+
+  /**
+   * Run the given test and report to the given result object.
+   * @param test test to run
+   * @param result result object to report to
+   */
+  inline void ParallelRunner::run(TestBase& test, TestResult& result)
+  {
+    bool direct = result.threadSafe();
+
+    Units units;
+    Fixtures fixtures;
+    Collector collector(units, fixtures, !direct);
+    test.accept(collector);
+
+    if (units.empty())
+      return;
+
+    arrange(units);
+    fixtures.setUp();
+
+    unsigned int workers = workers_ < units.size() ? workers_ : units.size();
+
+    std::vector<RecordingResult> records(direct ? 0 : units.size());
+    std::vector<char> done(units.size(), 0);
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::atomic<bool> stop(false);
+    WorkQueue queue(workers, units.size());
+
+    auto work = [&](unsigned int worker)
+    {
+      std::size_t task;
+
+      while (!stop.load(std::memory_order_relaxed) && queue.pop(worker, task))
+      {
+        if (direct)
+        {
+          if (result.stopped())
+            break;
+
+          execute(units[task], result);
+          continue;
+        }
+
+        execute(units[task], records[task]);
+
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          done[task] = 1;
+        }
+        condition.notify_one();
+      }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers);
+
+    for (unsigned int i = 0; i < workers; ++i)
+      threads.emplace_back(work, i);
+
+    bool open = false;
+
+    // replay the results in order as soon as they become available
+    for (std::size_t i = 0; i < records.size(); ++i)
+    {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&]() { return done[i] != 0; });
+      }
+
+      Unit const& unit = units[i];
+
+      if (unit.first)
+      {
+        result.startTest(unit.testCase->name());
+        open = true;
+      }
+
+      records[i].replay(result);
+      records[i].clear();
+
+      if (unit.last)
+      {
+        result.endTest();
+        open = false;
+      }
+
+      if (result.stopped())
+      {
+        // units already running are waited for, but not reported
+        stop.store(true, std::memory_order_relaxed);
+
+        if (open)
+          result.endTest();
+        break;
+      }
+    }
+
+    for (auto it = threads.begin(); it != threads.end(); ++it)
+      it->join();
+
+    // cases run function by function were set up by whichever function
+    // ran first, but are torn down only now that all of them are done
+    for (auto it = units.begin(); it != units.end(); ++it)
+    {
+      if (it->testCase != nullptr && it->first)
+        it->testCase->leave();
+    }
+
+    fixtures.tearDown();
+  }
+
+  /**
+   * @return number of worker threads used
+   */
+  inline unsigned int ParallelRunner::workers() const
+  {
+    return workers_;
+  }
+
+  /**
+   * Set the schedule determining the order in which test cases are
+   * started. Without a schedule they are started in the order in which
+   * a serial run would run them.
+   * @param schedule schedule to use (may be null); it has to stay alive
+   *        as long as it is used
+   */
+  inline void ParallelRunner::setSchedule(Schedule const* schedule)
+  {
+    schedule_ = schedule;
+  }
+
+  /**
+   * Reorder the units of work according to the schedule, if any. The
+   * units of the functions of a concurrent test case are kept together,
+   * so that they can still be reported between one startTest/endTest
+   * pair.
+   * @param units list of units to reorder
+   */
+  inline void ParallelRunner::arrange(Units& units) const
+  {
+    if (schedule_ == nullptr)
+      return;
+
+    std::vector<std::size_t> starts;
+    std::vector<Schedule::Estimate> estimates;
+
+    for (std::size_t i = 0; i < units.size(); ++i)
+    {
+      if (units[i].testCase == nullptr || units[i].first)
+      {
+        starts.push_back(i);
+        estimates.push_back(schedule_->estimate(*units[i].test));
+      }
+    }
+
+    starts.push_back(units.size());
+
+    std::vector<std::size_t> order = schedule_->arrange(estimates);
+    Units arranged;
+    arranged.reserve(units.size());
+
+    for (auto it = order.begin(); it != order.end(); ++it)
+      arranged.insert(arranged.end(), units.begin() + starts[*it], units.begin() + starts[*it + 1]);
+
+    units.swap(arranged);
+  }
+
+  /**
+   * @param unit unit of work to execute
+   * @param result result object to report to
+   */
+  inline void ParallelRunner::execute(Unit const& unit, TestResult& result)
+  {
+    // an exception must not escape the worker thread; we do the best we
+    // can and report it as a failure
+    TSTTRY
+    {
+      if (unit.testCase != nullptr)
+        unit.testCase->runFunction(result, unit.function);
+      else
+        unit.test->run(result);
+    }
+    TSTCATCH(...)
+    {
+      result.failed(__FILE__, __LINE__, "Unexpected exception");
+    }
+  }
+
+  /**
+   * @param units list of units to add collected units of work to
+   * @param fixtures fixtures to track the suites containing units in
+   * @param split true if the functions of concurrent test cases are to
+   *        be scheduled individually, false if not
+   */
+  inline ParallelRunner::Collector::Collector(Units& units, Fixtures& fixtures, bool split)
+    : units_(&units),
+      fixtures_(&fixtures),
+      split_(split)
+  {
+  }
+
+  /**
+   * @copydoc TestVisitor::visit
+   */
+  inline void ParallelRunner::Collector::visit(TestBase& test)
+  {
+    Unit unit = {&test, nullptr, 0, false, false};
+    units_->push_back(unit);
+    fixtures_->use();
+  }
+
+  /**
+   * @copydoc TestVisitor::visit
+   */
+  inline void ParallelRunner::Collector::visit(TestCaseBase& test)
+  {
+    unsigned int count = test.functionCount();
+    unsigned int selected = test.selectedCount();
+
+    if (count > 0 && selected == 0)
+      return;
+
+    if (!split_ || !test.concurrent() || count == 0)
+    {
+      visit(static_cast<TestBase&>(test));
+      return;
+    }
+
+    unsigned int index = 0;
+
+    for (unsigned int i = 0; i < count; ++i)
+    {
+      if (!test.functionSelected(i))
+        continue;
+
+      Unit unit = {&test, &test, i, index == 0, index == selected - 1};
+      units_->push_back(unit);
+      index++;
+    }
+    fixtures_->use();
+  }
+
+  /**
+   * @copydoc TestVisitor::enter
+   */
+  inline void ParallelRunner::Collector::enter(TestSuite& suite)
+  {
+    fixtures_->enter(suite);
+  }
+
+  /**
+   * @copydoc TestVisitor::leave
+   */
+  inline void ParallelRunner::Collector::leave(TestSuite& suite)
+  {
+    fixtures_->leave(suite);
+  }
+}
+
+
+#endif
@@ -0,0 +1,303 @@
+// PerfCounters.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+#ifndef TSTPERFCOUNTERS_HPP
+#define TSTPERFCOUNTERS_HPP
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__)
+#  include <linux/perf_event.h>
+#  include <pthread.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#endif
+
+#include "Measurement.hpp"
+
+
+namespace tst
+{
+  /**
+   * PerfCounters counts hardware events (cycles, instructions, branch
+   * misses, and cache misses) and software events (context switches
+   * and page faults) of the calling thread using Linux' perf_event_open
+   * interface. Events the system does not support, e.g., hardware
+   * events inside most virtual machines, are left out; the software
+   * events are available wherever perf events are permitted at all. On
+   * other systems nothing is counted.
+   *
+   * If TST_PERF_COUNTERS is defined, TestCase and BenchmarkCase count
+   * the events of each test function and benchmark. Unlike times,
+   * instruction counts hardly vary between runs, even on busy machines.
+   */
+  class PerfCounters
+  {
+  public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(PerfCounters&&) = delete;
+    PerfCounters(PerfCounters const&) = delete;
+
+    PerfCounters& operator =(PerfCounters&&) = delete;
+    PerfCounters& operator =(PerfCounters const&) = delete;
+
+    bool available() const;
+    bool hardware() const;
+    bool cycles() const;
+    bool instructions() const;
+
+    PerfCounts read();
+
+    static PerfCounters& thread();
+
+  private:
+    static unsigned int const Events = 7;
+    static unsigned int const HardwareEvents = 5;
+
+    /* The events are opened as one group and read at once. */
+    int fds_[Events];
+    int leader_;
+    unsigned int count_;
+    unsigned int generation_;
+
+    void open();
+    void close();
+
+    static unsigned int& generation();
+    static void forked();
+  };
+}
+
+namespace tst
+{
+  /**
+   * The default constructor opens counters for the calling thread.
+   */
+  inline PerfCounters::PerfCounters()
+    : leader_(-1),
+      count_(0),
+      generation_(0)
+  {
+    for (unsigned int i = 0; i < Events; ++i)
+      fds_[i] = -1;
+
+    open();
+  }
+
+  /**
+   * Close all counters.
+   */
+  inline PerfCounters::~PerfCounters()
+  {
+    close();
+  }
+
+  /**
+   * @return true if any event is counted, false otherwise
+   */
+  inline bool PerfCounters::available() const
+  {
+    return count_ > 0;
+  }
+
+  /**
+   * @return true if any hardware event is counted, false otherwise
+   */
+  inline bool PerfCounters::hardware() const
+  {
+    for (unsigned int i = 0; i < HardwareEvents; ++i)
+    {
+      if (fds_[i] >= 0)
+        return true;
+    }
+    return false;
+  }
+
+  /**
+   * @return true if CPU cycles are counted, false otherwise
+   */
+  inline bool PerfCounters::cycles() const
+  {
+    return fds_[0] >= 0;
+  }
+
+  /**
+   * @return true if instructions are counted, false otherwise
+   */
+  inline bool PerfCounters::instructions() const
+  {
+    return fds_[1] >= 0;
+  }
+
+  /**
+   * @return number of events counted so far by the thread that created
+   *         this object; only differences between two calls are
+   *         meaningful
+   */
+  inline PerfCounts PerfCounters::read()
+  {
+    PerfCounts counts = PerfCounts();
+
+#if defined(__linux__)
+    // a forked child inherits our descriptors, but they still count the
+    // events of the parent
+    if (generation_ != generation())
+    {
+      close();
+      open();
+    }
+
+    if (count_ == 0)
+      return counts;
+
+    std::uint64_t data[3 + Events];
+    ssize_t size = ::read(leader_, data, sizeof(data));
+
+    if (size < static_cast<ssize_t>(3 * sizeof(data[0])) || data[0] != count_)
+      return counts;
+
+    // with more events than the hardware can count at once, the kernel
+    // multiplexes them and we extrapolate
+    double scale = data[2] > 0 && data[2] < data[1] ? static_cast<double>(data[1]) / data[2] : 1.0;
+
+    std::uint64_t* fields[Events] = {
+      &counts.cycles,
+      &counts.instructions,
+      &counts.branch_misses,
+      &counts.l1d_misses,
+      &counts.llc_misses,
+      &counts.context_switches,
+      &counts.page_faults,
+    };
+
+    for (unsigned int i = 0, j = 3; i < Events; ++i)
+    {
+      if (fds_[i] >= 0)
+        *fields[i] = static_cast<std::uint64_t>(data[j++] * scale);
+    }
+#endif
+    return counts;
+  }
+
+  /**
+   * @return the counters of the calling thread, opened on first use
+   */
+  inline PerfCounters& PerfCounters::thread()
+  {
+    static thread_local PerfCounters counters;
+    return counters;
+  }
+
+  /**
+   * Open the counters for the calling thread. The first event that can
+   * be opened becomes the group leader.
+   */
+  inline void PerfCounters::open()
+  {
+#if defined(__linux__)
+    static bool const registered = pthread_atfork(nullptr, nullptr, &PerfCounters::forked) == 0;
+    static struct
+    {
+      std::uint32_t type;
+      std::uint64_t config;
+    } const events[Events] = {
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+      {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+                           (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                           (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+      {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+      {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+    };
+
+    (void)registered;
+    generation_ = generation();
+
+    for (unsigned int i = 0; i < Events; ++i)
+    {
+      perf_event_attr attributes;
+      std::memset(&attributes, 0, sizeof(attributes));
+
+      attributes.size = sizeof(attributes);
+      attributes.type = events[i].type;
+      attributes.config = events[i].config;
+      attributes.read_format = PERF_FORMAT_GROUP |
+                               PERF_FORMAT_TOTAL_TIME_ENABLED |
+                               PERF_FORMAT_TOTAL_TIME_RUNNING;
+      // user space only, which is permitted for unprivileged processes
+      attributes.exclude_kernel = 1;
+      attributes.exclude_hv = 1;
+
+      int fd = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, leader_, 0));
+
+      if (fd < 0)
+        continue;
+
+      if (leader_ < 0)
+        leader_ = fd;
+
+      fds_[i] = fd;
+      count_++;
+    }
+#endif
+  }
+
+  /**
+   * Close all counters opened.
+   */
+  inline void PerfCounters::close()
+  {
+#if defined(__linux__)
+    // the group leader has to be closed last
+    for (unsigned int i = Events; i > 0; --i)
+    {
+      if (fds_[i - 1] >= 0)
+        ::close(fds_[i - 1]);
+
+      fds_[i - 1] = -1;
+    }
+#endif
+    leader_ = -1;
+    count_ = 0;
+  }
+
+  /**
+   * @return the number of forks this process went through
+   */
+  inline unsigned int& PerfCounters::generation()
+  {
+    static unsigned int generation = 0;
+    return generation;
+  }
+
+  /**
+   * Handler invoked in the child after a fork.
+   */
+  inline void PerfCounters::forked()
+  {
+    generation()++;
+  }
+}
+
+
+#endif
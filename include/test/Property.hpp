@@ -0,0 +1,492 @@
+// Property.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+#ifndef TSTPROPERTY_HPP
+#define TSTPROPERTY_HPP
+
+/**
+ * TST_PROPERTIES is 1 if property tests are available. They allocate
+ * memory and run on threads, so programs that do without the heap
+ * (see TST_FIXED_CAPACITY) have to enable them explicitly. It changes
+ * the interface of TestCase, so all translation units of a program
+ * have to agree on it.
+ */
+#if !defined(TST_PROPERTIES)
+#  if defined(TST_FIXED_CAPACITY)
+#    define TST_PROPERTIES 0
+#  else
+#    define TST_PROPERTIES 1
+#  endif
+#endif
+
+#if TST_PROPERTIES
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Fatal.hpp"
+#include "Generator.hpp"
+#include "Measurement.hpp"
+#include "Sites.hpp"
+#include "TestResult.hpp"
+
+
+namespace tst
+{
+  /**
+   * A Property describes how a property test is run: a property, i.e.,
+   * a function containing assertions about a value, is evaluated for a
+   * number of values produced by a Generator. Evaluation is spread over
+   * multiple threads; every value is derived from the seed and its
+   * index only, so the outcome does not depend on the number of threads.
+   * The value with the lowest index for which the property does not
+   * hold is then shrunk, i.e., replaced by simpler values for which it
+   * still does not hold, as long as possible.
+   *
+   * The seed is either given explicitly, taken from the environment
+   * variable TST_SEED, or derived from the name of the test, in this
+   * order, so that runs are reproducible.
+   *
+   * @note Properties are evaluated concurrently, so they must not
+   *       modify state shared between evaluations.
+   */
+  class Property
+  {
+  public:
+    Property(std::size_t cases = 100, unsigned int threads = 0, std::uint64_t seed = 0);
+
+    std::size_t cases() const;
+    unsigned int threads() const;
+    unsigned int shrinks() const;
+    void setShrinks(unsigned int shrinks);
+
+    std::uint64_t seed(std::uint64_t fallback) const;
+
+    template<typename T>
+    bool check(TestResult& result,
+               Generator<T> const& generator,
+               std::function<void(TestResult&, T const&)> const& property,
+               std::uint64_t seed) const;
+
+  private:
+    /* Evaluates a property for a single value. */
+    class Evaluation: public TestResult
+    {
+    public:
+      Evaluation();
+
+      virtual void startTest(char const* test) override;
+      virtual void endTest() override;
+
+      virtual void startTestFunction(char const* function) override;
+      virtual void endTestFunction(Measurement const& measurement) override;
+
+      virtual void checked(char const* file, int line) override;
+      virtual void failed(char const* file, int line, char const* message) override;
+
+      template<typename T>
+      bool evaluate(std::function<void(TestResult&, T const&)> const& property, T const& value);
+
+      char const* file() const;
+      int line() const;
+      char const* message() const;
+
+      char const* checkedFile() const;
+      int checkedLine() const;
+
+    private:
+      char const* file_;
+      int line_;
+      std::string message_;
+      bool failed_;
+      char const* checked_file_;
+      int checked_line_;
+    };
+
+    std::size_t cases_;
+    unsigned int threads_;
+    unsigned int shrinks_;
+    std::uint64_t seed_;
+
+    unsigned int size(std::size_t index) const;
+  };
+}
+
+namespace tst
+{
+  /**
+   * @param cases number of values to evaluate the property for
+   * @param threads number of threads to evaluate the property on; zero
+   *        means one per hardware thread
+   * @param seed seed to derive all values from; zero means it is taken
+   *        from the environment or the name of the test
+   */
+  inline Property::Property(std::size_t cases, unsigned int threads, std::uint64_t seed)
+    : cases_(cases),
+      threads_(threads),
+      shrinks_(1000),
+      seed_(seed)
+  {
+    if (threads_ == 0)
+      threads_ = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+
+  /**
+   * @return number of values to evaluate the property for
+   */
+  inline std::size_t Property::cases() const
+  {
+    return cases_;
+  }
+
+  /**
+   * @return number of threads to evaluate the property on
+   */
+  inline unsigned int Property::threads() const
+  {
+    return threads_;
+  }
+
+  /**
+   * @return maximum number of times a failing value is shrunk
+   */
+  inline unsigned int Property::shrinks() const
+  {
+    return shrinks_;
+  }
+
+  /**
+   * @param shrinks maximum number of times a failing value is shrunk
+   */
+  inline void Property::setShrinks(unsigned int shrinks)
+  {
+    shrinks_ = shrinks;
+  }
+
+  /**
+   * @param fallback seed to use if neither an explicit one nor one in
+   *        the environment is given, typically derived from the name
+   *        of the test
+   * @return seed to derive all values from
+   */
+  inline std::uint64_t Property::seed(std::uint64_t fallback) const
+  {
+    if (seed_ != 0)
+      return seed_;
+
+    char const* seed = std::getenv("TST_SEED");
+
+    if (seed != nullptr && *seed != '\0')
+      return std::strtoull(seed, nullptr, 0);
+
+    return fallback;
+  }
+
+  /**
+   * Check that a property holds for all values generated. A failure is
+   * reported at the location of the first failed assertion for the
+   * shrunk value, along with this value and the seed.
+   * @param result result object to report to
+   * @param generator generator of the values to check
+   * @param property property to check; it is passed a result object to
+   *        report to and the value to check
+   * @param seed seed to use unless an explicit one was given (see
+   *        'seed')
+   * @return true if the property holds for all values, false otherwise
+   */
+  template<typename T>
+  inline bool Property::check(TestResult& result,
+                              Generator<T> const& generator,
+                              std::function<void(TestResult&, T const&)> const& property,
+                              std::uint64_t seed) const
+  {
+    seed = this->seed(seed);
+
+    unsigned int count = static_cast<unsigned int>(std::min<std::size_t>(threads_, cases_));
+    std::atomic<std::size_t> first(cases_);
+    char const* checked_file = nullptr;
+    int checked_line = 0;
+
+    auto work = [&](unsigned int thread)
+    {
+      for (std::size_t i = thread; i < cases_ && i < first.load(std::memory_order_relaxed); i += count)
+      {
+        Random random(Random::mix(seed + i));
+        T value = generator(random, size(i));
+        Evaluation evaluation;
+
+        if (evaluation.evaluate(property, value))
+        {
+          std::size_t current = first.load(std::memory_order_relaxed);
+
+          while (i < current && !first.compare_exchange_weak(current, i))
+          {
+          }
+        }
+
+        if (i == 0)
+        {
+          checked_file = evaluation.checkedFile();
+          checked_line = evaluation.checkedLine();
+        }
+      }
+    };
+
+    std::vector<std::thread> threads;
+
+    if (count > 1)
+    {
+      threads.reserve(count - 1);
+
+      for (unsigned int i = 1; i < count; ++i)
+        threads.emplace_back(work, i);
+    }
+
+    if (count > 0)
+      work(0);
+
+    for (auto it = threads.begin(); it != threads.end(); ++it)
+      it->join();
+
+    if (checked_file != nullptr)
+      result.checked(checked_file, checked_line);
+
+    std::size_t index = first.load();
+
+    if (index == cases_)
+      return true;
+
+    Random random(Random::mix(seed + index));
+    T value = generator(random, size(index));
+    Evaluation failure;
+
+    if (!failure.evaluate(property, value))
+    {
+      std::string message = "Property failed for " + generator.print(value) +
+                            " only on its first evaluation (seed " + std::to_string(seed) + ")";
+      result.failed(__FILE__, __LINE__, message.c_str());
+      return false;
+    }
+
+    unsigned int shrinks = 0;
+
+    for (bool shrunk = true; shrunk && shrinks < shrinks_;)
+    {
+      std::vector<T> candidates = generator.shrink(value);
+      shrunk = false;
+
+      for (auto it = candidates.begin(); it != candidates.end(); ++it)
+      {
+        Evaluation evaluation;
+
+        if (evaluation.evaluate(property, *it))
+        {
+          value = *it;
+          failure = evaluation;
+          shrinks++;
+          shrunk = true;
+          break;
+        }
+      }
+    }
+
+    std::string message = "Falsified after " + std::to_string(index + 1) + " cases (seed " +
+                          std::to_string(seed) + ", shrunk " + std::to_string(shrinks) + " times) by " +
+                          generator.print(value);
+
+    if (failure.message() != nullptr)
+      message += std::string(": ") + failure.message();
+
+    result.failed(failure.file(), failure.line(), message.c_str());
+    return false;
+  }
+
+  /**
+   * @param index index of a value
+   * @return size to generate the value with; sizes grow over the
+   *         first half of the cases and stay at the maximum afterwards
+   */
+  inline unsigned int Property::size(std::size_t index) const
+  {
+    return static_cast<unsigned int>(std::min<std::size_t>(100, index * 200 / std::max<std::size_t>(cases_, 1)));
+  }
+
+  /**
+   * The default constructor creates an Evaluation that did not fail.
+   */
+  inline Property::Evaluation::Evaluation()
+    : file_(nullptr),
+      line_(0),
+      message_(),
+      failed_(false),
+      checked_file_(nullptr),
+      checked_line_(0)
+  {
+  }
+
+  /**
+   * @copydoc TestResult::startTest
+   */
+  inline void Property::Evaluation::startTest(char const*)
+  {
+  }
+
+  /**
+   * @copydoc TestResult::endTest
+   */
+  inline void Property::Evaluation::endTest()
+  {
+  }
+
+  /**
+   * @copydoc TestResult::startTestFunction
+   */
+  inline void Property::Evaluation::startTestFunction(char const*)
+  {
+  }
+
+  /**
+   * @copydoc TestResult::endTestFunction
+   */
+  inline void Property::Evaluation::endTestFunction(Measurement const&)
+  {
+  }
+
+  /**
+   * @copydoc TestResult::checked
+   */
+  inline void Property::Evaluation::checked(char const* file, int line)
+  {
+    if (checked_file_ == nullptr)
+    {
+      checked_file_ = file;
+      checked_line_ = line;
+    }
+  }
+
+  /**
+   * @copydoc TestResult::failed
+   */
+  inline void Property::Evaluation::failed(char const* file, int line, char const* message)
+  {
+    // only the first failure is of interest
+    if (!failed_)
+    {
+      file_ = file;
+      line_ = line;
+      message_ = message != nullptr ? message : "";
+      failed_ = true;
+    }
+  }
+
+  /**
+   * @param property property to evaluate
+   * @param value value to evaluate the property for
+   * @return true if the property does not hold, false if it does
+   */
+  template<typename T>
+  inline bool Property::Evaluation::evaluate(std::function<void(TestResult&, T const&)> const& property,
+                                             T const& value)
+  {
+#ifdef TST_SITE_COUNTERS
+    // the property counts as a single assertion, however many values it
+    // is evaluated for
+    std::uint64_t outer = Sites::take();
+#endif
+#ifdef TST_FATAL_LONGJMP
+    std::jmp_buf target;
+    std::jmp_buf* previous = Fatal::exchange(&target);
+
+    if (setjmp(target) == 0)
+#endif
+    {
+      TSTTRY
+      {
+        property(*this, value);
+      }
+      TSTCATCH(FatalFailure const& failure)
+      {
+      }
+      TSTCATCH(...)
+      {
+        failed(__FILE__, __LINE__, "Unexpected exception");
+      }
+    }
+
+#ifdef TST_FATAL_LONGJMP
+    Fatal::exchange(previous);
+#endif
+#ifdef TST_SITE_COUNTERS
+    Sites::take();
+    Sites::credit(outer);
+#endif
+    return failed_;
+  }
+
+  /**
+   * @return file of the first failed assertion
+   */
+  inline char const* Property::Evaluation::file() const
+  {
+    return file_;
+  }
+
+  /**
+   * @return line of the first failed assertion
+   */
+  inline int Property::Evaluation::line() const
+  {
+    return line_;
+  }
+
+  /**
+   * @return message of the first failed assertion, or null if it had
+   *         none
+   */
+  inline char const* Property::Evaluation::message() const
+  {
+    return failed_ && !message_.empty() ? message_.c_str() : nullptr;
+  }
+
+  /**
+   * @return file of the first assertion checked, or null
+   */
+  inline char const* Property::Evaluation::checkedFile() const
+  {
+    return checked_file_;
+  }
+
+  /**
+   * @return line of the first assertion checked
+   */
+  inline int Property::Evaluation::checkedLine() const
+  {
+    return checked_line_;
+  }
+}
+
+#endif
+
+#endif
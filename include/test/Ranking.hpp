@@ -0,0 +1,120 @@
+// Ranking.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTRANKING_HPP
+#define TSTRANKING_HPP
+
+
+namespace tst
+{
+  /**
+   * A Ranking keeps the entries with the highest keys out of all
+   * entries offered to it, sorted in descending order. It uses a fixed
+   * (user-sizable) storage and never allocates.
+   */
+  template<typename T, unsigned int MAX_ENTRIES>
+  class Ranking
+  {
+  public:
+    Ranking();
+
+    void offer(unsigned long long key, T const& entry);
+
+    unsigned int size() const;
+
+    T const& operator [](unsigned int index) const;
+    unsigned long long key(unsigned int index) const;
+
+  private:
+    struct Slot
+    {
+      unsigned long long key;
+      T entry;
+    };
+
+    Slot slots_[MAX_ENTRIES];
+    unsigned int size_;
+  };
+}
+
+namespace tst
+{
+  /**
+   * The default constructor creates an empty Ranking.
+   */
+  template<typename T, unsigned int MAX_ENTRIES>
+  inline Ranking<T, MAX_ENTRIES>::Ranking()
+    : size_(0)
+  {
+  }
+
+  /**
+   * Offer an entry to the ranking. It is kept if its key is among the
+   * 'MAX_ENTRIES' highest keys seen so far.
+   * @param key key to rank the entry by
+   * @param entry entry to offer
+   */
+  template<typename T, unsigned int MAX_ENTRIES>
+  inline void Ranking<T, MAX_ENTRIES>::offer(unsigned long long key, T const& entry)
+  {
+    if (size_ == MAX_ENTRIES && key <= slots_[size_ - 1].key)
+      return;
+
+    unsigned int index = size_ < MAX_ENTRIES ? size_++ : size_ - 1;
+
+    // move smaller entries down to make room, keeping the order stable
+    for (; index > 0 && slots_[index - 1].key < key; --index)
+      slots_[index] = slots_[index - 1];
+
+    slots_[index].key = key;
+    slots_[index].entry = entry;
+  }
+
+  /**
+   * @return number of entries in the ranking
+   */
+  template<typename T, unsigned int MAX_ENTRIES>
+  inline unsigned int Ranking<T, MAX_ENTRIES>::size() const
+  {
+    return size_;
+  }
+
+  /**
+   * @param index rank of the entry to retrieve (zero is the highest)
+   * @return the entry at the given rank
+   */
+  template<typename T, unsigned int MAX_ENTRIES>
+  inline T const& Ranking<T, MAX_ENTRIES>::operator [](unsigned int index) const
+  {
+    return slots_[index].entry;
+  }
+
+  /**
+   * @param index rank of the entry to retrieve the key of
+   * @return the key of the entry at the given rank
+   */
+  template<typename T, unsigned int MAX_ENTRIES>
+  inline unsigned long long Ranking<T, MAX_ENTRIES>::key(unsigned int index) const
+  {
+    return slots_[index].key;
+  }
+}
+
+
+#endif
@@ -0,0 +1,300 @@
+// RecordingResult.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTRECORDINGRESULT_HPP
+#define TSTRECORDINGRESULT_HPP
+
+#include <cstring>
+#include <vector>
+
+#include "Allocations.hpp"
+#include "TestResult.hpp"
+
+
+namespace tst
+{
+  /**
+   * A TestResult that does not evaluate anything itself but records all
+   * events it receives so that they can be replayed into another
+   * TestResult later on. This way tests can run in isolation (e.g., on
+   * a different thread) and still report to a single result object in
+   * a well defined order.
+   *
+   * Recording events allocates memory, which is hidden from the
+   * allocation figures of the test functions (see Allocations).
+   */
+  class RecordingResult: public TestResult
+  {
+  public:
+    RecordingResult();
+
+    RecordingResult(RecordingResult&&) = default;
+    RecordingResult(RecordingResult const&) = delete;
+
+    RecordingResult& operator =(RecordingResult&&) = default;
+    RecordingResult& operator =(RecordingResult const&) = delete;
+
+    virtual void startTest(char const* test) override;
+    virtual void endTest() override;
+
+    virtual void startTestFunction(char const* function) override;
+    virtual void endTestFunction(Measurement const& measurement) override;
+
+    virtual void checked(char const* file, int line) override;
+    virtual void failed(char const* file, int line, char const* message) override;
+
+    void checked(char const* file, int line, unsigned int count);
+
+    void replay(TestResult& result) const;
+    void clear();
+
+    bool empty() const;
+
+  private:
+    enum Type
+    {
+      StartTest,
+      EndTest,
+      StartTestFunction,
+      EndTestFunction,
+      Checked,
+      Failed,
+    };
+
+    /*
+     * Strings passed in with a failure are copied into our string
+     * buffer and referenced by offset, so that they remain valid
+     * regardless of what the test does with them afterwards.
+     */
+    static unsigned int const NoString = static_cast<unsigned int>(-1);
+
+    struct Event
+    {
+      Type type;
+      int line;
+      union
+      {
+        char const* text;
+        unsigned int offset;
+      } file;
+      unsigned int message;
+      unsigned int count;
+    };
+
+    std::vector<Event> events_;
+    std::vector<Measurement> measurements_;
+    std::vector<char> strings_;
+
+    unsigned int store(char const* string);
+    char const* string(unsigned int offset) const;
+  };
+}
+
+namespace tst
+{
+  /**
+   * The default constructor creates an empty RecordingResult object.
+   */
+  inline RecordingResult::RecordingResult()
+    : events_(),
+      measurements_(),
+      strings_()
+  {
+  }
+
+  /**
+   * @copydoc TestResult::startTest
+   */
+  inline void RecordingResult::startTest(char const* test)
+  {
+    Allocations::Ignore ignore;
+
+    Event event = {StartTest, 0, {test}, NoString, 0};
+    events_.push_back(event);
+  }
+
+  /**
+   * @copydoc TestResult::endTest
+   */
+  inline void RecordingResult::endTest()
+  {
+    Allocations::Ignore ignore;
+
+    Event event = {EndTest, 0, {nullptr}, NoString, 0};
+    events_.push_back(event);
+  }
+
+  /**
+   * @copydoc TestResult::startTestFunction
+   */
+  inline void RecordingResult::startTestFunction(char const* function)
+  {
+    Allocations::Ignore ignore;
+
+    Event event = {StartTestFunction, 0, {function}, NoString, 0};
+    events_.push_back(event);
+  }
+
+  /**
+   * @copydoc TestResult::endTestFunction
+   */
+  inline void RecordingResult::endTestFunction(Measurement const& measurement)
+  {
+    Allocations::Ignore ignore;
+
+    // measurements are stored separately, the event refers to them by
+    // index
+    Event event = {EndTestFunction, 0, {nullptr}, NoString,
+                   static_cast<unsigned int>(measurements_.size())};
+    events_.push_back(event);
+    measurements_.push_back(measurement);
+  }
+
+  /**
+   * @copydoc TestResult::checked
+   */
+  inline void RecordingResult::checked(char const* file, int line)
+  {
+    checked(file, line, 1);
+  }
+
+  /**
+   * Record a number of assertion checks at once.
+   * @param file file in which the assertions were checked
+   * @param line line in which the assertions were checked
+   * @param count number of checks to record
+   * @note the string 'file' is not copied, it has to stay valid until
+   *       the events are replayed
+   */
+  inline void RecordingResult::checked(char const* file, int line, unsigned int count)
+  {
+    // assertions in loops hit the same location over and over again, we
+    // only store a counter for them instead of individual events
+    if (!events_.empty())
+    {
+      Event& last = events_.back();
+
+      if (last.type == Checked && last.file.text == file && last.line == line)
+      {
+        last.count += count;
+        return;
+      }
+    }
+
+    Allocations::Ignore ignore;
+
+    Event event = {Checked, line, {file}, NoString, count};
+    events_.push_back(event);
+  }
+
+  /**
+   * @copydoc TestResult::failed
+   */
+  inline void RecordingResult::failed(char const* file, int line, char const* message)
+  {
+    Allocations::Ignore ignore;
+
+    Event event = {Failed, line, {nullptr}, store(message), 0};
+    event.file.offset = store(file);
+    events_.push_back(event);
+  }
+
+  /**
+   * Replay all recorded events, in the order they were received, into
+   * the given result object.
+   * @param result result object to replay the events into
+   */
+  inline void RecordingResult::replay(TestResult& result) const
+  {
+    for (auto it = events_.begin(); it != events_.end(); ++it)
+    {
+      switch (it->type)
+      {
+      case StartTest:
+        result.startTest(it->file.text);
+        break;
+
+      case EndTest:
+        result.endTest();
+        break;
+
+      case StartTestFunction:
+        result.startTestFunction(it->file.text);
+        break;
+
+      case EndTestFunction:
+        result.endTestFunction(measurements_[it->count]);
+        break;
+
+      case Checked:
+        for (unsigned int i = 0; i < it->count; ++i)
+          result.checked(it->file.text, it->line);
+        break;
+
+      case Failed:
+        result.failed(string(it->file.offset), it->line, string(it->message));
+        break;
+      }
+    }
+  }
+
+  /**
+   * Remove all recorded events and release the memory they occupied.
+   */
+  inline void RecordingResult::clear()
+  {
+    std::vector<Event>().swap(events_);
+    std::vector<Measurement>().swap(measurements_);
+    std::vector<char>().swap(strings_);
+  }
+
+  /**
+   * @return true if no events have been recorded, false otherwise
+   */
+  inline bool RecordingResult::empty() const
+  {
+    return events_.empty();
+  }
+
+  /**
+   * @param string string to store (may be null)
+   * @return offset of the copy in our string buffer
+   */
+  inline unsigned int RecordingResult::store(char const* string)
+  {
+    if (string == nullptr)
+      return NoString;
+
+    unsigned int offset = static_cast<unsigned int>(strings_.size());
+    strings_.insert(strings_.end(), string, string + std::strlen(string) + 1);
+    return offset;
+  }
+
+  /**
+   * @param offset offset of a string as returned by 'store'
+   * @return pointer to the stored string or null
+   */
+  inline char const* RecordingResult::string(unsigned int offset) const
+  {
+    return offset != NoString ? &strings_[offset] : nullptr;
+  }
+}
+
+
+#endif
@@ -0,0 +1,213 @@
+// Schedule.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+#ifndef TSTSCHEDULE_HPP
+#define TSTSCHEDULE_HPP
+
+#include <algorithm>
+#include <vector>
+
+#include "History.hpp"
+#include "TestBase.hpp"
+#include "TestCaseBase.hpp"
+#include "TestVisitor.hpp"
+
+
+namespace tst
+{
+  /**
+   * A Schedule determines the order in which tests are run, based on
+   * the History of previous runs. Tests that failed last time can be
+   * run first, so that a regression that is not fixed yet is reported
+   * right away, and the longest tests can be run first, which minimizes
+   * the total duration of a parallel run. Tests without any record are
+   * assumed to take as long as the average test.
+   *
+   * A schedule is used by the TestSuite, the ParallelRunner, and the
+   * ForkRunner. They reorder whole test cases only: the functions of a
+   * case always run in the order they were declared in.
+   */
+  class Schedule
+  {
+  public:
+    enum Order
+    {
+      FailedFirst = 1,
+      LongestFirst = 2,
+    };
+
+    /** The expected outcome of a test. */
+    struct Estimate
+    {
+      bool failed;
+      double seconds;
+    };
+
+    Schedule(History const& history, unsigned int order = FailedFirst | LongestFirst);
+
+    unsigned int order() const;
+
+    Estimate estimate(TestBase& test) const;
+    std::vector<std::size_t> arrange(std::vector<Estimate> const& estimates) const;
+
+  private:
+    class Collector: public TestVisitor
+    {
+    public:
+      Collector(History const& history, double average);
+
+      virtual void visit(TestBase& test) override;
+      virtual void visit(TestCaseBase& test) override;
+
+      Estimate const& estimate() const;
+
+    private:
+      History const* history_;
+      double average_;
+      Estimate estimate_;
+    };
+
+    History const* history_;
+    unsigned int order_;
+    double average_;
+  };
+}
+
+namespace tst
+{
+  /**
+   * @param history history of previous runs
+   * @param order combination of Order flags; tests that compare equal
+   *        stay in the order they were added in
+   */
+  inline Schedule::Schedule(History const& history, unsigned int order)
+    : history_(&history),
+      order_(order),
+      average_(history.average())
+  {
+  }
+
+  /**
+   * @return combination of Order flags used for arranging tests
+   */
+  inline unsigned int Schedule::order() const
+  {
+    return order_;
+  }
+
+  /**
+   * @param test test (typically a test case) to estimate
+   * @return whether any of the selected functions of the test failed in
+   *         the last run and how long running all of them is expected
+   *         to take
+   */
+  inline Schedule::Estimate Schedule::estimate(TestBase& test) const
+  {
+    Collector collector(*history_, average_);
+    test.accept(collector);
+    return collector.estimate();
+  }
+
+  /**
+   * @param estimates list of estimates, one per test to arrange
+   * @return list of indices into the given list, in the order in which
+   *         the tests are to be run
+   */
+  inline std::vector<std::size_t> Schedule::arrange(std::vector<Estimate> const& estimates) const
+  {
+    std::vector<std::size_t> order(estimates.size());
+
+    for (std::size_t i = 0; i < order.size(); ++i)
+      order[i] = i;
+
+    unsigned int flags = order_;
+
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t lhs, std::size_t rhs)
+    {
+      Estimate const& left = estimates[lhs];
+      Estimate const& right = estimates[rhs];
+
+      if ((flags & FailedFirst) != 0 && left.failed != right.failed)
+        return left.failed;
+
+      return (flags & LongestFirst) != 0 && left.seconds > right.seconds;
+    });
+    return order;
+  }
+
+  /**
+   * @param history history of previous runs
+   * @param average duration assumed for tests without any record
+   */
+  inline Schedule::Collector::Collector(History const& history, double average)
+    : history_(&history),
+      average_(average),
+      estimate_()
+  {
+  }
+
+  /**
+   * @copydoc TestVisitor::visit
+   */
+  inline void Schedule::Collector::visit(TestBase&)
+  {
+    estimate_.seconds += average_;
+  }
+
+  /**
+   * @copydoc TestVisitor::visit
+   */
+  inline void Schedule::Collector::visit(TestCaseBase& test)
+  {
+    History::Key key = History::key(test.name());
+    double average = average_;
+
+    history_->duration(key, average);
+    estimate_.failed = estimate_.failed || history_->failed(key);
+
+    for (unsigned int i = 0; i < test.functionCount(); ++i)
+    {
+      if (!test.functionSelected(i))
+        continue;
+
+      char const* name = test.functionName(i);
+      double seconds = average;
+
+      if (name != nullptr)
+      {
+        key = History::key(test.name(), name);
+
+        history_->duration(key, seconds);
+        estimate_.failed = estimate_.failed || history_->failed(key);
+      }
+
+      estimate_.seconds += seconds;
+    }
+  }
+
+  /**
+   * @return estimate of all tests visited so far
+   */
+  inline Schedule::Estimate const& Schedule::Collector::estimate() const
+  {
+    return estimate_;
+  }
+}
+
+
+#endif
@@ -0,0 +1,301 @@
+// Shard.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTSHARD_HPP
+#define TSTSHARD_HPP
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "History.hpp"
+#include "TestBase.hpp"
+#include "TestCaseBase.hpp"
+#include "TestVisitor.hpp"
+
+
+namespace tst
+{
+  /**
+   * A Shard describes a slice of a test run that is split across
+   * multiple machines. Applying a shard to a tree of tests deselects
+   * all test functions not belonging to it.
+   *
+   * The partitioning is deterministic: given the same tests (and the
+   * same history) every node computes the same assignment of functions
+   * to shards, so that the shards are disjoint and together cover all
+   * selected functions.
+   */
+  class Shard
+  {
+  public:
+    Shard(unsigned int index = 0, unsigned int count = 1);
+
+    static Shard fromEnvironment();
+    static Shard fromArguments(int argc, char const* const* argv);
+
+    unsigned int index() const;
+    unsigned int count() const;
+
+    void apply(TestBase& test, History const* history = nullptr) const;
+
+  private:
+    struct Item
+    {
+      TestBase* test;
+      TestCaseBase* testCase;
+      unsigned int function;
+      double weight;
+      bool known;
+    };
+
+    typedef std::vector<Item> Items;
+
+    class Collector: public TestVisitor
+    {
+    public:
+      Collector(Items& items, History const* history);
+
+      virtual void visit(TestBase& test) override;
+      virtual void visit(TestCaseBase& test) override;
+
+    private:
+      Items* items_;
+      History const* history_;
+    };
+
+    unsigned int index_;
+    unsigned int count_;
+
+    static bool parse(char const* index, char const* count, Shard& shard);
+  };
+}
+
+namespace tst
+{
+  /**
+   * @param index index of this shard (has to be less than 'count')
+   * @param count total number of shards
+   */
+  inline Shard::Shard(unsigned int index, unsigned int count)
+    : index_(count > 0 && index < count ? index : 0),
+      count_(count > 0 && index < count ? count : 1)
+  {
+  }
+
+  /**
+   * Create a shard from the environment variables TST_SHARD_INDEX and
+   * TST_SHARD_COUNT.
+   * @return the shard described by the environment or a shard
+   *         containing all tests if the variables are not set (or
+   *         invalid)
+   */
+  inline Shard Shard::fromEnvironment()
+  {
+    Shard shard;
+    parse(std::getenv("TST_SHARD_INDEX"), std::getenv("TST_SHARD_COUNT"), shard);
+    return shard;
+  }
+
+  /**
+   * Create a shard from a command line argument of the form
+   * "--shard=<index>/<count>". If no such argument is present, the
+   * environment is consulted as done by 'fromEnvironment'.
+   * @param argc number of arguments
+   * @param argv list of arguments, as passed to main
+   * @return the shard described by the command line
+   */
+  inline Shard Shard::fromArguments(int argc, char const* const* argv)
+  {
+    static char const prefix[] = "--shard=";
+
+    for (int i = 1; i < argc; ++i)
+    {
+      if (std::strncmp(argv[i], prefix, sizeof(prefix) - 1) != 0)
+        continue;
+
+      char const* index = argv[i] + sizeof(prefix) - 1;
+      char const* count = std::strchr(index, '/');
+      Shard shard;
+
+      if (count != nullptr && parse(index, count + 1, shard))
+        return shard;
+    }
+    return fromEnvironment();
+  }
+
+  /**
+   * @return index of this shard
+   */
+  inline unsigned int Shard::index() const
+  {
+    return index_;
+  }
+
+  /**
+   * @return total number of shards
+   */
+  inline unsigned int Shard::count() const
+  {
+    return count_;
+  }
+
+  /**
+   * Deselect all currently selected tests and test functions that do
+   * not belong to this shard.
+   *
+   * Functions are weighted by their recorded duration if a history is
+   * given (falling back to the average duration of their test case's
+   * functions and then to the average of all recorded durations), and
+   * by one otherwise. They are handed out, heaviest first, to the shard
+   * with the least total weight so far. Without a history this
+   * degenerates to a round robin assignment.
+   * @param test root of the tree of tests to apply the shard to
+   * @param history optional history of previous runs
+   */
+  inline void Shard::apply(TestBase& test, History const* history) const
+  {
+    if (count_ <= 1)
+      return;
+
+    Items items;
+    Collector collector(items, history);
+    test.accept(collector);
+
+    double total = 0.0;
+    std::size_t known = 0;
+
+    for (auto it = items.begin(); it != items.end(); ++it)
+    {
+      if (it->known)
+      {
+        total += it->weight;
+        known++;
+      }
+    }
+
+    double average = known > 0 ? total / known : 1.0;
+    std::vector<std::size_t> order(items.size());
+
+    for (std::size_t i = 0; i < items.size(); ++i)
+    {
+      if (!items[i].known)
+        items[i].weight = average;
+
+      order[i] = i;
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&items](std::size_t lhs, std::size_t rhs)
+    {
+      return items[lhs].weight > items[rhs].weight;
+    });
+
+    std::vector<double> loads(count_, 0.0);
+
+    for (auto it = order.begin(); it != order.end(); ++it)
+    {
+      Item const& item = items[*it];
+      auto least = std::min_element(loads.begin(), loads.end());
+
+      *least += item.weight;
+
+      if (static_cast<unsigned int>(least - loads.begin()) == index_)
+        continue;
+
+      if (item.testCase != nullptr)
+        item.testCase->selectFunction(item.function, false);
+      else
+        item.test->select(false);
+    }
+  }
+
+  /**
+   * @param index string representation of the shard index (may be null)
+   * @param count string representation of the shard count (may be null)
+   * @param shard shard to assign the parsed values to
+   * @return true if both values were valid, false otherwise
+   */
+  inline bool Shard::parse(char const* index, char const* count, Shard& shard)
+  {
+    if (index == nullptr || count == nullptr)
+      return false;
+
+    char* end = nullptr;
+    unsigned long i = std::strtoul(index, &end, 10);
+
+    if (end == index || (*end != '\0' && *end != '/'))
+      return false;
+
+    unsigned long c = std::strtoul(count, &end, 10);
+
+    if (end == count || *end != '\0' || c == 0 || i >= c)
+      return false;
+
+    shard = Shard(static_cast<unsigned int>(i), static_cast<unsigned int>(c));
+    return true;
+  }
+
+  /**
+   * @param items list of items to add collected items to
+   * @param history optional history to look up weights in
+   */
+  inline Shard::Collector::Collector(Items& items, History const* history)
+    : items_(&items),
+      history_(history)
+  {
+  }
+
+  /**
+   * @copydoc TestVisitor::visit
+   */
+  inline void Shard::Collector::visit(TestBase& test)
+  {
+    Item item = {&test, nullptr, 0, 1.0, false};
+    items_->push_back(item);
+  }
+
+  /**
+   * @copydoc TestVisitor::visit
+   */
+  inline void Shard::Collector::visit(TestCaseBase& test)
+  {
+    double average = 1.0;
+    bool known = history_ != nullptr &&
+                 history_->duration(History::key(test.name()), average);
+
+    for (unsigned int i = 0; i < test.functionCount(); ++i)
+    {
+      if (!test.functionSelected(i))
+        continue;
+
+      char const* name = test.functionName(i);
+      Item item = {&test, &test, i, average, known};
+
+      if (history_ != nullptr && name != nullptr &&
+          history_->duration(History::key(test.name(), name), item.weight))
+        item.known = true;
+
+      items_->push_back(item);
+    }
+  }
+}
+
+
+#endif
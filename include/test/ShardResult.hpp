@@ -0,0 +1,196 @@
+// ShardResult.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTSHARDRESULT_HPP
+#define TSTSHARDRESULT_HPP
+
+#include "Shard.hpp"
+#include "TestResult.hpp"
+
+
+namespace tst
+{
+  /**
+   * A TestResult that writes a machine readable record of a shard's
+   * results to a stream and forwards all events to another TestResult.
+   * The records of all shards of a run can be combined into a single
+   * summary with the merge-shards tool.
+   *
+   * The record is line based with tab separated fields:
+   * @code
+   * tst-shard  <version>  <index>  <count>
+   * test       <name>
+   * failed     <file>  <line>  [<message>]
+   * function   <name>  <assertions checked>  <wall>  <cpu>  <set up>  <tear down>
+   * endtest
+   * @endcode
+   * Failures belong to the function line following them. Times are
+   * given in nanoseconds.
+   */
+  template<typename T>
+  class ShardResult: public TestResult
+  {
+  public:
+    ShardResult(T& printer, TestResult& result, Shard const& shard);
+
+    virtual void startTest(char const* test) override;
+    virtual void endTest() override;
+
+    virtual void startTestFunction(char const* function) override;
+    virtual void endTestFunction(Measurement const& measurement) override;
+
+    virtual void checked(char const* file, int line) override;
+    virtual void failed(char const* file, int line, char const* message) override;
+
+    virtual bool stopped() const override;
+
+  private:
+    T* printer_;
+    TestResult* result_;
+
+    char const* function_;
+    unsigned long checked_;
+
+    void print(char const* string);
+  };
+}
+
+namespace tst
+{
+  /**
+   * @param printer stream to write the record to
+   * @param result result object to forward all events to
+   * @param shard the shard that is being run
+   */
+  template<typename T>
+  inline ShardResult<T>::ShardResult(T& printer, TestResult& result, Shard const& shard)
+    : printer_(&printer),
+      result_(&result),
+      function_(nullptr),
+      checked_(0)
+  {
+    (*printer_) << "tst-shard\t1\t" << shard.index() << '\t' << shard.count() << '\n';
+  }
+
+  /**
+   * @copydoc TestResult::startTest
+   */
+  template<typename T>
+  void ShardResult<T>::startTest(char const* test)
+  {
+    (*printer_) << "test\t";
+    print(test);
+    (*printer_) << '\n';
+
+    result_->startTest(test);
+  }
+
+  /**
+   * @copydoc TestResult::endTest
+   */
+  template<typename T>
+  void ShardResult<T>::endTest()
+  {
+    (*printer_) << "endtest\n";
+    result_->endTest();
+  }
+
+  /**
+   * @copydoc TestResult::startTestFunction
+   */
+  template<typename T>
+  void ShardResult<T>::startTestFunction(char const* function)
+  {
+    function_ = function;
+    checked_ = 0;
+    result_->startTestFunction(function);
+  }
+
+  /**
+   * @copydoc TestResult::endTestFunction
+   */
+  template<typename T>
+  void ShardResult<T>::endTestFunction(Measurement const& measurement)
+  {
+    (*printer_) << "function\t";
+    print(function_);
+    (*printer_) << '\t' << checked_ + measurement.checked << '\t' << measurement.wall << '\t'
+                << measurement.cpu << '\t' << measurement.set_up << '\t'
+                << measurement.tear_down << '\n';
+    result_->endTestFunction(measurement);
+  }
+
+  /**
+   * @copydoc TestResult::checked
+   */
+  template<typename T>
+  void ShardResult<T>::checked(char const* file, int line)
+  {
+    checked_++;
+    result_->checked(file, line);
+  }
+
+  /**
+   * @copydoc TestResult::failed
+   */
+  template<typename T>
+  void ShardResult<T>::failed(char const* file, int line, char const* message)
+  {
+    (*printer_) << "failed\t";
+    print(file);
+    (*printer_) << '\t' << line;
+
+    if (message != nullptr)
+    {
+      (*printer_) << '\t';
+      print(message);
+    }
+
+    (*printer_) << '\n';
+
+    result_->failed(file, line, message);
+  }
+
+  /**
+   * @copydoc TestResult::stopped
+   */
+  template<typename T>
+  bool ShardResult<T>::stopped() const
+  {
+    return result_->stopped();
+  }
+
+  /**
+   * Print a string, replacing the characters that have a special
+   * meaning in the record format.
+   * @param string string to print (may be null)
+   */
+  template<typename T>
+  void ShardResult<T>::print(char const* string)
+  {
+    if (string == nullptr)
+      return;
+
+    for (; *string != '\0'; ++string)
+      (*printer_) << (*string == '\t' || *string == '\n' ? ' ' : *string);
+  }
+}
+
+
+#endif
@@ -0,0 +1,179 @@
+// Sites.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTSITES_HPP
+#define TSTSITES_HPP
+
+#include <atomic>
+#include <cstdint>
+
+
+namespace tst
+{
+  /**
+   * A single assertion site, i.e., a place in the source code where an
+   * assertion is checked.
+   */
+  struct Site
+  {
+    char const* file;
+    int line;
+    /* True once the site was executed. */
+    std::atomic<bool> listed;
+    Site* next;
+  };
+
+
+  /**
+   * Sites keeps track of the assertion sites of a program when
+   * TST_SITE_COUNTERS is defined. In this mode a passing assertion does
+   * not call 'TestResult::checked' but merely increments a counter of
+   * the thread checking it; only failures are reported to the
+   * TestResult. Test functions take the difference of the counter
+   * between their start and end and report it as part of their
+   * Measurement, from where results pick it up. Threads checking
+   * assertions on behalf of a test function (as Stress and Property
+   * do) hand their counts over using 'take' and 'credit'.
+   *
+   * Sites register themselves at runtime, once they are executed for
+   * the first time. Sites are not collected at link time (e.g., in a
+   * dedicated section), because compilers cannot place sites of inline
+   * functions and templates into the same section as the others, so
+   * sites that never executed are not known.
+   */
+  class Sites
+  {
+  public:
+    static void hit(Site& site);
+    static void list(Site& site);
+
+    static std::uint64_t take();
+    static void credit(std::uint64_t checked);
+
+    static Site* executed();
+
+  private:
+    static std::atomic<Site*>& head();
+    static std::uint64_t& counter();
+  };
+
+
+  /** @cond never */
+#ifdef TST_SITE_COUNTERS
+  #define TSTCHECKED()\
+    do\
+    {\
+      static tst::Site tst_site = {__FILE__, __LINE__, {false}, nullptr};\
+      tst::Sites::hit(tst_site);\
+    } while (false)
+#else
+  #define TSTCHECKED()\
+    result.checked(__FILE__, __LINE__)
+#endif
+  /** @endcond never */
+}
+
+namespace tst
+{
+  /**
+   * Count the execution of an assertion site.
+   * @param site site that was executed
+   */
+  inline void Sites::hit(Site& site)
+  {
+    counter()++;
+
+    if (!site.listed.load(std::memory_order_relaxed))
+      list(site);
+  }
+
+  /**
+   * @return number of assertions checked by the calling thread since
+   *         the last call; the count starts over at zero
+   */
+  inline std::uint64_t Sites::take()
+  {
+    std::uint64_t& counter = Sites::counter();
+    std::uint64_t checked = counter;
+
+    counter = 0;
+    return checked;
+  }
+
+  /**
+   * Account for assertions checked elsewhere, e.g., by another thread,
+   * as if the calling thread checked them.
+   * @param checked number of assertions checked
+   */
+  inline void Sites::credit(std::uint64_t checked)
+  {
+    counter() += checked;
+  }
+
+  /**
+   * @return the first site in the list of sites that were executed;
+   *         the remaining ones can be reached through 'Site::next'
+   */
+  inline Site* Sites::executed()
+  {
+    return head().load(std::memory_order_acquire);
+  }
+
+  /**
+   * @return the head of the list of executed sites
+   */
+  inline std::atomic<Site*>& Sites::head()
+  {
+    static std::atomic<Site*> head(nullptr);
+    return head;
+  }
+
+  /**
+   * @return the counter of assertions checked by the calling thread
+   */
+  inline std::uint64_t& Sites::counter()
+  {
+    static thread_local std::uint64_t counter = 0;
+    return counter;
+  }
+
+  /**
+   * Add a site to the list of executed sites, unless it is listed
+   * already, e.g., because it was executed in another process.
+   * @param site site to list
+   */
+  inline void Sites::list(Site& site)
+  {
+    if (site.listed.exchange(true))
+      return;
+
+    std::atomic<Site*>& head = Sites::head();
+    Site* next = head.load(std::memory_order_relaxed);
+
+    do
+    {
+      site.next = next;
+    } while (!head.compare_exchange_weak(next, &site,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed));
+  }
+}
+
+
+#endif
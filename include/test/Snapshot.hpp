@@ -0,0 +1,493 @@
+// Snapshot.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+#ifndef TSTSNAPSHOT_HPP
+#define TSTSNAPSHOT_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Allocations.hpp"
+#include "Compare.hpp"
+#include "Sites.hpp"
+
+
+namespace tst
+{
+  /**
+   * Snapshot compares data with golden files, e.g., the output of a
+   * serializer with a reference file kept alongside the tests. Golden
+   * files are mapped into memory and compared in place, so that even
+   * very large ones cost neither a copy nor an allocation; files that
+   * cannot be mapped are streamed in chunks.
+   *
+   * In update mode golden files that do not match, or do not exist, are
+   * replaced by the data they are compared with and no assertion fails.
+   * A new golden file is written to a temporary file next to it, which
+   * is renamed once complete, so that an interrupted update never
+   * leaves a truncated golden file behind.
+   */
+  class Snapshot
+  {
+  public:
+    /**
+     * A Mapping makes the contents of a file available in memory,
+     * mapping it if possible and reading it otherwise.
+     */
+    class Mapping
+    {
+    public:
+      explicit Mapping(char const* path);
+      ~Mapping();
+
+      Mapping(Mapping&&) = delete;
+      Mapping(Mapping const&) = delete;
+
+      Mapping& operator =(Mapping&&) = delete;
+      Mapping& operator =(Mapping const&) = delete;
+
+      bool valid() const;
+      void const* data() const;
+      std::size_t size() const;
+
+    private:
+      void* address_;
+      std::size_t size_;
+      std::vector<unsigned char> buffer_;
+      bool valid_;
+    };
+
+    static bool check(char const* path, void const* data, std::size_t size, char* message, std::size_t length);
+    static bool checkFile(char const* path, char const* actual, char* message, std::size_t length);
+
+    static bool write(char const* path, void const* data, std::size_t size);
+
+    static bool update();
+    static void setUpdate(bool update);
+
+    static bool updateRequested(int argc, char const* const* argv);
+
+  private:
+    static bool compare(int fd,
+                        unsigned char const* data,
+                        std::size_t size,
+                        Compare::Mismatch& mismatch,
+                        std::uint64_t& golden);
+
+    static std::atomic<bool>& updating();
+  };
+
+
+  /**
+   * Test that data matches the contents of a golden file. If it does
+   * not, the first differing offset and the bytes around it are
+   * reported. In update mode (see Snapshot) the golden file is replaced
+   * instead.
+   * @param path_ path to the golden file
+   * @param data_ pointer to the data
+   * @param size_ size of the data, in bytes
+   */
+  #define TESTASSERTSNAPSHOT(path_, data_, size_)\
+    TSTCOMPAREIMPL(tst::Snapshot::check((path_), (data_), (size_),\
+                                        tst_message, sizeof(tst_message)))
+
+  /**
+   * Test that a file matches a golden file, e.g., one written by the
+   * code under test. Both files are mapped into memory.
+   * @param path_ path to the golden file
+   * @param file_ path to the file to check
+   */
+  #define TESTASSERTSNAPSHOTFILE(path_, file_)\
+    TSTCOMPAREIMPL(tst::Snapshot::checkFile((path_), (file_),\
+                                            tst_message, sizeof(tst_message)))
+}
+
+namespace tst
+{
+  /**
+   * @param path path to the file to make available
+   */
+  inline Snapshot::Mapping::Mapping(char const* path)
+    : address_(nullptr),
+      size_(0),
+      buffer_(),
+      valid_(false)
+  {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+      return;
+
+    struct stat status;
+
+    if (fstat(fd, &status) == 0 && S_ISREG(status.st_mode) && status.st_size > 0)
+    {
+      void* address = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+      if (address != MAP_FAILED)
+      {
+        madvise(address, status.st_size, MADV_SEQUENTIAL);
+
+        address_ = address;
+        size_ = status.st_size;
+        valid_ = true;
+        close(fd);
+        return;
+      }
+    }
+
+    Allocations::Ignore ignore;
+    unsigned char chunk[1 << 16];
+
+    for (;;)
+    {
+      ssize_t count = read(fd, chunk, sizeof(chunk));
+
+      if (count < 0 && errno == EINTR)
+        continue;
+
+      if (count <= 0)
+      {
+        valid_ = count == 0;
+        break;
+      }
+
+      buffer_.insert(buffer_.end(), chunk, chunk + count);
+    }
+
+    size_ = buffer_.size();
+    close(fd);
+  }
+
+  /**
+   * Destroy the mapping.
+   */
+  inline Snapshot::Mapping::~Mapping()
+  {
+    if (address_ != nullptr)
+      munmap(address_, size_);
+  }
+
+  /**
+   * @return true if the file could be read, false otherwise
+   */
+  inline bool Snapshot::Mapping::valid() const
+  {
+    return valid_;
+  }
+
+  /**
+   * @return pointer to the contents of the file
+   */
+  inline void const* Snapshot::Mapping::data() const
+  {
+    return address_ != nullptr ? address_ : buffer_.data();
+  }
+
+  /**
+   * @return size of the file, in bytes
+   */
+  inline std::size_t Snapshot::Mapping::size() const
+  {
+    return size_;
+  }
+
+  /**
+   * Compare data with a golden file and describe how they differ.
+   * @param path path to the golden file
+   * @param data pointer to the data
+   * @param size size of the data, in bytes
+   * @param message buffer to store a description of the differences in
+   * @param length size of the message buffer
+   * @return true if the data matches the golden file or the golden file
+   *         was updated, false otherwise
+   */
+  inline bool Snapshot::check(char const* path, void const* data, std::size_t size, char* message, std::size_t length)
+  {
+    unsigned char const* bytes = static_cast<unsigned char const*>(data);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0)
+    {
+      if (update() && write(path, data, size))
+        return true;
+
+      std::snprintf(message, length,
+                    update() ? "cannot write snapshot %s"
+                             : "snapshot %s does not exist; set TST_UPDATE_SNAPSHOTS=1 to create it",
+                    path);
+      return false;
+    }
+
+    Compare::Mismatch mismatch = {0, 0};
+    std::uint64_t golden = 0;
+
+    if (!compare(fd, bytes, size, mismatch, golden))
+    {
+      close(fd);
+      std::snprintf(message, length, "cannot read snapshot %s", path);
+      return false;
+    }
+
+    if (mismatch.count == 0 && golden == size)
+    {
+      close(fd);
+      return true;
+    }
+
+    if (update())
+    {
+      close(fd);
+
+      if (write(path, data, size))
+        return true;
+
+      std::snprintf(message, length, "cannot write snapshot %s", path);
+      return false;
+    }
+
+    std::size_t first = mismatch.count > 0 ? mismatch.first : static_cast<std::size_t>(std::min<std::uint64_t>(golden, size));
+    std::size_t used = 0;
+
+    if (mismatch.count > 0)
+      Compare::print(message, length, used, "snapshot %s differs: %zu bytes differ, first at offset %zu (0x%zx)",
+                     path, mismatch.count, first, first);
+    else
+      Compare::print(message, length, used, "snapshot %s differs in size", path);
+
+    if (golden != size)
+      Compare::print(message, length, used, "; %llu bytes expected, %zu bytes actual",
+                     static_cast<unsigned long long>(golden), size);
+
+    std::size_t begin = first > 8 ? first - 8 : 0;
+    unsigned char expected[24];
+    ssize_t count = pread(fd, expected, sizeof(expected), begin);
+
+    close(fd);
+
+    struct
+    {
+      char const* name;
+      unsigned char const* bytes;
+      std::size_t count;
+    } const windows[] = {
+      {"expected:", expected, count > 0 ? static_cast<std::size_t>(count) : 0},
+      {"actual:  ", bytes + begin, begin < size ? std::min<std::size_t>(size - begin, sizeof(expected)) : 0},
+    };
+
+    for (auto it = std::begin(windows); it != std::end(windows); ++it)
+    {
+      Compare::print(message, length, used, "\n  %s %08zx:", it->name, begin);
+
+      for (std::size_t i = 0; i < it->count; ++i)
+        Compare::print(message, length, used, begin + i == first ? " [%02x]" : " %02x", it->bytes[i]);
+    }
+    return false;
+  }
+
+  /**
+   * Compare a file with a golden file and describe how they differ.
+   * @param path path to the golden file
+   * @param actual path to the file to compare
+   * @param message buffer to store a description of the differences in
+   * @param length size of the message buffer
+   * @return true if the file matches the golden file or the golden file
+   *         was updated, false otherwise
+   */
+  inline bool Snapshot::checkFile(char const* path, char const* actual, char* message, std::size_t length)
+  {
+    Mapping mapping(actual);
+
+    if (!mapping.valid())
+    {
+      std::snprintf(message, length, "cannot read %s", actual);
+      return false;
+    }
+    return check(path, mapping.data(), mapping.size(), message, length);
+  }
+
+  /**
+   * Atomically replace a golden file. The data is written to a
+   * temporary file in the same directory, which then replaces the
+   * golden file.
+   * @param path path to the golden file
+   * @param data pointer to the data
+   * @param size size of the data, in bytes
+   * @return true if the golden file was written, false otherwise
+   */
+  inline bool Snapshot::write(char const* path, void const* data, std::size_t size)
+  {
+    Allocations::Ignore ignore;
+
+    std::string temporary(path);
+    temporary += ".XXXXXX";
+
+    int fd = mkstemp(&temporary[0]);
+    if (fd < 0)
+      return false;
+
+    unsigned char const* bytes = static_cast<unsigned char const*>(data);
+    bool success = fchmod(fd, 0644) == 0;
+
+    for (std::size_t written = 0; success && written < size;)
+    {
+      ssize_t count = ::write(fd, bytes + written, size - written);
+
+      if (count < 0 && errno == EINTR)
+        continue;
+
+      success = count > 0;
+      written += success ? count : 0;
+    }
+
+    success = fsync(fd) == 0 && success;
+    success = close(fd) == 0 && success;
+    success = success && std::rename(temporary.c_str(), path) == 0;
+
+    if (!success)
+      unlink(temporary.c_str());
+
+    return success;
+  }
+
+  /**
+   * @return true if golden files are updated instead of compared with;
+   *         initially this is the case if the environment variable
+   *         TST_UPDATE_SNAPSHOTS is set to a value other than "0"
+   */
+  inline bool Snapshot::update()
+  {
+    return updating().load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @param update true to update golden files instead of comparing with
+   *        them, false to compare
+   */
+  inline void Snapshot::setUpdate(bool update)
+  {
+    updating().store(update, std::memory_order_relaxed);
+  }
+
+  /**
+   * @param argc number of arguments
+   * @param argv list of arguments, as passed to main
+   * @return true if the command line contains "--update-snapshots" or
+   *         the environment variable TST_UPDATE_SNAPSHOTS is set to a
+   *         value other than "0", false otherwise
+   */
+  inline bool Snapshot::updateRequested(int argc, char const* const* argv)
+  {
+    for (int i = 1; i < argc; ++i)
+    {
+      if (std::strcmp(argv[i], "--update-snapshots") == 0)
+        return true;
+    }
+
+    char const* update = std::getenv("TST_UPDATE_SNAPSHOTS");
+    return update != nullptr && *update != '\0' && std::strcmp(update, "0") != 0;
+  }
+
+  /**
+   * Compare data with the contents of a file, mapping it if possible and
+   * streaming it otherwise.
+   * @param fd file descriptor of the golden file
+   * @param data pointer to the data
+   * @param size size of the data, in bytes
+   * @param mismatch set to the bytes differing within the size of both
+   * @param golden set to the size of the golden file
+   * @return true if the file could be read, false otherwise
+   */
+  inline bool Snapshot::compare(int fd,
+                                unsigned char const* data,
+                                std::size_t size,
+                                Compare::Mismatch& mismatch,
+                                std::uint64_t& golden)
+  {
+    struct stat status;
+
+    if (fstat(fd, &status) == 0 && S_ISREG(status.st_mode) && status.st_size > 0)
+    {
+      void* address = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+      if (address != MAP_FAILED)
+      {
+        madvise(address, status.st_size, MADV_SEQUENTIAL);
+
+        golden = status.st_size;
+        mismatch = Compare::bytes(address, data, std::min<std::uint64_t>(golden, size));
+
+        munmap(address, status.st_size);
+        return true;
+      }
+    }
+
+    Allocations::Ignore ignore;
+    std::vector<unsigned char> buffer(1 << 20);
+
+    for (;;)
+    {
+      ssize_t count = read(fd, buffer.data(), buffer.size());
+
+      if (count < 0 && errno == EINTR)
+        continue;
+
+      if (count < 0)
+        return false;
+
+      if (count == 0)
+        return true;
+
+      if (golden < size)
+      {
+        std::size_t common = std::min<std::uint64_t>(count, size - golden);
+        Compare::Mismatch chunk = Compare::bytes(buffer.data(), data + golden, common);
+
+        if (chunk.count > 0 && mismatch.count == 0)
+          mismatch.first = golden + chunk.first;
+
+        mismatch.count += chunk.count;
+      }
+
+      golden += count;
+    }
+  }
+
+  /**
+   * @return the flag telling whether golden files are updated
+   */
+  inline std::atomic<bool>& Snapshot::updating()
+  {
+    static std::atomic<bool> update(updateRequested(0, nullptr));
+    return update;
+  }
+}
+
+
+#endif
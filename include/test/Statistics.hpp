@@ -0,0 +1,199 @@
+// Statistics.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTSTATISTICS_HPP
+#define TSTSTATISTICS_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+
+namespace tst
+{
+  /**
+   * This class provides robust statistics over a set of samples, as
+   * gathered when measuring the run time of a piece of code.
+   */
+  class Statistics
+  {
+  public:
+    Statistics();
+    explicit Statistics(std::vector<double> samples);
+
+    std::size_t size() const;
+
+    double min() const;
+    double max() const;
+    double mean() const;
+    double median() const;
+    double mad() const;
+    double deviation() const;
+    double percentile(double percentile) const;
+
+  private:
+    /* The samples, sorted in ascending order. */
+    std::vector<double> samples_;
+    double mad_;
+
+    static double percentile(std::vector<double> const& sorted, double percentile);
+  };
+}
+
+namespace tst
+{
+  /**
+   * The default constructor creates an empty Statistics object.
+   */
+  inline Statistics::Statistics()
+    : samples_(),
+      mad_(0.0)
+  {
+  }
+
+  /**
+   * @param samples samples to compute statistics over
+   */
+  inline Statistics::Statistics(std::vector<double> samples)
+    : samples_(std::move(samples)),
+      mad_(0.0)
+  {
+    std::sort(samples_.begin(), samples_.end());
+
+    if (samples_.empty())
+      return;
+
+    double median = this->median();
+    std::vector<double> deviations;
+
+    deviations.reserve(samples_.size());
+
+    for (auto it = samples_.begin(); it != samples_.end(); ++it)
+      deviations.push_back(std::fabs(*it - median));
+
+    std::sort(deviations.begin(), deviations.end());
+    mad_ = percentile(deviations, 50.0);
+  }
+
+  /**
+   * @return number of samples
+   */
+  inline std::size_t Statistics::size() const
+  {
+    return samples_.size();
+  }
+
+  /**
+   * @return smallest sample
+   */
+  inline double Statistics::min() const
+  {
+    return samples_.empty() ? 0.0 : samples_.front();
+  }
+
+  /**
+   * @return largest sample
+   */
+  inline double Statistics::max() const
+  {
+    return samples_.empty() ? 0.0 : samples_.back();
+  }
+
+  /**
+   * @return arithmetic mean of all samples
+   */
+  inline double Statistics::mean() const
+  {
+    if (samples_.empty())
+      return 0.0;
+
+    double sum = 0.0;
+
+    for (auto it = samples_.begin(); it != samples_.end(); ++it)
+      sum += *it;
+
+    return sum / samples_.size();
+  }
+
+  /**
+   * @return median of all samples
+   */
+  inline double Statistics::median() const
+  {
+    return percentile(samples_, 50.0);
+  }
+
+  /**
+   * @return median absolute deviation of all samples from their median
+   */
+  inline double Statistics::mad() const
+  {
+    return mad_;
+  }
+
+  /**
+   * @return sample standard deviation, or zero if there are fewer than
+   *         two samples
+   */
+  inline double Statistics::deviation() const
+  {
+    if (samples_.size() < 2)
+      return 0.0;
+
+    double mean = this->mean();
+    double sum = 0.0;
+
+    for (auto it = samples_.begin(); it != samples_.end(); ++it)
+      sum += (*it - mean) * (*it - mean);
+
+    return std::sqrt(sum / (samples_.size() - 1));
+  }
+
+  /**
+   * @param percentile percentile to retrieve (in the range 0 to 100)
+   * @return the given percentile of all samples, linearly interpolated
+   *         between the closest samples
+   */
+  inline double Statistics::percentile(double percentile) const
+  {
+    return Statistics::percentile(samples_, percentile);
+  }
+
+  /**
+   * @param sorted list of values sorted in ascending order
+   * @param percentile percentile to retrieve (in the range 0 to 100)
+   * @return the given percentile of the values
+   */
+  inline double Statistics::percentile(std::vector<double> const& sorted, double percentile)
+  {
+    if (sorted.empty())
+      return 0.0;
+
+    double rank = std::min(std::max(percentile, 0.0), 100.0) / 100.0 * (sorted.size() - 1);
+    std::size_t lower = static_cast<std::size_t>(rank);
+    std::size_t upper = std::min(lower + 1, sorted.size() - 1);
+    double fraction = rank - lower;
+
+    return sorted[lower] + (sorted[upper] - sorted[lower]) * fraction;
+  }
+}
+
+
+#endif
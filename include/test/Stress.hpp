@@ -0,0 +1,526 @@
+// Stress.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+#ifndef TSTSTRESS_HPP
+#define TSTSTRESS_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#  include <pthread.h>
+#  include <sched.h>
+#endif
+
+#include "Fatal.hpp"
+#include "RecordingResult.hpp"
+#include "Sites.hpp"
+#include "TestResult.hpp"
+
+
+namespace tst
+{
+  /**
+   * A SpinBarrier lets a fixed number of threads wait for each other by
+   * spinning, so that they are released within a few nanoseconds of one
+   * another rather than one by one as the scheduler wakes them up. It
+   * can be used repeatedly. Waiting threads yield their processor after
+   * spinning for a while, so that an oversubscribed machine does not
+   * grind to a halt.
+   */
+  class SpinBarrier
+  {
+  public:
+    explicit SpinBarrier(unsigned int count);
+
+    SpinBarrier(SpinBarrier&&) = delete;
+    SpinBarrier(SpinBarrier const&) = delete;
+
+    SpinBarrier& operator =(SpinBarrier&&) = delete;
+    SpinBarrier& operator =(SpinBarrier const&) = delete;
+
+    void wait();
+
+  private:
+    unsigned int count_;
+    std::atomic<unsigned int> waiting_;
+    std::atomic<unsigned int> generation_;
+
+    static void relax();
+  };
+
+
+  /**
+   * Stress runs a piece of test code on several threads at once to
+   * provoke data races and ordering bugs. The threads are released
+   * together by a SpinBarrier, and the whole process is repeated a
+   * number of times. Before each repetition every thread is pinned to
+   * a randomly chosen processor (on Linux) and, once released, yields
+   * a random number of times, which varies the interleavings tried.
+   *
+   * Each thread reports into a RecordingResult of its own, and the
+   * recorded events are replayed into the calling test's result once
+   * all threads are done, thread by thread. The run stops after the
+   * first repetition with a failure. All random decisions derive from
+   * a seed, which is taken from the environment variable TST_SEED if
+   * set, so that a failing run can be repeated.
+   */
+  class Stress
+  {
+  public:
+    typedef std::function<void(TestResult&, unsigned int)> Body;
+
+    Stress(unsigned int threads = 0, unsigned int repetitions = 100);
+
+    Stress(Stress&&) = delete;
+    Stress(Stress const&) = delete;
+
+    Stress& operator =(Stress&&) = delete;
+    Stress& operator =(Stress const&) = delete;
+
+    bool run(TestResult& result, Body const& body);
+
+    unsigned int threads() const;
+    unsigned int repetitions() const;
+    unsigned int failedRepetition() const;
+
+    unsigned int seed() const;
+    void setSeed(unsigned int seed);
+    void setPinning(bool pinning);
+
+  private:
+    /* Notes failures, so that the run can stop after them. */
+    class ThreadResult: public RecordingResult
+    {
+    public:
+      ThreadResult();
+
+      virtual void failed(char const* file, int line, char const* message) override;
+
+      void setFlag(std::atomic<bool>& failed);
+
+#ifdef TST_SITE_COUNTERS
+      std::uint64_t checked() const;
+      void setChecked(std::uint64_t checked);
+#endif
+
+    private:
+      std::atomic<bool>* failed_;
+#ifdef TST_SITE_COUNTERS
+      std::uint64_t checked_;
+#endif
+    };
+
+    unsigned int threads_;
+    unsigned int repetitions_;
+    unsigned int failed_;
+    unsigned int seed_;
+    bool pinning_;
+
+    void work(unsigned int thread,
+              Body const& body,
+              ThreadResult& result,
+              SpinBarrier& barrier,
+              std::atomic<bool> const& stop,
+              std::atomic<unsigned int> const& repetition,
+              std::vector<int> const& processors) const;
+
+    static std::vector<int> processors();
+    static void pin(int processor);
+  };
+
+
+  /**
+   * Run a piece of code on multiple threads at once, repeatedly (see
+   * Stress). The code is given as a callable object taking the result
+   * object to report to and the index of the thread running it, e.g.,
+   * a lambda '[&](tst::TestResult& result, unsigned int thread) {...}',
+   * so that the usual assertions can be used in it. If any of them
+   * fails, the repetition and seed of the failing run are reported as
+   * well.
+   * @param stress_ Stress object describing the run
+   * @param ... code to run
+   */
+  #define TESTSTRESS(stress_, ...)\
+    do\
+    {\
+      TSTCHECKED();\
+      tst::Stress& tst_stress = (stress_);\
+      if (!tst_stress.run(result, __VA_ARGS__))\
+      {\
+        char tst_message[128];\
+        std::snprintf(tst_message, sizeof(tst_message),\
+                      "Failed in repetition %u of %u (%u threads, seed %u)",\
+                      tst_stress.failedRepetition() + 1, tst_stress.repetitions(),\
+                      tst_stress.threads(), tst_stress.seed());\
+        result.failed(__FILE__, __LINE__, tst_message);\
+      }\
+    } while (false)
+}
+
+namespace tst
+{
+  /**
+   * @param count number of threads to wait for each other
+   */
+  inline SpinBarrier::SpinBarrier(unsigned int count)
+    : count_(count),
+      waiting_(0),
+      generation_(0)
+  {
+  }
+
+  /**
+   * Wait until all threads reached the barrier.
+   */
+  inline void SpinBarrier::wait()
+  {
+    unsigned int generation = generation_.load(std::memory_order_acquire);
+
+    if (waiting_.fetch_add(1, std::memory_order_acq_rel) + 1 == count_)
+    {
+      waiting_.store(0, std::memory_order_relaxed);
+      generation_.store(generation + 1, std::memory_order_release);
+      return;
+    }
+
+    for (unsigned int spins = 0; generation_.load(std::memory_order_acquire) == generation; ++spins)
+    {
+      if (spins < 4096)
+        relax();
+      else
+        std::this_thread::yield();
+    }
+  }
+
+  /**
+   * Tell the processor that we are spinning.
+   */
+  inline void SpinBarrier::relax()
+  {
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+    __builtin_ia32_pause();
+#elif defined(__GNUC__) && defined(__aarch64__)
+    asm volatile("yield");
+#endif
+  }
+
+  /**
+   * @param threads number of threads to use; zero means one per
+   *        hardware thread, but at least two
+   * @param repetitions number of times to run the code on all threads
+   */
+  inline Stress::Stress(unsigned int threads, unsigned int repetitions)
+    : threads_(threads),
+      repetitions_(repetitions),
+      failed_(0),
+      seed_(0),
+      pinning_(true)
+  {
+    if (threads_ == 0)
+      threads_ = std::max(std::thread::hardware_concurrency(), 2u);
+
+    char const* seed = std::getenv("TST_SEED");
+
+    if (seed != nullptr && *seed != '\0')
+      seed_ = static_cast<unsigned int>(std::strtoul(seed, nullptr, 0));
+    else
+      seed_ = std::random_device()();
+  }
+
+  /**
+   * Run a piece of code on all threads, repeatedly.
+   * @param result result object to report to
+   * @param body code to run; it is passed the result object to report
+   *        to and the index of the thread running it
+   * @return true if no failure was reported, false otherwise
+   */
+  inline bool Stress::run(TestResult& result, Body const& body)
+  {
+    std::vector<ThreadResult> results(threads_);
+    std::vector<int> processors = pinning_ ? Stress::processors() : std::vector<int>();
+    std::vector<std::thread> threads;
+    std::atomic<bool> failed(false);
+    std::atomic<bool> stop(false);
+    std::atomic<unsigned int> repetition(0);
+    // all workers plus the thread coordinating them
+    SpinBarrier barrier(threads_ + 1);
+
+    threads.reserve(threads_);
+
+    for (unsigned int i = 0; i < threads_; ++i)
+    {
+      results[i].setFlag(failed);
+      threads.emplace_back(&Stress::work, this, i, std::cref(body), std::ref(results[i]),
+                           std::ref(barrier), std::cref(stop), std::cref(repetition),
+                           std::cref(processors));
+    }
+
+    failed_ = repetitions_;
+
+    for (unsigned int i = 0; i < repetitions_; ++i)
+    {
+      repetition.store(i, std::memory_order_relaxed);
+
+      // the first wait starts the repetition, the second ends it
+      barrier.wait();
+      barrier.wait();
+
+      if (failed.load(std::memory_order_relaxed))
+      {
+        failed_ = i;
+        break;
+      }
+    }
+
+    stop.store(true, std::memory_order_relaxed);
+    barrier.wait();
+
+    for (auto it = threads.begin(); it != threads.end(); ++it)
+      it->join();
+
+    for (auto it = results.begin(); it != results.end(); ++it)
+    {
+      it->replay(result);
+#ifdef TST_SITE_COUNTERS
+      Sites::credit(it->checked());
+#endif
+    }
+
+    return failed_ == repetitions_;
+  }
+
+  /**
+   * @return number of threads used
+   */
+  inline unsigned int Stress::threads() const
+  {
+    return threads_;
+  }
+
+  /**
+   * @return number of times the code is run on all threads
+   */
+  inline unsigned int Stress::repetitions() const
+  {
+    return repetitions_;
+  }
+
+  /**
+   * @return index of the repetition the last run failed in, or the
+   *         number of repetitions if it did not fail
+   */
+  inline unsigned int Stress::failedRepetition() const
+  {
+    return failed_;
+  }
+
+  /**
+   * @return seed all random decisions are derived from
+   */
+  inline unsigned int Stress::seed() const
+  {
+    return seed_;
+  }
+
+  /**
+   * @param seed seed to derive all random decisions from
+   */
+  inline void Stress::setSeed(unsigned int seed)
+  {
+    seed_ = seed;
+  }
+
+  /**
+   * @param pinning true to pin threads to random processors, false to
+   *        leave their placement to the scheduler
+   */
+  inline void Stress::setPinning(bool pinning)
+  {
+    pinning_ = pinning;
+  }
+
+  /**
+   * The body of a worker thread.
+   * @param thread index of the thread
+   * @param body code to run
+   * @param result result object of this thread
+   * @param barrier barrier shared with all other threads
+   * @param stop flag set once no more repetitions are to be run
+   * @param repetition index of the current repetition
+   * @param processors processors the threads may be pinned to
+   */
+  inline void Stress::work(unsigned int thread,
+                           Body const& body,
+                           ThreadResult& result,
+                           SpinBarrier& barrier,
+                           std::atomic<bool> const& stop,
+                           std::atomic<unsigned int> const& repetition,
+                           std::vector<int> const& processors) const
+  {
+    for (;;)
+    {
+      barrier.wait();
+
+      if (stop.load(std::memory_order_relaxed))
+        break;
+
+      // derived from seed, repetition, and thread only, so that the
+      // same decisions are made when running with the same seed
+      std::seed_seq sequence = {seed_, repetition.load(std::memory_order_relaxed), thread};
+      std::minstd_rand random(sequence);
+
+      if (!processors.empty())
+        pin(processors[random() % processors.size()]);
+
+      for (unsigned int yields = random() % 4; yields > 0; --yields)
+        std::this_thread::yield();
+
+#ifdef TST_FATAL_LONGJMP
+      std::jmp_buf target;
+      std::jmp_buf* previous = Fatal::exchange(&target);
+
+      if (setjmp(target) == 0)
+#endif
+      {
+        TSTTRY
+        {
+          body(result, thread);
+        }
+        TSTCATCH(FatalFailure const& failure)
+        {
+        }
+        TSTCATCH(...)
+        {
+          result.failed(__FILE__, __LINE__, "Unexpected exception");
+        }
+      }
+
+#ifdef TST_FATAL_LONGJMP
+      Fatal::exchange(previous);
+#endif
+
+      barrier.wait();
+    }
+
+#ifdef TST_SITE_COUNTERS
+    // the counter of this thread goes away with it
+    result.setChecked(Sites::take());
+#endif
+  }
+
+  /**
+   * @return list of processors the calling thread may run on, or an
+   *         empty list if threads cannot be pinned
+   */
+  inline std::vector<int> Stress::processors()
+  {
+    std::vector<int> processors;
+
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+    {
+      for (int i = 0; i < CPU_SETSIZE; ++i)
+      {
+        if (CPU_ISSET(i, &set))
+          processors.push_back(i);
+      }
+    }
+#endif
+    return processors;
+  }
+
+  /**
+   * @param processor processor to pin the calling thread to
+   */
+  inline void Stress::pin(int processor)
+  {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(processor, &set);
+
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    static_cast<void>(processor);
+#endif
+  }
+
+  /**
+   * The default constructor creates a ThreadResult not reporting
+   * failures anywhere.
+   */
+  inline Stress::ThreadResult::ThreadResult()
+    : RecordingResult(),
+      failed_(nullptr)
+#ifdef TST_SITE_COUNTERS
+      , checked_(0)
+#endif
+  {
+  }
+
+  /**
+   * @copydoc TestResult::failed
+   */
+  inline void Stress::ThreadResult::failed(char const* file, int line, char const* message)
+  {
+    if (failed_ != nullptr)
+      failed_->store(true, std::memory_order_relaxed);
+
+    RecordingResult::failed(file, line, message);
+  }
+
+  /**
+   * @param failed flag to set on failure
+   */
+  inline void Stress::ThreadResult::setFlag(std::atomic<bool>& failed)
+  {
+    failed_ = &failed;
+  }
+
+#ifdef TST_SITE_COUNTERS
+  /**
+   * @return number of assertions the thread checked
+   */
+  inline std::uint64_t Stress::ThreadResult::checked() const
+  {
+    return checked_;
+  }
+
+  /**
+   * @param checked number of assertions the thread checked
+   */
+  inline void Stress::ThreadResult::setChecked(std::uint64_t checked)
+  {
+    checked_ = checked;
+  }
+#endif
+}
+
+
+#endif
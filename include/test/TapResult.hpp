@@ -0,0 +1,244 @@
+// TapResult.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTTAPRESULT_HPP
+#define TSTTAPRESULT_HPP
+
+#include "FailureBuffer.hpp"
+#include "Format.hpp"
+#include "Measurement.hpp"
+#include "TestResult.hpp"
+
+
+namespace tst
+{
+  /**
+   * A TestResult that streams the results in the Test Anything Protocol
+   * (TAP), version 14. Each test case is reported as a subtest with one
+   * test point per function; the plans are printed at the end. Every
+   * test point carries a YAML block with the duration of the function
+   * and the (first few) failures, e.g.,
+   * @code
+   * TAP version 14
+   * # Subtest: MyTest
+   *     not ok 1 - testMe1
+   *       ---
+   *       duration_ms: 0.001200
+   *       failures:
+   *         - file: "Sample.cpp"
+   *           line: 44
+   *           message: "has to fail!"
+   *       ...
+   *     1..1
+   * not ok 1 - MyTest
+   * 1..1
+   * @endcode
+   * Memory use is bounded by the FailureBuffer used for the failures of
+   * the function currently running.
+   */
+  template<typename T>
+  class TapResult: public TestResult
+  {
+  public:
+    TapResult(T& printer);
+
+    virtual void startTest(char const* test) override;
+    virtual void endTest() override;
+
+    virtual void startTestFunction(char const* function) override;
+    virtual void endTestFunction(Measurement const& measurement) override;
+
+    virtual void checked(char const* file, int line) override;
+    virtual void failed(char const* file, int line, char const* message) override;
+
+    void printSummary();
+
+  private:
+    T* printer_;
+
+    char const* test_;
+    char const* function_;
+
+    unsigned long tests_;
+    unsigned int functions_;
+    bool test_failed_;
+
+    FailureBuffer failures_;
+
+    void printDescription(char const* name, unsigned long index) const;
+  };
+}
+
+namespace tst
+{
+  /**
+   * @param printer stream to print the results to
+   */
+  template<typename T>
+  inline TapResult<T>::TapResult(T& printer)
+    : printer_(&printer),
+      test_(nullptr),
+      function_(nullptr),
+      tests_(0),
+      functions_(0),
+      test_failed_(false),
+      failures_()
+  {
+    (*printer_) << "TAP version 14\n";
+  }
+
+  /**
+   * @copydoc TestResult::startTest
+   */
+  template<typename T>
+  void TapResult<T>::startTest(char const* test)
+  {
+    test_ = test;
+    tests_++;
+    functions_ = 0;
+    test_failed_ = false;
+
+    (*printer_) << "# Subtest:";
+    printDescription(test_, tests_);
+    (*printer_) << '\n';
+  }
+
+  /**
+   * @copydoc TestResult::endTest
+   */
+  template<typename T>
+  void TapResult<T>::endTest()
+  {
+    (*printer_) << "    1.." << functions_ << '\n';
+    (*printer_) << (test_failed_ ? "not ok " : "ok ") << tests_ << " -";
+    printDescription(test_, tests_);
+    (*printer_) << '\n';
+
+    test_ = nullptr;
+  }
+
+  /**
+   * @copydoc TestResult::startTestFunction
+   */
+  template<typename T>
+  void TapResult<T>::startTestFunction(char const* function)
+  {
+    function_ = function;
+    functions_++;
+    failures_.clear();
+  }
+
+  /**
+   * @copydoc TestResult::endTestFunction
+   */
+  template<typename T>
+  void TapResult<T>::endTestFunction(Measurement const& measurement)
+  {
+    bool failed = failures_.count() > 0;
+
+    test_failed_ = test_failed_ || failed;
+
+    (*printer_) << "    " << (failed ? "not ok " : "ok ") << functions_ << " -";
+    printDescription(function_, functions_);
+    (*printer_) << "\n      ---\n      duration_ms: ";
+    printFixed(*printer_, measurement.wall, 1000000);
+    (*printer_) << '\n';
+
+    if (failed)
+    {
+      (*printer_) << "      failures:\n";
+
+      for (unsigned int i = 0; i < failures_.size(); ++i)
+      {
+        (*printer_) << "        - file: ";
+        printJson(*printer_, failures_[i].file);
+        (*printer_) << "\n          line: " << failures_[i].line << '\n';
+
+        if (failures_[i].has_message)
+        {
+          (*printer_) << "          message: ";
+          printJson(*printer_, failures_[i].message);
+          (*printer_) << '\n';
+        }
+      }
+
+      if (failures_.count() > failures_.size())
+        (*printer_) << "      omitted_failures: " << failures_.count() - failures_.size() << '\n';
+    }
+
+    (*printer_) << "      ...\n";
+    function_ = nullptr;
+  }
+
+  /**
+   * @copydoc TestResult::checked
+   */
+  template<typename T>
+  void TapResult<T>::checked(char const*, int)
+  {
+  }
+
+  /**
+   * @copydoc TestResult::failed
+   */
+  template<typename T>
+  void TapResult<T>::failed(char const* file, int line, char const* message)
+  {
+    failures_.add(file, line, message);
+  }
+
+  /**
+   * Print the plan of the whole run. To be called once after all tests
+   * have been run.
+   */
+  template<typename T>
+  void TapResult<T>::printSummary()
+  {
+    (*printer_) << "1.." << tests_ << '\n';
+  }
+
+  /**
+   * Print the description of a test point, escaping characters that
+   * have a special meaning in TAP.
+   * @param name name of the test or function (may be null)
+   * @param index number of the test point, used if there is no name
+   */
+  template<typename T>
+  void TapResult<T>::printDescription(char const* name, unsigned long index) const
+  {
+    (*printer_) << ' ';
+
+    if (name == nullptr)
+    {
+      (*printer_) << "\\#" << index;
+      return;
+    }
+
+    for (; *name != '\0'; ++name)
+    {
+      if (*name == '#' || *name == '\\')
+        (*printer_) << '\\' << *name;
+      else
+        (*printer_) << (*name == '\n' || *name == '\r' ? ' ' : *name);
+    }
+  }
+}
+
+
+#endif
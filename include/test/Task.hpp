@@ -0,0 +1,383 @@
+// Task.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+#ifndef TSTTASK_HPP
+#define TSTTASK_HPP
+
+/**
+ * TST_COROUTINES is 1 if test functions may be coroutines, which
+ * requires compiler support for C++20 coroutines and Linux (for the
+ * EventLoop, which uses epoll). Programs that do without the heap
+ * (see TST_FIXED_CAPACITY) have to enable it explicitly. It changes
+ * the interface of TestCase and TestCaseBase, so all translation units
+ * of a program have to agree on it.
+ */
+#if !defined(TST_COROUTINES)
+#  if defined(__cpp_impl_coroutine) && defined(__linux__) && !defined(TST_FIXED_CAPACITY)
+#    define TST_COROUTINES 1
+#  else
+#    define TST_COROUTINES 0
+#  endif
+#endif
+
+#if TST_COROUTINES
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+#include "Fatal.hpp"
+
+
+namespace tst
+{
+  class EventLoop;
+
+
+  /**
+   * A Task is the return type of coroutines run by the framework, most
+   * notably of asynchronous test functions (see EventLoop). A Task does
+   * not start running before it is awaited by another coroutine or
+   * spawned on an EventLoop. Once it finished, the coroutine awaiting
+   * it continues right away.
+   *
+   * An exception escaping the coroutine is passed on to the awaiting
+   * coroutine, which means FatalFailure works as in ordinary test
+   * functions. With TST_FATAL_RETURN or TST_FATAL_LONGJMP fatal
+   * assertions cannot be used in coroutines; TESTCOASSERTFATAL can.
+   */
+  class Task
+  {
+  public:
+    class promise_type;
+
+    typedef std::coroutine_handle<promise_type> Handle;
+    typedef void (*Notify)(void* context, Handle handle);
+
+    /* Continues whoever waits for the task once it finished. */
+    class FinalAwaiter
+    {
+    public:
+      bool await_ready() const noexcept;
+      std::coroutine_handle<> await_suspend(Handle handle) noexcept;
+      void await_resume() const noexcept;
+    };
+
+    class promise_type
+    {
+    public:
+      promise_type();
+
+      Task get_return_object();
+
+      std::suspend_always initial_suspend() noexcept;
+      FinalAwaiter final_suspend() noexcept;
+
+      void return_void();
+      void unhandled_exception();
+
+      void setNotify(Notify notify, void* context);
+
+    private:
+      friend class FinalAwaiter;
+      friend class Task;
+
+      /* The coroutine awaiting this one, if any. */
+      std::coroutine_handle<> continuation_;
+      /* Called once a task nobody awaits finished. */
+      Notify notify_;
+      void* context_;
+#if TSTEXCEPTIONS
+      std::exception_ptr exception_;
+#endif
+    };
+
+    Task();
+    Task(Task&& other) noexcept;
+    ~Task();
+
+    Task(Task const&) = delete;
+
+    Task& operator =(Task&& other) noexcept;
+    Task& operator =(Task const&) = delete;
+
+    bool valid() const;
+    bool done() const;
+
+    void rethrow() const;
+
+    bool await_ready() const noexcept;
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept;
+    void await_resume() const;
+
+    Handle release();
+
+  private:
+    friend class EventLoop;
+
+    Handle handle_;
+
+    explicit Task(Handle handle);
+  };
+
+
+  /**
+   * Test that an assertion holds, finish the current coroutine (and
+   * print message) if not. Unlike TESTASSERTFATALM this works in
+   * coroutines in all fatal assertion modes (see Fatal), but only
+   * finishes the coroutine it is used in directly.
+   * @param assertion_ boolean value to check for trueness
+   * @param message_ message to include in error report
+   */
+  #define TESTCOASSERTFATALM(assertion_, message_)\
+    do\
+    {\
+      TSTCHECKED();\
+      if (!(assertion_))\
+      {\
+        result.failed(__FILE__, __LINE__, message_);\
+        co_return;\
+      }\
+    } while(false)
+
+  /**
+   * Test that an assertion holds, finish the current coroutine if not.
+   * @param assertion_ boolean value to check for trueness
+   */
+  #define TESTCOASSERTFATAL(assertion_)\
+    TESTCOASSERTFATALM(assertion_, nullptr)
+}
+
+namespace tst
+{
+  /**
+   * The default constructor creates a promise of a task that nobody
+   * awaits yet.
+   */
+  inline Task::promise_type::promise_type()
+    : continuation_(),
+      notify_(nullptr),
+      context_(nullptr)
+  {
+  }
+
+  /**
+   * @return the Task object handed to the caller of the coroutine
+   */
+  inline Task Task::promise_type::get_return_object()
+  {
+    return Task(Handle::from_promise(*this));
+  }
+
+  /**
+   * Tasks start suspended, they are started when awaited or spawned.
+   */
+  inline std::suspend_always Task::promise_type::initial_suspend() noexcept
+  {
+    return std::suspend_always();
+  }
+
+  /**
+   * Tasks stay suspended once finished, so that their result can be
+   * inspected; they are destroyed by their owner.
+   */
+  inline Task::FinalAwaiter Task::promise_type::final_suspend() noexcept
+  {
+    return FinalAwaiter();
+  }
+
+  /**
+   * Tasks do not return values.
+   */
+  inline void Task::promise_type::return_void()
+  {
+  }
+
+  /**
+   * Remember an exception escaping the coroutine, to be passed on to
+   * the awaiting one.
+   */
+  inline void Task::promise_type::unhandled_exception()
+  {
+#if TSTEXCEPTIONS
+    exception_ = std::current_exception();
+#else
+    std::terminate();
+#endif
+  }
+
+  /**
+   * @param notify function to call once the task finished, unless
+   *        another coroutine awaits it
+   * @param context context passed to the function
+   */
+  inline void Task::promise_type::setNotify(Notify notify, void* context)
+  {
+    notify_ = notify;
+    context_ = context;
+  }
+
+  /**
+   * @return false, finishing always suspends
+   */
+  inline bool Task::FinalAwaiter::await_ready() const noexcept
+  {
+    return false;
+  }
+
+  /**
+   * @param handle handle of the finished coroutine
+   * @return the coroutine awaiting the finished one, if any
+   */
+  inline std::coroutine_handle<> Task::FinalAwaiter::await_suspend(Handle handle) noexcept
+  {
+    promise_type& promise = handle.promise();
+
+    if (promise.continuation_)
+      return promise.continuation_;
+
+    if (promise.notify_ != nullptr)
+      promise.notify_(promise.context_, handle);
+
+    return std::noop_coroutine();
+  }
+
+  /**
+   * A finished coroutine is never resumed.
+   */
+  inline void Task::FinalAwaiter::await_resume() const noexcept
+  {
+  }
+
+  /**
+   * The default constructor creates an invalid Task.
+   */
+  inline Task::Task()
+    : handle_()
+  {
+  }
+
+  /**
+   * @param handle handle of the coroutine
+   */
+  inline Task::Task(Handle handle)
+    : handle_(handle)
+  {
+  }
+
+  /**
+   * @param other task to take over
+   */
+  inline Task::Task(Task&& other) noexcept
+    : handle_(other.release())
+  {
+  }
+
+  /**
+   * Destroy the coroutine, if any.
+   */
+  inline Task::~Task()
+  {
+    if (handle_)
+      handle_.destroy();
+  }
+
+  /**
+   * @param other task to take over
+   * @return this task
+   */
+  inline Task& Task::operator =(Task&& other) noexcept
+  {
+    if (this != &other)
+    {
+      if (handle_)
+        handle_.destroy();
+
+      handle_ = other.release();
+    }
+    return *this;
+  }
+
+  /**
+   * @return true if the task refers to a coroutine, false otherwise
+   */
+  inline bool Task::valid() const
+  {
+    return static_cast<bool>(handle_);
+  }
+
+  /**
+   * @return true if the coroutine finished, false otherwise
+   */
+  inline bool Task::done() const
+  {
+    return handle_ && handle_.done();
+  }
+
+  /**
+   * Rethrow the exception that escaped the coroutine, if any.
+   */
+  inline void Task::rethrow() const
+  {
+#if TSTEXCEPTIONS
+    if (handle_ && handle_.promise().exception_)
+      std::rethrow_exception(handle_.promise().exception_);
+#endif
+  }
+
+  /**
+   * @return true if there is nothing to wait for, false otherwise
+   */
+  inline bool Task::await_ready() const noexcept
+  {
+    return !handle_ || handle_.done();
+  }
+
+  /**
+   * Start the task, continuing with the awaiting coroutine once it is
+   * done.
+   * @param awaiting the coroutine awaiting the task
+   * @return the coroutine to transfer control to
+   */
+  inline std::coroutine_handle<> Task::await_suspend(std::coroutine_handle<> awaiting) noexcept
+  {
+    handle_.promise().continuation_ = awaiting;
+    return handle_;
+  }
+
+  /**
+   * Awaiting a task resumes with any exception that escaped it.
+   */
+  inline void Task::await_resume() const
+  {
+    rethrow();
+  }
+
+  /**
+   * Give up ownership of the coroutine, e.g., to an EventLoop.
+   * @return the handle of the coroutine
+   */
+  inline Task::Handle Task::release()
+  {
+    return std::exchange(handle_, Handle());
+  }
+}
+
+#endif
+
+#endif
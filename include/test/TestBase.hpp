@@ -20,6 +20,8 @@
 #ifndef TSTTESTBASE_HPP
 #define TSTTESTBASE_HPP
 
+#include "TestVisitor.hpp"
+
 
 namespace tst
 {
@@ -33,19 +35,65 @@ namespace tst
   class TestBase
   {
   public:
+    TestBase();
     virtual ~TestBase();
 
     /** Run all tests. */
     virtual void run(TestResult& result) = 0;
+
+    virtual void accept(TestVisitor& visitor);
+
+    bool selected() const;
+    void select(bool selected);
+
+  private:
+    bool selected_;
   };
 }
 
 namespace tst
 {
+  /**
+   * The default constructor creates a selected test.
+   */
+  inline TestBase::TestBase()
+    : selected_(true)
+  {
+  }
+
   /** Destroy the test. */
   inline TestBase::~TestBase()
   {
   }
+
+  /**
+   * Let the given visitor visit this test and all tests contained in
+   * it. By default a test is treated as an opaque entity.
+   * @param visitor visitor to use
+   */
+  inline void TestBase::accept(TestVisitor& visitor)
+  {
+    visitor.visit(*this);
+  }
+
+  /**
+   * @return true if the test is selected for running, false if it is to
+   *         be skipped
+   */
+  inline bool TestBase::selected() const
+  {
+    return selected_;
+  }
+
+  /**
+   * Select or deselect a test for running. Suites and runners skip
+   * tests that are not selected.
+   * @param selected true to select the test, false to deselect it
+   */
+  inline void TestBase::select(bool selected)
+  {
+    selected_ = selected;
+  }
 }
 
 
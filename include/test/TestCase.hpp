@@ -20,11 +20,46 @@
 #ifndef TSTTESTCASE_HPP
 #define TSTTESTCASE_HPP
 
+#include <chrono>
+#include <new>
+#include <type_traits>
+
 #include <util/AssertImpl.hpp>
 
-#include "TestBase.hpp"
+#include "Allocations.hpp"
+#include "Fatal.hpp"
+#include "InstancePool.hpp"
+#include "Measurement.hpp"
+#include "Property.hpp"
+#include "Sites.hpp"
+#include "Task.hpp"
+#include "TestCaseBase.hpp"
+#include "TestRegistry.hpp"
 #include "TestResult.hpp"
-#include "TestContainer.hpp"
+#include "TestStorage.hpp"
+
+#if TST_COROUTINES
+#include "EventLoop.hpp"
+#endif
+#ifdef TST_PERF_COUNTERS
+#include "PerfCounters.hpp"
+#endif
+#if TST_PROPERTIES
+#include "History.hpp"
+#endif
+
+/** @cond never */
+/*
+ * Property tests and coroutines are run through adapters, i.e.,
+ * functions wrapping them.
+ */
+#define TSTADAPTERS (TST_PROPERTIES || TST_COROUTINES)
+
+#if TSTADAPTERS
+#include <functional>
+#include <vector>
+#endif
+/** @endcond never */
 
 
 namespace tst
@@ -33,12 +68,19 @@ namespace tst
    * This class is the base class for all classes that are to be tested.
    */
   template<typename T>
-  class TestCase: public TestBase
+  class TestCase: public TestCaseBase
   {
   public:
+    typedef T TestCaseType;
     typedef void (T::*Test)(TestResult&);
 
+    /* Selects the constructor used for the instances of isolated cases. */
+    struct Isolated
+    {
+    };
+
     TestCase(T& instance, char const* name = nullptr);
+    explicit TestCase(Isolated);
 
     TestCase(TestCase&&) = delete;
     TestCase(TestCase const&) = delete;
@@ -47,19 +89,89 @@ namespace tst
     TestCase& operator =(TestCase const&) = delete;
 
     virtual void run(TestResult& result);
-    virtual bool add(Test const& test);
+    virtual bool add(Test const& test,
+                     char const* name = nullptr,
+                     std::chrono::milliseconds timeout = std::chrono::milliseconds::zero());
+
+#if TST_PROPERTIES
+    template<typename V>
+    bool add(void (T::*property)(TestResult&, V const&),
+             Generator<V> const& generator,
+             char const* name = nullptr,
+             Property const& settings = Property());
+#endif
+
+#if TST_COROUTINES
+    typedef Task (T::*AsyncTest)(TestResult&);
+
+    bool add(AsyncTest const& test,
+             char const* name = nullptr,
+             std::chrono::milliseconds timeout = std::chrono::milliseconds::zero());
+#endif
+
+    virtual unsigned int functionCount() const override;
+    virtual char const* functionName(unsigned int index) const override;
+    virtual void runFunction(TestResult& result, unsigned int index) override;
+
+    virtual bool functionSelected(unsigned int index) const override;
+    virtual void selectFunction(unsigned int index, bool selected) override;
+
+    virtual std::chrono::milliseconds functionTimeout(unsigned int index) const override;
+
+#if TST_COROUTINES
+    virtual bool functionAsync(unsigned int index) const override;
+    virtual Task startFunction(TestResult& result, unsigned int index) override;
+#endif
+
+    bool isolated() const;
 
   protected:
+    void setIsolated(bool isolated);
+
     virtual void setUp();
     virtual void tearDown();
 
   private:
-    /* We have a fixed upper limit of tests that we support. */
-    typedef TestContainer<Test, 256> Tests;
+    struct Function
+    {
+      /* Null for functions wrapped as adapters, e.g., property tests. */
+      Test test;
+      char const* name;
+      std::chrono::milliseconds timeout;
+      bool selected;
+#if TSTADAPTERS
+      /* Index into the list of adapters, if 'test' is null. */
+      unsigned int adapter;
+#endif
+#if TST_COROUTINES
+      /* Null unless the function is a coroutine. */
+      AsyncTest async;
+#endif
+    };
+
+    typedef TestStorage<Function> Tests;
+#if TSTADAPTERS
+    typedef std::vector<std::function<void(T&, TestResult&)>> Adapters;
+#endif
+    typedef T* (*Construct)(void* memory);
 
     T* instance_;
-    char const* name_;
     Tests tests_;
+#if TSTADAPTERS
+    Adapters adapters_;
+#endif
+    /* Creates the instance for each function if isolated, else null. */
+    Construct construct_;
+
+    static T* construct(void* memory);
+    static T* create(void* memory, std::true_type);
+    static T* create(void* memory, std::false_type);
+    static bool& constructing();
+    static char const* strip(char const* name);
+
+    bool enterCase(TestResult& result, unsigned int index);
+    static bool setUpFixture(TestCase<T>& fixture, TestResult& result);
+    static void tearDownFixture(TestCase<T>& fixture, TestResult& result);
   };
 
 
@@ -73,13 +185,40 @@ namespace tst
 
 
   /**
-   * Test framework exception used for signaling fatal assertion
-   * failures, i.e., ones that have to terminate the current test
-   * function.
+   * Register a test function along with its name. To be used in the
+   * constructor of a test case, e.g., TESTADD(MyTest::testMe1).
+   * @param function_ qualified name of the test function
+   */
+  #define TESTADD(function_)\
+    add(&function_, #function_)
+
+  /**
+   * Register a test function along with its name and a timeout that
+   * overrides the one of the test case, e.g.,
+   * TESTADDTIMEOUT(MyTest::testMe1, std::chrono::seconds(5)).
+   * @param function_ qualified name of the test function
+   * @param timeout_ maximum time the function may take
+   */
+  #define TESTADDTIMEOUT(function_, timeout_)\
+    add(&function_, #function_, timeout_)
+
+#if TST_PROPERTIES
+  /**
+   * Register a property test along with its name and the generator of
+   * the values to check, e.g.,
+   * TESTADDPROPERTY(MyTest::sortIsIdempotent, tst::vectors(tst::integers<int>())).
+   * The function takes the result object and a value to check.
+   * @param function_ qualified name of the property test
+   * @param generator_ generator of the values to check
+   */
+  #define TESTADDPROPERTY(function_, generator_)\
+    add(&function_, generator_, #function_)
+#endif
+
+  /*
+   * Test functions that are coroutines, i.e., that return a Task, are
+   * registered using TESTADD and TESTADDTIMEOUT, too.
    */
-  struct FatalFailure
-  {
-  };
 
 
   /** @cond never */
@@ -87,7 +226,7 @@ namespace tst
     [&result](char const* assertion,\
               char const* file,\
               unsigned int line,\
-              char const* function)\
+              char const*)\
     {\
       result.failed(file, line, assertion);\
     }
@@ -102,7 +241,7 @@ namespace tst
   #define TESTASSERTM(assertion_, message_)\
     do\
     {\
-      result.checked(__FILE__, __LINE__);\
+      TSTCHECKED();\
       if (!(assertion_))\
         result.failed(__FILE__, __LINE__, message_);\
     } while (false)
@@ -114,7 +253,7 @@ namespace tst
   #define TESTASSERT(assertion_)\
     do\
     {\
-      result.checked(__FILE__, __LINE__);\
+      TSTCHECKED();\
       ASSERT_IMPL(assertion_, FAIL_LAMBDA);\
     } while (false)
 
@@ -130,7 +269,7 @@ namespace tst
   #define TESTASSERTOP(first_, operation_, second_)\
     do\
     {\
-      result.checked(__FILE__, __LINE__);\
+      TSTCHECKED();\
       ASSERTOP_IMPL(first_, operation_, second_, FAIL_LAMBDA);\
     } while (0)
 
@@ -143,11 +282,11 @@ namespace tst
   #define TESTASSERTFATALM(assertion_, message_)\
     do\
     {\
-      result.checked(__FILE__, __LINE__);\
+      TSTCHECKED();\
       if (!(assertion_))\
       {\
         result.failed(__FILE__, __LINE__, message_);\
-        throw tst::FatalFailure();\
+        TSTFATAL();\
       }\
     } while(false)
 
@@ -159,11 +298,12 @@ namespace tst
     TESTASSERTFATALM(assertion_, nullptr)
 
   /** @cond never */
+#if TSTEXCEPTIONS
   #define TESTTHROWSIMPL(exception_type_, expression_, message_)\
     do\
     {\
       auto success = true;\
-      result.checked(__FILE__, __LINE__);\
+      TSTCHECKED();\
       try\
       {\
         expression_;\
@@ -175,6 +315,14 @@ namespace tst
       if (!success)\
         result.failed(__FILE__, __LINE__, message_);\
     } while(false)
+#else
+  /* Without exceptions no expression can throw, so checking for one is a mistake. */
+  #define TESTTHROWSIMPL(exception_type_, expression_, message_)\
+    do\
+    {\
+      static_assert(TSTEXCEPTIONS, "TESTTHROWS and TESTTHROWSANY require exceptions");\
+    } while(false)
+#endif
   /** @endcond never */
 
   /**
@@ -225,13 +373,47 @@ namespace tst
   }
 
   /**
-   * The default constructor creates an empty TestCase.
+   * The default constructor creates a TestCase containing all the test
+   * functions declared using TESTFUNCTION. Further functions can be
+   * added using 'add'.
    */
   template<typename T>
   inline TestCase<T>::TestCase(T& instance, char const* name)
-    : instance_(&instance),
-      name_(name),
-      tests_()
+    : TestCaseBase(name),
+      instance_(&instance),
+      tests_(),
+#if TSTADAPTERS
+      adapters_(),
+#endif
+      construct_(nullptr)
+  {
+    // the functions of an instance created for an isolated case are
+    // never looked at, the case's own list is used
+    if (constructing())
+      return;
+
+    typename FunctionRegistry<T>::Functions& functions = FunctionRegistry<T>::functions();
+
+    for (auto it = functions.begin(); it != functions.end(); ++it)
+      add(it->test, it->name, it->timeout);
+  }
+
+  /**
+   * This constructor is used for the instances of an isolated case (see
+   * 'setIsolated') if the test case provides a constructor accepting
+   * the tag, e.g., MyTest(Isolated tag) : TestCase<MyTest>(tag) {}. It
+   * registers no functions at all, and neither does the rest of the
+   * derived constructor have to.
+   */
+  template<typename T>
+  inline TestCase<T>::TestCase(Isolated)
+    : TestCaseBase(nullptr),
+      instance_(nullptr),
+      tests_(),
+#if TSTADAPTERS
+      adapters_(),
+#endif
+      construct_(nullptr)
   {
   }
 
@@ -241,54 +423,581 @@ namespace tst
   template<typename T>
   inline void TestCase<T>::run(TestResult& result)
   {
-    result.startTest(name_);
+    // a test case with none of its functions selected is skipped as a
+    // whole
+    if (tests_.size() > 0 && selectedCount() == 0)
+      return;
+
+    result.startTest(name());
+
+    for (unsigned int i = 0; i < tests_.size() && !result.stopped(); ++i)
+    {
+      if (tests_[i].selected)
+        runFunction(result, i);
+    }
+
+    leave();
+    result.endTest();
+  }
+
+  /**
+   * @copydoc TestCaseBase::functionCount
+   */
+  template<typename T>
+  inline unsigned int TestCase<T>::functionCount() const
+  {
+    return tests_.size();
+  }
+
+  /**
+   * @copydoc TestCaseBase::runFunction
+   */
+  template<typename T>
+  inline void TestCase<T>::runFunction(TestResult& result, unsigned int index)
+  {
+    // the case is set up lazily, when its first function runs, no
+    // matter whether the whole case or individual functions are run
+    if (!enterCase(result, index))
+      return;
+
+    result.startTestFunction(tests_[index].name);
+
+    T* instance = instance_;
+    void* memory = nullptr;
+
+    // instances of isolated cases are created and destroyed outside of
+    // the measured interval
+    if (construct_ != nullptr)
+    {
+      memory = InstancePool<T>::global().acquire();
+      instance = construct_(memory);
+    }
+
+#ifdef TST_SITE_COUNTERS
+    // assertions are counted from here on, whatever was counted before
+    // belongs to the caller
+    std::uint64_t outer = Sites::take();
+#endif
+    AllocationCounters allocations = Allocations::start();
+#ifdef TST_PERF_COUNTERS
+    PerfCounts events = PerfCounters::thread().read();
+#endif
+    std::uint64_t start = wallTime();
+    // read within the wall clock interval, so that the CPU time cannot
+    // exceed the wall clock time
+    std::uint64_t cpu = cpuTime();
+
+    // set up and tear down may be declared inaccessible in T itself
+    TestCase<T>& fixture = *instance;
+    bool set_up = setUpFixture(fixture, result);
+
+    std::uint64_t run = wallTime();
+
+    // the test method is skipped if its set up failed
+    if (set_up)
+    {
+#ifdef TST_FATAL_LONGJMP
+      std::jmp_buf target;
+      std::jmp_buf* previous = Fatal::exchange(&target);
+
+      if (setjmp(target) == 0)
+#endif
+      {
+        TSTTRY
+        {
+          /* Run the test method. */
+#if TSTADAPTERS
+          if (tests_[index].test == nullptr)
+            adapters_[tests_[index].adapter](*instance, result);
+          else
+#endif
+            (instance->*tests_[index].test)(result);
+        }
+        TSTCATCH(FatalFailure const& failure)
+        {
+          /* There is nothing to be done here. */
+        }
+        TSTCATCH(...)
+        {
+          /*
+           * @todo It would be great to report the correct file and line
+           *       number here, but that would require pretty
+           *       sophisticated means.
+           */
+          TESTASSERTM(false, "Unexpected exception");
+        }
+      }
+
+#ifdef TST_FATAL_LONGJMP
+      Fatal::exchange(previous);
+#endif
+    }
+
+    std::uint64_t stop = wallTime();
+
+    if (set_up)
+      tearDownFixture(fixture, result);
+
+    cpu = cpuTime() - cpu;
+
+    std::uint64_t end = wallTime();
+    Measurement measurement = Measurement();
+    measurement.wall = end - start;
+    measurement.cpu = cpu;
+    measurement.set_up = run - start;
+    measurement.tear_down = end - stop;
+    Allocations::stop(allocations, measurement);
+#ifdef TST_PERF_COUNTERS
+    measurement.events = PerfCounters::thread().read() - events;
+#endif
+#ifdef TST_SITE_COUNTERS
+    measurement.checked = Sites::take();
+    Sites::credit(outer);
+#endif
+
+    if (memory != nullptr)
+    {
+      instance->~T();
+      InstancePool<T>::global().release(memory);
+    }
+
+    result.endTestFunction(measurement);
+  }
+
+  /**
+   * @copydoc TestCaseBase::functionName
+   */
+  template<typename T>
+  inline char const* TestCase<T>::functionName(unsigned int index) const
+  {
+    return tests_[index].name;
+  }
+
+  /**
+   * @copydoc TestCaseBase::functionSelected
+   */
+  template<typename T>
+  inline bool TestCase<T>::functionSelected(unsigned int index) const
+  {
+    return tests_[index].selected;
+  }
+
+  /**
+   * @copydoc TestCaseBase::selectFunction
+   */
+  template<typename T>
+  inline void TestCase<T>::selectFunction(unsigned int index, bool selected)
+  {
+    tests_[index].selected = selected;
+  }
+
+  /**
+   * @copydoc TestCaseBase::functionTimeout
+   */
+  template<typename T>
+  inline std::chrono::milliseconds TestCase<T>::functionTimeout(unsigned int index) const
+  {
+    std::chrono::milliseconds timeout = tests_[index].timeout;
+    return timeout != std::chrono::milliseconds::zero() ? timeout : this->timeout();
+  }
+
+#if TST_COROUTINES
+  /**
+   * @copydoc TestCaseBase::functionAsync
+   */
+  template<typename T>
+  inline bool TestCase<T>::functionAsync(unsigned int index) const
+  {
+    return tests_[index].async != nullptr;
+  }
+
+  /**
+   * @copydoc TestCaseBase::startFunction
+   * @note Other tasks may run on the same thread while the function
+   *       waits, so only wall clock times are measured; CPU time,
+   *       allocations, and hardware events are not.
+   */
+  template<typename T>
+  inline Task TestCase<T>::startFunction(TestResult& result, unsigned int index)
+  {
+    AsyncTest test = tests_[index].async;
 
-    for (auto it = tests_.begin(); it != tests_.end(); ++it)
+    if (test == nullptr)
     {
-      result.startTestFunction();
-      setUp();
+      runFunction(result, index);
+      co_return;
+    }
+
+    if (!enterCase(result, index))
+      co_return;
+
+    result.startTestFunction(tests_[index].name);
+
+    T* instance = instance_;
+    void* memory = nullptr;
+
+    if (construct_ != nullptr)
+    {
+      memory = InstancePool<T>::global().acquire();
+      instance = construct_(memory);
+    }
+
+#ifdef TST_SITE_COUNTERS
+    std::uint64_t outer = Sites::take();
+#endif
+    std::uint64_t start = wallTime();
 
+    TestCase<T>& fixture = *instance;
+    bool set_up = setUpFixture(fixture, result);
+
+    std::uint64_t run = wallTime();
+
+    if (set_up)
+    {
+#if TSTEXCEPTIONS
       try
       {
-        /* Run the test method. */
-        (instance_->*(*it))(result);
+        co_await (instance->*test)(result);
       }
-      catch(FatalFailure const& failure)
+      catch (FatalFailure const&)
       {
-        /* There is nothing to be done here. */
       }
-      catch(...)
+      catch (...)
       {
-        /*
-         * @todo It would be great to report the correct file and line
-         *       number here, but that would require pretty
-         *       sophisticated means.
-         */
         TESTASSERTM(false, "Unexpected exception");
       }
+#else
+      co_await (instance->*test)(result);
+#endif
+    }
+
+    std::uint64_t stop = wallTime();
+
+    if (set_up)
+      tearDownFixture(fixture, result);
+
+    std::uint64_t end = wallTime();
+    Measurement measurement = Measurement();
+    measurement.wall = end - start;
+    measurement.set_up = run - start;
+    measurement.tear_down = end - stop;
+#ifdef TST_SITE_COUNTERS
+    measurement.checked = Sites::take();
+    Sites::credit(outer);
+#endif
 
-      tearDown();
-      result.endTestFunction();
+    if (memory != nullptr)
+    {
+      instance->~T();
+      InstancePool<T>::global().release(memory);
     }
 
-    result.endTest();
+    result.endTestFunction(measurement);
+  }
+#endif
+
+  /**
+   * @return true if each test function runs on an instance of its own,
+   *         false if all of them share this one
+   */
+  template<typename T>
+  inline bool TestCase<T>::isolated() const
+  {
+    return construct_ != nullptr;
+  }
+
+  /**
+   * By default all test functions run on the instance the case was
+   * created with, so that state left behind by one function is seen by
+   * the next. An isolated case runs each function on a default
+   * constructed instance of its own instead, which is destroyed right
+   * after tear down; the memory for the instances is taken from an
+   * InstancePool. Since the functions do not share any state anymore,
+   * the case is also made concurrent (see 'setConcurrent'). Set up and
+   * tear down of the case as a whole (see 'setUpCase') still happen on
+   * the instance the case was created with.
+   *
+   * The instances are created by a constructor accepting the Isolated
+   * tag if the case provides one, by the default constructor otherwise.
+   * Functions the default constructor adds are ignored, the instances
+   * run the functions of this case.
+   * @param isolated true to run each function on a fresh instance,
+   *        false to run all functions on this instance
+   * @note Constructing and destroying the instances is not part of the
+   *       Measurement of a function, neither its time nor allocations.
+   */
+  template<typename T>
+  inline void TestCase<T>::setIsolated(bool isolated)
+  {
+    construct_ = isolated ? &TestCase<T>::construct : nullptr;
+    setConcurrent(isolated);
   }
 
   /**
    * This method can be used to add a new test function to the list of
    * tests to execute.
-   * @param test a test case or test suite to add
+   * @param test a test function to add
+   * @param name name of the test function; a qualified name (as
+   *        produced by TESTADD) is stripped down to the function name
+   * @param timeout maximum time the function may take; zero means the
+   *        timeout of the test case applies
    * @return true if adding the test was successful, false if not
    */
   template<typename T>
-  inline bool TestCase<T>::add(Test const& test)
+  inline bool TestCase<T>::add(Test const& test,
+                               char const* name,
+                               std::chrono::milliseconds timeout)
   {
+    if (constructing())
+      return false;
+
     if (test != nullptr)
-      return tests_.add(test);
+    {
+      Function function = Function();
+      function.test = test;
+      function.name = strip(name);
+      function.timeout = timeout;
+      function.selected = true;
+
+      return tests_.add(function);
+    }
 
     return false;
   }
 
+#if TST_PROPERTIES
+  /**
+   * Add a property test, i.e., a function checking a property of a
+   * value, which is run for many values produced by a generator (see
+   * Property). Unless given explicitly or in the environment, the seed
+   * is derived from the names of the case and the function, so that
+   * each property test sees the same values in every run.
+   * @param property member function checking the property; it reports
+   *        to the given result object like a test function
+   * @param generator generator of the values to check
+   * @param name name of the property test; a qualified name (as
+   *        produced by TESTADDPROPERTY) is stripped down to the
+   *        function name
+   * @param settings how to run the property test
+   * @return true if adding the test was successful, false if not
+   */
+  template<typename T>
+  template<typename V>
+  inline bool TestCase<T>::add(void (T::*property)(TestResult&, V const&),
+                               Generator<V> const& generator,
+                               char const* name,
+                               Property const& settings)
+  {
+    if (property == nullptr || constructing())
+      return false;
+
+    name = strip(name);
+
+    std::uint64_t seed = History::key(this->name(), name);
+    Function function = Function();
+    function.name = name;
+    function.timeout = std::chrono::milliseconds::zero();
+    function.selected = true;
+    function.adapter = static_cast<unsigned int>(adapters_.size());
+
+    if (!tests_.add(function))
+      return false;
+
+    adapters_.push_back([property, generator, settings, seed](T& instance, TestResult& result)
+    {
+      std::function<void(TestResult&, V const&)> bound = [&instance, property](TestResult& result, V const& value)
+      {
+        (instance.*property)(result, value);
+      };
+      settings.check(result, generator, bound, seed);
+    });
+    return true;
+  }
+#endif
+
+#if TST_COROUTINES
+  /**
+   * Add a test function that is a coroutine. It may wait for I/O or
+   * timers using the EventLoop it runs on (see 'readable', 'writable',
+   * and 'sleep'), letting runners supporting it (see AsyncRunner) run
+   * other functions in the meantime. All other runners run it to
+   * completion on an EventLoop of its own, like an ordinary function.
+   * @param test a test function to add
+   * @param name name of the test function; a qualified name (as
+   *        produced by TESTADD) is stripped down to the function name
+   * @param timeout maximum time the function may take; zero means the
+   *        timeout of the test case applies
+   * @return true if adding the test was successful, false if not
+   */
+  template<typename T>
+  inline bool TestCase<T>::add(AsyncTest const& test,
+                               char const* name,
+                               std::chrono::milliseconds timeout)
+  {
+    if (test == nullptr || constructing())
+      return false;
+
+    Function function = Function();
+    function.name = strip(name);
+    function.timeout = timeout;
+    function.selected = true;
+    function.adapter = static_cast<unsigned int>(adapters_.size());
+    function.async = test;
+
+    if (!tests_.add(function))
+      return false;
+
+    adapters_.push_back([test](T& instance, TestResult& result)
+    {
+      Task task = (instance.*test)(result);
+      EventLoop loop;
+
+      loop.run(task);
+      task.rethrow();
+    });
+    return true;
+  }
+#endif
+
+  /**
+   * @param name qualified or unqualified name of a function (may be
+   *        null)
+   * @return the name without any qualification
+   */
+  template<typename T>
+  inline char const* TestCase<T>::strip(char const* name)
+  {
+    if (name != nullptr)
+    {
+      for (char const* c = name; *c != '\0'; ++c)
+      {
+        if (*c == ':')
+          name = c + 1;
+      }
+    }
+    return name;
+  }
+  /**
+   * Set up the case the function at the given index belongs to, unless
+   * this already happened. If that fails the function is reported as
+   * failed without being run.
+   * @param result result object to report a failure to
+   * @param index index of the function about to run
+   * @return true if the case is set up, false if not
+   */
+  template<typename T>
+  inline bool TestCase<T>::enterCase(TestResult& result, unsigned int index)
+  {
+    TSTTRY
+    {
+      enter();
+      return true;
+    }
+    TSTCATCH(...)
+    {
+      result.startTestFunction(tests_[index].name);
+      result.failed(__FILE__, __LINE__, "Unexpected exception in setUpCase");
+      result.endTestFunction(Measurement());
+    }
+    return false;
+  }
+
+  /**
+   * @param fixture instance to set up for running a test function
+   * @param result result object to report a failure to
+   * @return true if the instance is set up, false if an exception was
+   *         thrown
+   */
+  template<typename T>
+  inline bool TestCase<T>::setUpFixture(TestCase<T>& fixture, TestResult& result)
+  {
+    TSTTRY
+    {
+      fixture.setUp();
+      return true;
+    }
+    TSTCATCH(...)
+    {
+      TESTASSERTM(false, "Unexpected exception in setUp");
+    }
+    return false;
+  }
+
+  /**
+   * @param fixture instance to tear down after running a test function
+   * @param result result object to report a failure to
+   */
+  template<typename T>
+  inline void TestCase<T>::tearDownFixture(TestCase<T>& fixture, TestResult& result)
+  {
+    TSTTRY
+    {
+      fixture.tearDown();
+    }
+    TSTCATCH(...)
+    {
+      TESTASSERTM(false, "Unexpected exception in tearDown");
+    }
+  }
+
+
+  /**
+   * @param memory memory to construct the instance in
+   * @return a newly constructed instance of the test case
+   */
+  template<typename T>
+  inline T* TestCase<T>::construct(void* memory)
+  {
+    return create(memory, std::is_constructible<T, Isolated>());
+  }
+
+  /**
+   * @param memory memory to construct the instance in
+   * @return a newly constructed instance of the test case, created by
+   *         the constructor accepting the Isolated tag
+   */
+  template<typename T>
+  inline T* TestCase<T>::create(void* memory, std::true_type)
+  {
+    return new (memory) T(Isolated());
+  }
+
+  /**
+   * @param memory memory to construct the instance in
+   * @return a newly constructed instance of the test case, created by
+   *         the default constructor; functions it adds are ignored
+   */
+  template<typename T>
+  inline T* TestCase<T>::create(void* memory, std::false_type)
+  {
+    // resets the flag even if the constructor throws
+    struct Guard
+    {
+      bool& constructing;
+
+      ~Guard()
+      {
+        constructing = false;
+      }
+    };
+
+    Guard guard = {constructing()};
+
+    guard.constructing = true;
+    return new (memory) T();
+  }
+
+  /**
+   * @return flag telling whether the calling thread is constructing an
+   *         instance for an isolated case
+   */
+  template<typename T>
+  inline bool& TestCase<T>::constructing()
+  {
+    static thread_local bool constructing = false;
+    return constructing;
+  }
+
   /**
    * This method can be overwritten to do some initialization work
    * before each test.
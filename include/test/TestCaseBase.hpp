@@ -0,0 +1,288 @@
+// TestCaseBase.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTTESTCASEBASE_HPP
+#define TSTTESTCASEBASE_HPP
+
+#include <chrono>
+#include <mutex>
+
+#include "Task.hpp"
+#include "TestBase.hpp"
+#include "TestVisitor.hpp"
+
+
+namespace tst
+{
+  /**
+   * This class is the type independent base of all TestCase objects.
+   * It allows for running individual test functions of a test case
+   * without knowing about the concrete class being tested.
+   */
+  class TestCaseBase: public TestBase
+  {
+  public:
+    TestCaseBase(char const* name);
+
+    virtual void accept(TestVisitor& visitor) override;
+
+    char const* name() const;
+    bool concurrent() const;
+    std::chrono::milliseconds timeout() const;
+
+    /** @return number of test functions registered */
+    virtual unsigned int functionCount() const = 0;
+
+    /**
+     * @param index index of a test function
+     * @return name of the function or null if it has none
+     */
+    virtual char const* functionName(unsigned int index) const = 0;
+
+    /**
+     * Run a single test function, including set up and tear down. The
+     * case is set up first, if it was not yet (see 'enter'); tearing it
+     * down is left to the caller (see 'leave').
+     * @param result result object to report to
+     * @param index index of the function to run (has to be less than
+     *        'functionCount()')
+     */
+    virtual void runFunction(TestResult& result, unsigned int index) = 0;
+
+    /**
+     * @param index index of a test function
+     * @return true if the function is selected for running, false if
+     *         it is to be skipped
+     */
+    virtual bool functionSelected(unsigned int index) const = 0;
+
+    /**
+     * Select or deselect a single test function for running.
+     * @param index index of the test function
+     * @param selected true to select the function, false to deselect it
+     */
+    virtual void selectFunction(unsigned int index, bool selected) = 0;
+
+    /**
+     * @param index index of a test function
+     * @return maximum time the function may take or zero if it has no
+     *         time limit; unless the function was registered with a
+     *         timeout of its own, this is the timeout of the case
+     */
+    virtual std::chrono::milliseconds functionTimeout(unsigned int index) const = 0;
+
+    unsigned int selectedCount() const;
+
+#if TST_COROUTINES
+    virtual bool functionAsync(unsigned int index) const;
+    virtual Task startFunction(TestResult& result, unsigned int index);
+#endif
+
+    void enter();
+    void leave();
+
+  protected:
+    void setConcurrent(bool concurrent);
+    void setTimeout(std::chrono::milliseconds timeout);
+
+    virtual void setUpCase();
+    virtual void tearDownCase();
+
+  private:
+    char const* name_;
+    bool concurrent_;
+    std::chrono::milliseconds timeout_;
+    std::mutex mutex_;
+    bool entered_;
+  };
+}
+
+namespace tst
+{
+  /**
+   * @param name name of the test case (may be null)
+   */
+  inline TestCaseBase::TestCaseBase(char const* name)
+    : name_(name),
+      concurrent_(false),
+      timeout_(std::chrono::milliseconds::zero()),
+      mutex_(),
+      entered_(false)
+  {
+  }
+
+  /**
+   * @copydoc TestBase::accept
+   */
+  inline void TestCaseBase::accept(TestVisitor& visitor)
+  {
+    visitor.visit(*this);
+  }
+
+  /**
+   * @return name of the test case or null if it has none
+   */
+  inline char const* TestCaseBase::name() const
+  {
+    return name_;
+  }
+
+  /**
+   * @return true if the test functions of this case may run
+   *         concurrently to each other, false if not
+   */
+  inline bool TestCaseBase::concurrent() const
+  {
+    return concurrent_;
+  }
+
+  /**
+   * @return maximum time each test function of this case may take or
+   *         zero if the case does not limit the time of its functions
+   */
+  inline std::chrono::milliseconds TestCaseBase::timeout() const
+  {
+    return timeout_;
+  }
+
+  /**
+   * @return number of test functions selected for running
+   */
+  inline unsigned int TestCaseBase::selectedCount() const
+  {
+    unsigned int count = 0;
+
+    for (unsigned int i = 0; i < functionCount(); ++i)
+    {
+      if (functionSelected(i))
+        count++;
+    }
+    return count;
+  }
+
+#if TST_COROUTINES
+  /**
+   * @param index index of a test function
+   * @return true if the function is a coroutine, which runners may
+   *         interleave with other functions on an EventLoop (see
+   *         'startFunction'), false otherwise
+   */
+  inline bool TestCaseBase::functionAsync(unsigned int) const
+  {
+    return false;
+  }
+
+  /**
+   * Run a single test function as a coroutine, as done by 'runFunction'
+   * otherwise. Awaiting the returned task on an EventLoop lets other
+   * tasks run while the function waits for I/O. For functions that are
+   * no coroutines the task simply calls 'runFunction'.
+   * @param result result object to report to; it has to stay valid
+   *        until the task finished
+   * @param index index of the function to run
+   * @return task running the function
+   */
+  inline Task TestCaseBase::startFunction(TestResult& result, unsigned int index)
+  {
+    runFunction(result, index);
+    co_return;
+  }
+#endif
+
+  /**
+   * Set up the case, unless this already happened. Functions of a
+   * concurrent case may enter it from multiple threads at once, only
+   * one of them sets it up and the others wait for it to finish.
+   */
+  inline void TestCaseBase::enter()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!entered_)
+    {
+      setUpCase();
+      entered_ = true;
+    }
+  }
+
+  /**
+   * Tear down the case, if it was set up.
+   */
+  inline void TestCaseBase::leave()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (entered_)
+    {
+      entered_ = false;
+      tearDownCase();
+    }
+  }
+
+  /**
+   * By default all test functions of a test case operate on the same
+   * instance and, hence, are never run concurrently to each other. A
+   * test case not keeping any state across set up, test functions, and
+   * tear down can lift this restriction, allowing runners to spread its
+   * functions over multiple threads.
+   * @param concurrent true if the test functions of this case may run
+   *        concurrently, false otherwise
+   */
+  inline void TestCaseBase::setConcurrent(bool concurrent)
+  {
+    concurrent_ = concurrent;
+  }
+
+  /**
+   * Limit the time each test function of this case may take, including
+   * set up and tear down. Functions registered with a timeout of their
+   * own are not affected. Timeouts are enforced by runners able to
+   * abandon a function, i.e., the ForkRunner; a function exceeding its
+   * time limit is reported as failed and the run continues with the
+   * next function.
+   * @param timeout maximum time per function; zero removes the limit
+   */
+  inline void TestCaseBase::setTimeout(std::chrono::milliseconds timeout)
+  {
+    timeout_ = timeout;
+  }
+
+  /**
+   * Set up state shared by all test functions of this case, e.g., an
+   * expensive to load data set. It is called once before the first
+   * selected function runs and not at all if no function is selected.
+   * Runners executing the functions of a case in several processes (see
+   * ForkRunner) set the case up in each of them. The time it takes is
+   * not accounted to any function.
+   */
+  inline void TestCaseBase::setUpCase()
+  {
+  }
+
+  /**
+   * Tear down the state set up by 'setUpCase', once the last selected
+   * function ran.
+   */
+  inline void TestCaseBase::tearDownCase()
+  {
+  }
+}
+
+
+#endif
@@ -44,6 +44,11 @@ namespace tst
 
     bool add(T const& test);
 
+    unsigned int size() const;
+
+    T& operator [](unsigned int index);
+    T const& operator [](unsigned int index) const;
+
     Iterator begin();
     Iterator end();
 
@@ -80,6 +85,35 @@ namespace tst
     return false;
   }
 
+  /**
+   * @return number of tests stored in the container
+   */
+  template<typename T, unsigned int MAX_TESTS>
+  inline unsigned int TestContainer<T, MAX_TESTS>::size() const
+  {
+    return index_;
+  }
+
+  /**
+   * @param index index of the test to retrieve (has to be less than
+   *        'size()')
+   * @return the test at the given index
+   */
+  template<typename T, unsigned int MAX_TESTS>
+  inline T& TestContainer<T, MAX_TESTS>::operator [](unsigned int index)
+  {
+    return tests_[index];
+  }
+
+  /**
+   * @copydoc TestContainer::operator []
+   */
+  template<typename T, unsigned int MAX_TESTS>
+  inline T const& TestContainer<T, MAX_TESTS>::operator [](unsigned int index) const
+  {
+    return tests_[index];
+  }
+
   /**
    * @return an iterator to the first test in the container
    */
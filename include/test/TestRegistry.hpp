@@ -0,0 +1,252 @@
+// TestRegistry.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTTESTREGISTRY_HPP
+#define TSTTESTREGISTRY_HPP
+
+#include <chrono>
+#include <utility>
+
+#include "TestBase.hpp"
+#include "TestStorage.hpp"
+#include "TestSuite.hpp"
+
+
+namespace tst
+{
+  class TestResult;
+
+
+  /**
+   * A FunctionRegistry collects the test functions of a test case that
+   * are declared using TESTFUNCTION. The functions register themselves
+   * during static initialization and are added to the test case when it
+   * is constructed. The order of initialization is unspecified, so the
+   * functions are kept sorted by the line they are declared on.
+   */
+  template<typename T>
+  class FunctionRegistry
+  {
+  public:
+    typedef void (T::*Test)(TestResult&);
+
+    struct Function
+    {
+      Test test;
+      char const* name;
+      std::chrono::milliseconds timeout;
+      /* The line the function is declared on. */
+      unsigned int order;
+    };
+
+    typedef TestStorage<Function> Functions;
+
+    static bool add(Test test, char const* name, std::chrono::milliseconds timeout, unsigned int order);
+    static Functions& functions();
+  };
+
+
+  /** @cond never */
+  template<typename T, typename F>
+  class FunctionRegistrar
+  {
+  public:
+    static bool registered();
+
+  private:
+    static bool registered_;
+  };
+  /** @endcond never */
+
+
+  /**
+   * The TestRegistry collects all test cases declared using TESTCASE.
+   * The cases are only created once the suite containing them is
+   * requested, so that all their functions are registered by then.
+   */
+  class TestRegistry
+  {
+  public:
+    typedef TestBase& (*Factory)();
+
+    static bool add(Factory factory);
+    static TestSuite& suite();
+
+  private:
+    typedef TestStorage<Factory> Factories;
+
+    static Factories& factories();
+  };
+
+
+  /** @cond never */
+  #define TSTCONCATIMPL(first_, second_) first_##second_
+  #define TSTCONCAT(first_, second_) TSTCONCATIMPL(first_, second_)
+  /** @endcond never */
+
+  /**
+   * Declare a test function that registers itself with its test case.
+   * To be used inside the definition of a test case, followed by the
+   * body of the function, e.g.,
+   * @code
+   * TESTFUNCTION(testMe1)
+   * {
+   *   TESTASSERT(true);
+   * }
+   * @endcode
+   * Functions are run in the order they are declared in.
+   * @param function_ name of the test function
+   */
+  #define TESTFUNCTION(function_)\
+    TESTFUNCTIONTIMEOUT(function_, std::chrono::milliseconds::zero())
+
+  /**
+   * Declare a test function like TESTFUNCTION, with a timeout that
+   * overrides the one of the test case, e.g.,
+   * TESTFUNCTIONTIMEOUT(testMe1, std::chrono::seconds(5)).
+   * @param function_ name of the test function
+   * @param timeout_ maximum time the function may take
+   */
+  #define TESTFUNCTIONTIMEOUT(function_, timeout_)\
+    struct TestFunction_##function_\
+    {\
+      static tst::FunctionRegistry<TestCaseType>::Test test()\
+      {\
+        return &TestCaseType::function_;\
+      }\
+      static char const* name()\
+      {\
+        return #function_;\
+      }\
+      static std::chrono::milliseconds timeout()\
+      {\
+        return timeout_;\
+      }\
+      static unsigned int order()\
+      {\
+        return __LINE__;\
+      }\
+      static bool registered()\
+      {\
+        return tst::FunctionRegistrar<TestCaseType, TestFunction_##function_>::registered();\
+      }\
+    };\
+    void function_(tst::TestResult& result)
+
+  /**
+   * Register a test case with the TestRegistry. To be used at namespace
+   * scope after the definition of the test case, e.g., TESTCASE(MyTest).
+   * @param case_ type of the test case
+   */
+  #define TESTCASE(case_)\
+    static bool const TSTCONCAT(tst_registered_, __COUNTER__) =\
+      tst::TestRegistry::add([]() -> tst::TestBase& { return tst::createTestCase<case_>(); })
+}
+
+namespace tst
+{
+  /**
+   * @param test test function to register
+   * @param name name of the test function
+   * @param timeout maximum time the function may take; zero means the
+   *        timeout of the test case applies
+   * @param order key the functions are sorted by, i.e., the line the
+   *        function is declared on
+   * @return true if registering the function was successful, false if
+   *         not
+   */
+  template<typename T>
+  inline bool FunctionRegistry<T>::add(Test test,
+                                       char const* name,
+                                       std::chrono::milliseconds timeout,
+                                       unsigned int order)
+  {
+    Functions& functions = FunctionRegistry<T>::functions();
+    Function function = {test, name, timeout, order};
+
+    if (!functions.add(function))
+      return false;
+
+    // usually the functions register in order, and nothing is moved
+    for (unsigned int i = functions.size() - 1; i > 0 && functions[i - 1].order > order; --i)
+      std::swap(functions[i - 1], functions[i]);
+
+    return true;
+  }
+
+  /**
+   * @return all test functions registered so far
+   */
+  template<typename T>
+  inline typename FunctionRegistry<T>::Functions& FunctionRegistry<T>::functions()
+  {
+    static Functions functions;
+    return functions;
+  }
+
+  /** @cond never */
+  template<typename T, typename F>
+  bool FunctionRegistrar<T, F>::registered_ = FunctionRegistry<T>::add(F::test(), F::name(), F::timeout(), F::order());
+
+  template<typename T, typename F>
+  inline bool FunctionRegistrar<T, F>::registered()
+  {
+    return registered_;
+  }
+  /** @endcond never */
+
+  /**
+   * @param factory function creating the test case to register
+   * @return true if registering the test case was successful, false if
+   *         not
+   */
+  inline bool TestRegistry::add(Factory factory)
+  {
+    return factories().add(factory);
+  }
+
+  /**
+   * @return a suite containing all registered test cases, in the order
+   *         they were registered in
+   */
+  inline TestSuite& TestRegistry::suite()
+  {
+    static TestSuite suite;
+    static unsigned int created = 0;
+
+    Factories& factories = TestRegistry::factories();
+
+    for (; created < factories.size(); ++created)
+      suite.add(factories[created]());
+
+    return suite;
+  }
+
+  /**
+   * @return all test case factories registered so far
+   */
+  inline TestRegistry::Factories& TestRegistry::factories()
+  {
+    static Factories factories;
+    return factories;
+  }
+}
+
+
+#endif
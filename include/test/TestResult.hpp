@@ -20,6 +20,8 @@
 #ifndef TSTTESTRESULT_HPP
 #define TSTTESTRESULT_HPP
 
+#include "Measurement.hpp"
+
 
 namespace tst
 {
@@ -32,6 +34,26 @@ namespace tst
     /** Destroy the test result object. */
     virtual ~TestResult() = default;
 
+    /**
+     * @return true if this object may be used by multiple threads at
+     *         the same time, false if not
+     */
+    virtual bool threadSafe() const
+    {
+      return false;
+    }
+
+    /**
+     * Runners ask this method before starting another test function or
+     * test case, so that a result object can cut a test run short (see
+     * FailFastResult).
+     * @return true if no further tests are to be run, false otherwise
+     */
+    virtual bool stopped() const
+    {
+      return false;
+    }
+
     /**
      * This method marks the beginning of a new test case to run. The
      * method is invoked automatically by the framework.
@@ -50,14 +72,17 @@ namespace tst
      * This method marks the beginning of a new test function
      * invocation. The method is invoked automatically by the
      * framework.
+     * @param function name of the test function that is about to be
+     *        run (may be null)
      */
-    virtual void startTestFunction() = 0;
+    virtual void startTestFunction(char const* function) = 0;
 
     /**
      * This method marks the end of a test function invocation. The
      * method is invoked automatically by the framework.
+     * @param measurement figures collected while running the function
      */
-    virtual void endTestFunction() = 0;
+    virtual void endTestFunction(Measurement const& measurement) = 0;
 
     /**
      * Tell this object that an assertion is about to be checked. This
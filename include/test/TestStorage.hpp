@@ -0,0 +1,49 @@
+// TestStorage.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTTESTSTORAGE_HPP
+#define TSTTESTSTORAGE_HPP
+
+#ifdef TST_FIXED_CAPACITY
+#include "TestContainer.hpp"
+#else
+#include "TestVector.hpp"
+#endif
+
+
+namespace tst
+{
+  /**
+   * The storage used by test cases and test suites for their tests. By
+   * default it grows as needed. Builds that must not allocate dynamic
+   * memory can define TST_FIXED_CAPACITY to the maximum number of tests
+   * per case and suite, in which case a TestContainer of that size is
+   * used instead.
+   */
+#ifdef TST_FIXED_CAPACITY
+  template<typename T>
+  using TestStorage = TestContainer<T, TST_FIXED_CAPACITY>;
+#else
+  template<typename T>
+  using TestStorage = TestVector<T>;
+#endif
+}
+
+
+#endif
@@ -20,8 +20,14 @@
 #ifndef TSTTESTSUITE_HPP
 #define TSTTESTSUITE_HPP
 
+#include <vector>
+
+#include "Schedule.hpp"
 #include "TestBase.hpp"
-#include "TestContainer.hpp"
+#include "TestCaseBase.hpp"
+#include "TestResult.hpp"
+#include "TestStorage.hpp"
+#include "TestVisitor.hpp"
 
 
 namespace tst
@@ -42,12 +48,39 @@ namespace tst
     TestSuite& operator =(TestSuite const&) = delete;
 
     virtual void run(TestResult& result);
+    virtual void accept(TestVisitor& visitor) override;
     virtual bool add(TestBase& test);
 
+    void setSchedule(Schedule const* schedule);
+
+    void enter();
+    void leave();
+
+  protected:
+    virtual void setUpSuite();
+    virtual void tearDownSuite();
+
   private:
-    typedef TestContainer<TestBase*, 256> Tests;
+    typedef TestStorage<TestBase*> Tests;
+
+    /* Finds out whether a tree of tests contains anything to run. */
+    class Probe: public TestVisitor
+    {
+    public:
+      Probe();
+
+      virtual void visit(TestBase& test) override;
+      virtual void visit(TestCaseBase& test) override;
+
+      bool active() const;
+
+    private:
+      bool active_;
+    };
 
     Tests tests_;
+    Schedule const* schedule_;
+    bool entered_;
   };
 }
 
@@ -57,7 +90,9 @@ namespace tst
    * The default constructor creates an empty TestSuite.
    */
   inline TestSuite::TestSuite()
-    : tests_()
+    : tests_(),
+      schedule_(nullptr),
+      entered_(false)
   {
   }
 
@@ -66,8 +101,64 @@ namespace tst
    */
   inline void TestSuite::run(TestResult& result)
   {
+    // a suite with nothing selected to run is not even set up
+    Probe probe;
+    accept(probe);
+
+    if (!probe.active())
+      return;
+
+    enter();
+
+    if (schedule_ == nullptr)
+    {
+      for (auto it = tests_.begin(); it != tests_.end(); ++it)
+      {
+        if (result.stopped())
+          break;
+
+        if ((*it)->selected())
+          (*it)->run(result);
+      }
+
+      leave();
+      return;
+    }
+
+    std::vector<TestBase*> tests;
+    std::vector<Schedule::Estimate> estimates;
+
+    for (auto it = tests_.begin(); it != tests_.end(); ++it)
+    {
+      if ((*it)->selected())
+      {
+        tests.push_back(*it);
+        estimates.push_back(schedule_->estimate(**it));
+      }
+    }
+
+    std::vector<std::size_t> order = schedule_->arrange(estimates);
+
+    for (auto it = order.begin(); it != order.end() && !result.stopped(); ++it)
+      tests[*it]->run(result);
+
+    leave();
+  }
+
+  /**
+   * @copydoc TestBase::accept
+   */
+  inline void TestSuite::accept(TestVisitor& visitor)
+  {
+    visitor.enter(*this);
+
     for (auto it = tests_.begin(); it != tests_.end(); ++it)
-      (*it)->run(result);
+    {
+      if ((*it)->selected())
+        (*it)->accept(visitor);
+    }
+
+    visitor.leave(*this);
   }
 
   /**
@@ -81,6 +172,94 @@ namespace tst
 
     return false;
   }
+
+  /**
+   * Set the schedule determining the order in which the tests directly
+   * contained in this suite are run. Without a schedule they run in the
+   * order they were added in.
+   * @param schedule schedule to use (may be null); it has to stay alive
+   *        as long as it is used
+   */
+  inline void TestSuite::setSchedule(Schedule const* schedule)
+  {
+    schedule_ = schedule;
+  }
+
+  /**
+   * Set up the suite, unless this already happened.
+   */
+  inline void TestSuite::enter()
+  {
+    if (!entered_)
+    {
+      setUpSuite();
+      entered_ = true;
+    }
+  }
+
+  /**
+   * Tear down the suite, if it was set up.
+   */
+  inline void TestSuite::leave()
+  {
+    if (entered_)
+    {
+      entered_ = false;
+      tearDownSuite();
+    }
+  }
+
+  /**
+   * Set up state shared by all tests contained in this suite. It is
+   * called once before the first test runs and not at all if nothing
+   * in the suite is selected. Runners set up all suites containing
+   * tests to run before running any of them; the ForkRunner does so
+   * before starting its worker processes, which inherit the state.
+   */
+  inline void TestSuite::setUpSuite()
+  {
+  }
+
+  /**
+   * Tear down the state set up by 'setUpSuite', once all tests ran.
+   */
+  inline void TestSuite::tearDownSuite()
+  {
+  }
+
+  /**
+   * The default constructor creates a Probe that has found nothing to
+   * run yet.
+   */
+  inline TestSuite::Probe::Probe()
+    : active_(false)
+  {
+  }
+
+  /**
+   * @copydoc TestVisitor::visit
+   */
+  inline void TestSuite::Probe::visit(TestBase&)
+  {
+    active_ = true;
+  }
+
+  /**
+   * @copydoc TestVisitor::visit
+   */
+  inline void TestSuite::Probe::visit(TestCaseBase& test)
+  {
+    if (test.functionCount() == 0 || test.selectedCount() > 0)
+      active_ = true;
+  }
+
+  /**
+   * @return true if a test to run was visited, false otherwise
+   */
+  inline bool TestSuite::Probe::active() const
+  {
+    return active_;
+  }
 }
 
 
@@ -0,0 +1,135 @@
+// TestVector.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTTESTVECTOR_HPP
+#define TSTTESTVECTOR_HPP
+
+#include <vector>
+
+
+namespace tst
+{
+  /**
+   * Objects of this class can be used to group and store a set of test
+   * related objects. In contrast to TestContainer the storage grows as
+   * needed, so that there is no upper limit on the number of tests. The
+   * tests are still stored contiguously.
+   */
+  template<typename T>
+  class TestVector
+  {
+  public:
+    typedef T* Iterator;
+
+    TestVector();
+
+    TestVector(TestVector&&) = delete;
+    TestVector(TestVector const&) = delete;
+
+    TestVector& operator =(TestVector&&) = delete;
+    TestVector& operator =(TestVector const&) = delete;
+
+    bool add(T const& test);
+
+    unsigned int size() const;
+
+    T& operator [](unsigned int index);
+    T const& operator [](unsigned int index) const;
+
+    Iterator begin();
+    Iterator end();
+
+  private:
+    std::vector<T> tests_;
+  };
+}
+
+namespace tst
+{
+  /**
+   * The default constructor creates an empty TestVector.
+   */
+  template<typename T>
+  inline TestVector<T>::TestVector()
+    : tests_()
+  {
+  }
+
+  /**
+   * This method can be used to add a new test to the container.
+   * @param test test case or test suite to add
+   * @return true
+   */
+  template<typename T>
+  inline bool TestVector<T>::add(T const& test)
+  {
+    tests_.push_back(test);
+    return true;
+  }
+
+  /**
+   * @return number of tests stored in the container
+   */
+  template<typename T>
+  inline unsigned int TestVector<T>::size() const
+  {
+    return static_cast<unsigned int>(tests_.size());
+  }
+
+  /**
+   * @param index index of the test to retrieve (has to be less than
+   *        'size()')
+   * @return the test at the given index
+   */
+  template<typename T>
+  inline T& TestVector<T>::operator [](unsigned int index)
+  {
+    return tests_[index];
+  }
+
+  /**
+   * @copydoc TestVector::operator []
+   */
+  template<typename T>
+  inline T const& TestVector<T>::operator [](unsigned int index) const
+  {
+    return tests_[index];
+  }
+
+  /**
+   * @return an iterator to the first test in the container
+   */
+  template<typename T>
+  inline typename TestVector<T>::Iterator TestVector<T>::begin()
+  {
+    return tests_.data();
+  }
+
+  /**
+   * @return an iterator to one past the last test in the container
+   */
+  template<typename T>
+  inline typename TestVector<T>::Iterator TestVector<T>::end()
+  {
+    return tests_.data() + tests_.size();
+  }
+}
+
+
+#endif
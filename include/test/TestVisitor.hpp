@@ -0,0 +1,83 @@
+// TestVisitor.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTTESTVISITOR_HPP
+#define TSTTESTVISITOR_HPP
+
+
+namespace tst
+{
+  class TestBase;
+  class TestCaseBase;
+  class TestSuite;
+
+
+  /**
+   * A TestVisitor can be used to walk a tree of tests (as formed by
+   * TestSuite objects) and to inspect the individual test cases
+   * contained in it. Runners use it to find out about the pieces of
+   * work they can distribute.
+   */
+  class TestVisitor
+  {
+  public:
+    /** Destroy the visitor. */
+    virtual ~TestVisitor() = default;
+
+    /**
+     * Visit a test that does not expose its inner structure. Such a
+     * test can only be run as a whole using 'TestBase::run'.
+     * @param test the test to visit
+     */
+    virtual void visit(TestBase& test) = 0;
+
+    /**
+     * Visit a test case, i.e., a collection of test functions.
+     * @param test the test case to visit
+     */
+    virtual void visit(TestCaseBase& test) = 0;
+
+    virtual void enter(TestSuite& suite);
+    virtual void leave(TestSuite& suite);
+  };
+}
+
+namespace tst
+{
+  /**
+   * Enter a suite, before the tests contained in it are visited. By
+   * default nothing is done.
+   * @param suite the suite entered
+   */
+  inline void TestVisitor::enter(TestSuite& /*suite*/)
+  {
+  }
+
+  /**
+   * Leave a suite, after all tests contained in it were visited. By
+   * default nothing is done.
+   * @param suite the suite left
+   */
+  inline void TestVisitor::leave(TestSuite& /*suite*/)
+  {
+  }
+}
+
+
+#endif
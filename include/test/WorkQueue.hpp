@@ -0,0 +1,201 @@
+// WorkQueue.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTWORKQUEUE_HPP
+#define TSTWORKQUEUE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+
+
+namespace tst
+{
+  /**
+   * A WorkQueue hands out a fixed number of tasks (identified by their
+   * index) to a set of workers. Each worker owns a share of the tasks
+   * and processes them in ascending order. A worker that ran out of
+   * tasks steals half of the remaining tasks of the most loaded other
+   * worker, so that the load is balanced without a central point of
+   * contention.
+   */
+  class WorkQueue
+  {
+  public:
+    WorkQueue(unsigned int workers, std::size_t tasks);
+    ~WorkQueue();
+
+    WorkQueue(WorkQueue&&) = delete;
+    WorkQueue(WorkQueue const&) = delete;
+
+    WorkQueue& operator =(WorkQueue&&) = delete;
+    WorkQueue& operator =(WorkQueue const&) = delete;
+
+    bool pop(unsigned int worker, std::size_t& task);
+
+  private:
+    /*
+     * Tasks are dealt out round robin, so that all workers progress
+     * through the task list at roughly the same pace. A range therefore
+     * describes the tasks 'begin * stride + offset' up to (but not
+     * including) 'end * stride + offset'. Ranges are aligned to keep
+     * them on separate cache lines.
+     */
+    struct alignas(64) Range
+    {
+      std::mutex mutex;
+      std::size_t begin;
+      std::size_t end;
+      std::size_t offset;
+    };
+
+    unsigned int workers_;
+    /* Holds the ranges, with room to spare for aligning them. */
+    std::unique_ptr<char[]> memory_;
+    Range* ranges_;
+
+    bool steal(unsigned int worker);
+  };
+}
+
+namespace tst
+{
+  /**
+   * @param workers number of workers that will pop tasks
+   * @param tasks total number of tasks to distribute
+   */
+  inline WorkQueue::WorkQueue(unsigned int workers, std::size_t tasks)
+    : workers_(workers > 0 ? workers : 1),
+      memory_(new char[workers_ * sizeof(Range) + alignof(Range)]),
+      ranges_(nullptr)
+  {
+    // before C++17 new does not honor alignments beyond that of
+    // std::max_align_t, so we align the ranges ourselves
+    void* memory = memory_.get();
+    std::size_t size = workers_ * sizeof(Range) + alignof(Range);
+
+    memory = std::align(alignof(Range), workers_ * sizeof(Range), memory, size);
+    ranges_ = static_cast<Range*>(memory);
+
+    for (unsigned int i = 0; i < workers_; ++i)
+    {
+      Range& range = *new (&ranges_[i]) Range();
+
+      range.begin = 0;
+      range.end = tasks / workers_ + (i < tasks % workers_ ? 1 : 0);
+      range.offset = i;
+    }
+  }
+
+  /**
+   * Destroy the WorkQueue.
+   */
+  inline WorkQueue::~WorkQueue()
+  {
+    for (unsigned int i = 0; i < workers_; ++i)
+      ranges_[i].~Range();
+  }
+
+  /**
+   * Retrieve the next task for a worker.
+   * @param worker index of the worker asking for work
+   * @param task the retrieved task
+   * @return true if a task was retrieved, false if all tasks have been
+   *         handed out
+   */
+  inline bool WorkQueue::pop(unsigned int worker, std::size_t& task)
+  {
+    Range& range = ranges_[worker];
+
+    do
+    {
+      std::lock_guard<std::mutex> lock(range.mutex);
+
+      if (range.begin < range.end)
+      {
+        task = range.begin++ * workers_ + range.offset;
+        return true;
+      }
+    } while (steal(worker));
+
+    return false;
+  }
+
+  /**
+   * @param worker index of the worker to steal work for
+   * @return true if some work could be stolen, false if there is no
+   *         work left
+   */
+  inline bool WorkQueue::steal(unsigned int worker)
+  {
+    for (;;)
+    {
+      unsigned int victim = workers_;
+      std::size_t most = 0;
+
+      // find the worker with the most remaining tasks; the numbers might
+      // be outdated by the time we actually steal, which is fine
+      for (unsigned int i = 1; i < workers_; ++i)
+      {
+        unsigned int index = (worker + i) % workers_;
+        Range& range = ranges_[index];
+        std::lock_guard<std::mutex> lock(range.mutex);
+
+        if (range.end - range.begin > most)
+        {
+          most = range.end - range.begin;
+          victim = index;
+        }
+      }
+
+      if (victim == workers_)
+        return false;
+
+      std::size_t begin;
+      std::size_t end;
+      std::size_t offset;
+      {
+        Range& range = ranges_[victim];
+        std::lock_guard<std::mutex> lock(range.mutex);
+
+        std::size_t count = range.end - range.begin;
+        if (count == 0)
+          continue;
+
+        end = range.end;
+        begin = end - (count + 1) / 2;
+        offset = range.offset;
+
+        range.end = begin;
+      }
+
+      Range& range = ranges_[worker];
+      std::lock_guard<std::mutex> lock(range.mutex);
+
+      range.begin = begin;
+      range.end = end;
+      range.offset = offset;
+      return true;
+    }
+  }
+}
+
+
+#endif
@@ -0,0 +1,143 @@
+// AllocationsTest.cpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                   *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <memory>
+#include <vector>
+
+#include <test/Allocations.hpp>
+#include <test/TestCase.hpp>
+
+#include "LogResult.hpp"
+
+
+TESTALLOCATIONHOOKS()
+
+
+namespace
+{
+  class Allocating: public tst::TestCase<Allocating>
+  {
+  public:
+    Allocating()
+      : tst::TestCase<Allocating>(*this, "Allocating"),
+        leaked_()
+    {
+      TESTADD(Allocating::testNone);
+      TESTADD(Allocating::testBalanced);
+      TESTADD(Allocating::testLeak);
+      TESTADD(Allocating::testIgnored);
+    }
+
+    void testNone(tst::TestResult&)
+    {
+    }
+
+    void testBalanced(tst::TestResult&)
+    {
+      for (unsigned int i = 0; i < 3; ++i)
+        delete[] new char[64];
+    }
+
+    void testLeak(tst::TestResult&)
+    {
+      leaked_.reset(new char[100]);
+    }
+
+    void testIgnored(tst::TestResult&)
+    {
+      tst::Allocations::Ignore ignore;
+      delete[] new char[64];
+    }
+
+  private:
+    std::unique_ptr<char[]> leaked_;
+  };
+
+  class Asserting: public tst::TestCase<Asserting>
+  {
+  public:
+    Asserting()
+      : tst::TestCase<Asserting>(*this, "Asserting")
+    {
+      TESTADD(Asserting::testAllocations);
+    }
+
+    void testAllocations(tst::TestResult& result)
+    {
+      int value = 0;
+      std::vector<int> values;
+
+      TESTASSERTNOALLOCATIONS(value += 1);
+      TESTASSERTALLOCATIONS(values.push_back(value), 1);
+      TESTASSERTNOALLOCATIONS(values.push_back(value));
+    }
+  };
+}
+
+
+class AllocationsTest: public tst::TestCase<AllocationsTest>
+{
+public:
+  AllocationsTest()
+    : tst::TestCase<AllocationsTest>(*this, "AllocationsTest")
+  {
+  }
+
+  TESTFUNCTION(testMeasuresAllocations)
+  {
+    TESTASSERT(tst::Allocations::installed());
+
+    Allocating allocating;
+    tst::LogResult log;
+
+    allocating.run(log);
+
+    std::vector<tst::Measurement> measurements = log.measurements();
+    TESTASSERTFATAL(measurements.size() == 4);
+
+    TESTASSERTOP(measurements[0].allocations, eq, 0u);
+    TESTASSERTOP(measurements[0].peak, eq, 0u);
+
+    TESTASSERTOP(measurements[1].allocations, eq, 3u);
+    TESTASSERTOP(measurements[1].allocated, eq, 3u * 64u);
+    TESTASSERTOP(measurements[1].peak, eq, 64u);
+    TESTASSERTOP(measurements[1].leaked, eq, 0u);
+
+    TESTASSERTOP(measurements[2].allocations, eq, 1u);
+    TESTASSERTOP(measurements[2].leaked, eq, 100u);
+
+    TESTASSERTOP(measurements[3].allocations, eq, 0u);
+  }
+
+  TESTFUNCTION(testAssertsAllocations)
+  {
+    Asserting asserting;
+    tst::LogResult log;
+
+    asserting.run(log);
+
+    // a vector with room for one element needs to grow for a second
+    TESTASSERTOP(log.checks(), eq, 3u);
+    TESTASSERTOP(log.failures(), eq, 1u);
+    TESTASSERTFATAL(log.messages().size() == 1);
+    TESTASSERT(log.messages()[0] == "Unexpected allocation in: values.push_back(value)");
+  }
+};
+
+TESTCASE(AllocationsTest);
@@ -0,0 +1,157 @@
+// BaselineTest.cpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                   *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+/*
+ * Allocations are counted exactly, which makes them the metric of
+ * choice for testing the comparison against a baseline.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include <test/Allocations.hpp>
+#include <test/Baseline.hpp>
+#include <test/TestCase.hpp>
+
+#include "LogResult.hpp"
+
+
+TESTALLOCATIONHOOKS()
+
+
+namespace
+{
+  char const path[] = "BaselineTest.baseline";
+
+  /**
+   * Allocate and release memory the given number of times.
+   */
+  void allocate(unsigned int count)
+  {
+    for (unsigned int i = 0; i < count; ++i)
+      delete new int(0);
+  }
+
+  class Measuring: public tst::TestCase<Measuring>
+  {
+  public:
+    Measuring(tst::Baseline& baseline, unsigned int count)
+      : tst::TestCase<Measuring>(*this, "Measuring"),
+        baseline_(&baseline),
+        count_(count)
+    {
+      TESTADD(Measuring::testAllocate);
+    }
+
+    void testAllocate(tst::TestResult& result)
+    {
+      TESTASSERTBASELINEIN(*baseline_, Allocations, "allocate", allocate(count_));
+    }
+
+  private:
+    tst::Baseline* baseline_;
+    unsigned int count_;
+  };
+
+  /**
+   * Run a measurement of the given number of allocations against a
+   * baseline.
+   * @return the message of the failure reported, or an empty string if
+   *         the measurement passed
+   */
+  std::string measure(tst::Baseline& baseline, unsigned int count)
+  {
+    Measuring measuring(baseline, count);
+    tst::LogResult log;
+
+    measuring.run(log);
+    return log.messages().empty() ? std::string() : log.messages()[0];
+  }
+}
+
+
+class BaselineTest: public tst::TestCase<BaselineTest>
+{
+public:
+  BaselineTest()
+    : tst::TestCase<BaselineTest>(*this, "BaselineTest")
+  {
+  }
+
+  TESTFUNCTION(testDetectsRegressions)
+  {
+    tst::Baseline baseline;
+
+    // the first measurement becomes the baseline
+    TESTASSERT(measure(baseline, 1).empty());
+    TESTASSERTOP(baseline.size(), eq, 1u);
+    TESTASSERT(measure(baseline, 1).empty());
+    TESTASSERT(measure(baseline, 0).empty());
+
+    std::string message = measure(baseline, 3);
+    TESTASSERT(message.find("allocate regressed: 3 allocations") == 0);
+  }
+
+  TESTFUNCTION(testUpdatesBaseline)
+  {
+    tst::Baseline baseline;
+
+    TESTASSERT(measure(baseline, 1).empty());
+
+    baseline.setUpdate(true);
+    TESTASSERT(measure(baseline, 3).empty());
+
+    baseline.setUpdate(false);
+    TESTASSERT(measure(baseline, 3).empty());
+    TESTASSERT(!measure(baseline, 4).empty());
+  }
+
+  TESTFUNCTION(testSavesAndLoads)
+  {
+    tst::Baseline baseline;
+
+    TESTASSERT(measure(baseline, 2).empty());
+    TESTASSERT(baseline.save(path));
+
+    tst::Baseline loaded;
+
+    TESTASSERT(loaded.load(path));
+    TESTASSERTOP(loaded.size(), eq, 1u);
+    TESTASSERT(measure(loaded, 2).empty());
+    TESTASSERT(!measure(loaded, 3).empty());
+
+    std::remove(path);
+  }
+
+  TESTFUNCTION(testParsesArguments)
+  {
+    char const* update[] = {"test", "--update-baseline"};
+    char const* other[] = {"test", "--other"};
+
+    TESTASSERT(tst::Baseline::updateRequested(2, update));
+    TESTASSERT(tst::Baseline::key("a.cpp", "name") != tst::Baseline::key("b.cpp", "name"));
+    TESTASSERT(tst::Baseline::key("a.cpp", "name") == tst::Baseline::key("a.cpp", "name"));
+
+    if (std::getenv("TST_UPDATE_BASELINE") == nullptr)
+      TESTASSERT(!tst::Baseline::updateRequested(2, other));
+  }
+};
+
+TESTCASE(BaselineTest);
@@ -0,0 +1,210 @@
+// BenchmarkCaseTest.cpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                   *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <test/BenchmarkCase.hpp>
+#include <test/Statistics.hpp>
+#include <test/TestCase.hpp>
+
+
+namespace
+{
+  /**
+   * A BenchmarkReporter logging the events it receives as text, e.g.,
+   * "<A:f=5!>" for a benchmark case A with a function f for which five
+   * samples were taken and that failed.
+   */
+  class LogReporter: public tst::BenchmarkReporter
+  {
+  public:
+    LogReporter()
+      : log_(),
+        message_(),
+        iterations_(0)
+    {
+    }
+
+    virtual void startBenchmark(char const* benchmark) override
+    {
+      log_ += '<';
+      log_ += benchmark;
+      log_ += ':';
+    }
+
+    virtual void endBenchmark() override
+    {
+      log_ += '>';
+    }
+
+    virtual void startBenchmarkFunction(char const* function) override
+    {
+      log_ += function;
+    }
+
+    virtual void endBenchmarkFunction(tst::Statistics const& statistics,
+                                      std::size_t iterations) override
+    {
+      log_ += '=';
+      log_ += std::to_string(statistics.size());
+      log_ += ';';
+      iterations_ = iterations;
+    }
+
+    virtual void failed(char const* message) override
+    {
+      log_ += '!';
+      message_ = message;
+    }
+
+    std::string const& log() const
+    {
+      return log_;
+    }
+
+    std::string const& message() const
+    {
+      return message_;
+    }
+
+    std::size_t iterations() const
+    {
+      return iterations_;
+    }
+
+  private:
+    std::string log_;
+    std::string message_;
+    std::size_t iterations_;
+  };
+
+  class Loop: public tst::BenchmarkCase<Loop>
+  {
+  public:
+    Loop()
+      : tst::BenchmarkCase<Loop>(*this, "Loop"),
+        set_up_(0),
+        torn_down_(0)
+    {
+      setSamples(5);
+      setSampleTime(std::chrono::microseconds(100));
+      setWarmUpTime(std::chrono::microseconds(100));
+
+      TESTADDBENCHMARK(Loop::sum);
+      TESTADDBENCHMARK(Loop::fail);
+    }
+
+    void sum(tst::Benchmark& benchmark)
+    {
+      for (std::size_t i = 0; i < benchmark.iterations(); ++i)
+        tst::doNotOptimize(i * i);
+    }
+
+    void fail(tst::Benchmark&)
+    {
+      throw std::runtime_error("fails");
+    }
+
+    unsigned int set_up_;
+    unsigned int torn_down_;
+
+  protected:
+    virtual void setUp() override
+    {
+      set_up_++;
+    }
+
+    virtual void tearDown() override
+    {
+      torn_down_++;
+    }
+  };
+
+  class Sleep: public tst::BenchmarkCase<Sleep>
+  {
+  public:
+    Sleep()
+      : tst::BenchmarkCase<Sleep>(*this, "Sleep")
+    {
+      setSampleTime(std::chrono::seconds(10));
+      setWarmUpTime(std::chrono::nanoseconds(0));
+      setCalibrationTime(std::chrono::milliseconds(5));
+
+      TESTADDBENCHMARK(Sleep::sleep);
+    }
+
+    // ignores the number of iterations it is asked to run
+    void sleep(tst::Benchmark&)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  };
+}
+
+
+class BenchmarkCaseTest: public tst::TestCase<BenchmarkCaseTest>
+{
+public:
+  BenchmarkCaseTest()
+    : tst::TestCase<BenchmarkCaseTest>(*this, "BenchmarkCaseTest")
+  {
+  }
+
+  TESTFUNCTION(testMeasuresAndReportsFailures)
+  {
+    Loop loop;
+    LogReporter reporter;
+
+    loop.run(reporter);
+
+    TESTASSERT(reporter.log() == "<Loop:sum=5;fail!=0;>");
+    TESTASSERT(reporter.message() == "Unexpected exception");
+    TESTASSERTOP(reporter.iterations(), eq, 0u);
+    TESTASSERTOP(loop.set_up_, eq, 2u);
+    TESTASSERTOP(loop.torn_down_, eq, 2u);
+  }
+
+  TESTFUNCTION(testGivesUpCalibration)
+  {
+    Sleep sleep;
+    LogReporter reporter;
+
+    sleep.run(reporter);
+
+    TESTASSERT(reporter.log() == "<Sleep:sleep!=0;>");
+    TESTASSERT(reporter.message() == "Calibration exceeded the maximum time");
+  }
+
+  TESTFUNCTION(testComputesStatistics)
+  {
+    tst::Statistics statistics({4.0, 1.0, 3.0, 2.0, 100.0});
+
+    TESTASSERTOP(statistics.size(), eq, 5u);
+    TESTASSERTOP(statistics.min(), eq, 1.0);
+    TESTASSERTOP(statistics.max(), eq, 100.0);
+    TESTASSERTOP(statistics.median(), eq, 3.0);
+    TESTASSERTOP(statistics.mean(), eq, 22.0);
+    TESTASSERTOP(statistics.mad(), eq, 1.0);
+  }
+};
+
+TESTCASE(BenchmarkCaseTest);
@@ -0,0 +1,150 @@
+// BufferedPrinterTest.cpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                   *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <climits>
+#include <cstdlib>
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <test/BufferedPrinter.hpp>
+#include <test/DefaultResult.hpp>
+#include <test/TestCase.hpp>
+
+
+namespace
+{
+  class Failing: public tst::TestCase<Failing>
+  {
+  public:
+    Failing()
+      : tst::TestCase<Failing>(*this, "Failing")
+    {
+      TESTADD(Failing::testFail);
+    }
+
+    void testFail(tst::TestResult& result)
+    {
+      TESTASSERTM(false, "fails");
+    }
+  };
+
+  /**
+   * Read everything from a file descriptor until the end of file.
+   */
+  std::string readAll(int fd)
+  {
+    std::string string;
+    char buffer[256];
+    ssize_t count;
+
+    while ((count = read(fd, buffer, sizeof(buffer))) > 0)
+      string.append(buffer, count);
+
+    return string;
+  }
+}
+
+
+class BufferedPrinterTest: public tst::TestCase<BufferedPrinterTest>
+{
+public:
+  BufferedPrinterTest()
+    : tst::TestCase<BufferedPrinterTest>(*this, "BufferedPrinterTest")
+  {
+  }
+
+  TESTFUNCTION(testWritesAllOutput)
+  {
+    int fds[2];
+    TESTASSERTFATAL(pipe(fds) == 0);
+
+    {
+      // buffers much smaller than the output force many round trips
+      // through the writer thread
+      tst::BufferedPrinter printer(fds[1], 7);
+
+      printer << "abc" << ' ' << 0 << ' ' << -42 << ' ' << LLONG_MIN << ' '
+              << ULLONG_MAX << ' ' << static_cast<char const*>(nullptr) << "defghijklmnop";
+      printer.flush();
+      printer << '\n';
+    }
+
+    close(fds[1]);
+
+    std::string output = readAll(fds[0]);
+    close(fds[0]);
+
+    TESTASSERT(output == "abc 0 -42 -9223372036854775808 18446744073709551615 defghijklmnop\n");
+  }
+
+  TESTFUNCTION(testPrintsResults)
+  {
+    int fds[2];
+    TESTASSERTFATAL(pipe(fds) == 0);
+
+    {
+      tst::BufferedPrinter printer(fds[1], 16);
+      tst::DefaultResult<tst::BufferedPrinter> result(printer);
+      Failing failing;
+
+      failing.run(result);
+      result.printSummary();
+    }
+
+    close(fds[1]);
+
+    std::string output = readAll(fds[0]);
+    close(fds[0]);
+
+    TESTASSERT(output.find("fails") != std::string::npos);
+    TESTASSERT(output.find("Functions failed:   1\n") != std::string::npos);
+  }
+
+  TESTFUNCTION(testWritesPendingOutputOnSignal)
+  {
+    int fds[2];
+    TESTASSERTFATAL(pipe(fds) == 0);
+
+    pid_t pid = fork();
+    TESTASSERTFATAL(pid >= 0);
+
+    if (pid == 0)
+    {
+      close(fds[0]);
+
+      tst::BufferedPrinter printer(fds[1]);
+      printer << "pending";
+      std::abort();
+    }
+
+    close(fds[1]);
+
+    std::string output = readAll(fds[0]);
+    close(fds[0]);
+
+    int status = 0;
+    TESTASSERTOP(waitpid(pid, &status, 0), eq, pid);
+    TESTASSERT(WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT);
+    TESTASSERT(output == "pending");
+  }
+};
+
+TESTCASE(BufferedPrinterTest);
@@ -0,0 +1,229 @@
+// CompareTest.cpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                   *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <test/Compare.hpp>
+#include <test/TestCase.hpp>
+
+#include "LogResult.hpp"
+
+
+namespace
+{
+  /**
+   * @return all instruction sets supported by the processor
+   */
+  std::vector<tst::Compare::Isa> supported()
+  {
+    std::vector<tst::Compare::Isa> isas;
+
+    for (int isa = tst::Compare::Scalar; isa <= tst::Compare::best(); ++isa)
+      isas.push_back(static_cast<tst::Compare::Isa>(isa));
+
+    return isas;
+  }
+
+  /**
+   * A case using the bulk assertions.
+   */
+  class Buffers: public tst::TestCase<Buffers>
+  {
+  public:
+    Buffers()
+      : tst::TestCase<Buffers>(*this, "Buffers")
+    {
+      TESTADD(Buffers::testEqual);
+      TESTADD(Buffers::testBytesDiffer);
+      TESTADD(Buffers::testFloatsDiffer);
+    }
+
+    void testEqual(tst::TestResult& result)
+    {
+      std::vector<double> values(1000, 0.5);
+
+      TESTASSERTBUFFER(values.data(), values.data(), values.size() * sizeof(double));
+      TESTASSERTFLOATS(values.data(), values.data(), values.size(), tst::ulps(0));
+    }
+
+    void testBytesDiffer(tst::TestResult& result)
+    {
+      std::vector<unsigned char> first(100, 0xaa);
+      std::vector<unsigned char> second(first);
+
+      second[40] = 0x55;
+      second[99] = 0x00;
+
+      TESTASSERTBUFFER(first.data(), second.data(), first.size());
+    }
+
+    void testFloatsDiffer(tst::TestResult& result)
+    {
+      float first[] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f};
+      float second[] = {1.0f, 2.0f, 3.5f, 4.0f, 5.0f};
+
+      TESTASSERTFLOATS(first, second, 5, tst::absolute(0.25));
+    }
+  };
+}
+
+
+class CompareTest: public tst::TestCase<CompareTest>
+{
+public:
+  CompareTest()
+    : tst::TestCase<CompareTest>(*this, "CompareTest")
+  {
+  }
+
+  TESTFUNCTION(testCountsDifferingBytes)
+  {
+    std::vector<tst::Compare::Isa> isas = supported();
+    std::vector<unsigned char> first(300);
+
+    for (std::size_t i = 0; i < first.size(); ++i)
+      first[i] = static_cast<unsigned char>(i * 7);
+
+    for (auto isa = isas.begin(); isa != isas.end(); ++isa)
+    {
+      // unaligned starts and sizes that are no multiple of the vector
+      // width exercise the tails of the kernels
+      for (std::size_t offset = 0; offset < 3; ++offset)
+      {
+        for (std::size_t size = 0; size < 200; size += 13)
+        {
+          std::vector<unsigned char> second(first);
+          tst::Compare::Mismatch none = tst::Compare::bytes(&first[offset], &second[offset], size, *isa);
+
+          TESTASSERTOP(none.count, eq, 0u);
+          TESTASSERTOP(none.first, eq, size);
+
+          if (size < 3)
+            continue;
+
+          second[offset + 1]++;
+          second[offset + size - 1]++;
+
+          tst::Compare::Mismatch two = tst::Compare::bytes(&first[offset], &second[offset], size, *isa);
+
+          TESTASSERTOP(two.count, eq, 2u);
+          TESTASSERTOP(two.first, eq, 1u);
+
+          // the bytes past the end do not count
+          second[offset + size]++;
+          TESTASSERTOP(tst::Compare::bytes(&first[offset], &second[offset], size, *isa).count, eq, 2u);
+        }
+      }
+    }
+  }
+
+  TESTFUNCTION(testComparesFloatsWithinTolerance)
+  {
+    std::vector<tst::Compare::Isa> isas = supported();
+    float const nan = std::numeric_limits<float>::quiet_NaN();
+    float const one = 1.0f;
+    float const next = std::nextafter(std::nextafter(one, 2.0f), 2.0f);
+
+    for (auto isa = isas.begin(); isa != isas.end(); ++isa)
+    {
+      std::vector<float> first(37, one);
+      std::vector<float> second(37, one);
+
+      first[3] = nan;
+      second[3] = nan;
+      second[20] = next;
+
+      TESTASSERTOP(tst::Compare::floats(first.data(), second.data(), 37, tst::ulps(2), *isa).count, eq, 0u);
+      TESTASSERTOP(tst::Compare::floats(first.data(), second.data(), 37, tst::ulps(1), *isa).first, eq, 20u);
+      TESTASSERTOP(tst::Compare::floats(first.data(), second.data(), 37, tst::absolute(1e-6), *isa).count, eq, 0u);
+      TESTASSERTOP(tst::Compare::floats(first.data(), second.data(), 37, tst::relative(1e-9), *isa).count, eq, 1u);
+
+      // a NaN is not equal to a number
+      second[36] = nan;
+      TESTASSERTOP(tst::Compare::floats(first.data(), second.data(), 37, tst::ulps(2), *isa).first, eq, 36u);
+    }
+  }
+
+  TESTFUNCTION(testComparesDoublesWithinTolerance)
+  {
+    std::vector<tst::Compare::Isa> isas = supported();
+
+    for (auto isa = isas.begin(); isa != isas.end(); ++isa)
+    {
+      std::vector<double> first(19);
+      std::vector<double> second(19);
+
+      for (std::size_t i = 0; i < first.size(); ++i)
+      {
+        first[i] = -1e6 + i * 1e5;
+        second[i] = first[i] * (1.0 + 1e-12);
+      }
+
+      TESTASSERTOP(tst::Compare::floats(first.data(), second.data(), 19, tst::relative(1e-10), *isa).count, eq, 0u);
+
+      tst::Compare::Mismatch mismatch = tst::Compare::floats(first.data(), second.data(), 19, tst::ulps(0), *isa);
+
+      // the value in the middle is zero, which is not scaled
+      TESTASSERTOP(mismatch.count, eq, 18u);
+      TESTASSERTOP(mismatch.first, eq, 0u);
+    }
+
+    TESTASSERT(tst::Compare::equal(-0.0, 0.0, tst::ulps(0)));
+    TESTASSERT(!tst::Compare::equal(1.0, 1.5, tst::absolute(0.25)));
+  }
+
+  TESTFUNCTION(testReportsFirstDifference)
+  {
+    Buffers buffers;
+    tst::LogResult log;
+
+    buffers.run(log);
+
+    std::vector<std::string> messages = log.messages();
+
+    TESTASSERT(log.log() == "<Buffers:testEqual;testBytesDiffer!;testFloatsDiffer!;>");
+    TESTASSERTOP(log.checks(), eq, 4u);
+    TESTASSERTFATAL(messages.size() == 2);
+
+    TESTASSERTOP(messages[0].find("2 of 100 bytes differ, first at offset 40 (0x28)\n"), eq, 0u);
+    TESTASSERT(messages[0].find("first:  00000020: aa aa aa aa aa aa aa aa [aa] aa") != std::string::npos);
+    TESTASSERT(messages[0].find("second: 00000020: aa aa aa aa aa aa aa aa [55] aa") != std::string::npos);
+
+    TESTASSERTOP(messages[1].find("1 of 5 values differ (tolerance 0 ulps, absolute 0.25, relative 0),"
+                                  " first at index 2\n"), eq, 0u);
+    TESTASSERT(messages[1].find("first:  [0] 1 2 <3> 4 5") != std::string::npos);
+    TESTASSERT(messages[1].find("second: [0] 1 2 <3.5> 4 5") != std::string::npos);
+  }
+
+  TESTFUNCTION(testTruncatesLongMessages)
+  {
+    std::vector<unsigned char> first(64, 0);
+    std::vector<unsigned char> second(64, 1);
+    char message[32];
+
+    TESTASSERT(!tst::Compare::checkBytes(first.data(), second.data(), 64, message, sizeof(message)));
+    TESTASSERTOP(std::strlen(message), eq, sizeof(message) - 1);
+  }
+};
+
+TESTCASE(CompareTest);
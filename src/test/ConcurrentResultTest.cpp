@@ -0,0 +1,150 @@
+// ConcurrentResultTest.cpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                   *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <test/ConcurrentResult.hpp>
+#include <test/FanOutResult.hpp>
+#include <test/ParallelRunner.hpp>
+#include <test/TestCase.hpp>
+#include <test/TestSuite.hpp>
+
+
+namespace
+{
+  class Failing: public tst::TestCase<Failing>
+  {
+  public:
+    Failing()
+      : tst::TestCase<Failing>(*this, "Failing")
+    {
+      TESTADD(Failing::testPass);
+      TESTADD(Failing::testFail);
+    }
+
+    void testPass(tst::TestResult& result)
+    {
+      TESTASSERT(true);
+    }
+
+    void testFail(tst::TestResult& result)
+    {
+      TESTASSERTM(false, "fails");
+    }
+  };
+}
+
+
+class ConcurrentResultTest: public tst::TestCase<ConcurrentResultTest>
+{
+public:
+  ConcurrentResultTest()
+    : tst::TestCase<ConcurrentResultTest>(*this, "ConcurrentResultTest")
+  {
+  }
+
+  TESTFUNCTION(testCountsFromManyThreads)
+  {
+    std::ostringstream stream;
+    tst::ConcurrentResult<std::ostream> concurrent(stream);
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < 4; ++i)
+    {
+      threads.emplace_back([&concurrent]()
+      {
+        concurrent.startTest("Thread");
+
+        for (int j = 0; j < 100; ++j)
+        {
+          concurrent.startTestFunction("function");
+          concurrent.checked(__FILE__, __LINE__);
+          concurrent.endTestFunction(tst::Measurement());
+        }
+
+        concurrent.failed(__FILE__, __LINE__, "fails");
+        concurrent.endTest();
+      });
+    }
+
+    for (auto it = threads.begin(); it != threads.end(); ++it)
+      it->join();
+
+    TESTASSERTOP(concurrent.testsRun(), eq, 4);
+    TESTASSERTOP(concurrent.testsFailed(), eq, 4);
+    TESTASSERTOP(concurrent.functionsRun(), eq, 400);
+    TESTASSERTOP(concurrent.assertionsChecked(), eq, 400);
+    TESTASSERTOP(concurrent.assertionsFailed(), eq, 4);
+  }
+
+  TESTFUNCTION(testTwoResultsOnOneThread)
+  {
+    std::ostringstream stream1;
+    std::ostringstream stream2;
+    tst::ConcurrentResult<std::ostream> concurrent1(stream1, true);
+    tst::ConcurrentResult<std::ostream> concurrent2(stream2, true);
+    tst::FanOutResult fan_out;
+    Failing failing;
+
+    fan_out.add(concurrent1);
+    fan_out.add(concurrent2);
+
+    // every event is reported to both results in turn
+    failing.run(fan_out);
+
+    TESTASSERTOP(concurrent1.testsFailed(), eq, 1);
+    TESTASSERTOP(concurrent1.functionsRun(), eq, 2);
+    TESTASSERTOP(concurrent1.functionsFailed(), eq, 1);
+    TESTASSERTOP(concurrent2.testsFailed(), eq, 1);
+    TESTASSERTOP(concurrent2.functionsRun(), eq, 2);
+    TESTASSERTOP(concurrent2.functionsFailed(), eq, 1);
+
+    TESTASSERT(stream1.str().find("Failing::testFail") != std::string::npos);
+    TESTASSERT(stream1.str().find("Failing:\n\t1/2 (50%):\tFailed") != std::string::npos);
+    TESTASSERT(stream2.str() == stream1.str());
+  }
+
+  TESTFUNCTION(testParallelRunner)
+  {
+    std::ostringstream stream;
+    tst::ConcurrentResult<std::ostream> concurrent(stream);
+    std::vector<Failing*> cases;
+    tst::TestSuite suite;
+
+    for (int i = 0; i < 8; ++i)
+    {
+      cases.push_back(new Failing());
+      suite.add(*cases.back());
+    }
+
+    tst::ParallelRunner(4).run(suite, concurrent);
+
+    for (auto it = cases.begin(); it != cases.end(); ++it)
+      delete *it;
+
+    TESTASSERTOP(concurrent.testsRun(), eq, 8);
+    TESTASSERTOP(concurrent.testsFailed(), eq, 8);
+    TESTASSERTOP(concurrent.functionsRun(), eq, 16);
+    TESTASSERTOP(concurrent.assertionsChecked(), eq, 16);
+  }
+};
+
+TESTCASE(ConcurrentResultTest);
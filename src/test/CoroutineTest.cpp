@@ -0,0 +1,321 @@
+// CoroutineTest.cpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                   *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <chrono>
+#include <string>
+
+#include <unistd.h>
+
+#include <test/AsyncRunner.hpp>
+#include <test/EventLoop.hpp>
+#include <test/Task.hpp>
+#include <test/TestCase.hpp>
+#include <test/TestSuite.hpp>
+
+#include "LogResult.hpp"
+
+
+namespace
+{
+  /**
+   * @param trace string to append to
+   * @param milliseconds time to sleep before appending
+   * @param tag character to append
+   */
+  tst::Task sleepAndAppend(std::string& trace, int milliseconds, char tag)
+  {
+    co_await tst::sleep(std::chrono::milliseconds(milliseconds));
+    trace += tag;
+  }
+
+  /**
+   * @param trace string to append to
+   */
+  tst::Task awaitNested(std::string& trace)
+  {
+    trace += '(';
+    co_await sleepAndAppend(trace, 1, 'x');
+    co_await sleepAndAppend(trace, 0, 'y');
+    trace += ')';
+  }
+
+  tst::Task throwAfterYield()
+  {
+    co_await tst::yield();
+    throw 42;
+  }
+
+  /**
+   * @param fd file descriptor to read a byte from
+   * @param byte byte read
+   */
+  tst::Task readByte(int fd, char& byte)
+  {
+    co_await tst::readable(fd);
+
+    if (read(fd, &byte, 1) != 1)
+      byte = '\0';
+  }
+
+  /**
+   * @param fd file descriptor to write a byte to
+   * @param byte byte to write
+   */
+  tst::Task writeByte(int fd, char byte)
+  {
+    co_await tst::yield();
+    co_await tst::writable(fd);
+
+    if (write(fd, &byte, 1) != 1)
+      close(fd);
+  }
+
+
+  /**
+   * A case mixing ordinary test functions and coroutines.
+   */
+  class Async: public tst::TestCase<Async>
+  {
+  public:
+    Async()
+      : tst::TestCase<Async>(*this, "Async")
+    {
+      TESTADD(Async::testSleeps);
+      TESTADD(Async::testOrdinary);
+      TESTADD(Async::testFailsFatally);
+      TESTADD(Async::testThrows);
+    }
+
+    tst::Task testSleeps(tst::TestResult& result)
+    {
+      co_await tst::sleep(std::chrono::milliseconds(1));
+      TESTASSERT(tst::EventLoop::current() != nullptr);
+    }
+
+    void testOrdinary(tst::TestResult& result)
+    {
+      TESTASSERT(true);
+    }
+
+    tst::Task testFailsFatally(tst::TestResult& result)
+    {
+      co_await tst::yield();
+      TESTCOASSERTFATALM(false, "fatal");
+      TESTASSERTM(false, "unreachable");
+    }
+
+    tst::Task testThrows(tst::TestResult&)
+    {
+      co_await throwAfterYield();
+    }
+  };
+
+  /**
+   * A case with coroutines that each wait for a while.
+   */
+  class Waiting: public tst::TestCase<Waiting>
+  {
+  public:
+    explicit Waiting(bool concurrent)
+      : tst::TestCase<Waiting>(*this, "Waiting")
+    {
+      setConcurrent(concurrent);
+
+      TESTADD(Waiting::testWait1);
+      TESTADD(Waiting::testWait2);
+      TESTADD(Waiting::testWait3);
+      TESTADD(Waiting::testWait4);
+    }
+
+    tst::Task testWait1(tst::TestResult& result)
+    {
+      co_await tst::sleep(std::chrono::milliseconds(100));
+      TESTASSERT(true);
+    }
+
+    tst::Task testWait2(tst::TestResult& result)
+    {
+      co_await tst::sleep(std::chrono::milliseconds(100));
+      TESTASSERT(true);
+    }
+
+    tst::Task testWait3(tst::TestResult& result)
+    {
+      co_await tst::sleep(std::chrono::milliseconds(100));
+      TESTASSERT(true);
+    }
+
+    tst::Task testWait4(tst::TestResult& result)
+    {
+      co_await tst::sleep(std::chrono::milliseconds(100));
+      TESTASSERT(true);
+    }
+  };
+
+  /**
+   * @param test test to run
+   * @param runner runner to run the test with
+   * @param log result object to report to
+   * @return wall clock time the run took, in milliseconds
+   */
+  long long timeRun(tst::TestBase& test, tst::AsyncRunner& runner, tst::LogResult& log)
+  {
+    auto start = std::chrono::steady_clock::now();
+    runner.run(test, log);
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+  }
+}
+
+
+class CoroutineTest: public tst::TestCase<CoroutineTest>
+{
+public:
+  CoroutineTest()
+    : tst::TestCase<CoroutineTest>(*this, "CoroutineTest")
+  {
+  }
+
+  TESTFUNCTION(testWakesTasksInDeadlineOrder)
+  {
+    std::string trace;
+    tst::EventLoop loop;
+
+    loop.spawn(sleepAndAppend(trace, 30, 'c'));
+    loop.spawn(sleepAndAppend(trace, 10, 'a'));
+    loop.spawn(sleepAndAppend(trace, 20, 'b'));
+
+    TESTASSERTOP(loop.tasks(), eq, 3u);
+    TESTASSERT(trace.empty());
+
+    loop.run();
+
+    TESTASSERT(trace == "abc");
+    TESTASSERTOP(loop.tasks(), eq, 0u);
+    TESTASSERT(tst::EventLoop::current() == nullptr);
+  }
+
+  TESTFUNCTION(testAwaitsNestedTasks)
+  {
+    std::string trace;
+    tst::EventLoop loop;
+    tst::Task task = awaitNested(trace);
+
+    TESTASSERT(task.valid());
+    TESTASSERT(!task.done());
+
+    loop.run(task);
+
+    TESTASSERT(task.done());
+    TESTASSERT(trace == "(xy)");
+  }
+
+  TESTFUNCTION(testPassesOnExceptions)
+  {
+    tst::EventLoop loop;
+    tst::Task task = throwAfterYield();
+    bool caught = false;
+
+    loop.run(task);
+
+    try
+    {
+      task.rethrow();
+    }
+    catch (int value)
+    {
+      caught = value == 42;
+    }
+
+    TESTASSERT(caught);
+  }
+
+  TESTFUNCTION(testWaitsForFileDescriptors)
+  {
+    int fds[2];
+    TESTASSERTFATAL(pipe(fds) == 0);
+
+    char byte = '\0';
+    tst::EventLoop loop;
+
+    // the reader waits for the writer, which only starts afterwards
+    loop.spawn(readByte(fds[0], byte));
+    loop.spawn(writeByte(fds[1], '!'));
+    loop.run();
+
+    close(fds[0]);
+    close(fds[1]);
+
+    TESTASSERTOP(byte, eq, '!');
+  }
+
+  TESTFUNCTION(testRunsCoroutineFunctions)
+  {
+    Async async;
+    tst::LogResult log;
+
+    TESTASSERTOP(async.functionCount(), eq, 4u);
+    TESTASSERT(async.functionAsync(0));
+    TESTASSERT(!async.functionAsync(1));
+
+    async.run(log);
+
+    std::vector<std::string> messages = log.messages();
+
+    TESTASSERT(log.log() == "<Async:testSleeps;testOrdinary;testFailsFatally!;testThrows!;>");
+    TESTASSERTOP(log.checks(), eq, 4u);
+    TESTASSERTFATAL(messages.size() == 2);
+    TESTASSERT(messages[0] == "fatal");
+    TESTASSERT(messages[1] == "Unexpected exception");
+  }
+
+  TESTFUNCTION(testReplaysInSerialOrder)
+  {
+    Async async;
+    tst::LogResult serial;
+    async.run(serial);
+
+    tst::LogResult log;
+    tst::AsyncRunner(2).run(async, log);
+
+    TESTASSERT(log.log() == serial.log());
+    TESTASSERT(log.messages() == serial.messages());
+  }
+
+  TESTFUNCTION(testInterleavesWaitingFunctions)
+  {
+    Waiting concurrent(true);
+    Waiting serial(false);
+    tst::AsyncRunner runner(1);
+    tst::LogResult log1;
+    tst::LogResult log2;
+
+    // all functions of the concurrent case wait at the same time on a
+    // single thread, those of the other one after each other
+    TESTASSERTOP(timeRun(concurrent, runner, log1), lt, 300);
+    TESTASSERTOP(timeRun(serial, runner, log2), ge, 400);
+
+    TESTASSERT(log1.log() == "<Waiting:testWait1;testWait2;testWait3;testWait4;>");
+    TESTASSERT(log2.log() == log1.log());
+    TESTASSERTOP(log1.checks(), eq, 4u);
+  }
+};
+
+TESTCASE(CoroutineTest);
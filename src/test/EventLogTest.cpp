@@ -0,0 +1,244 @@
+// EventLogTest.cpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                   *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <test/EventLog.hpp>
+#include <test/EventLogResult.hpp>
+#include <test/TestCase.hpp>
+
+#include "LogResult.hpp"
+
+
+namespace
+{
+  char const path[] = "EventLogTest.log";
+
+  /**
+   * A case with passing and failing functions to log.
+   */
+  class Logged: public tst::TestCase<Logged>
+  {
+  public:
+    Logged()
+      : tst::TestCase<Logged>(*this, "Logged")
+    {
+      TESTADD(Logged::testPasses);
+      TESTADD(Logged::testFails);
+    }
+
+    void testPasses(tst::TestResult& result)
+    {
+      for (unsigned int i = 0; i < 1000; ++i)
+        TESTASSERT(i < 1000);
+    }
+
+    void testFails(tst::TestResult& result)
+    {
+      TESTASSERTM(false, "first");
+      TESTASSERTM(false, "second");
+      TESTASSERTM(false, "first");
+    }
+  };
+
+  /**
+   * @param log log to describe
+   * @return the records of the log as text, e.g., "<Logged:testFails(3)!first>"
+   */
+  std::string describe(tst::EventLog const& log)
+  {
+    std::string text;
+
+    log.forEach([&](tst::EventLog::Record const& record)
+    {
+      switch (record.type)
+      {
+      case tst::EventLog::StartTest:
+        text += std::string("<") + log.string(record.string) + ":";
+        break;
+
+      case tst::EventLog::EndTest:
+        text += ">";
+        break;
+
+      case tst::EventLog::StartFunction:
+        text += log.string(record.string);
+        break;
+
+      case tst::EventLog::EndFunction:
+        text += "(" + std::to_string(record.number) + ")";
+        break;
+
+      case tst::EventLog::Failed:
+        text += std::string("!") + log.string(record.message);
+        break;
+
+      default:
+        text += "?";
+        break;
+      }
+    });
+    return text;
+  }
+
+  /**
+   * Write a log of a run with the given outcomes, for the query-log
+   * tool tests.
+   * @param file path of the log to write
+   * @param walls wall clock time of each function, in milliseconds
+   * @param failing index of the function that fails
+   * @param count number of functions
+   * @return true if the log was written, false otherwise
+   */
+  bool writeRun(char const* file, unsigned int const* walls, unsigned int failing, unsigned int count)
+  {
+    tst::EventLogResult result(file);
+    char const* names[] = {"f1", "f2", "f3", "f4"};
+
+    result.startTest("Case");
+
+    for (unsigned int i = 0; i < count; ++i)
+    {
+      result.startTestFunction(names[i]);
+      result.checked("Case.cpp", 10 * (i + 1));
+
+      if (i == failing)
+        result.failed(i == 1 ? "A.cpp" : "B.cpp", 10 * (i + 1), "broken");
+
+      tst::Measurement measurement = tst::Measurement();
+      measurement.wall = walls[i] * 1000000ull;
+      result.endTestFunction(measurement);
+    }
+
+    result.endTest();
+    return result.flush();
+  }
+}
+
+
+class EventLogTest: public tst::TestCase<EventLogTest>
+{
+public:
+  EventLogTest()
+    : tst::TestCase<EventLogTest>(*this, "EventLogTest")
+  {
+  }
+
+  TESTFUNCTION(testLogsEvents)
+  {
+    Logged logged;
+    tst::LogResult forwarded;
+
+    {
+      tst::EventLogResult logging(path, forwarded);
+
+      TESTASSERT(logging.valid());
+      logged.run(logging);
+    }
+
+    // all events are forwarded as they happen
+    TESTASSERT(forwarded.log() == "<Logged:testPasses;testFails!!!;>");
+    TESTASSERTOP(forwarded.checks(), eq, 1003u);
+
+    tst::EventLog log(path);
+    std::uint32_t const magic = tst::EventLog::Magic;
+    std::uint32_t const version = tst::EventLog::Version;
+
+    TESTASSERTFATAL(log.valid());
+    TESTASSERTOP(log.header().magic, eq, magic);
+    TESTASSERTOP(log.header().version, eq, version);
+    TESTASSERT(describe(log) == "<Logged:testPasses(1000)testFails!first!second!first(3)>");
+
+    // strings are stored once each, in order of first use
+    TESTASSERT(log.string(0) == nullptr);
+    TESTASSERT(std::strcmp(log.string(1), "Logged") == 0);
+    TESTASSERT(std::strcmp(log.string(4), __FILE__) == 0);
+    TESTASSERT(std::strcmp(log.string(6), "second") == 0);
+    TESTASSERT(log.string(7) == nullptr);
+  }
+
+  TESTFUNCTION(testDropsTruncatedStrings)
+  {
+    {
+      tst::EventLogResult logging(path);
+
+      logging.startTest("Case");
+      logging.startTestFunction("a function with a name spanning more than a single record of the log");
+    }
+
+    std::FILE* file = std::fopen(path, "r+b");
+    TESTASSERTFATAL(file != nullptr);
+
+    // cut the log off in the middle of the second string
+    int status = std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::fclose(file);
+
+    TESTASSERTFATAL(status == 0);
+    TESTASSERTFATAL(truncate(path, size - 2 * sizeof(tst::EventLog::Record)) == 0);
+
+    tst::EventLog log(path);
+
+    TESTASSERT(log.valid());
+    TESTASSERT(std::strcmp(log.string(1), "Case") == 0);
+    TESTASSERT(log.string(2) == nullptr);
+  }
+
+  TESTFUNCTION(testRejectsOtherFiles)
+  {
+    std::FILE* file = std::fopen(path, "wb");
+    TESTASSERTFATAL(file != nullptr);
+
+    tst::EventLog::Header header = tst::EventLog::Header();
+    header.magic = tst::EventLog::Magic;
+    header.version = tst::EventLog::Version + 1;
+    header.size = sizeof(tst::EventLog::Record);
+
+    std::fwrite(&header, sizeof(header), 1, file);
+    std::fclose(file);
+
+    TESTASSERT(!tst::EventLog(path).valid());
+    TESTASSERT(!tst::EventLog("EventLogTest.missing").valid());
+    TESTASSERT(!tst::EventLogResult("EventLogTest.missing/log").valid());
+  }
+
+  TESTFUNCTION(testWritesRunsToQuery)
+  {
+    // f2 gets fixed, f3 starts failing, f1 gets slower, and f4 is added
+    unsigned int const old[] = {1, 1, 2};
+    unsigned int const current[] = {10, 1, 2, 3};
+
+    TESTASSERT(writeRun("EventLogTest.old.log", old, 1, 3));
+    TESTASSERT(writeRun("EventLogTest.new.log", current, 2, 4));
+  }
+
+protected:
+  virtual void tearDown() override
+  {
+    std::remove(path);
+  }
+};
+
+TESTCASE(EventLogTest);
@@ -0,0 +1,141 @@
+// FatalTest.cpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                   *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+/*
+ * This file is built once for each way a fatal assertion failure can
+ * terminate a test function (see Fatal).
+ */
+
+#include <test/ParallelRunner.hpp>
+#include <test/TestCase.hpp>
+#include <test/TestSuite.hpp>
+
+#include "LogResult.hpp"
+
+
+namespace
+{
+  /**
+   * Fail fatally from within a function called by a test function.
+   */
+  void fail(tst::TestResult& result)
+  {
+    TESTASSERTFATALM(false, "fatal");
+  }
+
+  class Terminating: public tst::TestCase<Terminating>
+  {
+  public:
+    Terminating(char const* name)
+      : tst::TestCase<Terminating>(*this, name),
+        set_up_(0),
+        torn_down_(0),
+        reached_(0)
+    {
+      TESTADD(Terminating::testFatal);
+      TESTADD(Terminating::testPass);
+#ifndef TST_FATAL_RETURN
+      TESTADD(Terminating::testNested);
+#endif
+      TESTADD(Terminating::testFatal);
+    }
+
+    void testFatal(tst::TestResult& result)
+    {
+      TESTASSERTFATALM(false, "fatal");
+      reached_++;
+    }
+
+    void testPass(tst::TestResult& result)
+    {
+      TESTASSERTFATAL(true);
+      reached_++;
+    }
+
+    void testNested(tst::TestResult& result)
+    {
+      fail(result);
+      reached_++;
+    }
+
+    unsigned int set_up_;
+    unsigned int torn_down_;
+    unsigned int reached_;
+
+  protected:
+    virtual void setUp() override
+    {
+      set_up_++;
+    }
+
+    virtual void tearDown() override
+    {
+      torn_down_++;
+    }
+  };
+}
+
+
+class FatalTest: public tst::TestCase<FatalTest>
+{
+public:
+  FatalTest()
+    : tst::TestCase<FatalTest>(*this, "FatalTest")
+  {
+  }
+
+  TESTFUNCTION(testTerminatesFunction)
+  {
+    Terminating fatal("Fatal");
+    tst::LogResult log;
+
+    fatal.run(log);
+
+    unsigned int functions = fatal.functionCount();
+
+    TESTASSERTOP(log.failures(), eq, functions - 1);
+    TESTASSERTOP(log.checks(), eq, functions);
+    TESTASSERTOP(fatal.reached_, eq, 1u);
+    TESTASSERTOP(fatal.set_up_, eq, functions);
+    TESTASSERTOP(fatal.torn_down_, eq, functions);
+  }
+
+  TESTFUNCTION(testTerminatesFunctionOnWorkerThreads)
+  {
+    Terminating case1("Case1");
+    Terminating case2("Case2");
+    Terminating case3("Case3");
+    tst::TestSuite suite;
+
+    suite.add(case1);
+    suite.add(case2);
+    suite.add(case3);
+
+    tst::LogResult serial;
+    suite.run(serial);
+
+    tst::LogResult parallel;
+    tst::ParallelRunner(3).run(suite, parallel);
+
+    TESTASSERT(parallel.log() == serial.log());
+    TESTASSERTOP(parallel.failures(), eq, serial.failures());
+  }
+};
+
+TESTCASE(FatalTest);
@@ -0,0 +1,132 @@
+// FilterTest.cpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                   *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <cstring>
+
+#include <test/Filter.hpp>
+#include <test/TestCase.hpp>
+#include <test/TestSuite.hpp>
+
+#include "LogResult.hpp"
+
+
+namespace
+{
+  class Parser: public tst::TestCase<Parser>
+  {
+  public:
+    Parser(char const* name)
+      : tst::TestCase<Parser>(*this, name)
+    {
+      TESTADD(Parser::testParse);
+      TESTADD(Parser::testSlowParse);
+      add(&Parser::testAnonymous);
+    }
+
+    void testParse(tst::TestResult& result)
+    {
+      TESTASSERT(true);
+    }
+
+    void testSlowParse(tst::TestResult& result)
+    {
+      TESTASSERT(true);
+    }
+
+    void testAnonymous(tst::TestResult& result)
+    {
+      TESTASSERT(true);
+    }
+  };
+}
+
+
+class FilterTest: public tst::TestCase<FilterTest>
+{
+public:
+  FilterTest()
+    : tst::TestCase<FilterTest>(*this, "FilterTest")
+  {
+  }
+
+  TESTFUNCTION(testNamesFunctions)
+  {
+    Parser parser("Parser");
+
+    TESTASSERTOP(parser.functionCount(), eq, 3u);
+    TESTASSERT(std::strcmp(parser.functionName(0), "testParse") == 0);
+    TESTASSERT(std::strcmp(parser.functionName(1), "testSlowParse") == 0);
+    TESTASSERT(parser.functionName(2) == nullptr);
+  }
+
+  TESTFUNCTION(testMatchesPatterns)
+  {
+    TESTASSERT(tst::Filter().empty());
+    TESTASSERT(tst::Filter().matches("Parser", "testParse"));
+
+    tst::Filter filter("Pars?r*,-*::testSlow*");
+
+    TESTASSERT(!filter.empty());
+    TESTASSERT(filter.matches("Parser", "testParse"));
+    TESTASSERT(filter.matches("ParserTest", "testParse"));
+    TESTASSERT(!filter.matches("Parser", "testSlowParse"));
+    TESTASSERT(!filter.matches("Lexer", "testParse"));
+
+    // only negative patterns select everything else
+    tst::Filter negative("-Lexer");
+
+    TESTASSERT(negative.matches("Parser", nullptr));
+    TESTASSERT(!negative.matches("Lexer", nullptr));
+
+    tst::Filter qualified("*::testParse");
+
+    TESTASSERT(qualified.matches("Lexer", "testParse"));
+    TESTASSERT(!qualified.matches("Lexer", "testParseMore"));
+    TESTASSERT(!qualified.matches("Lexer", nullptr));
+  }
+
+  TESTFUNCTION(testParsesArguments)
+  {
+    char const* argv[] = {"test", "--other", "--filter=Parser::testParse,Lexer"};
+    tst::Filter filter = tst::Filter::fromArguments(3, argv);
+
+    TESTASSERT(filter.matches("Parser", "testParse"));
+    TESTASSERT(!filter.matches("Parser", "testSlowParse"));
+    TESTASSERT(filter.matches("Lexer", "testLex"));
+  }
+
+  TESTFUNCTION(testRunsSelectedFunctions)
+  {
+    Parser parser("Parser");
+    Parser lexer("Lexer");
+    tst::TestSuite suite;
+
+    suite.add(parser);
+    suite.add(lexer);
+
+    tst::Filter("Parser,-*::testSlow*").apply(suite);
+
+    tst::LogResult log;
+    suite.run(log);
+
+    TESTASSERT(log.log() == "<Parser:testParse;?;>");
+  }
+};
+
+TESTCASE(FilterTest);
@@ -0,0 +1,103 @@
+// FixedCapacityTest.cpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                   *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+/*
+ * This file is built with TST_FIXED_CAPACITY and without exceptions,
+ * the configuration used for firmware. TestCase must not pull in any
+ * of the features that need the heap or an operating system there.
+ */
+
+#include <test/TestCase.hpp>
+
+#if TST_PROPERTIES || TST_COROUTINES
+#  error "property tests and coroutines must be disabled by default"
+#endif
+
+#if defined(TSTEVENTLOOP_HPP) || defined(TSTPERFCOUNTERS_HPP)
+#  error "TestCase must not include the headers of disabled features"
+#endif
+
+#include "LogResult.hpp"
+
+
+namespace
+{
+  class Fixed: public tst::TestCase<Fixed>
+  {
+  public:
+    Fixed()
+      : tst::TestCase<Fixed>(*this, "Fixed"),
+        set_up_(0),
+        torn_down_(0)
+    {
+      TESTADD(Fixed::testPass);
+      TESTADD(Fixed::testFatal);
+    }
+
+    void testPass(tst::TestResult& result)
+    {
+      TESTASSERT(true);
+    }
+
+    void testFatal(tst::TestResult& result)
+    {
+      TESTASSERTFATALM(false, "fatal");
+      TESTASSERTM(false, "not reached");
+    }
+
+    unsigned int set_up_;
+    unsigned int torn_down_;
+
+  protected:
+    virtual void setUp() override
+    {
+      set_up_++;
+    }
+
+    virtual void tearDown() override
+    {
+      torn_down_++;
+    }
+  };
+}
+
+
+class FixedCapacityTest: public tst::TestCase<FixedCapacityTest>
+{
+public:
+  FixedCapacityTest()
+    : tst::TestCase<FixedCapacityTest>(*this, "FixedCapacityTest")
+  {
+  }
+
+  TESTFUNCTION(testFatalWithoutExceptions)
+  {
+    Fixed fixed;
+    tst::LogResult log;
+
+    fixed.run(log);
+
+    TESTASSERT(log.log() == "<Fixed:testPass;testFatal!;>");
+    TESTASSERTOP(log.checks(), eq, 2u);
+    TESTASSERTOP(fixed.set_up_, eq, 2u);
+    TESTASSERTOP(fixed.torn_down_, eq, 2u);
+  }
+};
+
+TESTCASE(FixedCapacityTest);
@@ -0,0 +1,236 @@
+// FixturesTest.cpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                   *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <test/Filter.hpp>
+#include <test/Fixtures.hpp>
+#include <test/ParallelRunner.hpp>
+#include <test/TestCase.hpp>
+#include <test/TestSuite.hpp>
+
+#include "LogResult.hpp"
+
+
+namespace
+{
+  /**
+   * A list of the fixture events of a run, e.g., "+S" when suite S is
+   * set up and "-S" when it is torn down.
+   */
+  class Events
+  {
+  public:
+    void add(char sign, char const* name)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      events_ += sign;
+      events_ += name;
+      events_ += ' ';
+    }
+
+    std::string get() const
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return events_;
+    }
+
+  private:
+    mutable std::mutex mutex_;
+    std::string events_;
+  };
+
+  class Suite: public tst::TestSuite
+  {
+  public:
+    Suite(char const* name, Events& events)
+      : name_(name),
+        events_(&events)
+    {
+    }
+
+  protected:
+    virtual void setUpSuite() override
+    {
+      events_->add('+', name_);
+    }
+
+    virtual void tearDownSuite() override
+    {
+      events_->add('-', name_);
+    }
+
+  private:
+    char const* name_;
+    Events* events_;
+  };
+
+  class Case: public tst::TestCase<Case>
+  {
+  public:
+    Case(char const* name, Events& events, bool concurrent = false)
+      : tst::TestCase<Case>(*this, name),
+        events_(&events)
+    {
+      setConcurrent(concurrent);
+
+      TESTADD(Case::test1);
+      TESTADD(Case::test2);
+      TESTADD(Case::test3);
+    }
+
+    void test1(tst::TestResult& result)
+    {
+      TESTASSERT(true);
+    }
+
+    void test2(tst::TestResult& result)
+    {
+      TESTASSERT(true);
+    }
+
+    void test3(tst::TestResult& result)
+    {
+      TESTASSERT(true);
+    }
+
+  protected:
+    virtual void setUpCase() override
+    {
+      events_->add('+', name());
+    }
+
+    virtual void tearDownCase() override
+    {
+      events_->add('-', name());
+    }
+
+  private:
+    Events* events_;
+  };
+
+  struct Expensive
+  {
+    static std::atomic<unsigned int> constructed;
+
+    Expensive()
+    {
+      constructed++;
+    }
+  };
+
+  std::atomic<unsigned int> Expensive::constructed(0);
+}
+
+
+class FixturesTest: public tst::TestCase<FixturesTest>
+{
+public:
+  FixturesTest()
+    : tst::TestCase<FixturesTest>(*this, "FixturesTest")
+  {
+  }
+
+  TESTFUNCTION(testSetsUpAroundFunctions)
+  {
+    Events events;
+    Suite outer("Outer", events);
+    Suite inner("Inner", events);
+    Suite unused("Unused", events);
+    Case case1("A", events);
+    Case case2("B", events);
+    Case case3("C", events);
+
+    outer.add(case1);
+    outer.add(inner);
+    outer.add(unused);
+    inner.add(case2);
+    unused.add(case3);
+
+    // a suite with nothing to run is not set up
+    tst::Filter("A,B").apply(outer);
+
+    tst::LogResult log;
+    outer.run(log);
+
+    TESTASSERT(events.get() == "+Outer +A -A +Inner +B -B -Inner -Outer ");
+    TESTASSERTOP(log.measurements().size(), eq, 6u);
+  }
+
+  TESTFUNCTION(testSetsUpOnceForParallelRuns)
+  {
+    for (unsigned int workers = 1; workers < 5; ++workers)
+    {
+      Events events;
+      Suite outer("Outer", events);
+      Suite inner("Inner", events);
+      Case case1("A", events, true);
+      Case case2("B", events, true);
+
+      outer.add(inner);
+      inner.add(case1);
+      inner.add(case2);
+
+      tst::LogResult log(true);
+      tst::ParallelRunner(workers).run(outer, log);
+
+      std::string string = events.get();
+
+      TESTASSERT(string.find("+Outer +Inner ") == 0);
+      TESTASSERT(string.find("-Inner -Outer ") == string.size() - 14);
+      // each case is set up once, even with its functions run on
+      // multiple threads
+      TESTASSERTOP(string.size(), eq, 40u);
+      TESTASSERT(string.find("+A ") < string.find("-A "));
+      TESTASSERT(string.find("+B ") < string.find("-B "));
+      TESTASSERTOP(log.measurements().size(), eq, 6u);
+    }
+  }
+
+  TESTFUNCTION(testConstructsSharedFixtureOnce)
+  {
+    Expensive::constructed = 0;
+
+    tst::SharedFixture<Expensive> fixture;
+    std::vector<std::thread> threads;
+
+    TESTASSERT(!fixture.constructed());
+
+    for (unsigned int i = 0; i < 8; ++i)
+      threads.emplace_back([&fixture]() { fixture.get(); });
+
+    for (auto it = threads.begin(); it != threads.end(); ++it)
+      it->join();
+
+    TESTASSERT(fixture.constructed());
+    TESTASSERTOP(Expensive::constructed.load(), eq, 1u);
+
+    fixture.reset();
+
+    TESTASSERT(!fixture.constructed());
+    TESTASSERT(&*fixture == fixture.operator ->());
+    TESTASSERTOP(Expensive::constructed.load(), eq, 2u);
+  }
+};
+
+TESTCASE(FixturesTest);
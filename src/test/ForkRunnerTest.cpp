@@ -0,0 +1,124 @@
+// ForkRunnerTest.cpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                   *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+#include <test/ForkRunner.hpp>
+#include <test/TestCase.hpp>
+#include <test/TestSuite.hpp>
+
+#include "LogResult.hpp"
+
+
+namespace
+{
+  class Crashing: public tst::TestCase<Crashing>
+  {
+  public:
+    Crashing()
+      : tst::TestCase<Crashing>(*this, "Crashing")
+    {
+      TESTADD(Crashing::testFailThenCrash);
+      TESTADD(Crashing::testPass);
+    }
+
+    void testFailThenCrash(tst::TestResult& result)
+    {
+      TESTASSERTM(false, "fails");
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      std::abort();
+    }
+
+    void testPass(tst::TestResult& result)
+    {
+      TESTASSERT(true);
+    }
+  };
+
+  class Hanging: public tst::TestCase<Hanging>
+  {
+  public:
+    Hanging()
+      : tst::TestCase<Hanging>(*this, "Hanging")
+    {
+      TESTADDTIMEOUT(Hanging::testHang, std::chrono::milliseconds(100));
+      TESTADD(Hanging::testPass);
+    }
+
+    void testHang(tst::TestResult&)
+    {
+      std::this_thread::sleep_for(std::chrono::seconds(10));
+    }
+
+    void testPass(tst::TestResult& result)
+    {
+      TESTASSERT(true);
+    }
+  };
+}
+
+
+class ForkRunnerTest: public tst::TestCase<ForkRunnerTest>
+{
+public:
+  ForkRunnerTest()
+    : tst::TestCase<ForkRunnerTest>(*this, "ForkRunnerTest")
+  {
+  }
+
+  TESTFUNCTION(testKeepsFailuresBeforeCrash)
+  {
+    Crashing crashing;
+    tst::TestSuite suite;
+    tst::LogResult log;
+
+    suite.add(crashing);
+    tst::ForkRunner(1).run(suite, log);
+
+    TESTASSERT(log.log() == "<Crashing:testFailThenCrash!!;testPass;>");
+    TESTASSERTFATAL(log.messages().size() == 2);
+    TESTASSERT(log.messages()[0] == "fails");
+    TESTASSERT(log.messages()[1].find("Terminated by signal") == 0);
+
+    // the function ran for at least as long as it slept
+    TESTASSERTOP(log.measurements()[0].wall, ge, 20000000u);
+  }
+
+  TESTFUNCTION(testTimesOut)
+  {
+    Hanging hanging;
+    tst::TestSuite suite;
+    tst::LogResult log;
+
+    suite.add(hanging);
+    tst::ForkRunner(1).run(suite, log);
+
+    TESTASSERT(log.log() == "<Hanging:testHang!;testPass;>");
+    TESTASSERTFATAL(log.messages().size() == 1);
+    TESTASSERT(log.messages()[0].find("Timed out after") == 0);
+
+    std::uint64_t wall = log.measurements()[0].wall;
+    TESTASSERTOP(wall, ge, 100000000u);
+    TESTASSERTOP(wall, lt, 10000000000u);
+  }
+};
+
+TESTCASE(ForkRunnerTest);
@@ -0,0 +1,244 @@
+// HistoryTest.cpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                   *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <cstdint>
+#include <cstdio>
+
+#include <test/FailFastResult.hpp>
+#include <test/History.hpp>
+#include <test/HistoryResult.hpp>
+#include <test/Schedule.hpp>
+#include <test/TestCase.hpp>
+#include <test/TestSuite.hpp>
+
+#include "LogResult.hpp"
+
+
+namespace
+{
+  char const path[] = "HistoryTest.history";
+
+  /**
+   * Write a history file with the given header and raw records.
+   * @return true if the file was written, false otherwise
+   */
+  bool writeHistory(std::uint32_t count, void const* records, std::size_t size)
+  {
+    std::FILE* file = std::fopen(path, "wb");
+    if (file == nullptr)
+      return false;
+
+    std::uint32_t const header[] = {0x48545354, 3, count};
+    bool success = std::fwrite(header, sizeof(header), 1, file) == 1 &&
+                   (size == 0 || std::fwrite(records, size, 1, file) == 1);
+
+    return std::fclose(file) == 0 && success;
+  }
+
+  class Outcome: public tst::TestCase<Outcome>
+  {
+  public:
+    Outcome(char const* name, bool fail)
+      : tst::TestCase<Outcome>(*this, name),
+        fail_(fail)
+    {
+      TESTADD(Outcome::test1);
+      TESTADD(Outcome::test2);
+    }
+
+    void test1(tst::TestResult& result)
+    {
+      TESTASSERTM(!fail_, "fails");
+    }
+
+    void test2(tst::TestResult& result)
+    {
+      TESTASSERT(true);
+    }
+
+  private:
+    bool fail_;
+  };
+}
+
+
+class HistoryTest: public tst::TestCase<HistoryTest>
+{
+public:
+  HistoryTest()
+    : tst::TestCase<HistoryTest>(*this, "HistoryTest")
+  {
+  }
+
+  TESTFUNCTION(testSavesAndLoads)
+  {
+    tst::History history;
+    history.update(tst::History::key("B"), 2.0, true);
+    history.update(tst::History::key("A"), 1.0);
+    history.update(tst::History::key("A"), 5.0);
+
+    TESTASSERT(history.save(path));
+
+    // the temporary file is gone once the history was saved
+    std::FILE* temporary = std::fopen("HistoryTest.history.tmp", "rb");
+    TESTASSERT(temporary == nullptr);
+
+    if (temporary != nullptr)
+      std::fclose(temporary);
+
+    tst::History loaded;
+    double seconds = 0.0;
+
+    TESTASSERT(loaded.load(path));
+    TESTASSERTOP(loaded.size(), eq, 2u);
+    TESTASSERT(loaded.duration(tst::History::key("A"), seconds));
+    TESTASSERTOP(seconds, eq, 2.0);
+    TESTASSERT(loaded.failed(tst::History::key("B")));
+    TESTASSERT(!loaded.failed(tst::History::key("A")));
+
+    std::remove(path);
+  }
+
+  TESTFUNCTION(testRejectsTruncatedFile)
+  {
+    tst::History history;
+    history.update(tst::History::key("A"), 1.0);
+
+    // a count of four billion records, backed by none
+    TESTASSERT(writeHistory(0xffffffff, nullptr, 0));
+    TESTASSERT(!history.load(path));
+    TESTASSERTOP(history.size(), eq, 1u);
+
+    std::remove(path);
+  }
+
+  TESTFUNCTION(testRejectsUnsortedRecords)
+  {
+    struct Record
+    {
+      std::uint64_t key;
+      double seconds;
+      double instructions;
+      std::uint32_t status;
+      std::uint32_t runs;
+    };
+
+    Record records[] = {
+      {2, 1.0, 0.0, 0, 1},
+      {1, 1.0, 0.0, 0, 1},
+    };
+
+    tst::History history;
+
+    TESTASSERT(writeHistory(2, records, sizeof(records)));
+    TESTASSERT(!history.load(path));
+
+    records[0].key = 0;
+
+    TESTASSERT(writeHistory(2, records, sizeof(records)));
+    TESTASSERT(history.load(path));
+    TESTASSERTOP(history.size(), eq, 2u);
+
+    std::remove(path);
+  }
+
+  TESTFUNCTION(testRecordsResults)
+  {
+    Outcome pass("Pass", false);
+    Outcome fail("Fail", true);
+    tst::TestSuite suite;
+
+    suite.add(pass);
+    suite.add(fail);
+
+    tst::History history;
+    tst::LogResult log;
+    tst::HistoryResult recorder(history, log);
+
+    suite.run(recorder);
+
+    double seconds = -1.0;
+
+    // two cases along with two functions each
+    TESTASSERTOP(history.size(), eq, 6u);
+    TESTASSERT(history.duration(tst::History::key("Pass", "test2"), seconds));
+    TESTASSERT(seconds >= 0.0);
+    TESTASSERT(!history.failed(tst::History::key("Pass")));
+    TESTASSERT(history.failed(tst::History::key("Fail")));
+    TESTASSERT(history.failed(tst::History::key("Fail", "test1")));
+    TESTASSERT(!history.failed(tst::History::key("Fail", "test2")));
+    TESTASSERT(log.log() == "<Pass:test1;test2;><Fail:test1!;test2;>");
+  }
+
+  TESTFUNCTION(testSchedulesFailedAndLongestFirst)
+  {
+    tst::History history;
+    history.update(tst::History::key("A"), 1.0);
+    history.update(tst::History::key("B"), 3.0);
+    history.update(tst::History::key("C"), 0.5, true);
+
+    Outcome a("A", false);
+    Outcome b("B", false);
+    Outcome c("C", false);
+    Outcome d("D", false);
+    tst::TestSuite suite;
+
+    suite.add(a);
+    suite.add(b);
+    suite.add(c);
+    suite.add(d);
+
+    // D is unknown and assumed to take as long as the average
+    tst::Schedule schedule(history);
+    suite.setSchedule(&schedule);
+
+    tst::LogResult log;
+    suite.run(log);
+
+    TESTASSERT(log.log() == "<C:test1;test2;><B:test1;test2;><D:test1;test2;><A:test1;test2;>");
+
+    tst::Schedule longest(history, tst::Schedule::LongestFirst);
+    suite.setSchedule(&longest);
+
+    tst::LogResult unordered;
+    suite.run(unordered);
+
+    TESTASSERT(unordered.log() == "<B:test1;test2;><D:test1;test2;><A:test1;test2;><C:test1;test2;>");
+  }
+
+  TESTFUNCTION(testStopsAfterFailures)
+  {
+    Outcome first("First", true);
+    Outcome second("Second", true);
+    tst::TestSuite suite;
+
+    suite.add(first);
+    suite.add(second);
+
+    tst::LogResult log;
+    tst::FailFastResult fail_fast(log);
+
+    suite.run(fail_fast);
+
+    TESTASSERT(fail_fast.stopped());
+    TESTASSERT(log.log() == "<First:test1!;>");
+  }
+};
+
+TESTCASE(HistoryTest);
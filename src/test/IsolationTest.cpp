@@ -0,0 +1,225 @@
+// IsolationTest.cpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                   *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <atomic>
+
+#include <test/InstancePool.hpp>
+#include <test/ParallelRunner.hpp>
+#include <test/TestCase.hpp>
+#include <test/TestSuite.hpp>
+
+#include "LogResult.hpp"
+
+
+namespace
+{
+  /**
+   * An isolated case created by its default constructor. Each function
+   * expects to see a fresh instance.
+   */
+  class Fresh: public tst::TestCase<Fresh>
+  {
+  public:
+    static std::atomic<unsigned int> created;
+    static std::atomic<unsigned int> destroyed;
+
+    Fresh()
+      : tst::TestCase<Fresh>(*this, "Fresh"),
+        state_(0),
+        set_up_case_(false)
+    {
+      setIsolated(true);
+
+      TESTADD(Fresh::test1);
+      TESTADD(Fresh::test2);
+      TESTADD(Fresh::test3);
+
+      created++;
+    }
+
+    ~Fresh()
+    {
+      destroyed++;
+    }
+
+    void test1(tst::TestResult& result)
+    {
+      TESTASSERTOP(++state_, eq, 1u);
+    }
+
+    void test2(tst::TestResult& result)
+    {
+      TESTASSERTOP(++state_, eq, 1u);
+    }
+
+    void test3(tst::TestResult& result)
+    {
+      TESTASSERTOP(++state_, eq, 1u);
+    }
+
+    unsigned int state_;
+    bool set_up_case_;
+
+  protected:
+    virtual void setUpCase() override
+    {
+      set_up_case_ = true;
+    }
+  };
+
+  std::atomic<unsigned int> Fresh::created(0);
+  std::atomic<unsigned int> Fresh::destroyed(0);
+
+  /**
+   * An isolated case providing a cheap constructor for its instances.
+   */
+  class Tagged: public tst::TestCase<Tagged>
+  {
+  public:
+    static std::atomic<unsigned int> tagged;
+
+    Tagged()
+      : tst::TestCase<Tagged>(*this, "Tagged"),
+        state_(0)
+    {
+      setIsolated(true);
+
+      TESTADD(Tagged::test1);
+      TESTADD(Tagged::test2);
+    }
+
+    Tagged(Isolated tag)
+      : tst::TestCase<Tagged>(tag),
+        state_(0)
+    {
+      tagged++;
+    }
+
+    void test1(tst::TestResult& result)
+    {
+      TESTASSERTOP(++state_, eq, 1u);
+    }
+
+    void test2(tst::TestResult& result)
+    {
+      TESTASSERTOP(++state_, eq, 1u);
+    }
+
+  private:
+    unsigned int state_;
+  };
+
+  std::atomic<unsigned int> Tagged::tagged(0);
+}
+
+
+class IsolationTest: public tst::TestCase<IsolationTest>
+{
+public:
+  IsolationTest()
+    : tst::TestCase<IsolationTest>(*this, "IsolationTest")
+  {
+  }
+
+  TESTFUNCTION(testRunsFunctionsOnFreshInstances)
+  {
+    Fresh::created = 0;
+    Fresh::destroyed = 0;
+
+    {
+      Fresh fresh;
+      tst::LogResult log;
+
+      TESTASSERT(fresh.isolated());
+      TESTASSERT(fresh.concurrent());
+
+      fresh.run(log);
+
+      TESTASSERT(log.log() == "<Fresh:test1;test2;test3;>");
+      TESTASSERTOP(log.failures(), eq, 0u);
+      TESTASSERTOP(log.checks(), eq, 3u);
+
+      // the case is set up on the instance it was created with
+      TESTASSERT(fresh.set_up_case_);
+      TESTASSERTOP(fresh.state_, eq, 0u);
+      TESTASSERTOP(fresh.functionCount(), eq, 3u);
+      TESTASSERTOP(Fresh::created.load(), eq, 4u);
+      TESTASSERTOP(Fresh::destroyed.load(), eq, 3u);
+    }
+
+    // one instance at a time needs just one slot
+    TESTASSERTOP(tst::InstancePool<Fresh>::global().capacity(), eq, 1u);
+  }
+
+  TESTFUNCTION(testPrefersTaggedConstructor)
+  {
+    Tagged::tagged = 0;
+
+    Tagged tagged;
+    tst::LogResult log;
+
+    tagged.run(log);
+
+    TESTASSERTOP(log.failures(), eq, 0u);
+    TESTASSERTOP(Tagged::tagged.load(), eq, 2u);
+  }
+
+  TESTFUNCTION(testRunsFunctionsConcurrently)
+  {
+    Fresh::created = 0;
+
+    Fresh fresh;
+    Tagged tagged;
+    tst::TestSuite suite;
+
+    suite.add(fresh);
+    suite.add(tagged);
+
+    tst::LogResult serial;
+    suite.run(serial);
+
+    tst::LogResult parallel;
+    tst::ParallelRunner(4).run(suite, parallel);
+
+    TESTASSERT(parallel.log() == serial.log());
+    TESTASSERTOP(parallel.failures(), eq, 0u);
+    TESTASSERTOP(Fresh::created.load(), eq, 7u);
+  }
+
+  TESTFUNCTION(testReusesPooledMemory)
+  {
+    tst::InstancePool<int> pool;
+
+    void* first = pool.acquire();
+    void* second = pool.acquire();
+
+    // the pool doubles in size whenever it runs out of memory
+    TESTASSERT(first != second);
+    TESTASSERTOP(pool.capacity(), eq, 2u);
+    pool.acquire();
+    TESTASSERTOP(pool.capacity(), eq, 4u);
+
+    pool.release(first);
+
+    TESTASSERT(pool.acquire() == first);
+    TESTASSERTOP(pool.capacity(), eq, 4u);
+  }
+};
+
+TESTCASE(IsolationTest);
@@ -0,0 +1,208 @@
+// LogResult.hpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                   *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TSTLOGRESULT_HPP
+#define TSTLOGRESULT_HPP
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <test/Measurement.hpp>
+#include <test/TestResult.hpp>
+
+
+namespace tst
+{
+  /**
+   * A TestResult used by the tests of the framework itself. It logs
+   * the events it receives as text, e.g., "<A:f!>" for a test case A
+   * with a function f that failed, so that tests can compare what a
+   * runner reported against what they expect.
+   */
+  class LogResult: public TestResult
+  {
+  public:
+    explicit LogResult(bool thread_safe = false);
+
+    LogResult(LogResult&&) = delete;
+    LogResult(LogResult const&) = delete;
+
+    LogResult& operator =(LogResult&&) = delete;
+    LogResult& operator =(LogResult const&) = delete;
+
+    virtual bool threadSafe() const override;
+
+    virtual void startTest(char const* test) override;
+    virtual void endTest() override;
+
+    virtual void startTestFunction(char const* function) override;
+    virtual void endTestFunction(Measurement const& measurement) override;
+
+    virtual void checked(char const* file, int line) override;
+    virtual void failed(char const* file, int line, char const* message) override;
+
+    std::string log() const;
+    std::vector<std::string> messages() const;
+    std::vector<Measurement> measurements() const;
+
+    unsigned int checks() const;
+    unsigned int failures() const;
+
+  private:
+    bool thread_safe_;
+    mutable std::mutex mutex_;
+    std::string log_;
+    std::vector<std::string> messages_;
+    std::vector<Measurement> measurements_;
+    unsigned int checks_;
+  };
+}
+
+namespace tst
+{
+  /**
+   * @param thread_safe true if the result object is to claim being
+   *        thread-safe, i.e., if runners are to report to it directly
+   */
+  inline LogResult::LogResult(bool thread_safe)
+    : thread_safe_(thread_safe),
+      mutex_(),
+      log_(),
+      messages_(),
+      measurements_(),
+      checks_(0)
+  {
+  }
+
+  /**
+   * @copydoc TestResult::threadSafe
+   */
+  inline bool LogResult::threadSafe() const
+  {
+    return thread_safe_;
+  }
+
+  /**
+   * @copydoc TestResult::startTest
+   */
+  inline void LogResult::startTest(char const* test)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    log_ += '<';
+    log_ += test;
+    log_ += ':';
+  }
+
+  /**
+   * @copydoc TestResult::endTest
+   */
+  inline void LogResult::endTest()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    log_ += '>';
+  }
+
+  /**
+   * @copydoc TestResult::startTestFunction
+   */
+  inline void LogResult::startTestFunction(char const* function)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    log_ += function != nullptr ? function : "?";
+  }
+
+  /**
+   * @copydoc TestResult::endTestFunction
+   */
+  inline void LogResult::endTestFunction(Measurement const& measurement)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    log_ += ';';
+    checks_ += static_cast<unsigned int>(measurement.checked);
+    measurements_.push_back(measurement);
+  }
+
+  /**
+   * @copydoc TestResult::checked
+   */
+  inline void LogResult::checked(char const*, int)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    checks_++;
+  }
+
+  /**
+   * @copydoc TestResult::failed
+   */
+  inline void LogResult::failed(char const*, int, char const* message)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    log_ += '!';
+    messages_.push_back(message);
+  }
+
+  /**
+   * @return all events received so far, as text
+   */
+  inline std::string LogResult::log() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return log_;
+  }
+
+  /**
+   * @return messages of all failures received so far
+   */
+  inline std::vector<std::string> LogResult::messages() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return messages_;
+  }
+
+  /**
+   * @return measurements of all test functions that ended so far
+   */
+  inline std::vector<Measurement> LogResult::measurements() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return measurements_;
+  }
+
+  /**
+   * @return number of assertions checked so far
+   */
+  inline unsigned int LogResult::checks() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return checks_;
+  }
+
+  /**
+   * @return number of failures received so far
+   */
+  inline unsigned int LogResult::failures() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<unsigned int>(messages_.size());
+  }
+}
+
+
+#endif
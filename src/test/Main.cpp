@@ -0,0 +1,43 @@
+// Main.cpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                   *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <iostream>
+
+#include <test/Filter.hpp>
+#include <test/TestRegistry.hpp>
+#include <test/TestSuite.hpp>
+#include <test/DefaultResult.hpp>
+
+
+/**
+ * Run all test cases registered with TESTCASE, or the ones selected by
+ * --filter or TST_FILTER.
+ * @return 0 if all assertions held, 1 otherwise
+ */
+int main(int argc, char* argv[])
+{
+  tst::DefaultResult<std::ostream> result(std::cout, true);
+  tst::TestSuite& suite = tst::TestRegistry::suite();
+
+  tst::Filter::fromArguments(argc, argv).apply(suite);
+  suite.run(result);
+
+  result.printSummary();
+  return result.assertionsFailed() > 0 ? 1 : 0;
+}
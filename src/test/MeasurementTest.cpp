@@ -0,0 +1,124 @@
+// MeasurementTest.cpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                   *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+#include <test/DefaultResult.hpp>
+#include <test/TestCase.hpp>
+
+#include "LogResult.hpp"
+
+
+namespace
+{
+  void sleep(unsigned int milliseconds)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+  }
+
+  class Timed: public tst::TestCase<Timed>
+  {
+  public:
+    Timed()
+      : tst::TestCase<Timed>(*this, "Timed")
+    {
+      TESTADD(Timed::testSlow);
+      TESTADD(Timed::testFast);
+    }
+
+    void testSlow(tst::TestResult&)
+    {
+      sleep(30);
+    }
+
+    void testFast(tst::TestResult&)
+    {
+    }
+
+  protected:
+    virtual void setUp() override
+    {
+      sleep(10);
+    }
+
+    virtual void tearDown() override
+    {
+      sleep(20);
+    }
+  };
+}
+
+
+class MeasurementTest: public tst::TestCase<MeasurementTest>
+{
+public:
+  MeasurementTest()
+    : tst::TestCase<MeasurementTest>(*this, "MeasurementTest")
+  {
+  }
+
+  TESTFUNCTION(testMeasuresPhases)
+  {
+    Timed timed;
+    tst::LogResult log;
+
+    timed.run(log);
+
+    std::vector<tst::Measurement> measurements = log.measurements();
+    TESTASSERTFATAL(measurements.size() == 2);
+
+    tst::Measurement const& slow = measurements[0];
+    TESTASSERTOP(slow.set_up, ge, 10000000u);
+    TESTASSERTOP(slow.tear_down, ge, 20000000u);
+    TESTASSERTOP(slow.wall, ge, 60000000u);
+    TESTASSERTOP(slow.wall, ge, slow.set_up + slow.tear_down);
+    // the thread slept, so it could not have used the CPU all along
+    TESTASSERTOP(slow.cpu, lt, slow.wall);
+
+    // fields that are not measured are zero
+    TESTASSERTOP(slow.allocations, eq, 0u);
+    TESTASSERTOP(slow.leaked, eq, 0u);
+    TESTASSERTOP(slow.checked, eq, 0u);
+
+    tst::Measurement const& fast = measurements[1];
+    TESTASSERTOP(fast.wall, ge, 30000000u);
+    TESTASSERTOP(fast.wall, lt, slow.wall);
+  }
+
+  TESTFUNCTION(testReportsSlowest)
+  {
+    Timed timed;
+    std::ostringstream stream;
+    tst::DefaultResult<std::ostream> report(stream, false, 1);
+
+    timed.run(report);
+    report.printSummary();
+
+    std::string output = stream.str();
+    std::string::size_type slowest = output.find("Slowest functions:");
+
+    TESTASSERT(slowest != std::string::npos);
+    TESTASSERT(output.find("Timed::testSlow", slowest) != std::string::npos);
+    TESTASSERT(output.find("Timed::testFast", slowest) == std::string::npos);
+  }
+};
+
+TESTCASE(MeasurementTest);
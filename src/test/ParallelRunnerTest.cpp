@@ -0,0 +1,236 @@
+// ParallelRunnerTest.cpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                   *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <set>
+#include <stdexcept>
+
+#include <test/ParallelRunner.hpp>
+#include <test/TestCase.hpp>
+#include <test/TestSuite.hpp>
+#include <test/WorkQueue.hpp>
+
+#include "LogResult.hpp"
+
+
+namespace
+{
+  class Serial: public tst::TestCase<Serial>
+  {
+  public:
+    Serial(char const* name)
+      : tst::TestCase<Serial>(*this, name)
+    {
+      TESTADD(Serial::testPass);
+      TESTADD(Serial::testFail);
+    }
+
+    void testPass(tst::TestResult& result)
+    {
+      TESTASSERT(true);
+    }
+
+    void testFail(tst::TestResult& result)
+    {
+      TESTASSERTM(false, "fails");
+    }
+  };
+
+  class Concurrent: public tst::TestCase<Concurrent>
+  {
+  public:
+    Concurrent()
+      : tst::TestCase<Concurrent>(*this, "Concurrent")
+    {
+      setConcurrent(true);
+
+      TESTADD(Concurrent::test1);
+      TESTADD(Concurrent::test2);
+      TESTADD(Concurrent::test3);
+    }
+
+    void test1(tst::TestResult& result)
+    {
+      TESTASSERT(true);
+    }
+
+    void test2(tst::TestResult& result)
+    {
+      TESTASSERTM(false, "fails");
+    }
+
+    void test3(tst::TestResult& result)
+    {
+      TESTASSERT(true);
+    }
+  };
+
+  class Throwing: public tst::TestCase<Throwing>
+  {
+  public:
+    enum Phase
+    {
+      SetUpCase,
+      SetUp,
+      TearDown,
+    };
+
+    Throwing(char const* name, Phase phase)
+      : tst::TestCase<Throwing>(*this, name),
+        phase_(phase)
+    {
+      setConcurrent(true);
+
+      TESTADD(Throwing::test1);
+      TESTADD(Throwing::test2);
+    }
+
+    void test1(tst::TestResult& result)
+    {
+      TESTASSERTM(phase_ == TearDown, "runs despite failed set up");
+    }
+
+    void test2(tst::TestResult& result)
+    {
+      TESTASSERTM(phase_ == TearDown, "runs despite failed set up");
+    }
+
+  protected:
+    virtual void setUpCase() override
+    {
+      if (phase_ == SetUpCase)
+        throw std::runtime_error("setUpCase");
+    }
+
+    virtual void setUp() override
+    {
+      if (phase_ == SetUp)
+        throw std::runtime_error("setUp");
+    }
+
+    virtual void tearDown() override
+    {
+      if (phase_ == TearDown)
+        throw std::runtime_error("tearDown");
+    }
+
+  private:
+    Phase phase_;
+  };
+}
+
+
+class ParallelRunnerTest: public tst::TestCase<ParallelRunnerTest>
+{
+public:
+  ParallelRunnerTest()
+    : tst::TestCase<ParallelRunnerTest>(*this, "ParallelRunnerTest")
+  {
+  }
+
+  TESTFUNCTION(testWorkQueueHandsOutEachTaskOnce)
+  {
+    for (unsigned int workers = 1; workers < 5; ++workers)
+    {
+      tst::WorkQueue queue(workers, 13);
+      std::multiset<std::size_t> tasks;
+      std::size_t task;
+
+      // the last worker does all the work, stealing from the others
+      while (queue.pop(workers - 1, task))
+        tasks.insert(task);
+
+      TESTASSERTOP(tasks.size(), eq, 13u);
+
+      for (std::size_t i = 0; i < 13; ++i)
+        TESTASSERTOP(tasks.count(i), eq, 1u);
+    }
+  }
+
+  TESTFUNCTION(testReportsInSerialOrder)
+  {
+    Serial case1("Case1");
+    Serial case2("Case2");
+    Serial case3("Case3");
+    Concurrent concurrent;
+    tst::TestSuite suite;
+
+    suite.add(case1);
+    suite.add(concurrent);
+    suite.add(case2);
+    suite.add(case3);
+
+    tst::LogResult serial;
+    suite.run(serial);
+
+    for (unsigned int workers = 1; workers < 5; ++workers)
+    {
+      tst::LogResult parallel;
+      tst::ParallelRunner(workers).run(suite, parallel);
+
+      TESTASSERT(parallel.log() == serial.log());
+      TESTASSERTOP(parallel.checks(), eq, serial.checks());
+    }
+  }
+
+  TESTFUNCTION(testReportsDirectlyToThreadSafeResult)
+  {
+    Serial case1("Case1");
+    Concurrent concurrent;
+    tst::TestSuite suite;
+
+    suite.add(case1);
+    suite.add(concurrent);
+
+    tst::LogResult log(true);
+    tst::ParallelRunner(4).run(suite, log);
+
+    TESTASSERTOP(log.measurements().size(), eq, 5u);
+    TESTASSERTOP(log.failures(), eq, 2u);
+    TESTASSERTOP(log.checks(), eq, 5u);
+  }
+
+  TESTFUNCTION(testReportsExceptionsFromFixtures)
+  {
+    Throwing set_up_case("SetUpCase", Throwing::SetUpCase);
+    Throwing set_up("SetUp", Throwing::SetUp);
+    Throwing tear_down("TearDown", Throwing::TearDown);
+    tst::TestSuite suite;
+
+    suite.add(set_up_case);
+    suite.add(set_up);
+    suite.add(tear_down);
+
+    tst::LogResult serial;
+    suite.run(serial);
+
+    TESTASSERTOP(serial.measurements().size(), eq, 6u);
+    TESTASSERTOP(serial.failures(), eq, 6u);
+
+    for (unsigned int workers = 1; workers < 5; ++workers)
+    {
+      tst::LogResult parallel;
+      tst::ParallelRunner(workers).run(suite, parallel);
+
+      TESTASSERT(parallel.log() == serial.log());
+      TESTASSERT(parallel.messages() == serial.messages());
+    }
+  }
+};
+
+TESTCASE(ParallelRunnerTest);
@@ -0,0 +1,115 @@
+// PerfCountersTest.cpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                   *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+/*
+ * Perf events may not be permitted where the tests run, e.g., inside a
+ * container; the checks needing them are skipped in that case.
+ */
+
+#include <cstdlib>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <test/PerfCounters.hpp>
+#include <test/TestCase.hpp>
+
+#include "LogResult.hpp"
+
+
+namespace
+{
+  /**
+   * Touch a few megabytes of fresh memory, which causes page faults.
+   */
+  unsigned int touch()
+  {
+    std::vector<char> memory(16 * 1024 * 1024, 1);
+    return memory[memory.size() / 2];
+  }
+
+  class Faulting: public tst::TestCase<Faulting>
+  {
+  public:
+    Faulting()
+      : tst::TestCase<Faulting>(*this, "Faulting")
+    {
+      TESTADD(Faulting::testTouch);
+    }
+
+    void testTouch(tst::TestResult& result)
+    {
+      TESTASSERTOP(touch(), eq, 1u);
+    }
+  };
+}
+
+
+class PerfCountersTest: public tst::TestCase<PerfCountersTest>
+{
+public:
+  PerfCountersTest()
+    : tst::TestCase<PerfCountersTest>(*this, "PerfCountersTest")
+  {
+  }
+
+  TESTFUNCTION(testCountsEventsOfFunctions)
+  {
+    if (!tst::PerfCounters::thread().available())
+      return;
+
+    Faulting faulting;
+    tst::LogResult log;
+
+    faulting.run(log);
+
+    std::vector<tst::Measurement> measurements = log.measurements();
+    TESTASSERTFATAL(measurements.size() == 1);
+    TESTASSERT(measurements[0].events.page_faults > 0);
+
+    if (tst::PerfCounters::thread().instructions())
+      TESTASSERT(measurements[0].events.instructions > 0);
+  }
+
+  TESTFUNCTION(testCountsEventsOfForkedChild)
+  {
+    if (!tst::PerfCounters::thread().available())
+      return;
+
+    pid_t pid = fork();
+    TESTASSERTFATAL(pid >= 0);
+
+    if (pid == 0)
+    {
+      // the counters inherited from the parent count the parent's events
+      tst::PerfCounts start = tst::PerfCounters::thread().read();
+      touch();
+      tst::PerfCounts events = tst::PerfCounters::thread().read() - start;
+
+      _exit(events.page_faults > 0 ? 0 : 1);
+    }
+
+    int status = 0;
+    TESTASSERTOP(waitpid(pid, &status, 0), eq, pid);
+    TESTASSERT(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  }
+};
+
+TESTCASE(PerfCountersTest);
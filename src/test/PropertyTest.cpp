@@ -0,0 +1,175 @@
+// PropertyTest.cpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                   *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <string>
+#include <vector>
+
+#include <test/Generator.hpp>
+#include <test/Property.hpp>
+#include <test/TestCase.hpp>
+
+#include "LogResult.hpp"
+
+
+namespace
+{
+  /**
+   * A case with property tests that hold and ones that do not.
+   */
+  class Properties: public tst::TestCase<Properties>
+  {
+  public:
+    Properties()
+      : tst::TestCase<Properties>(*this, "Properties")
+    {
+      TESTADDPROPERTY(Properties::testHolds, tst::integers<int>());
+      TESTADDPROPERTY(Properties::testSmall, tst::integers<int>(0, 1000));
+      TESTADDPROPERTY(Properties::testThrows, tst::integers<int>(0, 1000));
+    }
+
+    void testHolds(tst::TestResult& result, int const& value)
+    {
+      TESTASSERTOP(value, eq, value);
+    }
+
+    void testSmall(tst::TestResult& result, int const& value)
+    {
+      TESTASSERTOP(value, lt, 10);
+    }
+
+    void testThrows(tst::TestResult& result, int const& value)
+    {
+      TESTASSERT(true);
+
+      if (value >= 20)
+        throw 0;
+    }
+  };
+
+  /**
+   * @param result result object to report to
+   * @param values list of values to check
+   */
+  void noLargeValues(tst::TestResult& result, std::vector<int> const& values)
+  {
+    for (auto it = values.begin(); it != values.end(); ++it)
+      TESTASSERTOP(*it, lt, 50);
+  }
+
+  /**
+   * @param property property test settings to check with
+   * @return the message reported for the falsified property
+   */
+  std::string falsify(tst::Property const& property)
+  {
+    tst::LogResult log;
+    tst::Generator<std::vector<int>> generator = tst::vectors(tst::integers<int>(0, 100));
+
+    if (property.check<std::vector<int>>(log, generator, &noLargeValues, 1))
+      return std::string();
+
+    std::vector<std::string> messages = log.messages();
+    return messages.size() == 1 ? messages[0] : std::string();
+  }
+}
+
+
+class PropertyTest: public tst::TestCase<PropertyTest>
+{
+public:
+  PropertyTest()
+    : tst::TestCase<PropertyTest>(*this, "PropertyTest")
+  {
+  }
+
+  TESTFUNCTION(testReportsShrunkCounterexamples)
+  {
+    Properties properties;
+    tst::LogResult log;
+
+    properties.run(log);
+
+    TESTASSERT(log.log() == "<Properties:testHolds;testSmall!;testThrows!;>");
+    TESTASSERTOP(log.checks(), eq, 3u);
+
+    std::vector<std::string> messages = log.messages();
+    TESTASSERTOP(messages.size(), eq, 2u);
+
+    // the smallest values for which the properties do not hold
+    TESTASSERTOP(messages[0].find("Falsified after "), eq, 0u);
+    TESTASSERT(messages[0].find(") by 10: ") != std::string::npos);
+    TESTASSERT(messages[1].find(") by 20: Unexpected exception") != std::string::npos);
+  }
+
+  TESTFUNCTION(testShrinksCompositeValues)
+  {
+    std::string message = falsify(tst::Property(200, 1, 42));
+
+    TESTASSERT(message.find("(seed 42, ") != std::string::npos);
+    TESTASSERT(message.find(") by [50]: ") != std::string::npos);
+  }
+
+  TESTFUNCTION(testIndependentOfThreads)
+  {
+    std::string serial = falsify(tst::Property(200, 1, 42));
+    std::string parallel = falsify(tst::Property(200, 8, 42));
+
+    TESTASSERT(!serial.empty());
+    TESTASSERT(parallel == serial);
+    TESTASSERT(falsify(tst::Property(200, 8, 43)).find("(seed 43, ") != std::string::npos);
+  }
+
+  TESTFUNCTION(testLimitsShrinks)
+  {
+    tst::Property property(200, 4, 42);
+    property.setShrinks(0);
+
+    std::string message = falsify(property);
+
+    TESTASSERT(message.find(", shrunk 0 times) by ") != std::string::npos);
+    TESTASSERT(message.find(") by [50]: ") == std::string::npos);
+  }
+
+  TESTFUNCTION(testGeneratesValuesInRange)
+  {
+    tst::Generator<int> generator = tst::integers<int>(-5, 5);
+    tst::Random random(42);
+
+    for (unsigned int size = 0; size <= 100; ++size)
+    {
+      int value = generator(random, size);
+
+      TESTASSERTOP(value, ge, -5);
+      TESTASSERTOP(value, le, 5);
+    }
+
+    TESTASSERT(generator.shrink(0).empty());
+    TESTASSERTOP(generator.shrink(4).front(), eq, 0);
+    TESTASSERT(generator.print(-3) == "-3");
+
+    tst::Generator<std::vector<std::string>> strings = tst::vectors(tst::strings(4, "ab"), 3);
+    tst::Random first(7);
+    tst::Random second(7);
+
+    TESTASSERT(strings(first, 100) == strings(second, 100));
+    TESTASSERT(strings.print(std::vector<std::string>()) == "[]");
+  }
+};
+
+TESTCASE(PropertyTest);
@@ -0,0 +1,133 @@
+// RegistryTest.cpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                   *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <chrono>
+#include <string>
+
+#include <test/TestCase.hpp>
+#include <test/TestVisitor.hpp>
+
+#include "LogResult.hpp"
+
+
+namespace
+{
+  // not registered itself, or the driver would run it
+  class Ordered: public tst::TestCase<Ordered>
+  {
+  public:
+    Ordered()
+      : tst::TestCase<Ordered>(*this, "Ordered")
+    {
+    }
+
+    TESTFUNCTION(testC)
+    {
+      TESTASSERT(true);
+    }
+
+    TESTFUNCTION(testA)
+    {
+      TESTASSERT(true);
+    }
+
+    TESTFUNCTIONTIMEOUT(testB, std::chrono::seconds(5))
+    {
+      TESTASSERT(true);
+    }
+  };
+
+  class Many: public tst::TestCase<Many>
+  {
+  public:
+    Many(unsigned int count)
+      : tst::TestCase<Many>(*this, "Many")
+    {
+      for (unsigned int i = 0; i < count; ++i)
+        add(&Many::test);
+    }
+
+    void test(tst::TestResult& result)
+    {
+      TESTASSERT(true);
+    }
+  };
+
+  class Names: public tst::TestVisitor
+  {
+  public:
+    virtual void visit(tst::TestBase&) override
+    {
+    }
+
+    virtual void visit(tst::TestCaseBase& test) override
+    {
+      names += test.name();
+      names += ';';
+    }
+
+    std::string names;
+  };
+}
+
+
+class RegistryTest: public tst::TestCase<RegistryTest>
+{
+public:
+  RegistryTest()
+    : tst::TestCase<RegistryTest>(*this, "RegistryTest")
+  {
+  }
+
+  TESTFUNCTION(testRunsFunctionsInDeclarationOrder)
+  {
+    Ordered ordered;
+    tst::LogResult log;
+
+    ordered.run(log);
+
+    TESTASSERT(log.log() == "<Ordered:testC;testA;testB;>");
+    TESTASSERT(ordered.functionTimeout(0) == std::chrono::milliseconds::zero());
+    TESTASSERT(ordered.functionTimeout(2) == std::chrono::seconds(5));
+  }
+
+  TESTFUNCTION(testHoldsMoreThan256Functions)
+  {
+    Many many(1000);
+    tst::LogResult log;
+
+    many.run(log);
+
+    TESTASSERTOP(many.functionCount(), eq, 1000u);
+    TESTASSERTOP(log.measurements().size(), eq, 1000u);
+    TESTASSERTOP(log.checks(), eq, 1000u);
+  }
+
+  TESTFUNCTION(testRegistersCases)
+  {
+    Names names;
+    tst::TestRegistry::suite().accept(names);
+
+    // this very case is run from the registry's suite, as a single
+    // instance
+    TESTASSERT(names.names == "RegistryTest;");
+  }
+};
+
+TESTCASE(RegistryTest);
@@ -0,0 +1,160 @@
+// ReporterTest.cpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                   *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <sstream>
+#include <string>
+
+#include <test/JUnitResult.hpp>
+#include <test/JsonResult.hpp>
+#include <test/TapResult.hpp>
+#include <test/TestCase.hpp>
+
+
+namespace
+{
+  // a copy, so that the assertions do not odr-use the static member
+  unsigned int const capacity = tst::FailureBuffer::Capacity;
+
+  class Reporting: public tst::TestCase<Reporting>
+  {
+  public:
+    Reporting()
+      : tst::TestCase<Reporting>(*this, "Reporting")
+    {
+      TESTADD(Reporting::testPass);
+      TESTADD(Reporting::testFail);
+    }
+
+    void testPass(tst::TestResult& result)
+    {
+      TESTASSERT(true);
+    }
+
+    // fails more often than a FailureBuffer holds failures
+    void testFail(tst::TestResult& result)
+    {
+      for (unsigned int i = 0; i < capacity + 4; ++i)
+        TESTASSERTM(false, "say \"<hi>\" & bye\n");
+    }
+  };
+
+  /**
+   * @return number of (non overlapping) occurrences of 'needle' in
+   *         'string'
+   */
+  unsigned int count(std::string const& string, std::string const& needle)
+  {
+    unsigned int count = 0;
+
+    for (std::size_t i = string.find(needle); i != std::string::npos;
+         i = string.find(needle, i + needle.size()))
+      count++;
+
+    return count;
+  }
+
+  /**
+   * @return true if 'string' ends with 'suffix', false otherwise
+   */
+  bool endsWith(std::string const& string, std::string const& suffix)
+  {
+    return string.size() >= suffix.size() &&
+           string.compare(string.size() - suffix.size(), suffix.size(), suffix) == 0;
+  }
+}
+
+
+class ReporterTest: public tst::TestCase<ReporterTest>
+{
+public:
+  ReporterTest()
+    : tst::TestCase<ReporterTest>(*this, "ReporterTest")
+  {
+  }
+
+  TESTFUNCTION(testWritesJUnit)
+  {
+    Reporting reporting;
+    std::ostringstream stream;
+    tst::JUnitResult<std::ostream> junit(stream);
+
+    reporting.run(junit);
+    junit.printSummary();
+
+    std::string xml = stream.str();
+
+    TESTASSERT(xml.find("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<testsuites>\n"
+                        "  <testsuite name=\"Reporting\">\n"
+                        "    <testcase classname=\"Reporting\" name=\"testPass\" time=\"") == 0);
+    TESTASSERTOP(count(xml, "<failure type=\"assertion\" message=\"say &quot;&lt;hi&gt;&quot; &amp; bye&#10;\">"),
+                 eq, capacity);
+    TESTASSERTOP(count(xml, "<system-out>4 further failures omitted</system-out>"), eq, 1u);
+    TESTASSERT(endsWith(xml, "    </testcase>\n  </testsuite>\n</testsuites>\n"));
+  }
+
+  TESTFUNCTION(testWritesTap)
+  {
+    Reporting reporting;
+    std::ostringstream stream;
+    tst::TapResult<std::ostream> tap(stream);
+
+    reporting.run(tap);
+    tap.printSummary();
+
+    std::string text = stream.str();
+
+    TESTASSERT(text.find("TAP version 14\n# Subtest: Reporting\n    ok 1 - testPass\n") == 0);
+    TESTASSERTOP(count(text, "\n    not ok 2 - testFail\n"), eq, 1u);
+    TESTASSERTOP(count(text, "message: \"say \\\"<hi>\\\" & bye\\n\"\n"), eq, capacity);
+    TESTASSERTOP(count(text, "omitted_failures: 4\n"), eq, 1u);
+    TESTASSERT(endsWith(text, "      ...\n    1..2\nnot ok 1 - Reporting\n1..1\n"));
+  }
+
+  TESTFUNCTION(testWritesJsonLines)
+  {
+    Reporting reporting;
+    std::ostringstream stream;
+    tst::JsonResult<std::ostream> json(stream);
+
+    reporting.run(json);
+    json.printSummary();
+
+    std::istringstream lines(stream.str());
+    std::string line;
+    unsigned int objects = 0;
+
+    while (std::getline(lines, line))
+    {
+      TESTASSERT(line.find("{\"type\":\"") == 0 && endsWith(line, "}"));
+      objects++;
+    }
+
+    std::string text = stream.str();
+
+    // test, two functions, twenty failures, end of test, summary
+    TESTASSERTOP(objects, eq, 25u);
+    TESTASSERTOP(count(text, "\"message\":\"say \\\"<hi>\\\" & bye\\n\"}\n"), eq, 20u);
+    TESTASSERTOP(count(text, "\"function\":\"testFail\",\"index\":2,\"checked\":20,\"failed\":20,"), eq, 1u);
+    TESTASSERT(endsWith(text, "{\"type\":\"endtest\",\"test\":\"Reporting\",\"functions\":2,\"functions_failed\":1}\n"
+                              "{\"type\":\"summary\",\"tests\":1,\"tests_failed\":1,\"functions\":2,"
+                              "\"functions_failed\":1,\"assertions\":21,\"assertions_failed\":20}\n"));
+  }
+};
+
+TESTCASE(ReporterTest);
@@ -0,0 +1,39 @@
+# RunTool.cmake
+
+#/***************************************************************************
+# *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                   *
+# *                                                                         *
+# *   This program is free software: you can redistribute it and/or modify  *
+# *   it under the terms of the GNU General Public License as published by  *
+# *   the Free Software Foundation, either version 3 of the License, or     *
+# *   (at your option) any later version.                                   *
+# *                                                                         *
+# *   This program is distributed in the hope that it will be useful,       *
+# *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+# *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+# *   GNU General Public License for more details.                          *
+# *                                                                         *
+# *   You should have received a copy of the GNU General Public License     *
+# *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+# ***************************************************************************/
+
+# Run a tool and check its exit status and, optionally, its output.
+#
+# cmake -DTOOL=<path> -DARGUMENTS=<argument>|... -DSTATUS=<status>
+#       [-DOUTPUT=<regex>] -P RunTool.cmake
+#
+# Arguments are separated by '|', because add_test splits lists.
+string(REPLACE "|" ";" arguments "${ARGUMENTS}")
+
+execute_process(COMMAND ${TOOL} ${arguments}
+                RESULT_VARIABLE status
+                OUTPUT_VARIABLE output
+                ERROR_VARIABLE output)
+
+if(NOT status STREQUAL STATUS)
+  message(FATAL_ERROR "${TOOL} exited with ${status} instead of ${STATUS}:\n${output}")
+endif()
+
+if(DEFINED OUTPUT AND NOT output MATCHES "${OUTPUT}")
+  message(FATAL_ERROR "Output of ${TOOL} does not match '${OUTPUT}':\n${output}")
+endif()
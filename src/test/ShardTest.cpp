@@ -0,0 +1,168 @@
+// ShardTest.cpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                   *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+#include <test/Shard.hpp>
+#include <test/ShardResult.hpp>
+#include <test/TestCase.hpp>
+#include <test/TestSuite.hpp>
+
+#include "LogResult.hpp"
+
+
+namespace
+{
+  class Functions: public tst::TestCase<Functions>
+  {
+  public:
+    Functions(char const* name)
+      : tst::TestCase<Functions>(*this, name)
+    {
+      TESTADD(Functions::test1);
+      TESTADD(Functions::test2);
+      TESTADD(Functions::test3);
+    }
+
+    void test1(tst::TestResult& result)
+    {
+      TESTASSERT(true);
+    }
+
+    void test2(tst::TestResult& result)
+    {
+      TESTASSERTM(false, "fails\tonce");
+    }
+
+    void test3(tst::TestResult& result)
+    {
+      TESTASSERT(true);
+    }
+  };
+}
+
+
+class ShardTest: public tst::TestCase<ShardTest>
+{
+public:
+  ShardTest()
+    : tst::TestCase<ShardTest>(*this, "ShardTest")
+  {
+  }
+
+  TESTFUNCTION(testShardsAreDisjointAndComplete)
+  {
+    unsigned int selected[2][3] = {};
+
+    for (unsigned int index = 0; index < 3; ++index)
+    {
+      Functions case1("Case1");
+      Functions case2("Case2");
+      tst::TestSuite suite;
+
+      suite.add(case1);
+      suite.add(case2);
+
+      tst::Shard(index, 3).apply(suite);
+
+      TESTASSERTOP(case1.selectedCount() + case2.selectedCount(), eq, 2u);
+
+      for (unsigned int i = 0; i < 3; ++i)
+      {
+        selected[0][i] += case1.functionSelected(i) ? 1 : 0;
+        selected[1][i] += case2.functionSelected(i) ? 1 : 0;
+      }
+    }
+
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      TESTASSERTOP(selected[0][i], eq, 1u);
+      TESTASSERTOP(selected[1][i], eq, 1u);
+    }
+  }
+
+  TESTFUNCTION(testHistoryBalancesDurations)
+  {
+    tst::History history;
+    history.update(tst::History::key("Case1", "test2"), 10.0);
+
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      char const* names[] = {"test1", "test2", "test3"};
+
+      if (i != 1)
+        history.update(tst::History::key("Case1", names[i]), 1.0);
+
+      history.update(tst::History::key("Case2", names[i]), 1.0);
+    }
+
+    Functions case1("Case1");
+    Functions case2("Case2");
+    tst::TestSuite suite;
+
+    suite.add(case1);
+    suite.add(case2);
+
+    // the slow function takes as long as all others together
+    tst::Shard(0, 2).apply(suite, &history);
+
+    TESTASSERTOP(case1.selectedCount(), eq, 1u);
+    TESTASSERT(case1.functionSelected(1));
+    TESTASSERTOP(case2.selectedCount(), eq, 0u);
+  }
+
+  TESTFUNCTION(testParsesArguments)
+  {
+    char const* valid[] = {"test", "--other", "--shard=1/3"};
+    tst::Shard shard = tst::Shard::fromArguments(3, valid);
+
+    TESTASSERTOP(shard.index(), eq, 1u);
+    TESTASSERTOP(shard.count(), eq, 3u);
+
+    unsetenv("TST_SHARD_INDEX");
+    unsetenv("TST_SHARD_COUNT");
+
+    char const* invalid[] = {"test", "--shard=3/3"};
+    shard = tst::Shard::fromArguments(2, invalid);
+
+    TESTASSERTOP(shard.index(), eq, 0u);
+    TESTASSERTOP(shard.count(), eq, 1u);
+  }
+
+  TESTFUNCTION(testWritesRecord)
+  {
+    Functions functions("Case1");
+    std::ostringstream stream;
+    tst::LogResult log;
+    tst::ShardResult<std::ostream> record(stream, log, tst::Shard(1, 3));
+
+    functions.run(record);
+
+    std::string text = stream.str();
+
+    TESTASSERT(text.find("tst-shard\t1\t1\t3\ntest\tCase1\n") == 0);
+    TESTASSERT(text.find("\tfails once\nfunction\ttest2\t1\t") != std::string::npos);
+    TESTASSERT(text.rfind("\nendtest\n") == text.size() - 9);
+    TESTASSERT(log.log() == "<Case1:test1;test2!;test3;>");
+  }
+};
+
+TESTCASE(ShardTest);
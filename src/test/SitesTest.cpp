@@ -0,0 +1,143 @@
+// SitesTest.cpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                   *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+/*
+ * This file is built with TST_SITE_COUNTERS and optimizations enabled.
+ * It checks assertions from inline functions (the ones defined in the
+ * class definitions) as well as from non-inline ones, which is what
+ * most test cases do.
+ */
+
+#include <thread>
+
+#include <test/Sites.hpp>
+#include <test/TestCase.hpp>
+
+#include "LogResult.hpp"
+
+
+namespace
+{
+  /* Lines of an assertion in an inline and a non-inline function. */
+  int inline_line = 0;
+  int out_of_line_line = 0;
+
+  template<typename T>
+  inline void checkEqual(tst::TestResult& result, T const& first, T const& second)
+  {
+    TESTASSERTOP(first, eq, second);
+  }
+
+  class Counted: public tst::TestCase<Counted>
+  {
+  public:
+    Counted()
+      : tst::TestCase<Counted>(*this, "Counted")
+    {
+      TESTADD(Counted::testInline);
+      TESTADD(Counted::testOutOfLine);
+    }
+
+    void testInline(tst::TestResult& result)
+    {
+      for (int i = 0; i < 10; ++i)
+        TESTASSERT(i < 10);
+
+      inline_line = __LINE__; TESTASSERTM(false, "fails");
+    }
+
+    void testOutOfLine(tst::TestResult& result);
+  };
+
+  void Counted::testOutOfLine(tst::TestResult& result)
+  {
+    checkEqual(result, 1, 1);
+    checkEqual(result, 2, 2);
+    out_of_line_line = __LINE__; TESTASSERT(true);
+  }
+}
+
+
+class SitesTest: public tst::TestCase<SitesTest>
+{
+public:
+  SitesTest()
+    : tst::TestCase<SitesTest>(*this, "SitesTest")
+  {
+  }
+
+  TESTFUNCTION(testCountsPerFunction)
+  {
+    Counted counted;
+    tst::LogResult log;
+
+    counted.run(log);
+
+    TESTASSERT(log.log() == "<Counted:testInline!;testOutOfLine;>");
+    TESTASSERTOP(log.measurements().size(), eq, 2u);
+    TESTASSERTOP(log.measurements()[0].checked, eq, 11u);
+    TESTASSERTOP(log.measurements()[1].checked, eq, 3u);
+  }
+
+  TESTFUNCTION(testListsExecutedSites);
+
+  TESTFUNCTION(testTakesAndCredits)
+  {
+    std::uint64_t before = tst::Sites::take();
+    std::uint64_t checked = 0;
+
+    std::thread thread([&checked]()
+    {
+      tst::LogResult log;
+      tst::TestResult& result = log;
+
+      TESTASSERT(true);
+      TESTASSERT(true);
+      checked = tst::Sites::take();
+    });
+    thread.join();
+
+    tst::Sites::credit(checked);
+    std::uint64_t credited = tst::Sites::take();
+
+    tst::Sites::credit(before);
+
+    TESTASSERTOP(checked, eq, 2u);
+    TESTASSERTOP(credited, eq, 2u);
+  }
+};
+
+void SitesTest::testListsExecutedSites(tst::TestResult& result)
+{
+  bool inline_listed = false;
+  bool out_of_line_listed = false;
+
+  for (tst::Site* site = tst::Sites::executed(); site != nullptr; site = site->next)
+  {
+    if (site->line == inline_line)
+      inline_listed = true;
+    else if (site->line == out_of_line_line)
+      out_of_line_listed = true;
+  }
+
+  TESTASSERT(inline_listed);
+  TESTASSERT(out_of_line_listed);
+}
+
+TESTCASE(SitesTest);
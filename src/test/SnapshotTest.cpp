@@ -0,0 +1,224 @@
+// SnapshotTest.cpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                   *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <test/Snapshot.hpp>
+#include <test/TestCase.hpp>
+
+#include "LogResult.hpp"
+
+
+namespace
+{
+  char const golden[] = "SnapshotTest.golden";
+  char const actual[] = "SnapshotTest.actual";
+
+  /**
+   * @param path path of the file to write
+   * @param contents contents to write
+   */
+  void writeFile(char const* path, std::string const& contents)
+  {
+    std::FILE* file = std::fopen(path, "wb");
+
+    if (file != nullptr)
+    {
+      std::fwrite(contents.data(), 1, contents.size(), file);
+      std::fclose(file);
+    }
+  }
+
+  /**
+   * @param path path of the file to read
+   * @return contents of the file
+   */
+  std::string readFile(char const* path)
+  {
+    tst::Snapshot::Mapping mapping(path);
+    char const* data = static_cast<char const*>(mapping.data());
+
+    return mapping.valid() ? std::string(data, data + mapping.size()) : std::string();
+  }
+
+  /**
+   * @param contents data to compare with the golden file
+   * @return the message describing the differences, empty if there are
+   *         none
+   */
+  std::string check(std::string const& contents)
+  {
+    char message[1024];
+
+    if (tst::Snapshot::check(golden, contents.data(), contents.size(), message, sizeof(message)))
+      return std::string();
+
+    return message;
+  }
+
+  /**
+   * A case using the snapshot assertions.
+   */
+  class Snapshots: public tst::TestCase<Snapshots>
+  {
+  public:
+    Snapshots()
+      : tst::TestCase<Snapshots>(*this, "Snapshots")
+    {
+      TESTADD(Snapshots::testData);
+      TESTADD(Snapshots::testFile);
+    }
+
+    void testData(tst::TestResult& result)
+    {
+      TESTASSERTSNAPSHOT(golden, "hello world", 11);
+      TESTASSERTSNAPSHOT(golden, "hello there", 11);
+    }
+
+    void testFile(tst::TestResult& result)
+    {
+      TESTASSERTSNAPSHOTFILE(golden, actual);
+    }
+  };
+}
+
+
+class SnapshotTest: public tst::TestCase<SnapshotTest>
+{
+public:
+  SnapshotTest()
+    : tst::TestCase<SnapshotTest>(*this, "SnapshotTest"),
+      update_(false)
+  {
+  }
+
+  TESTFUNCTION(testCreatesMissingSnapshots)
+  {
+    std::string message = check("created");
+
+    TESTASSERT(message == std::string("snapshot ") + golden +
+                          " does not exist; set TST_UPDATE_SNAPSHOTS=1 to create it");
+
+    tst::Snapshot::setUpdate(true);
+    TESTASSERT(check("created").empty());
+
+    tst::Snapshot::setUpdate(false);
+    TESTASSERT(check("created").empty());
+    TESTASSERT(readFile(golden) == "created");
+  }
+
+  TESTFUNCTION(testReportsDifferences)
+  {
+    writeFile(golden, "hello world");
+
+    TESTASSERT(check("hello world").empty());
+    TESTASSERT(check("hello there") ==
+               std::string("snapshot ") + golden + " differs: 5 bytes differ, first at offset 6 (0x6)\n"
+               "  expected: 00000000: 68 65 6c 6c 6f 20 [77] 6f 72 6c 64\n"
+               "  actual:   00000000: 68 65 6c 6c 6f 20 [74] 68 65 72 65");
+
+    // a prefix only differs in size
+    TESTASSERT(check("hello") ==
+               std::string("snapshot ") + golden + " differs in size; 11 bytes expected, 5 bytes actual\n"
+               "  expected: 00000000: 68 65 6c 6c 6f [20] 77 6f 72 6c 64\n"
+               "  actual:   00000000: 68 65 6c 6c 6f");
+  }
+
+  TESTFUNCTION(testComparesEmptySnapshots)
+  {
+    writeFile(golden, "");
+
+    TESTASSERT(check("").empty());
+    TESTASSERT(check("x").find(" differs in size; 0 bytes expected, 1 bytes actual") != std::string::npos);
+  }
+
+  TESTFUNCTION(testUpdatesDifferingSnapshots)
+  {
+    std::string large(1 << 20, 'a');
+    writeFile(golden, large);
+
+    large[large.size() / 2] = 'b';
+    TESTASSERT(!check(large).empty());
+
+    tst::Snapshot::setUpdate(true);
+    TESTASSERT(check(large).empty());
+    tst::Snapshot::setUpdate(false);
+
+    TESTASSERT(check(large).empty());
+    TESTASSERT(readFile(golden) == large);
+  }
+
+  TESTFUNCTION(testReportsThroughAssertions)
+  {
+    writeFile(golden, "hello world");
+    writeFile(actual, "hello world");
+
+    Snapshots snapshots;
+    tst::LogResult log;
+
+    snapshots.run(log);
+
+    TESTASSERT(log.log() == "<Snapshots:testData!;testFile;>");
+    TESTASSERTOP(log.checks(), eq, 3u);
+
+    std::remove(actual);
+
+    tst::LogResult missing;
+    snapshots.run(missing);
+
+    std::vector<std::string> messages = missing.messages();
+
+    TESTASSERTFATAL(messages.size() == 2);
+    TESTASSERT(messages[1] == std::string("cannot read ") + actual);
+  }
+
+  TESTFUNCTION(testRequestsUpdates)
+  {
+    char const* update[] = {"test", "--update-snapshots"};
+    char const* none[] = {"test", "--verbose"};
+
+    TESTASSERT(tst::Snapshot::updateRequested(2, update));
+
+    if (std::getenv("TST_UPDATE_SNAPSHOTS") == nullptr)
+      TESTASSERT(!tst::Snapshot::updateRequested(2, none));
+  }
+
+protected:
+  virtual void setUp() override
+  {
+    update_ = tst::Snapshot::update();
+    tst::Snapshot::setUpdate(false);
+    std::remove(golden);
+  }
+
+  virtual void tearDown() override
+  {
+    std::remove(golden);
+    tst::Snapshot::setUpdate(update_);
+  }
+
+private:
+  bool update_;
+};
+
+TESTCASE(SnapshotTest);
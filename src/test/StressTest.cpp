@@ -0,0 +1,161 @@
+// StressTest.cpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                   *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <test/Stress.hpp>
+#include <test/TestCase.hpp>
+
+#include "LogResult.hpp"
+
+
+namespace
+{
+  class Racing: public tst::TestCase<Racing>
+  {
+  public:
+    Racing()
+      : tst::TestCase<Racing>(*this, "Racing"),
+        calls_(0)
+    {
+      TESTADD(Racing::testFails);
+      TESTADD(Racing::testThrows);
+    }
+
+    // fails on one of the threads in the third repetition
+    void testFails(tst::TestResult& result)
+    {
+      tst::Stress stress(4, 10);
+      stress.setSeed(42);
+
+      TESTSTRESS(stress, [this](tst::TestResult& result, unsigned int thread)
+      {
+        unsigned int calls = ++calls_;
+        TESTASSERTM(thread != 2 || calls <= 8, "racy");
+      });
+    }
+
+    void testThrows(tst::TestResult& result)
+    {
+      tst::Stress stress(2, 10);
+
+      TESTSTRESS(stress, [](tst::TestResult&, unsigned int)
+      {
+        throw std::runtime_error("throws");
+      });
+    }
+
+  private:
+    std::atomic<unsigned int> calls_;
+  };
+}
+
+
+class StressTest: public tst::TestCase<StressTest>
+{
+public:
+  StressTest()
+    : tst::TestCase<StressTest>(*this, "StressTest")
+  {
+  }
+
+  TESTFUNCTION(testBarrierReleasesTogether)
+  {
+    unsigned int const threads = 4;
+    unsigned int const rounds = 100;
+
+    tst::SpinBarrier barrier(threads);
+    std::vector<std::atomic<unsigned int>> arrived(rounds);
+    std::atomic<unsigned int> early(0);
+    std::vector<std::thread> workers;
+
+    for (auto it = arrived.begin(); it != arrived.end(); ++it)
+      it->store(0);
+
+    for (unsigned int i = 0; i < threads; ++i)
+    {
+      workers.emplace_back([&]()
+      {
+        for (unsigned int round = 0; round < rounds; ++round)
+        {
+          arrived[round]++;
+          barrier.wait();
+
+          if (arrived[round].load() != threads)
+            early++;
+        }
+      });
+    }
+
+    for (auto it = workers.begin(); it != workers.end(); ++it)
+      it->join();
+
+    TESTASSERTOP(early.load(), eq, 0u);
+  }
+
+  TESTFUNCTION(testRunsBodyOnAllThreads)
+  {
+    tst::Stress stress(4, 25);
+    std::atomic<unsigned int> calls(0);
+    std::atomic<unsigned int> threads[4];
+
+    for (unsigned int i = 0; i < 4; ++i)
+      threads[i] = 0;
+
+    tst::LogResult log;
+    bool passed = stress.run(log, [&](tst::TestResult& result, unsigned int thread)
+    {
+      calls++;
+      threads[thread]++;
+      TESTASSERT(thread < 4);
+    });
+
+    TESTASSERT(passed);
+    TESTASSERTOP(stress.failedRepetition(), eq, 25u);
+    TESTASSERTOP(calls.load(), eq, 100u);
+    TESTASSERTOP(log.checks(), eq, 100u);
+
+    for (unsigned int i = 0; i < 4; ++i)
+      TESTASSERTOP(threads[i].load(), eq, 25u);
+  }
+
+  TESTFUNCTION(testReportsFailingRepetition)
+  {
+    Racing racing;
+    tst::LogResult log;
+
+    racing.run(log);
+
+    std::vector<std::string> messages = log.messages();
+
+    // both threads throw in the first repetition
+    TESTASSERTFATAL(messages.size() == 5);
+    TESTASSERT(messages[0] == "racy");
+    TESTASSERT(messages[1] == "Failed in repetition 3 of 10 (4 threads, seed 42)");
+    TESTASSERT(messages[2] == "Unexpected exception");
+    TESTASSERT(messages[3] == "Unexpected exception");
+    TESTASSERT(messages[4].find("Failed in repetition 1 of 10 (2 threads, seed ") == 0);
+  }
+};
+
+TESTCASE(StressTest);
@@ -0,0 +1,42 @@
+// ThrowsWithoutExceptions.cpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                   *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+/*
+ * This file must not compile: it is built without exceptions, where
+ * checking that an expression throws is rejected.
+ */
+
+#include <test/TestCase.hpp>
+
+
+class ThrowsWithoutExceptions: public tst::TestCase<ThrowsWithoutExceptions>
+{
+public:
+  ThrowsWithoutExceptions()
+    : tst::TestCase<ThrowsWithoutExceptions>(*this, "ThrowsWithoutExceptions")
+  {
+  }
+
+  TESTFUNCTION(testThrows)
+  {
+    TESTTHROWSANY(result.checked(__FILE__, __LINE__));
+  }
+};
+
+TESTCASE(ThrowsWithoutExceptions);
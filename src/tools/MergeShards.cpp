@@ -0,0 +1,319 @@
+// MergeShards.cpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+/*
+ * This tool merges the records written by ShardResult objects of all
+ * shards of a test run into a single summary, as printed by
+ * DefaultResult.
+ *
+ * Usage: merge-shards [-v] [-s <count>] <record>...
+ *
+ * The records of all shards of the run have to be given, each exactly
+ * once; otherwise the tool fails with exit status 2.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <test/DefaultResult.hpp>
+
+
+namespace
+{
+  struct Failure
+  {
+    std::string file;
+    int line;
+    std::string message;
+    bool has_message;
+  };
+
+  struct Function
+  {
+    std::string name;
+    unsigned long checked;
+    tst::Measurement measurement;
+    std::vector<Failure> failures;
+  };
+
+  struct Test
+  {
+    std::string name;
+    bool has_name;
+    std::vector<Function> functions;
+    /* Failures reported outside of any function. */
+    std::vector<Failure> failures;
+  };
+
+
+  /**
+   * @param line line to split
+   * @return list of tab separated fields contained in the line
+   */
+  std::vector<std::string> split(std::string const& line)
+  {
+    std::vector<std::string> fields;
+    std::string::size_type begin = 0;
+
+    for (;;)
+    {
+      std::string::size_type end = line.find('\t', begin);
+      fields.push_back(line.substr(begin, end - begin));
+
+      if (end == std::string::npos)
+        break;
+
+      begin = end + 1;
+    }
+    return fields;
+  }
+
+  /**
+   * Attribute failures that were not followed by the function they were
+   * reported in to the enclosing test, or to an unnamed test of their
+   * own if there is none.
+   * @param failures failures to attribute; the list is emptied
+   * @param test enclosing test (may be null)
+   * @param tests list of all tests
+   */
+  void orphan(std::vector<Failure>& failures, Test* test, std::vector<Test>& tests)
+  {
+    if (failures.empty())
+      return;
+
+    if (test == nullptr)
+    {
+      tests.push_back(Test());
+      test = &tests.back();
+    }
+
+    test->failures.insert(test->failures.end(), failures.begin(), failures.end());
+    failures.clear();
+  }
+
+  /**
+   * Read the record of one shard and merge it into the given list of
+   * tests. Tests are identified by their name; unnamed tests are never
+   * merged.
+   * @param path path to the record to read
+   * @param shard index of the shard the record belongs to
+   * @param count total number of shards of the run
+   * @param tests list of tests to merge into
+   * @param index map from test names to their index in 'tests'
+   * @return true on success, false if the record could not be read
+   */
+  bool read(char const* path,
+            unsigned long& shard,
+            unsigned long& count,
+            std::vector<Test>& tests,
+            std::map<std::string, std::size_t>& index)
+  {
+    std::ifstream stream(path);
+    std::string line;
+
+    if (!std::getline(stream, line))
+      return false;
+
+    std::vector<std::string> header = split(line);
+
+    if (header.size() < 4 || header[0] != "tst-shard" || header[1] != "1")
+      return false;
+
+    char* end;
+    shard = std::strtoul(header[2].c_str(), &end, 10);
+
+    if (header[2].empty() || *end != '\0')
+      return false;
+
+    count = std::strtoul(header[3].c_str(), &end, 10);
+
+    if (header[3].empty() || *end != '\0' || shard >= count)
+      return false;
+
+    Test* test = nullptr;
+    Function function = Function();
+
+    while (std::getline(stream, line))
+    {
+      std::vector<std::string> fields = split(line);
+
+      if (fields[0] == "test" && fields.size() >= 2)
+      {
+        bool has_name = !fields[1].empty();
+
+        orphan(function.failures, test, tests);
+        function = Function();
+
+        if (has_name && index.count(fields[1]) > 0)
+          test = &tests[index[fields[1]]];
+        else
+        {
+          Test t = {fields[1], has_name, std::vector<Function>(), std::vector<Failure>()};
+          tests.push_back(t);
+
+          if (has_name)
+            index[fields[1]] = tests.size() - 1;
+
+          test = &tests.back();
+        }
+      }
+      else if (fields[0] == "failed" && fields.size() >= 3)
+      {
+        Failure failure = {
+          fields[1],
+          std::atoi(fields[2].c_str()),
+          fields.size() >= 4 ? fields[3] : std::string(),
+          fields.size() >= 4,
+        };
+        function.failures.push_back(failure);
+      }
+      else if (fields[0] == "function" && fields.size() >= 7 && test != nullptr)
+      {
+        function.name = fields[1];
+        function.checked = std::strtoul(fields[2].c_str(), nullptr, 10);
+        function.measurement.wall = std::strtoull(fields[3].c_str(), nullptr, 10);
+        function.measurement.cpu = std::strtoull(fields[4].c_str(), nullptr, 10);
+        function.measurement.set_up = std::strtoull(fields[5].c_str(), nullptr, 10);
+        function.measurement.tear_down = std::strtoull(fields[6].c_str(), nullptr, 10);
+
+        test->functions.push_back(function);
+        function = Function();
+      }
+      else if (fields[0] == "endtest")
+      {
+        orphan(function.failures, test, tests);
+        function = Function();
+        test = nullptr;
+      }
+    }
+
+    // the shard did not get to finish its last function
+    orphan(function.failures, test, tests);
+    return true;
+  }
+}
+
+
+int main(int argc, char* argv[])
+{
+  bool verbose = false;
+  unsigned int slowest = 0;
+  std::vector<Test> tests;
+  std::map<std::string, std::size_t> index;
+  /* Shards whose records were read and the number of shards of the run. */
+  std::set<unsigned long> shards;
+  unsigned long shard_count = 0;
+
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " [-v] [-s <count>] <record>...\n";
+    return 2;
+  }
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (std::strcmp(argv[i], "-v") == 0)
+      verbose = true;
+    else if (std::strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+      slowest = std::strtoul(argv[++i], nullptr, 10);
+    else
+    {
+      unsigned long shard;
+      unsigned long count;
+
+      if (!read(argv[i], shard, count, tests, index))
+      {
+        std::cerr << "Failed to read shard record " << argv[i] << '\n';
+        return 2;
+      }
+
+      if (shards.empty())
+        shard_count = count;
+
+      if (count != shard_count)
+      {
+        std::cerr << "Shard record " << argv[i] << " is from a run with " << count
+                  << " shards, not " << shard_count << '\n';
+        return 2;
+      }
+
+      if (!shards.insert(shard).second)
+      {
+        std::cerr << "Shard record " << argv[i] << " duplicates shard " << shard << '\n';
+        return 2;
+      }
+    }
+  }
+
+  if (shards.size() != shard_count)
+  {
+    // the indices are all below the count, so the first gap is missing
+    unsigned long missing = 0;
+
+    for (auto it = shards.begin(); it != shards.end() && *it == missing; ++it)
+      missing++;
+
+    std::cerr << "Shard record of shard " << missing << " of " << shard_count << " is missing\n";
+    return 2;
+  }
+
+  tst::DefaultResult<std::ostream> result(std::cout, verbose, slowest);
+
+  for (auto test = tests.begin(); test != tests.end(); ++test)
+  {
+    result.startTest(test->has_name ? test->name.c_str() : nullptr);
+
+    for (auto function = test->functions.begin(); function != test->functions.end(); ++function)
+    {
+      result.startTestFunction(function->name.empty() ? nullptr : function->name.c_str());
+
+      for (auto failure = function->failures.begin(); failure != function->failures.end(); ++failure)
+      {
+        char const* message = failure->has_message ? failure->message.c_str() : nullptr;
+        result.failed(failure->file.c_str(), failure->line, message);
+      }
+
+      tst::Measurement measurement = function->measurement;
+      measurement.checked = function->checked;
+
+      result.endTestFunction(measurement);
+    }
+
+    for (auto failure = test->failures.begin(); failure != test->failures.end(); ++failure)
+    {
+      char const* message = failure->has_message ? failure->message.c_str() : nullptr;
+      result.failed(failure->file.c_str(), failure->line, message);
+    }
+
+    result.endTest();
+  }
+
+  std::cout << "-----------------------------\n";
+  std::cout << "Summary:\n";
+
+  result.printSummary();
+  return result.assertionsFailed() > 0 ? 1 : 0;
+}
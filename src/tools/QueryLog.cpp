@@ -0,0 +1,365 @@
+// QueryLog.cpp
+
+/***************************************************************************
+ *   Copyright (C) 2026 Daniel Mueller (deso@posteo.net)                    *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+/*
+ * This tool answers questions about binary logs of test runs, as
+ * written by EventLogResult, without parsing any text.
+ *
+ * Usage: query-log summary <log>
+ *        query-log failures <log> [<file>]
+ *        query-log slowest <log> [<count>]
+ *        query-log diff <old log> <new log>
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <test/EventLog.hpp>
+#include <test/Format.hpp>
+
+
+namespace
+{
+  struct Function
+  {
+    /* Qualified name, i.e., "<case>::<function>". */
+    std::string name;
+    std::uint64_t wall;
+    std::uint64_t cpu;
+    std::uint64_t checked;
+    std::uint64_t failures;
+  };
+
+  struct Failure
+  {
+    char const* file;
+    std::uint32_t line;
+    char const* message;
+    /* Index of the function the failure occurred in. */
+    std::size_t function;
+  };
+
+  struct Run
+  {
+    std::vector<Function> functions;
+    std::vector<Failure> failures;
+    std::uint64_t tests;
+    std::uint64_t duration;
+  };
+
+
+  /**
+   * @param string string to return (may be null)
+   * @return the string or an empty one if it is null
+   */
+  char const* text(char const* string)
+  {
+    return string != nullptr ? string : "";
+  }
+
+  /**
+   * Collect the functions and failures of a run from its log.
+   * @param log log to read
+   * @return the run described by the log
+   */
+  Run collect(tst::EventLog const& log)
+  {
+    Run run = {std::vector<Function>(), std::vector<Failure>(), 0, 0};
+    char const* test = nullptr;
+    char const* function = nullptr;
+    std::uint64_t failures = 0;
+
+    log.forEach([&](tst::EventLog::Record const& record)
+    {
+      run.duration = std::max(run.duration, record.time);
+
+      switch (record.type)
+      {
+      case tst::EventLog::StartTest:
+        test = log.string(record.string);
+        run.tests++;
+        break;
+
+      case tst::EventLog::StartFunction:
+        function = log.string(record.string);
+        failures = 0;
+        break;
+
+      case tst::EventLog::Failed:
+      {
+        Failure failure = {log.string(record.string), record.number, log.string(record.message), run.functions.size()};
+        run.failures.push_back(failure);
+        failures++;
+        break;
+      }
+
+      case tst::EventLog::EndFunction:
+      {
+        Function entry = {
+          std::string(text(test)) + "::" + text(function),
+          record.wall,
+          record.cpu,
+          record.number,
+          failures,
+        };
+        run.functions.push_back(entry);
+        break;
+      }
+
+      default:
+        break;
+      }
+    });
+    return run;
+  }
+
+  /**
+   * @param run run to print a summary of
+   */
+  void summary(Run const& run)
+  {
+    std::uint64_t checked = 0;
+    std::uint64_t failed = 0;
+
+    for (auto it = run.functions.begin(); it != run.functions.end(); ++it)
+    {
+      checked += it->checked;
+      failed += it->failures > 0 ? 1 : 0;
+    }
+
+    std::cout << "Tests run:          " << run.tests << '\n'
+              << "Functions run:      " << run.functions.size() << '\n'
+              << "Functions failed:   " << failed << '\n'
+              << "Assertions checked: " << checked << '\n'
+              << "Assertions failed:  " << run.failures.size() << '\n'
+              << "Duration:           ";
+    tst::printTime(std::cout, static_cast<double>(run.duration));
+    std::cout << '\n';
+  }
+
+  /**
+   * Print the number of failures per file or, if a file is given, the
+   * failures in files whose name contains it.
+   * @param run run to print the failures of
+   * @param file part of the name of the files of interest (may be
+   *        null)
+   */
+  void failures(Run const& run, char const* file)
+  {
+    if (file != nullptr)
+    {
+      for (auto it = run.failures.begin(); it != run.failures.end(); ++it)
+      {
+        if (std::strstr(text(it->file), file) == nullptr)
+          continue;
+
+        std::cout << text(it->file) << ':' << it->line << ": "
+                  << run.functions[it->function].name;
+
+        if (it->message != nullptr)
+          std::cout << ": " << it->message;
+
+        std::cout << '\n';
+      }
+      return;
+    }
+
+    std::map<std::string, std::uint64_t> counts;
+
+    for (auto it = run.failures.begin(); it != run.failures.end(); ++it)
+      counts[text(it->file)]++;
+
+    std::vector<std::pair<std::uint64_t, std::string>> sorted;
+
+    for (auto it = counts.begin(); it != counts.end(); ++it)
+      sorted.push_back(std::make_pair(it->second, it->first));
+
+    std::stable_sort(sorted.begin(), sorted.end(), [](std::pair<std::uint64_t, std::string> const& lhs,
+                                                      std::pair<std::uint64_t, std::string> const& rhs)
+    {
+      return lhs.first > rhs.first;
+    });
+
+    for (auto it = sorted.begin(); it != sorted.end(); ++it)
+      std::cout << it->first << '\t' << it->second << '\n';
+  }
+
+  /**
+   * @param run run to print the slowest functions of
+   * @param count number of functions to print
+   */
+  void slowest(Run const& run, std::size_t count)
+  {
+    std::vector<Function const*> functions;
+
+    for (auto it = run.functions.begin(); it != run.functions.end(); ++it)
+      functions.push_back(&*it);
+
+    count = std::min(count, functions.size());
+    std::partial_sort(functions.begin(), functions.begin() + count, functions.end(),
+                      [](Function const* lhs, Function const* rhs)
+    {
+      return lhs->wall > rhs->wall;
+    });
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      tst::printTime(std::cout, static_cast<double>(functions[i]->wall));
+      std::cout << '\t' << functions[i]->name << '\n';
+    }
+  }
+
+  /**
+   * Print the differences between two runs: functions failing in only
+   * one of them, functions run in only one of them, and functions that
+   * got at least 50% slower (and by more than a millisecond).
+   * @param old earlier run
+   * @param run later run
+   * @return true if functions failed in the later run only, false
+   *         otherwise
+   */
+  bool diff(Run const& old, Run const& run)
+  {
+    std::map<std::string, Function const*> before;
+    std::map<std::string, Function const*> after;
+
+    for (auto it = old.functions.begin(); it != old.functions.end(); ++it)
+      before.insert(std::make_pair(it->name, &*it));
+
+    for (auto it = run.functions.begin(); it != run.functions.end(); ++it)
+      after.insert(std::make_pair(it->name, &*it));
+
+    bool regressed = false;
+    std::vector<std::pair<std::uint64_t, std::string>> slower;
+
+    for (auto it = after.begin(); it != after.end(); ++it)
+    {
+      auto other = before.find(it->first);
+
+      if (other == before.end())
+      {
+        std::cout << "added\t" << it->first << '\n';
+        continue;
+      }
+
+      Function const& previous = *other->second;
+      Function const& current = *it->second;
+
+      if (current.failures > 0 && previous.failures == 0)
+      {
+        std::cout << "failing\t" << it->first << '\n';
+        regressed = true;
+      }
+      else if (current.failures == 0 && previous.failures > 0)
+        std::cout << "fixed\t" << it->first << '\n';
+
+      if (current.wall > previous.wall + previous.wall / 2 && current.wall - previous.wall > 1000000)
+        slower.push_back(std::make_pair(current.wall - previous.wall, it->first));
+    }
+
+    for (auto it = before.begin(); it != before.end(); ++it)
+    {
+      if (after.count(it->first) == 0)
+        std::cout << "removed\t" << it->first << '\n';
+    }
+
+    std::stable_sort(slower.begin(), slower.end(), [](std::pair<std::uint64_t, std::string> const& lhs,
+                                                      std::pair<std::uint64_t, std::string> const& rhs)
+    {
+      return lhs.first > rhs.first;
+    });
+
+    for (auto it = slower.begin(); it != slower.end(); ++it)
+    {
+      Function const& previous = *before[it->second];
+      Function const& current = *after[it->second];
+
+      std::cout << "slower\t" << it->second << '\t';
+      tst::printTime(std::cout, static_cast<double>(previous.wall));
+      std::cout << " -> ";
+      tst::printTime(std::cout, static_cast<double>(current.wall));
+      std::cout << '\n';
+    }
+    return regressed;
+  }
+
+  /**
+   * @param program name of the program
+   * @return exit code for usage errors
+   */
+  int usage(char const* program)
+  {
+    std::cerr << "Usage: " << program << " summary <log>\n"
+              << "       " << program << " failures <log> [<file>]\n"
+              << "       " << program << " slowest <log> [<count>]\n"
+              << "       " << program << " diff <old log> <new log>\n";
+    return 2;
+  }
+}
+
+
+int main(int argc, char* argv[])
+{
+  if (argc < 3)
+    return usage(argv[0]);
+
+  char const* command = argv[1];
+  bool comparing = std::strcmp(command, "diff") == 0;
+
+  if (comparing && argc < 4)
+    return usage(argv[0]);
+
+  tst::EventLog log(argv[2]);
+
+  if (!log.valid())
+  {
+    std::cerr << "Failed to read log " << argv[2] << '\n';
+    return 2;
+  }
+
+  Run run = collect(log);
+
+  if (std::strcmp(command, "summary") == 0)
+    summary(run);
+  else if (std::strcmp(command, "failures") == 0)
+    failures(run, argc > 3 ? argv[3] : nullptr);
+  else if (std::strcmp(command, "slowest") == 0)
+    slowest(run, argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 10);
+  else if (comparing)
+  {
+    tst::EventLog other(argv[3]);
+
+    if (!other.valid())
+    {
+      std::cerr << "Failed to read log " << argv[3] << '\n';
+      return 2;
+    }
+    return diff(run, collect(other)) ? 1 : 0;
+  }
+  else
+    return usage(argv[0]);
+
+  return 0;
+}